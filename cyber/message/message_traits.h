@@ -19,6 +19,9 @@
 
 #include <string>
 
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+
 #include "cyber/base/macros.h"
 #include "cyber/common/log.h"
 #include "cyber/message/message_header.h"
@@ -165,6 +168,49 @@ ParseFromString(const std::string& str, T* message) {
   return false;
 }
 
+// Parse only the `header` field of a protobuf message and skip the rest of
+// the wire data, falls back to a full parse for messages without a header.
+template <typename T>
+typename std::enable_if<std::is_base_of<google::protobuf::Message, T>::value,
+                        bool>::type
+ParseHeaderFromArray(const void* data, int size, T* message) {
+  using google::protobuf::FieldDescriptor;
+  using google::protobuf::internal::WireFormatLite;
+  const FieldDescriptor* field = T::descriptor()->FindFieldByName("header");
+  if (field == nullptr || field->is_repeated() ||
+      field->type() != FieldDescriptor::TYPE_MESSAGE) {
+    return message->ParseFromArray(data, size);
+  }
+  message->Clear();
+  const uint8_t* buf = static_cast<const uint8_t*>(data);
+  google::protobuf::io::CodedInputStream input(buf, size);
+  while (true) {
+    uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      return input.CurrentPosition() == size;
+    }
+    if (WireFormatLite::GetTagFieldNumber(tag) != field->number() ||
+        WireFormatLite::GetTagWireType(tag) !=
+            WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      RETURN_VAL_IF(!WireFormatLite::SkipField(&input, tag), false);
+      continue;
+    }
+    uint32_t length = 0;
+    RETURN_VAL_IF(!input.ReadVarint32(&length), false);
+    int offset = input.CurrentPosition();
+    RETURN_VAL_IF(static_cast<int64_t>(length) > size - offset, false);
+    auto header = message->GetReflection()->MutableMessage(message, field);
+    return header->ParseFromArray(buf + offset, static_cast<int>(length));
+  }
+}
+
+template <typename T>
+typename std::enable_if<!std::is_base_of<google::protobuf::Message, T>::value,
+                        bool>::type
+ParseHeaderFromArray(const void* data, int size, T* message) {
+  return ParseFromArray(data, size, message);
+}
+
 template <typename T>
 typename std::enable_if<HasParseFromArray<T>::value, bool>::type ParseFromHC(
     const void* data, int size, T* message) {
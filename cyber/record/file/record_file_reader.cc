@@ -132,6 +132,30 @@ bool RecordFileReader::ReadSection(Section* section) {
   return true;
 }
 
+bool RecordFileReader::ReadRawSection(int64_t size, std::string* buffer) {
+  if (size < 0 || size > std::numeric_limits<int>::max()) {
+    AERROR << "Invalid section size: " << size;
+    return false;
+  }
+  buffer->resize(static_cast<size_t>(size));
+  int64_t offset = 0;
+  while (offset < size) {
+    ssize_t count = read(fd_, &(*buffer)[offset], size - offset);
+    if (count < 0) {
+      AERROR << "Read fd failed, fd_: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    if (count == 0) {
+      end_of_file_ = true;
+      AERROR << "Unexpected end of file, expect count: " << size
+             << ", actual count: " << offset;
+      return false;
+    }
+    offset += count;
+  }
+  return true;
+}
+
 bool RecordFileReader::SkipSection(int64_t size) {
   int64_t pos = CurrentPosition();
   if (size > INT64_MAX - pos) {
@@ -53,6 +53,8 @@ class RecordFileReader : public RecordFileBase {
   bool SkipSection(int64_t size);
   template <typename T>
   bool ReadSection(int64_t size, T* message);
+  // read the serialized section body without parsing it
+  bool ReadRawSection(int64_t size, std::string* buffer);
   bool ReadIndex();
   bool EndOfFile() { return end_of_file_; }
 
@@ -207,6 +207,76 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   return true;
 }
 
+bool RecordFileWriter::WriteRawSection(SectionType type,
+                                       const std::string& data) {
+  Section section;
+  /// zero out whole struct even if padded
+  memset(&section, 0, sizeof(section));
+  section = {type, static_cast<int64_t>(data.size())};
+  ssize_t count = write(fd_, &section, sizeof(section));
+  if (count != sizeof(section)) {
+    AERROR << "Write fd failed, fd: " << fd_
+           << ", expect count: " << sizeof(section)
+           << ", actual count: " << count << ", errno: " << errno;
+    return false;
+  }
+  size_t offset = 0;
+  while (offset < data.size()) {
+    count = write(fd_, data.data() + offset, data.size() - offset);
+    if (count < 0) {
+      AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    offset += count;
+  }
+  header_.set_size(CurrentPosition());
+  return true;
+}
+
+bool RecordFileWriter::WriteRawChunk(
+    const ChunkHeader& chunk_header, const std::string& chunk_body,
+    const std::unordered_map<std::string, uint64_t>& channel_message_number) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t pos = CurrentPosition();
+    if (!WriteSection<ChunkHeader>(chunk_header)) {
+      AERROR << "Write chunk header fail";
+      return false;
+    }
+    SingleIndex* single_index = index_.add_indexes();
+    single_index->set_type(SectionType::SECTION_CHUNK_HEADER);
+    single_index->set_position(pos);
+    ChunkHeaderCache* chunk_header_cache =
+        single_index->mutable_chunk_header_cache();
+    chunk_header_cache->set_begin_time(chunk_header.begin_time());
+    chunk_header_cache->set_end_time(chunk_header.end_time());
+    chunk_header_cache->set_message_number(chunk_header.message_number());
+    chunk_header_cache->set_raw_size(chunk_header.raw_size());
+
+    pos = CurrentPosition();
+    if (!WriteRawSection(SectionType::SECTION_CHUNK_BODY, chunk_body)) {
+      AERROR << "Write chunk body fail";
+      return false;
+    }
+    header_.set_chunk_number(header_.chunk_number() + 1);
+    if (header_.begin_time() == 0) {
+      header_.set_begin_time(chunk_header.begin_time());
+    }
+    header_.set_end_time(chunk_header.end_time());
+    header_.set_message_number(header_.message_number() +
+                               chunk_header.message_number());
+    single_index = index_.add_indexes();
+    single_index->set_type(SectionType::SECTION_CHUNK_BODY);
+    single_index->set_position(pos);
+    single_index->mutable_chunk_body_cache()->set_message_number(
+        chunk_header.message_number());
+  }
+  for (const auto& item : channel_message_number) {
+    channel_message_number_map_[item.first] += item.second;
+  }
+  return true;
+}
+
 bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
   chunk_active_->add(message);
   auto it = channel_message_number_map_.find(message.channel_name());
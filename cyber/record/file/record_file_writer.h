@@ -83,6 +83,11 @@ class RecordFileWriter : public RecordFileBase {
   bool WriteHeader(const proto::Header& header);
   bool WriteChannel(const proto::Channel& channel);
   bool WriteMessage(const proto::SingleMessage& message);
+  // Write an already serialized chunk body as is, bypassing the active chunk
+  // used by WriteMessage. Do not mix both on the same file.
+  bool WriteRawChunk(
+      const proto::ChunkHeader& chunk_header, const std::string& chunk_body,
+      const std::unordered_map<std::string, uint64_t>& channel_message_number);
   uint64_t GetMessageNumber(const std::string& channel_name) const;
 
  private:
@@ -90,6 +95,7 @@ class RecordFileWriter : public RecordFileBase {
                   const proto::ChunkBody& chunk_body);
   template <typename T>
   bool WriteSection(const T& message);
+  bool WriteRawSection(proto::SectionType type, const std::string& data);
   bool WriteIndex();
   void Flush();
   std::atomic_bool is_writing_;
@@ -0,0 +1,185 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/cpu_topology.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "cyber/scheduler/common/pin_thread.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+namespace {
+
+bool ReadCpuList(const std::string& path, std::vector<int>* cpus) {
+  std::string content;
+  if (!common::GetContent(path, &content)) {
+    return false;
+  }
+  content.erase(std::remove_if(content.begin(), content.end(),
+                               [](char c) { return std::isspace(c); }),
+                content.end());
+  if (!content.empty()) {
+    ParseCpuset(content, cpus);
+  }
+  return true;
+}
+
+bool ReadInt(const std::string& path, int* value) {
+  std::string content;
+  if (!common::GetContent(path, &content)) {
+    return false;
+  }
+  std::istringstream iss(content);
+  return static_cast<bool>(iss >> *value);
+}
+
+}  // namespace
+
+bool CpuTopology::Load(const std::string& sysfs_root) {
+  cpus_.clear();
+  const std::string cpu_root = sysfs_root + "/cpu";
+  std::vector<int> online;
+  if (!ReadCpuList(cpu_root + "/online", &online) || online.empty()) {
+    AERROR << "read online cpus from " << cpu_root << " failed.";
+    return false;
+  }
+  std::vector<int> isolated;
+  // missing on kernels built without isolcpus support
+  ReadCpuList(cpu_root + "/isolated", &isolated);
+  const std::set<int> isolated_set(isolated.begin(), isolated.end());
+
+  std::map<int, int> cpu_node;
+  for (const auto& node_dir : common::Glob(sysfs_root + "/node/node*")) {
+    int node = -1;
+    std::istringstream iss(node_dir.substr(node_dir.rfind("node") + 4));
+    std::vector<int> node_cpus;
+    if (!(iss >> node) || !ReadCpuList(node_dir + "/cpulist", &node_cpus)) {
+      continue;
+    }
+    for (int cpu : node_cpus) {
+      cpu_node[cpu] = node;
+    }
+  }
+
+  std::map<std::pair<int, int>, int> core_index;
+  for (int cpu : online) {
+    CpuInfo info;
+    info.cpu = cpu;
+    const std::string topology =
+        cpu_root + "/cpu" + std::to_string(cpu) + "/topology";
+    int core_id = cpu;
+    ReadInt(topology + "/core_id", &core_id);
+    ReadInt(topology + "/physical_package_id", &info.package_id);
+    if (!ReadCpuList(topology + "/thread_siblings_list", &info.siblings) ||
+        info.siblings.empty()) {
+      info.siblings = {cpu};
+    }
+    auto key = std::make_pair(info.package_id, core_id);
+    auto iter = core_index.find(key);
+    if (iter == core_index.end()) {
+      iter = core_index.emplace(key, static_cast<int>(core_index.size())).first;
+    }
+    info.core = iter->second;
+    auto node_iter = cpu_node.find(cpu);
+    info.numa_node = node_iter == cpu_node.end() ? 0 : node_iter->second;
+    info.isolated = isolated_set.count(cpu) > 0;
+    cpus_.push_back(std::move(info));
+  }
+  return true;
+}
+
+const CpuInfo* CpuTopology::GetCpu(int cpu) const {
+  for (const auto& info : cpus_) {
+    if (info.cpu == cpu) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<int> CpuTopology::NumaNodes() const {
+  std::set<int> nodes;
+  for (const auto& info : cpus_) {
+    nodes.insert(info.numa_node);
+  }
+  return std::vector<int>(nodes.begin(), nodes.end());
+}
+
+int CpuTopology::CoreNum() const {
+  std::set<int> cores;
+  for (const auto& info : cpus_) {
+    cores.insert(info.core);
+  }
+  return static_cast<int>(cores.size());
+}
+
+std::string CpuTopology::DebugString() const {
+  std::vector<int> isolated;
+  for (const auto& info : cpus_) {
+    if (info.isolated) {
+      isolated.push_back(info.cpu);
+    }
+  }
+  std::ostringstream oss;
+  oss << cpus_.size() << " cpus, " << CoreNum() << " cores, "
+      << NumaNodes().size() << " numa nodes, isolated: ["
+      << FormatCpuset(isolated) << "]";
+  for (int node : NumaNodes()) {
+    std::vector<int> node_cpus;
+    for (const auto& info : cpus_) {
+      if (info.numa_node == node) {
+        node_cpus.push_back(info.cpu);
+      }
+    }
+    oss << ", node" << node << ": [" << FormatCpuset(node_cpus) << "]";
+  }
+  return oss.str();
+}
+
+std::string FormatCpuset(std::vector<int> cpus) {
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  std::ostringstream oss;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+    if (i > 0) {
+      oss << ",";
+    }
+    oss << cpus[i];
+    if (j > i) {
+      oss << "-" << cpus[j];
+    }
+    i = j + 1;
+  }
+  return oss.str();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
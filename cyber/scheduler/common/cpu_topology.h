@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_COMMON_CPU_TOPOLOGY_H_
+#define CYBER_SCHEDULER_COMMON_CPU_TOPOLOGY_H_
+
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+struct CpuInfo {
+  int cpu = -1;
+  // physical core, unique across packages
+  int core = -1;
+  int package_id = 0;
+  int numa_node = 0;
+  bool isolated = false;
+  // smt siblings sharing the physical core, itself included
+  std::vector<int> siblings;
+};
+
+/**
+ * @class CpuTopology
+ * @brief Online cpus of the host with their physical core, package, numa
+ * node and whether they are isolated from the kernel scheduler, as reported
+ * by sysfs.
+ */
+class CpuTopology {
+ public:
+  /**
+   * @brief Read the topology from `sysfs_root`, which is expected to hold
+   * the `cpu` and `node` directories of /sys/devices/system.
+   */
+  bool Load(const std::string& sysfs_root = "/sys/devices/system");
+
+  const std::vector<CpuInfo>& cpus() const { return cpus_; }
+  const CpuInfo* GetCpu(int cpu) const;
+  std::vector<int> NumaNodes() const;
+  int CoreNum() const;
+  std::string DebugString() const;
+
+ private:
+  std::vector<CpuInfo> cpus_;
+};
+
+// "0-3,8" style list from cpu ids, the inverse of ParseCpuset
+std::string FormatCpuset(std::vector<int> cpus);
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_COMMON_CPU_TOPOLOGY_H_
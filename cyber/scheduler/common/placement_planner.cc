@@ -0,0 +1,507 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/placement_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+#include "cyber/common/log.h"
+#include "cyber/scheduler/common/pin_thread.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::proto::ComponentLoad;
+using apollo::cyber::proto::LatencyClass;
+using apollo::cyber::proto::LoadProfile;
+using apollo::cyber::proto::PlacementConf;
+using apollo::cyber::proto::SchedGroup;
+using apollo::cyber::proto::SchedulerConf;
+
+namespace {
+
+// group names of the generated conf, best effort has to be the first group
+// as the classic scheduler puts unknown routines into groups(0)
+const char kBestEffortGroup[] = "best_effort";
+const char kLatencySensitiveGroup[] = "latency_sensitive";
+const char kRealtimeGroup[] = "realtime";
+
+bool IsRealtimePolicy(const std::string& policy) {
+  return policy == "SCHED_FIFO" || policy == "SCHED_RR";
+}
+
+std::string FormatLoad(double load) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(2) << load;
+  return oss.str();
+}
+
+}  // namespace
+
+std::string PlacementReport::DebugString() const {
+  std::ostringstream oss;
+  oss << "groups:" << std::endl;
+  for (const auto& group : groups) {
+    oss << "  " << std::left << std::setw(24) << group.name << " cpuset: ["
+        << group.cpuset << "] processors: " << group.processor_num
+        << " policy: " << (group.policy.empty() ? "-" : group.policy)
+        << " load: " << FormatLoad(group.load)
+        << " utilization: " << FormatLoad(group.utilization) << std::endl;
+  }
+  oss << "expected cpu load:" << std::endl;
+  for (const auto& item : cpu_load) {
+    oss << "  cpu" << item.first << ": " << FormatLoad(item.second)
+        << std::endl;
+  }
+  for (const auto& warning : warnings) {
+    oss << "WARNING: " << warning << std::endl;
+  }
+  for (const auto& error : errors) {
+    oss << "ERROR: " << error << std::endl;
+  }
+  return oss.str();
+}
+
+PlacementPlanner::PlacementPlanner(const CpuTopology& topology,
+                                   const PlacementConf& conf)
+    : topology_(topology), conf_(conf) {}
+
+void PlacementPlanner::MergeLoadProfile(const LoadProfile& profile) {
+  for (const auto& measured : profile.components()) {
+    auto iter = std::find_if(
+        conf_.mutable_components()->begin(), conf_.mutable_components()->end(),
+        [&measured](const ComponentLoad& component) {
+          return component.name() == measured.name();
+        });
+    if (iter != conf_.mutable_components()->end()) {
+      iter->set_cpu_load(measured.cpu_load());
+    } else {
+      auto component = conf_.add_components();
+      component->set_name(measured.name());
+      component->set_cpu_load(measured.cpu_load());
+      component->set_latency_class(proto::BEST_EFFORT);
+    }
+  }
+}
+
+std::vector<PlacementPlanner::Core> PlacementPlanner::AvailableCores() const {
+  std::vector<int> reserved;
+  if (!conf_.reserved_cpuset().empty()) {
+    ParseCpuset(conf_.reserved_cpuset(), &reserved);
+  }
+  std::map<int, Core> cores;
+  for (const auto& info : topology_.cpus()) {
+    if (std::find(reserved.begin(), reserved.end(), info.cpu) !=
+        reserved.end()) {
+      continue;
+    }
+    auto iter = cores.find(info.core);
+    if (iter == cores.end()) {
+      Core core;
+      core.id = info.core;
+      core.numa_node = info.numa_node;
+      core.isolated = info.isolated;
+      iter = cores.emplace(info.core, core).first;
+    }
+    iter->second.isolated = iter->second.isolated && info.isolated;
+    iter->second.cpus.push_back(info.cpu);
+  }
+  std::vector<Core> result;
+  for (auto& item : cores) {
+    std::sort(item.second.cpus.begin(), item.second.cpus.end());
+    result.push_back(item.second);
+  }
+  return result;
+}
+
+double PlacementPlanner::ClassLoad(LatencyClass latency_class) const {
+  double load = 0.0;
+  for (const auto& component : conf_.components()) {
+    if (component.latency_class() == latency_class) {
+      load += component.cpu_load();
+    }
+  }
+  return load;
+}
+
+void PlacementPlanner::AddGroup(const std::string& name,
+                                LatencyClass latency_class,
+                                const std::vector<int>& cpus,
+                                SchedulerConf* conf) const {
+  auto group = conf->mutable_classic_conf()->add_groups();
+  group->set_name(name);
+  group->set_cpuset(FormatCpuset(cpus));
+  group->set_processor_num(static_cast<uint32_t>(cpus.size()));
+  if (latency_class == proto::REALTIME) {
+    group->set_affinity("1to1");
+    group->set_processor_policy("SCHED_FIFO");
+    group->set_processor_prio(conf_.realtime_prio());
+  } else {
+    group->set_affinity("range");
+    group->set_processor_policy("SCHED_OTHER");
+    group->set_processor_prio(0);
+  }
+  for (const auto& component : conf_.components()) {
+    if (component.latency_class() == latency_class) {
+      auto task = group->add_tasks();
+      task->set_name(component.name());
+      task->set_prio(component.prio());
+    }
+  }
+}
+
+bool PlacementPlanner::Plan(SchedulerConf* sched_conf,
+                            PlacementReport* report) const {
+  std::vector<Core> cores = AvailableCores();
+  if (cores.empty()) {
+    report->errors.push_back("no cpu left after reserved cpuset " +
+                             conf_.reserved_cpuset());
+    return false;
+  }
+  const double max_utilization =
+      std::min(std::max(conf_.max_cpu_utilization(), 0.1), 1.0);
+  auto has_class = [this](LatencyClass latency_class) {
+    return std::any_of(conf_.components().begin(), conf_.components().end(),
+                       [latency_class](const ComponentLoad& component) {
+                         return component.latency_class() == latency_class;
+                       });
+  };
+  auto cpus_needed = [max_utilization](double load) {
+    return std::max(1, static_cast<int>(std::ceil(load / max_utilization)));
+  };
+  const int realtime_cores =
+      has_class(proto::REALTIME) ? cpus_needed(ClassLoad(proto::REALTIME))
+                                 : 0;
+  const int latency_cpus =
+      has_class(proto::LATENCY_SENSITIVE)
+          ? cpus_needed(ClassLoad(proto::LATENCY_SENSITIVE))
+          : 0;
+
+  // realtime and latency sensitive groups live on the node with the most
+  // isolated cores, then the most cores
+  std::map<int, std::pair<int, int>> node_score;
+  for (const auto& core : cores) {
+    auto& score = node_score[core.numa_node];
+    score.first += core.isolated ? 1 : 0;
+    score.second += 1;
+  }
+  const int home_node =
+      std::max_element(node_score.begin(), node_score.end(),
+                       [](const std::pair<const int, std::pair<int, int>>& a,
+                          const std::pair<const int, std::pair<int, int>>& b) {
+                         return a.second < b.second;
+                       })
+          ->first;
+
+  std::vector<bool> used(cores.size(), false);
+  // pick a free core: on the home node first, then by isolation preference
+  auto pick_core = [&](bool want_isolated, bool allow_other_isolation) {
+    int best = -1;
+    int best_rank = 0;
+    for (size_t i = 0; i < cores.size(); ++i) {
+      if (used[i]) {
+        continue;
+      }
+      if (cores[i].isolated != want_isolated && !allow_other_isolation) {
+        continue;
+      }
+      const int rank = (cores[i].numa_node == home_node ? 0 : 2) +
+                       (cores[i].isolated == want_isolated ? 0 : 1);
+      if (best < 0 || rank < best_rank) {
+        best = static_cast<int>(i);
+        best_rank = rank;
+      }
+    }
+    if (best >= 0) {
+      used[best] = true;
+    }
+    return best;
+  };
+
+  std::vector<int> realtime_cpus;
+  std::set<int> realtime_nodes;
+  for (int i = 0; i < realtime_cores; ++i) {
+    int index = pick_core(true, true);
+    if (index < 0) {
+      report->errors.push_back(
+          "not enough cores for realtime components, need " +
+          std::to_string(realtime_cores) + " got " + std::to_string(i));
+      break;
+    }
+    const Core& core = cores[index];
+    realtime_nodes.insert(core.numa_node);
+    if (conf_.realtime_use_smt_siblings()) {
+      realtime_cpus.insert(realtime_cpus.end(), core.cpus.begin(),
+                           core.cpus.end());
+    } else {
+      // the siblings stay idle so that nothing shares the core
+      realtime_cpus.push_back(core.cpus.front());
+    }
+  }
+  if (realtime_nodes.size() > 1) {
+    report->warnings.push_back("realtime group spans " +
+                               std::to_string(realtime_nodes.size()) +
+                               " numa nodes");
+  }
+
+  std::vector<int> latency_sensitive_cpus;
+  std::set<int> latency_nodes;
+  while (static_cast<int>(latency_sensitive_cpus.size()) < latency_cpus) {
+    // isolated cpus do not load balance, only use them as a last resort
+    int index = pick_core(false, true);
+    if (index < 0) {
+      report->errors.push_back(
+          "not enough cpus for latency sensitive components, need " +
+          std::to_string(latency_cpus) + " got " +
+          std::to_string(latency_sensitive_cpus.size()));
+      break;
+    }
+    if (cores[index].isolated) {
+      report->warnings.push_back("latency sensitive group uses isolated cpus " +
+                                 FormatCpuset(cores[index].cpus));
+    }
+    latency_nodes.insert(cores[index].numa_node);
+    latency_sensitive_cpus.insert(latency_sensitive_cpus.end(),
+                                  cores[index].cpus.begin(),
+                                  cores[index].cpus.end());
+  }
+  if (latency_nodes.size() > 1) {
+    report->warnings.push_back("latency sensitive group spans " +
+                               std::to_string(latency_nodes.size()) +
+                               " numa nodes");
+  }
+
+  std::vector<int> best_effort_cpus;
+  std::vector<int> idle_isolated_cpus;
+  for (size_t i = 0; i < cores.size(); ++i) {
+    if (used[i]) {
+      continue;
+    }
+    auto& target = cores[i].isolated ? idle_isolated_cpus : best_effort_cpus;
+    target.insert(target.end(), cores[i].cpus.begin(), cores[i].cpus.end());
+  }
+  if (!idle_isolated_cpus.empty()) {
+    report->warnings.push_back("isolated cpus " +
+                               FormatCpuset(idle_isolated_cpus) +
+                               " are left unused");
+  }
+  if (best_effort_cpus.empty()) {
+    best_effort_cpus = latency_sensitive_cpus.empty() ? realtime_cpus
+                                                      : latency_sensitive_cpus;
+    report->warnings.push_back(
+        "no cpu left for best effort components, they share cpus " +
+        FormatCpuset(best_effort_cpus));
+  }
+
+  sched_conf->Clear();
+  sched_conf->set_policy("classic");
+  sched_conf->set_process_level_cpuset(FormatCpuset(best_effort_cpus));
+  AddGroup(kBestEffortGroup, proto::BEST_EFFORT, best_effort_cpus,
+           sched_conf);
+  if (!latency_sensitive_cpus.empty()) {
+    AddGroup(kLatencySensitiveGroup, proto::LATENCY_SENSITIVE,
+             latency_sensitive_cpus, sched_conf);
+  }
+  if (!realtime_cpus.empty()) {
+    AddGroup(kRealtimeGroup, proto::REALTIME, realtime_cpus, sched_conf);
+  }
+
+  const bool planned = report->ok();
+  return Validate(*sched_conf, report) && planned;
+}
+
+bool PlacementPlanner::Validate(const SchedulerConf& sched_conf,
+                                PlacementReport* report) const {
+  const auto& groups = sched_conf.classic_conf().groups();
+  if (groups.empty()) {
+    report->errors.push_back("no classic scheduler group configured");
+    return false;
+  }
+  const double max_utilization = conf_.max_cpu_utilization();
+
+  std::unordered_map<std::string, const ComponentLoad*> components;
+  for (const auto& component : conf_.components()) {
+    components[component.name()] = &component;
+  }
+  std::vector<int> reserved;
+  if (!conf_.reserved_cpuset().empty()) {
+    ParseCpuset(conf_.reserved_cpuset(), &reserved);
+  }
+  std::vector<int> all_cpus;
+  for (const auto& info : topology_.cpus()) {
+    all_cpus.push_back(info.cpu);
+  }
+
+  // cpus every group may run on, unpinned groups run everywhere
+  std::vector<std::vector<int>> group_cpus;
+  std::map<int, std::vector<int>> cpu_groups;
+  for (int i = 0; i < groups.size(); ++i) {
+    std::vector<int> cpus;
+    if (!groups[i].cpuset().empty()) {
+      ParseCpuset(groups[i].cpuset(), &cpus);
+    }
+    if (cpus.empty() || groups[i].affinity().empty()) {
+      cpus = all_cpus;
+    }
+    for (int cpu : cpus) {
+      cpu_groups[cpu].push_back(i);
+    }
+    group_cpus.push_back(cpus);
+  }
+
+  std::set<std::string> assigned;
+  for (const auto& group : groups) {
+    for (const auto& task : group.tasks()) {
+      assigned.insert(task.name());
+    }
+  }
+
+  for (int i = 0; i < groups.size(); ++i) {
+    const SchedGroup& group = groups[i];
+    const std::vector<int>& cpus = group_cpus[i];
+    const bool realtime = IsRealtimePolicy(group.processor_policy());
+    const std::string name = "group " + group.name();
+
+    PlacementReport::GroupLoad group_load;
+    group_load.name = group.name();
+    group_load.cpuset = FormatCpuset(cpus);
+    group_load.policy = group.processor_policy();
+    group_load.processor_num = group.processor_num();
+
+    if (group.processor_num() == 0) {
+      report->errors.push_back(name + " has no processor");
+    }
+    std::set<int> nodes;
+    int isolated_num = 0;
+    for (int cpu : cpus) {
+      const CpuInfo* info = topology_.GetCpu(cpu);
+      if (info == nullptr) {
+        report->errors.push_back(name + " uses cpu " + std::to_string(cpu) +
+                                 " which is not online");
+        continue;
+      }
+      nodes.insert(info->numa_node);
+      isolated_num += info->isolated ? 1 : 0;
+      if (std::find(reserved.begin(), reserved.end(), cpu) != reserved.end()) {
+        report->warnings.push_back(name + " uses reserved cpu " +
+                                   std::to_string(cpu));
+      }
+      if (!realtime) {
+        continue;
+      }
+      for (int other : cpu_groups[cpu]) {
+        if (other != i) {
+          report->warnings.push_back(name + " shares cpu " +
+                                     std::to_string(cpu) + " with group " +
+                                     groups[other].name());
+        }
+      }
+      for (int sibling : info->siblings) {
+        if (sibling == cpu) {
+          continue;
+        }
+        for (int other : cpu_groups[sibling]) {
+          if (other != i) {
+            report->warnings.push_back(
+                name + " cpu " + std::to_string(cpu) +
+                " shares its core with cpu " + std::to_string(sibling) +
+                " of group " + groups[other].name());
+          }
+        }
+      }
+    }
+    if (nodes.size() > 1 && cpus != all_cpus) {
+      report->warnings.push_back(name + " spans " +
+                                 std::to_string(nodes.size()) +
+                                 " numa nodes");
+    }
+    if (group.affinity() == "range" && isolated_num > 1) {
+      report->warnings.push_back(
+          name + " uses range affinity over " + std::to_string(isolated_num) +
+          " isolated cpus, the kernel does not balance load between them");
+    }
+    if (group.affinity() == "1to1" && group.processor_num() > cpus.size()) {
+      report->warnings.push_back(name + " has more processors than cpus, " +
+                                 "the extra processors are not pinned");
+    }
+
+    for (const auto& task : group.tasks()) {
+      auto iter = components.find(task.name());
+      if (iter == components.end()) {
+        continue;
+      }
+      group_load.load += iter->second->cpu_load();
+      if (iter->second->latency_class() == proto::REALTIME && !realtime) {
+        report->warnings.push_back("realtime component " + task.name() +
+                                   " runs in non realtime " + name);
+      }
+    }
+    if (i == 0) {
+      // routines missing from the conf end up in the first group
+      for (const auto& component : conf_.components()) {
+        if (assigned.count(component.name()) == 0) {
+          report->warnings.push_back("component " + component.name() +
+                                     " is not in any group, it runs in " +
+                                     name);
+          group_load.load += component.cpu_load();
+        }
+      }
+    }
+
+    const size_t runnable =
+        group.affinity() == "1to1"
+            ? std::min<size_t>(group.processor_num(), cpus.size())
+            : std::min<size_t>(std::max<uint32_t>(group.processor_num(), 1),
+                               cpus.size());
+    group_load.utilization =
+        runnable == 0 ? 0.0 : group_load.load / static_cast<double>(runnable);
+    if (group_load.utilization > 1.0) {
+      report->errors.push_back(name + " is overloaded, load " +
+                               FormatLoad(group_load.load) + " on " +
+                               std::to_string(runnable) + " cpus");
+    } else if (group_load.utilization > max_utilization) {
+      report->warnings.push_back(
+          name + " utilization " + FormatLoad(group_load.utilization) +
+          " exceeds " + FormatLoad(max_utilization));
+    }
+    const size_t spread =
+        group.affinity() == "1to1" ? runnable : cpus.size();
+    for (size_t j = 0; j < spread; ++j) {
+      report->cpu_load[cpus[j]] +=
+          group_load.load / static_cast<double>(spread);
+    }
+    report->groups.push_back(group_load);
+  }
+
+  for (const auto& item : report->cpu_load) {
+    if (item.second > 1.0) {
+      report->warnings.push_back("cpu " + std::to_string(item.first) +
+                                 " is expected to be contended, load " +
+                                 FormatLoad(item.second));
+    }
+  }
+  return report->ok();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_COMMON_PLACEMENT_PLANNER_H_
+#define CYBER_SCHEDULER_COMMON_PLACEMENT_PLANNER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cyber/proto/placement_conf.pb.h"
+#include "cyber/proto/scheduler_conf.pb.h"
+
+#include "cyber/scheduler/common/cpu_topology.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+struct PlacementReport {
+  struct GroupLoad {
+    std::string name;
+    std::string cpuset;
+    std::string policy;
+    uint32_t processor_num = 0;
+    // sum of the cpu load of the group tasks
+    double load = 0.0;
+    // load over the cpus the group can actually run on
+    double utilization = 0.0;
+  };
+
+  std::vector<std::string> errors;
+  std::vector<std::string> warnings;
+  std::vector<GroupLoad> groups;
+  // expected load of every cpu when group load spreads evenly
+  std::map<int, double> cpu_load;
+
+  bool ok() const { return errors.empty(); }
+  std::string DebugString() const;
+};
+
+/**
+ * @class PlacementPlanner
+ * @brief Generates and checks classic scheduler groups from the host cpu
+ * topology and the latency class and measured load of every component.
+ *
+ * Realtime components get dedicated physical cores on a single numa node,
+ * isolated ones first, with SCHED_FIFO and 1to1 affinity. Latency sensitive
+ * components share whole cores on the same node. Best effort components and
+ * every thread not owned by a group get the remaining cpus.
+ */
+class PlacementPlanner {
+ public:
+  PlacementPlanner(const CpuTopology& topology,
+                   const proto::PlacementConf& conf);
+
+  /**
+   * @brief Take the measured load of the components from a sysmo profile,
+   * components unknown to the placement conf are added as best effort.
+   */
+  void MergeLoadProfile(const proto::LoadProfile& profile);
+
+  bool Plan(proto::SchedulerConf* sched_conf, PlacementReport* report) const;
+
+  /**
+   * @brief Check a classic scheduler conf against the topology and report
+   * the expected contention. Returns false if the conf cannot work as is.
+   */
+  bool Validate(const proto::SchedulerConf& sched_conf,
+                PlacementReport* report) const;
+
+  const proto::PlacementConf& conf() const { return conf_; }
+
+ private:
+  struct Core {
+    int id = -1;
+    int numa_node = 0;
+    bool isolated = false;
+    std::vector<int> cpus;
+  };
+
+  std::vector<Core> AvailableCores() const;
+  double ClassLoad(proto::LatencyClass latency_class) const;
+  void AddGroup(const std::string& name, proto::LatencyClass latency_class,
+                const std::vector<int>& cpus, proto::SchedulerConf* conf) const;
+
+  CpuTopology topology_;
+  proto::PlacementConf conf_;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_COMMON_PLACEMENT_PLANNER_H_
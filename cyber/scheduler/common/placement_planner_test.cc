@@ -0,0 +1,187 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/placement_planner.h"
+
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/file.h"
+#include "cyber/scheduler/common/cpu_topology.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+namespace {
+
+void WriteFile(const std::string& path, const std::string& content) {
+  common::EnsureDirectory(path.substr(0, path.rfind('/')));
+  std::ofstream ofs(path);
+  ofs << content << "\n";
+}
+
+// two numa nodes with two smt cores each, cpus 2-3 isolated
+std::string CreateSysfs() {
+  char dir[] = "/tmp/placement_planner_test_XXXXXX";
+  std::string root = mkdtemp(dir);
+  WriteFile(root + "/cpu/online", "0-7");
+  WriteFile(root + "/cpu/isolated", "2-3");
+  for (int cpu = 0; cpu < 8; ++cpu) {
+    const std::string topology =
+        root + "/cpu/cpu" + std::to_string(cpu) + "/topology";
+    const int first = cpu / 2 * 2;
+    WriteFile(topology + "/core_id", std::to_string(cpu % 4 / 2));
+    WriteFile(topology + "/physical_package_id", std::to_string(cpu / 4));
+    WriteFile(topology + "/thread_siblings_list",
+              std::to_string(first) + "-" + std::to_string(first + 1));
+  }
+  WriteFile(root + "/node/node0/cpulist", "0-3");
+  WriteFile(root + "/node/node1/cpulist", "4-7");
+  return root;
+}
+
+proto::PlacementConf MakePlacementConf() {
+  proto::PlacementConf conf;
+  auto add = [&conf](const std::string& name, double load,
+                     proto::LatencyClass latency_class) {
+    auto component = conf.add_components();
+    component->set_name(name);
+    component->set_cpu_load(load);
+    component->set_latency_class(latency_class);
+  };
+  add("control", 0.3, proto::REALTIME);
+  add("lidar_compensator", 0.2, proto::REALTIME);
+  add("perception", 1.0, proto::LATENCY_SENSITIVE);
+  add("dreamview", 0.5, proto::BEST_EFFORT);
+  return conf;
+}
+
+}  // namespace
+
+class PlacementPlannerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sysfs_root_ = CreateSysfs();
+    ASSERT_TRUE(topology_.Load(sysfs_root_));
+  }
+
+  void TearDown() override { common::RemoveAllFiles(sysfs_root_); }
+
+  std::string sysfs_root_;
+  CpuTopology topology_;
+};
+
+TEST(CpuTopologyTest, FormatCpuset) {
+  EXPECT_EQ(FormatCpuset({8, 0, 1, 2, 5, 7}), "0-2,5,7-8");
+  EXPECT_EQ(FormatCpuset({3}), "3");
+  EXPECT_EQ(FormatCpuset({}), "");
+}
+
+TEST_F(PlacementPlannerTest, Topology) {
+  ASSERT_EQ(topology_.cpus().size(), 8);
+  EXPECT_EQ(topology_.CoreNum(), 4);
+  EXPECT_EQ(topology_.NumaNodes().size(), 2);
+  const CpuInfo* cpu = topology_.GetCpu(5);
+  ASSERT_NE(cpu, nullptr);
+  EXPECT_EQ(cpu->numa_node, 1);
+  EXPECT_EQ(cpu->siblings.size(), 2);
+  EXPECT_FALSE(cpu->isolated);
+  EXPECT_TRUE(topology_.GetCpu(3)->isolated);
+  EXPECT_EQ(topology_.GetCpu(2)->core, topology_.GetCpu(3)->core);
+  EXPECT_NE(topology_.GetCpu(1)->core, topology_.GetCpu(5)->core);
+}
+
+TEST_F(PlacementPlannerTest, Plan) {
+  PlacementPlanner planner(topology_, MakePlacementConf());
+  proto::LoadProfile profile;
+  auto measured = profile.add_components();
+  measured->set_name("perception");
+  measured->set_cpu_load(1.2);
+  planner.MergeLoadProfile(profile);
+
+  proto::SchedulerConf conf;
+  PlacementReport report;
+  ASSERT_TRUE(planner.Plan(&conf, &report)) << report.DebugString();
+  const auto& groups = conf.classic_conf().groups();
+  ASSERT_EQ(groups.size(), 3);
+
+  EXPECT_EQ(groups[0].name(), "best_effort");
+  EXPECT_EQ(groups[0].cpuset(), "4-7");
+  EXPECT_EQ(conf.process_level_cpuset(), "4-7");
+
+  // 1.2 cpus of load at 0.7 utilization take two cpus, a full core of the
+  // home node
+  EXPECT_EQ(groups[1].name(), "latency_sensitive");
+  EXPECT_EQ(groups[1].cpuset(), "0-1");
+  EXPECT_EQ(groups[1].affinity(), "range");
+
+  // a single isolated cpu, its sibling stays idle
+  EXPECT_EQ(groups[2].name(), "realtime");
+  EXPECT_EQ(groups[2].cpuset(), "2");
+  EXPECT_EQ(groups[2].processor_num(), 1);
+  EXPECT_EQ(groups[2].affinity(), "1to1");
+  EXPECT_EQ(groups[2].processor_policy(), "SCHED_FIFO");
+  EXPECT_EQ(groups[2].tasks_size(), 2);
+
+  EXPECT_TRUE(report.warnings.empty()) << report.DebugString();
+  EXPECT_EQ(report.cpu_load.count(3), 0);
+  EXPECT_NEAR(report.cpu_load[2], 0.5, 1e-6);
+}
+
+TEST_F(PlacementPlannerTest, Validate) {
+  PlacementPlanner planner(topology_, MakePlacementConf());
+  proto::SchedulerConf conf;
+  auto rt = conf.mutable_classic_conf()->add_groups();
+  rt->set_name("rt");
+  rt->set_cpuset("0,9");
+  rt->set_affinity("1to1");
+  rt->set_processor_num(1);
+  rt->set_processor_policy("SCHED_FIFO");
+  rt->add_tasks()->set_name("perception");
+  auto other = conf.mutable_classic_conf()->add_groups();
+  other->set_name("other");
+  other->set_cpuset("0-1");
+  other->set_affinity("range");
+  other->set_processor_num(2);
+  other->set_processor_policy("SCHED_OTHER");
+  other->add_tasks()->set_name("dreamview");
+  other->add_tasks()->set_name("control");
+
+  PlacementReport report;
+  EXPECT_FALSE(planner.Validate(conf, &report));
+  auto contains = [](const std::vector<std::string>& messages,
+                     const std::string& text) {
+    for (const auto& message : messages) {
+      if (message.find(text) != std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  };
+  EXPECT_TRUE(contains(report.errors, "cpu 9 which is not online"));
+  EXPECT_TRUE(contains(report.warnings, "group rt shares cpu 0"));
+  EXPECT_TRUE(contains(report.warnings, "shares its core with cpu 1"));
+  EXPECT_TRUE(contains(report.warnings, "realtime component control"));
+  EXPECT_TRUE(contains(report.warnings, "lidar_compensator is not in any"));
+  EXPECT_TRUE(contains(report.warnings, "cpu 0 is expected to be contended"));
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
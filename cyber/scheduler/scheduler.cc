@@ -122,6 +122,15 @@ void Scheduler::CheckSchedStatus() {
   snap_info.clear();
 }
 
+void Scheduler::GetRunningRoutines(std::vector<std::string>* routines) {
+  for (auto processor : processors_) {
+    auto snap = processor->ProcSnapshot();
+    if (snap->execute_start_time.load()) {
+      routines->emplace_back(snap->routine_name);
+    }
+  }
+}
+
 void Scheduler::Shutdown() {
   if (cyber_unlikely(stop_.exchange(true))) {
     return;
@@ -78,6 +78,8 @@ class Scheduler {
   virtual bool RemoveCRoutine(uint64_t crid) = 0;
 
   void CheckSchedStatus();
+  // names of the routines executing on the processors right now
+  void GetRunningRoutines(std::vector<std::string>* routines);
 
   void SetInnerThreadConfs(
       const std::unordered_map<std::string, InnerThread>& confs) {
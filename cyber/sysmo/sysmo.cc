@@ -16,12 +16,19 @@
 
 #include "cyber/sysmo/sysmo.h"
 
+#include <vector>
+
+#include "cyber/proto/placement_conf.pb.h"
+
 #include "cyber/common/environment.h"
+#include "cyber/common/file.h"
+#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
 
 using apollo::cyber::common::GetEnv;
+using apollo::cyber::proto::LoadProfile;
 
 SysMo::SysMo() { Start(); }
 
@@ -29,6 +36,7 @@ void SysMo::Start() {
   auto sysmo_start = GetEnv("sysmo_start");
   if (sysmo_start != "" && std::stoi(sysmo_start)) {
     start_ = true;
+    load_profile_file_ = GetEnv("sysmo_load_profile");
     sysmo_ = std::thread(&SysMo::Checker, this);
   }
 }
@@ -42,15 +50,53 @@ void SysMo::Shutdown() {
   if (sysmo_.joinable()) {
     sysmo_.join();
   }
+  DumpLoadProfile();
 }
 
 void SysMo::Checker() {
   while (cyber_unlikely(!shut_down_.load())) {
     scheduler::Instance()->CheckSchedStatus();
+    if (!load_profile_file_.empty()) {
+      SampleRoutineLoad();
+    }
     std::unique_lock<std::mutex> lk(lk_);
     cv_.wait_for(lk, std::chrono::milliseconds(sysmo_interval_ms_));
   }
 }
 
+void SysMo::SampleRoutineLoad() {
+  std::vector<std::string> routines;
+  scheduler::Instance()->GetRunningRoutines(&routines);
+  for (const auto& routine : routines) {
+    ++routine_samples_[routine];
+  }
+  last_sample_ns_ = Time::Now().ToNanosecond();
+  if (sample_num_++ == 0) {
+    first_sample_ns_ = last_sample_ns_;
+  }
+}
+
+void SysMo::DumpLoadProfile() {
+  if (load_profile_file_.empty() || sample_num_ == 0) {
+    return;
+  }
+  // the share of samples a routine was running in is the average number of
+  // cpus it keeps busy
+  LoadProfile profile;
+  profile.set_duration_ns(last_sample_ns_ - first_sample_ns_);
+  for (const auto& item : routine_samples_) {
+    auto component = profile.add_components();
+    component->set_name(item.first);
+    component->set_cpu_load(static_cast<double>(item.second) /
+                            static_cast<double>(sample_num_));
+  }
+  if (!common::SetProtoToASCIIFile(profile, load_profile_file_)) {
+    AERROR << "write load profile to " << load_profile_file_ << " failed.";
+    return;
+  }
+  AINFO << "load profile of " << sample_num_ << " samples is written to "
+        << load_profile_file_;
+}
+
 }  // namespace cyber
 }  // namespace apollo
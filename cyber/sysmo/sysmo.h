@@ -23,6 +23,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
 #include "cyber/scheduler/scheduler_factory.h"
 
@@ -38,6 +39,8 @@ class SysMo {
 
  private:
   void Checker();
+  void SampleRoutineLoad();
+  void DumpLoadProfile();
 
   std::atomic<bool> shut_down_{false};
   bool start_ = false;
@@ -47,6 +50,14 @@ class SysMo {
   std::mutex lk_;
   std::thread sysmo_;
 
+  // busy samples of every routine for the placement planner, dumped to
+  // $sysmo_load_profile on shutdown
+  std::string load_profile_file_;
+  uint64_t sample_num_ = 0;
+  uint64_t first_sample_ns_ = 0;
+  uint64_t last_sample_ns_ = 0;
+  std::unordered_map<std::string, uint64_t> routine_samples_;
+
   DECLARE_SINGLETON(SysMo);
 };
 
@@ -0,0 +1,353 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/tools/cyber_recorder/chunk_processor.h"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+
+#include "cyber/base/thread_pool.h"
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::Channel;
+using apollo::cyber::proto::ChunkHeader;
+using apollo::cyber::proto::SectionType;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace {
+
+// field numbers of proto::ChunkBody and proto::SingleMessage
+constexpr int kChunkBodyMessagesField = 1;
+constexpr int kMessageChannelNameField = 1;
+constexpr int kMessageTimeField = 2;
+constexpr int kMessageContentField = 3;
+
+bool ScanMessage(const uint8_t* data, int size, std::string* channel_name,
+                 uint64_t* time, uint64_t* content_size) {
+  CodedInputStream input(data, size);
+  while (true) {
+    uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      return input.CurrentPosition() == size;
+    }
+    int field = WireFormatLite::GetTagFieldNumber(tag);
+    auto wire_type = WireFormatLite::GetTagWireType(tag);
+    if (field == kMessageChannelNameField &&
+        wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!WireFormatLite::ReadString(&input, channel_name)) {
+        return false;
+      }
+    } else if (field == kMessageTimeField &&
+               wire_type == WireFormatLite::WIRETYPE_VARINT) {
+      if (!input.ReadVarint64(time)) {
+        return false;
+      }
+    } else if (field == kMessageContentField &&
+               wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32_t length = 0;
+      if (!input.ReadVarint32(&length) || !input.Skip(length)) {
+        return false;
+      }
+      *content_size = length;
+    } else if (!WireFormatLite::SkipField(&input, tag)) {
+      return false;
+    }
+  }
+}
+
+}  // namespace
+
+ChunkProcessor::ChunkProcessor(uint32_t thread_num,
+                               const ChannelFilter& channel_filter,
+                               uint64_t begin_time, uint64_t end_time)
+    : thread_num_(std::max(thread_num, 1U)),
+      channel_filter_(channel_filter),
+      begin_time_(begin_time),
+      end_time_(end_time) {}
+
+bool ChunkProcessor::IsSelected(const std::string& channel_name,
+                                uint64_t time) const {
+  if (time < begin_time_ || time > end_time_) {
+    return false;
+  }
+  return channel_filter_ == nullptr || channel_filter_(channel_name);
+}
+
+bool ChunkProcessor::WriteChannel(const Channel& channel,
+                                  RecordFileWriter* writer) {
+  if (written_channels_.count(channel.name()) > 0) {
+    return true;
+  }
+  if (channel_filter_ != nullptr && !channel_filter_(channel.name())) {
+    return true;
+  }
+  written_channels_.insert(channel.name());
+  return writer->WriteChannel(channel);
+}
+
+bool ChunkProcessor::FilterChunk(const RawChunk& chunk,
+                                 FilteredChunk* filtered) const {
+  const uint8_t* buf = reinterpret_cast<const uint8_t*>(chunk.body.data());
+  const int size = static_cast<int>(chunk.body.size());
+  CodedInputStream input(buf, size);
+  // serialized [begin, end) ranges of the kept messages, tag included
+  std::vector<std::pair<int, int>> kept_ranges;
+  bool all_kept = true;
+  ChunkHeader& header = filtered->header;
+  header.set_begin_time(0);
+  header.set_end_time(0);
+  header.set_message_number(0);
+  header.set_raw_size(0);
+
+  while (true) {
+    int begin = input.CurrentPosition();
+    uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      filtered->broken = input.CurrentPosition() != size;
+      break;
+    }
+    if (WireFormatLite::GetTagFieldNumber(tag) != kChunkBodyMessagesField ||
+        WireFormatLite::GetTagWireType(tag) !=
+            WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      all_kept = false;
+      if (!WireFormatLite::SkipField(&input, tag)) {
+        filtered->broken = true;
+        break;
+      }
+      continue;
+    }
+    uint32_t length = 0;
+    if (!input.ReadVarint32(&length) ||
+        static_cast<int64_t>(length) > size - input.CurrentPosition()) {
+      filtered->broken = true;
+      break;
+    }
+    int offset = input.CurrentPosition();
+    std::string channel_name;
+    uint64_t time = 0;
+    uint64_t content_size = 0;
+    if (!ScanMessage(buf + offset, static_cast<int>(length), &channel_name,
+                     &time, &content_size)) {
+      filtered->broken = true;
+      break;
+    }
+    input.Skip(static_cast<int>(length));
+    if (!IsSelected(channel_name, time)) {
+      all_kept = false;
+      continue;
+    }
+    kept_ranges.emplace_back(begin, input.CurrentPosition());
+    ++filtered->channel_message_number[channel_name];
+    if (header.begin_time() == 0 || header.begin_time() > time) {
+      header.set_begin_time(time);
+    }
+    if (header.end_time() < time) {
+      header.set_end_time(time);
+    }
+    header.set_message_number(header.message_number() + 1);
+    header.set_raw_size(header.raw_size() + content_size);
+  }
+
+  if (all_kept && !filtered->broken && chunk.header_valid) {
+    filtered->verbatim = true;
+    filtered->header = chunk.header;
+    filtered->body = chunk.body;
+    return true;
+  }
+  size_t body_size = 0;
+  for (const auto& range : kept_ranges) {
+    body_size += range.second - range.first;
+  }
+  filtered->body.reserve(body_size);
+  for (const auto& range : kept_ranges) {
+    filtered->body.append(chunk.body, range.first, range.second - range.first);
+  }
+  return !filtered->broken;
+}
+
+bool ChunkProcessor::WriteChunk(const FilteredChunk& chunk,
+                                RecordFileWriter* writer, bool skip_broken) {
+  ++total_chunks_;
+  if (chunk.broken) {
+    if (!skip_broken) {
+      AERROR << "chunk body is broken.";
+      return false;
+    }
+    // as the serial recoverer, a chunk body that does not parse is dropped
+    AINFO << "one chunk body section broken, skip it.";
+    return true;
+  }
+  if (chunk.header.message_number() == 0) {
+    return true;
+  }
+  if (chunk.verbatim) {
+    ++verbatim_chunks_;
+  }
+  if (!writer->WriteRawChunk(chunk.header, chunk.body,
+                             chunk.channel_message_number)) {
+    AERROR << "write chunk failed.";
+    return false;
+  }
+  return true;
+}
+
+bool ChunkProcessor::Proc(RecordFileReader* reader, RecordFileWriter* writer,
+                          bool skip_broken) {
+  struct Pending {
+    bool is_channel = false;
+    Channel channel;
+    std::future<FilteredChunk> chunk;
+  };
+  std::deque<Pending> pending;
+  const size_t max_pending = 2 * thread_num_;
+  base::ThreadPool pool(thread_num_);
+
+  // sections are written in input order, the oldest chunk is waited for
+  // once enough chunks are in flight
+  auto write_front = [&]() {
+    Pending& front = pending.front();
+    bool ret = front.is_channel ? WriteChannel(front.channel, writer)
+                                : WriteChunk(front.chunk.get(), writer,
+                                             skip_broken);
+    pending.pop_front();
+    return ret;
+  };
+  // after a failed write nothing is written any more, the tasks still in
+  // the pool are only joined
+  auto drop_front = [&]() {
+    if (!pending.front().is_channel) {
+      pending.front().chunk.wait();
+    }
+    pending.pop_front();
+  };
+
+  RawChunk chunk;
+  bool skip_next_chunk_body = false;
+  bool ret = true;
+  bool write_ok = true;
+  reader->Reset();
+  while (ret && write_ok && !reader->EndOfFile()) {
+    Section section;
+    const int64_t position = reader->CurrentPosition();
+    if (!reader->ReadSection(&section)) {
+      if (reader->EndOfFile() || !skip_broken) {
+        ret = reader->EndOfFile();
+        break;
+      }
+      // a failed read that did not consume anything fails again forever
+      if (reader->CurrentPosition() == position) {
+        AERROR << "read section failed at position " << position
+               << " without progress, stop.";
+        ret = false;
+        break;
+      }
+      AINFO << "read section failed, try next.";
+      continue;
+    }
+    if (section.type == SectionType::SECTION_INDEX) {
+      break;
+    }
+    switch (section.type) {
+      case SectionType::SECTION_CHANNEL: {
+        Pending item;
+        item.is_channel = true;
+        if (!reader->ReadSection<Channel>(section.size, &item.channel)) {
+          AERROR << "read channel section fail.";
+          ret = skip_broken;
+          break;
+        }
+        pending.push_back(std::move(item));
+        break;
+      }
+      case SectionType::SECTION_CHUNK_HEADER: {
+        chunk.header_valid =
+            reader->ReadSection<ChunkHeader>(section.size, &chunk.header);
+        if (!chunk.header_valid) {
+          AERROR << "read chunk header section fail.";
+          ret = skip_broken;
+          break;
+        }
+        if (begin_time_ > chunk.header.end_time() ||
+            end_time_ < chunk.header.begin_time()) {
+          skip_next_chunk_body = true;
+        }
+        break;
+      }
+      case SectionType::SECTION_CHUNK_BODY: {
+        if (skip_next_chunk_body) {
+          reader->SkipSection(section.size);
+          skip_next_chunk_body = false;
+          break;
+        }
+        if (!reader->ReadRawSection(section.size, &chunk.body)) {
+          AERROR << "read chunk body section fail.";
+          ret = skip_broken;
+          break;
+        }
+        Pending item;
+        item.chunk = pool.Enqueue([this, chunk = std::move(chunk)]() {
+          FilteredChunk filtered;
+          FilterChunk(chunk, &filtered);
+          return filtered;
+        });
+        pending.push_back(std::move(item));
+        chunk = RawChunk();
+        break;
+      }
+      default: {
+        AERROR << "this section should not be here, section type: "
+               << section.type;
+        // the serial recoverer gives up here, split skips the section
+        if (skip_broken) {
+          ret = false;
+          break;
+        }
+        reader->SkipSection(section.size);
+        break;
+      }
+    }  // end for switch
+    while (write_ok && pending.size() > max_pending) {
+      write_ok = write_front();
+    }
+  }  // end for while
+  // the sections read before a read failure are still written, as the
+  // serial tools write them before giving up
+  while (!pending.empty()) {
+    if (write_ok) {
+      write_ok = write_front();
+    } else {
+      drop_front();
+    }
+  }
+  AINFO << "rewrote " << total_chunks_ << " chunks, " << verbatim_chunks_
+        << " of them copied verbatim.";
+  return ret && write_ok;
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
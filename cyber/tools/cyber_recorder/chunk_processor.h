@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TOOLS_CYBER_RECORDER_CHUNK_PROCESSOR_H_
+#define CYBER_TOOLS_CYBER_RECORDER_CHUNK_PROCESSOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cyber/proto/record.pb.h"
+#include "cyber/record/file/record_file_reader.h"
+#include "cyber/record/file/record_file_writer.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @brief A chunk read from the input file, the body is kept serialized.
+ */
+struct RawChunk {
+  proto::ChunkHeader header;
+  bool header_valid = false;
+  std::string body;
+};
+
+/**
+ * @brief The filtered chunk, ready to be appended to the output file.
+ */
+struct FilteredChunk {
+  proto::ChunkHeader header;
+  std::string body;
+  std::unordered_map<std::string, uint64_t> channel_message_number;
+  bool broken = false;
+  bool verbatim = false;
+};
+
+/**
+ * @class ChunkProcessor
+ * @brief Rewrite a record file chunk by chunk with a thread pool.
+ *
+ * Chunk bodies are scanned at the wire format level: only the channel name
+ * and time of each SingleMessage are decoded, kept messages are copied as
+ * serialized bytes and a chunk whose messages are all kept is copied
+ * verbatim. Chunks are written in input order.
+ */
+class ChunkProcessor {
+ public:
+  using ChannelFilter = std::function<bool(const std::string&)>;
+
+  ChunkProcessor(uint32_t thread_num, const ChannelFilter& channel_filter,
+                 uint64_t begin_time = 0,
+                 uint64_t end_time = std::numeric_limits<uint64_t>::max());
+  virtual ~ChunkProcessor() = default;
+
+  /**
+   * @brief Process all sections after the header of `reader`.
+   * @param skip_broken skip broken sections and drop broken chunks instead
+   * of failing, the same as the serial Recoverer::Proc
+   */
+  bool Proc(RecordFileReader* reader, RecordFileWriter* writer,
+            bool skip_broken);
+
+  /**
+   * @brief Write the channel unless a channel with the same name is already
+   * written or it is filtered out.
+   */
+  bool WriteChannel(const proto::Channel& channel, RecordFileWriter* writer);
+
+  /**
+   * @brief Filter one chunk, thread safe.
+   */
+  bool FilterChunk(const RawChunk& chunk, FilteredChunk* filtered) const;
+
+  uint64_t total_chunks() const { return total_chunks_; }
+  uint64_t verbatim_chunks() const { return verbatim_chunks_; }
+
+ private:
+  bool IsSelected(const std::string& channel_name, uint64_t time) const;
+  bool WriteChunk(const FilteredChunk& chunk, RecordFileWriter* writer,
+                  bool skip_broken);
+
+  uint32_t thread_num_;
+  ChannelFilter channel_filter_;
+  uint64_t begin_time_;
+  uint64_t end_time_;
+  std::unordered_set<std::string> written_channels_;
+  uint64_t total_chunks_ = 0;
+  uint64_t verbatim_chunks_ = 0;
+};
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TOOLS_CYBER_RECORDER_CHUNK_PROCESSOR_H_
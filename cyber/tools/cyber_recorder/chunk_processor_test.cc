@@ -0,0 +1,285 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/tools/cyber_recorder/chunk_processor.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/record/header_builder.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::Channel;
+using apollo::cyber::proto::ChunkBody;
+using apollo::cyber::proto::SectionType;
+using apollo::cyber::proto::SingleMessage;
+
+namespace {
+
+constexpr char kChan1[] = "/test1";
+constexpr char kChan2[] = "/test2";
+constexpr char kMsgType[] = "apollo.cyber.proto.Test";
+constexpr char kInputFile[] = "chunk_processor_test_input.record";
+constexpr char kOutputFile[] = "chunk_processor_test_output.record";
+
+using Messages = std::vector<std::pair<std::string, uint64_t>>;
+
+// three chunks of messages on both channels, one second apart
+const std::vector<Messages> kChunks = {
+    {{kChan1, 1000000000ULL}, {kChan2, 2000000000ULL}},
+    {{kChan1, 3000000000ULL}, {kChan2, 4000000000ULL}},
+    {{kChan1, 5000000000ULL}}};
+
+// a writer that can put a header section between the chunks
+class StrayHeaderWriter : public RecordFileWriter {
+ public:
+  bool WriteStrayHeader() {
+    std::string data;
+    if (!HeaderBuilder::GetHeader().SerializeToString(&data)) {
+      return false;
+    }
+    Section section;
+    memset(&section, 0, sizeof(section));
+    section = {SectionType::SECTION_HEADER, static_cast<int64_t>(data.size())};
+    return write(fd_, &section, sizeof(section)) == sizeof(section) &&
+           write(fd_, data.data(), data.size()) ==
+               static_cast<ssize_t>(data.size());
+  }
+};
+
+// write kChunks, the body of the second chunk is followed by broken_tail and
+// a stray header section follows the first chunk if stray_header
+void WriteInputFile(const std::string& broken_tail = "",
+                    bool stray_header = false) {
+  StrayHeaderWriter writer;
+  ASSERT_TRUE(writer.Open(kInputFile));
+  ASSERT_TRUE(writer.WriteHeader(HeaderBuilder::GetHeader()));
+  for (const char* name : {kChan1, kChan2}) {
+    Channel channel;
+    channel.set_name(name);
+    channel.set_message_type(kMsgType);
+    ASSERT_TRUE(writer.WriteChannel(channel));
+  }
+  for (size_t i = 0; i < kChunks.size(); ++i) {
+    Chunk chunk;
+    std::unordered_map<std::string, uint64_t> channel_message_number;
+    for (const auto& message : kChunks[i]) {
+      SingleMessage single_message;
+      single_message.set_channel_name(message.first);
+      single_message.set_time(message.second);
+      single_message.set_content("1234567890");
+      chunk.add(single_message);
+      ++channel_message_number[message.first];
+    }
+    std::string body;
+    ASSERT_TRUE(chunk.body_->SerializeToString(&body));
+    if (i == 1) {
+      body += broken_tail;
+    }
+    ASSERT_TRUE(
+        writer.WriteRawChunk(chunk.header_, body, channel_message_number));
+    if (i == 0 && stray_header) {
+      ASSERT_TRUE(writer.WriteStrayHeader());
+    }
+  }
+  writer.Close();
+}
+
+bool Rewrite(ChunkProcessor* processor, bool skip_broken) {
+  RecordFileReader reader;
+  if (!reader.Open(kInputFile)) {
+    return false;
+  }
+  RecordFileWriter writer;
+  if (!writer.Open(kOutputFile) || !writer.WriteHeader(reader.GetHeader())) {
+    return false;
+  }
+  const bool ret = processor->Proc(&reader, &writer, skip_broken);
+  writer.Close();
+  return ret;
+}
+
+// the channels and the messages of the output file
+void ReadOutputFile(std::vector<std::string>* channels, Messages* messages) {
+  RecordFileReader reader;
+  ASSERT_TRUE(reader.Open(kOutputFile));
+  Section section;
+  while (reader.ReadSection(&section)) {
+    if (section.type == SectionType::SECTION_INDEX) {
+      break;
+    }
+    if (section.type == SectionType::SECTION_CHANNEL) {
+      Channel channel;
+      ASSERT_TRUE(reader.ReadSection<Channel>(section.size, &channel));
+      channels->push_back(channel.name());
+    } else if (section.type == SectionType::SECTION_CHUNK_BODY) {
+      ChunkBody body;
+      ASSERT_TRUE(reader.ReadSection<ChunkBody>(section.size, &body));
+      for (const auto& message : body.messages()) {
+        messages->emplace_back(message.channel_name(), message.time());
+      }
+    } else {
+      ASSERT_TRUE(reader.SkipSection(section.size));
+    }
+  }
+}
+
+// a reader whose file descriptor fails every read without moving
+class ReadErrorReader : public RecordFileReader {
+ public:
+  void BreakFileDescriptor() {
+    int fd = open("/dev/null", O_WRONLY);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(dup2(fd, fd_), fd_);
+    close(fd);
+  }
+};
+
+// a writer whose file descriptor fails every write
+class WriteErrorWriter : public RecordFileWriter {
+ public:
+  void BreakFileDescriptor() {
+    int fd = open("/dev/null", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(dup2(fd, fd_), fd_);
+    close(fd);
+  }
+};
+
+}  // namespace
+
+TEST(ChunkProcessorTest, TimeFilter) {
+  WriteInputFile();
+  ChunkProcessor processor(2, nullptr, 2000000000ULL, 4000000000ULL);
+  ASSERT_TRUE(Rewrite(&processor, false));
+  // the last chunk ends before the range and its body is skipped
+  EXPECT_EQ(processor.total_chunks(), 2);
+  EXPECT_EQ(processor.verbatim_chunks(), 1);
+
+  std::vector<std::string> channels;
+  Messages messages;
+  ReadOutputFile(&channels, &messages);
+  EXPECT_EQ(channels, std::vector<std::string>({kChan1, kChan2}));
+  EXPECT_EQ(messages, Messages({{kChan2, 2000000000ULL},
+                                {kChan1, 3000000000ULL},
+                                {kChan2, 4000000000ULL}}));
+}
+
+TEST(ChunkProcessorTest, ChannelFilter) {
+  WriteInputFile();
+  ChunkProcessor processor(2, [](const std::string& channel_name) {
+    return channel_name == kChan1;
+  });
+  ASSERT_TRUE(Rewrite(&processor, false));
+  EXPECT_EQ(processor.total_chunks(), 3);
+  EXPECT_EQ(processor.verbatim_chunks(), 1);
+
+  std::vector<std::string> channels;
+  Messages messages;
+  ReadOutputFile(&channels, &messages);
+  EXPECT_EQ(channels, std::vector<std::string>({kChan1}));
+  EXPECT_EQ(messages, Messages({{kChan1, 1000000000ULL},
+                                {kChan1, 3000000000ULL},
+                                {kChan1, 5000000000ULL}}));
+}
+
+TEST(ChunkProcessorTest, BrokenChunkBody) {
+  // a messages field whose length is cut off
+  WriteInputFile(std::string("\x0a\xff", 2));
+
+  ChunkProcessor split_processor(2, nullptr);
+  EXPECT_FALSE(Rewrite(&split_processor, false));
+
+  // the broken chunk is dropped, later chunks are not affected
+  ChunkProcessor recover_processor(2, nullptr);
+  ASSERT_TRUE(Rewrite(&recover_processor, true));
+  EXPECT_EQ(recover_processor.total_chunks(), 3);
+  EXPECT_EQ(recover_processor.verbatim_chunks(), 2);
+
+  std::vector<std::string> channels;
+  Messages messages;
+  ReadOutputFile(&channels, &messages);
+  EXPECT_EQ(messages,
+            Messages({{kChan1, 1000000000ULL}, {kChan2, 2000000000ULL},
+                      {kChan1, 5000000000ULL}}));
+}
+
+TEST(ChunkProcessorTest, UnexpectedSection) {
+  WriteInputFile("", true);
+
+  // split skips the stray header section
+  ChunkProcessor split_processor(2, nullptr);
+  ASSERT_TRUE(Rewrite(&split_processor, false));
+  EXPECT_EQ(split_processor.total_chunks(), 3);
+
+  // recover gives up like the serial recoverer, no chunk after the failure
+  // is written
+  ChunkProcessor recover_processor(2, nullptr);
+  EXPECT_FALSE(Rewrite(&recover_processor, true));
+  EXPECT_EQ(recover_processor.total_chunks(), 1);
+
+  std::vector<std::string> channels;
+  Messages messages;
+  ReadOutputFile(&channels, &messages);
+  EXPECT_EQ(messages,
+            Messages({{kChan1, 1000000000ULL}, {kChan2, 2000000000ULL}}));
+}
+
+TEST(ChunkProcessorTest, ReadErrorWithoutProgress) {
+  WriteInputFile();
+  ReadErrorReader reader;
+  ASSERT_TRUE(reader.Open(kInputFile));
+  reader.BreakFileDescriptor();
+  RecordFileWriter writer;
+  ASSERT_TRUE(writer.Open(kOutputFile));
+  ASSERT_TRUE(writer.WriteHeader(HeaderBuilder::GetHeader()));
+
+  // skipping broken sections must not retry the same failed read forever
+  ChunkProcessor processor(2, nullptr);
+  EXPECT_FALSE(processor.Proc(&reader, &writer, true));
+  EXPECT_EQ(processor.total_chunks(), 0);
+  writer.Close();
+}
+
+TEST(ChunkProcessorTest, WriteError) {
+  WriteInputFile();
+  RecordFileReader reader;
+  ASSERT_TRUE(reader.Open(kInputFile));
+  WriteErrorWriter writer;
+  ASSERT_TRUE(writer.Open(kOutputFile));
+  ASSERT_TRUE(writer.WriteHeader(HeaderBuilder::GetHeader()));
+  writer.BreakFileDescriptor();
+
+  // the first failed write stops the writing of the chunks still in flight
+  ChunkProcessor processor(4, nullptr);
+  EXPECT_FALSE(processor.Proc(&reader, &writer, true));
+  EXPECT_EQ(processor.total_chunks(), 0);
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
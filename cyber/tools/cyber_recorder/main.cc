@@ -44,8 +44,8 @@ using apollo::cyber::record::Spliter;
 const char INFO_OPTIONS[] = "h";
 const char RECORD_OPTIONS[] = "o:ac:k:i:m:h";
 const char PLAY_OPTIONS[] = "f:ac:k:lr:b:e:s:d:p:h";
-const char SPLIT_OPTIONS[] = "f:o:c:k:b:e:h";
-const char RECOVER_OPTIONS[] = "f:o:h";
+const char SPLIT_OPTIONS[] = "f:o:c:k:b:e:j:h";
+const char RECOVER_OPTIONS[] = "f:o:j:h";
 
 void DisplayUsage(const std::string& binary);
 void DisplayUsage(const std::string& binary, const std::string& command);
@@ -145,6 +145,10 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-m, --segment-size <MB>\t\t\t" << command
                   << " segmented every n megabyte(s)" << std::endl;
         break;
+      case 'j':
+        std::cout << "\t-j, --jobs <1>\t\t\t\t" << command
+                  << " chunks with n threads" << std::endl;
+        break;
       case 'h':
         std::cout << "\t-h, --help\t\t\t\tshow help message" << std::endl;
         break;
@@ -170,7 +174,7 @@ int main(int argc, char** argv) {
   }
 
   int long_index = 0;
-  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:h";
+  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:j:h";
   static const struct option long_opts[] = {
       {"files", required_argument, nullptr, 'f'},
       {"white-channel", required_argument, nullptr, 'c'},
@@ -186,6 +190,7 @@ int main(int argc, char** argv) {
       {"preload", required_argument, nullptr, 'p'},
       {"segment-interval", required_argument, nullptr, 'i'},
       {"segment-size", required_argument, nullptr, 'm'},
+      {"jobs", required_argument, nullptr, 'j'},
       {"help", no_argument, nullptr, 'h'}};
 
   std::vector<std::string> opt_file_vec;
@@ -200,6 +205,7 @@ int main(int argc, char** argv) {
   uint64_t opt_start = 0;
   uint64_t opt_delay = 0;
   uint32_t opt_preload = 3;
+  uint32_t opt_jobs = 1;
   auto opt_header = HeaderBuilder::GetHeader();
 
   do {
@@ -346,6 +352,25 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'j':
+        try {
+          int jobs = std::stoi(optarg);
+          if (jobs < 1) {
+            std::cout << "Argument is less than one: -j/--jobs "
+                      << std::string(optarg) << std::endl;
+            return -1;
+          }
+          opt_jobs = jobs;
+        } catch (std::invalid_argument& ia) {
+          std::cout << "Invalid argument: -j/--jobs " << std::string(optarg)
+                    << std::endl;
+          return -1;
+        } catch (const std::out_of_range& e) {
+          std::cout << "Argument is out of range: -j/--jobs "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        break;
       case 'h':
         DisplayUsage(binary, command);
         return 0;
@@ -378,7 +403,7 @@ int main(int argc, char** argv) {
       opt_output_vec.push_back(default_output_file);
     }
     ::apollo::cyber::Init(argv[0]);
-    Recoverer recoverer(opt_file_vec[0], opt_output_vec[0]);
+    Recoverer recoverer(opt_file_vec[0], opt_output_vec[0], opt_jobs);
     bool recover_result = recoverer.Proc();
     return recover_result ? 0 : -1;
   }
@@ -449,7 +474,7 @@ int main(int argc, char** argv) {
     }
     ::apollo::cyber::Init(argv[0]);
     Spliter spliter(opt_file_vec[0], opt_output_vec[0], opt_white_channels,
-                    opt_black_channels, opt_begin, opt_end);
+                    opt_black_channels, opt_begin, opt_end, opt_jobs);
     bool split_result = spliter.Proc();
     return split_result ? 0 : -1;
   }
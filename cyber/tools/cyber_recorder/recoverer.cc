@@ -18,6 +18,7 @@
 
 #include "cyber/base/for_each.h"
 #include "cyber/record/header_builder.h"
+#include "cyber/tools/cyber_recorder/chunk_processor.h"
 
 namespace apollo {
 namespace cyber {
@@ -28,8 +29,10 @@ using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::SectionType;
 
 Recoverer::Recoverer(const std::string& input_file,
-                     const std::string& output_file)
-    : input_file_(input_file), output_file_(output_file) {}
+                     const std::string& output_file, uint32_t thread_num)
+    : input_file_(input_file),
+      output_file_(output_file),
+      thread_num_(thread_num) {}
 
 Recoverer::~Recoverer() {}
 
@@ -50,6 +53,10 @@ bool Recoverer::Proc() {
     return false;
   }
 
+  if (thread_num_ > 1) {
+    return ProcParallel();
+  }
+
   // write channel sections
   if (reader_.ReadIndex()) {
     proto::Index index = reader_.GetIndex();
@@ -128,6 +135,34 @@ bool Recoverer::Proc() {
   return true;
 }  // end for Proc()
 
+bool Recoverer::ProcParallel() {
+  ChunkProcessor processor(thread_num_, nullptr);
+  // write channel sections
+  if (reader_.ReadIndex()) {
+    const proto::Index& index = reader_.GetIndex();
+    FOR_EACH(i, 0, index.indexes_size()) {
+      const proto::SingleIndex& single_index = index.indexes(i);
+      if (single_index.type() != SectionType::SECTION_CHANNEL) {
+        continue;
+      }
+      const ChannelCache& chan_cache = single_index.channel_cache();
+      Channel chan;
+      chan.set_name(chan_cache.name());
+      chan.set_message_type(chan_cache.message_type());
+      chan.set_proto_desc(chan_cache.proto_desc());
+      processor.WriteChannel(chan, &writer_);
+    }
+  }
+
+  // valid chunks are copied verbatim, broken ones are dropped as in Proc()
+  if (!processor.Proc(&reader_, &writer_, true)) {
+    AERROR << "recover record file failed.";
+    return false;
+  }
+  AINFO << "recover record file done.";
+  return true;
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
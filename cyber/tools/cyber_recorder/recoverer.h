@@ -38,16 +38,20 @@ namespace record {
 
 class Recoverer {
  public:
-  Recoverer(const std::string& input_file, const std::string& output_file);
+  Recoverer(const std::string& input_file, const std::string& output_file,
+            uint32_t thread_num = 1);
   virtual ~Recoverer();
   bool Proc();
 
  private:
+  bool ProcParallel();
+
   RecordFileReader reader_;
   RecordFileWriter writer_;
   std::string input_file_;
   std::string output_file_;
   std::vector<std::string> channel_vec_;
+  uint32_t thread_num_;
 };
 
 }  // namespace record
@@ -16,6 +16,8 @@
 
 #include "cyber/tools/cyber_recorder/spliter.h"
 
+#include "cyber/tools/cyber_recorder/chunk_processor.h"
+
 namespace apollo {
 namespace cyber {
 namespace record {
@@ -26,16 +28,28 @@ using apollo::cyber::proto::SectionType;
 Spliter::Spliter(const std::string& input_file, const std::string& output_file,
                  const std::vector<std::string>& white_channels,
                  const std::vector<std::string>& black_channels,
-                 uint64_t begin_time, uint64_t end_time)
+                 uint64_t begin_time, uint64_t end_time,
+                 uint32_t thread_num)
     : input_file_(input_file),
       output_file_(output_file),
       white_channels_(white_channels),
       black_channels_(black_channels),
       begin_time_(begin_time),
-      end_time_(end_time) {}
+      end_time_(end_time),
+      thread_num_(thread_num) {}
 
 Spliter::~Spliter() {}
 
+bool Spliter::IsChannelSelected(const std::string& channel_name) const {
+  if (!white_channels_.empty() &&
+      std::find(white_channels_.begin(), white_channels_.end(),
+                channel_name) == white_channels_.end()) {
+    return false;
+  }
+  return std::find(black_channels_.begin(), black_channels_.end(),
+                   channel_name) == black_channels_.end();
+}
+
 bool Spliter::Proc() {
   // check params
   if (begin_time_ >= end_time_) {
@@ -77,6 +91,21 @@ bool Spliter::Proc() {
     return false;
   }
 
+  if (thread_num_ > 1) {
+    ChunkProcessor processor(
+        thread_num_,
+        [this](const std::string& channel_name) {
+          return IsChannelSelected(channel_name);
+        },
+        begin_time_, end_time_);
+    if (!processor.Proc(&reader_, &writer_, false)) {
+      AERROR << "split record file failed.";
+      return false;
+    }
+    AINFO << "split record file done.";
+    return true;
+  }
+
   // read through record file
   bool skip_next_chunk_body(false);
   reader_.Reset();
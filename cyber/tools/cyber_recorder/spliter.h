@@ -44,11 +44,14 @@ class Spliter {
           const std::vector<std::string>& white_channels,
           const std::vector<std::string>& black_channels,
           uint64_t begin_time = 0,
-          uint64_t end_time = std::numeric_limits<uint64_t>::max());
+          uint64_t end_time = std::numeric_limits<uint64_t>::max(),
+          uint32_t thread_num = 1);
   virtual ~Spliter();
   bool Proc();
 
  private:
+  bool IsChannelSelected(const std::string& channel_name) const;
+
   RecordFileReader reader_;
   RecordFileWriter writer_;
   std::string input_file_;
@@ -58,6 +61,7 @@ class Spliter {
   bool all_channels_;
   uint64_t begin_time_;
   uint64_t end_time_;
+  uint32_t thread_num_;
 };
 
 }  // namespace record
@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <getopt.h>
+
+#include <iostream>
+#include <string>
+
+#include "cyber/proto/cyber_conf.pb.h"
+#include "cyber/proto/placement_conf.pb.h"
+
+#include "cyber/common/file.h"
+#include "cyber/scheduler/common/cpu_topology.h"
+#include "cyber/scheduler/common/placement_planner.h"
+
+using apollo::cyber::common::GetProtoFromFile;
+using apollo::cyber::common::SetProtoToASCIIFile;
+using apollo::cyber::proto::CyberConfig;
+using apollo::cyber::proto::LoadProfile;
+using apollo::cyber::proto::PlacementConf;
+using apollo::cyber::scheduler::CpuTopology;
+using apollo::cyber::scheduler::PlacementPlanner;
+using apollo::cyber::scheduler::PlacementReport;
+
+const char OPTIONS[] = "c:l:i:o:s:h";
+
+void DisplayUsage(const std::string& binary) {
+  std::cout << "usage: " << binary << " <command> [options]\n"
+            << "The " << binary << " commands are:\n"
+            << "\tplan\tGenerate classic scheduler groups for this host.\n"
+            << "\tvalidate\tCheck a scheduler conf against this host.\n"
+            << "options:\n"
+            << "\t-c, --placement <file>\t\tplacement conf, latency class "
+               "and load of the components\n"
+            << "\t-l, --load <file>\t\tload profile written by sysmo with "
+               "sysmo_load_profile set\n"
+            << "\t-i, --input <file>\t\tscheduler conf to validate\n"
+            << "\t-o, --output <file>\t\twrite the planned conf, dry run "
+               "without it\n"
+            << "\t-s, --sysfs <dir>\t\tsysfs root, default "
+               "/sys/devices/system\n"
+            << "\t-h, --help\t\t\tshow help message" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const std::string binary = apollo::cyber::common::GetFileName(argv[0]);
+  if (argc < 2) {
+    DisplayUsage(binary);
+    return -1;
+  }
+  const std::string command = argv[1];
+  if (command != "plan" && command != "validate") {
+    DisplayUsage(binary);
+    return -1;
+  }
+
+  std::string placement_file;
+  std::string load_file;
+  std::string input_file;
+  std::string output_file;
+  std::string sysfs_root = "/sys/devices/system";
+  const struct option long_options[] = {
+      {"placement", required_argument, nullptr, 'c'},
+      {"load", required_argument, nullptr, 'l'},
+      {"input", required_argument, nullptr, 'i'},
+      {"output", required_argument, nullptr, 'o'},
+      {"sysfs", required_argument, nullptr, 's'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0}};
+  int opt = 0;
+  optind = 2;
+  while ((opt = getopt_long(argc, argv, OPTIONS, long_options, nullptr)) !=
+         -1) {
+    switch (opt) {
+      case 'c':
+        placement_file = optarg;
+        break;
+      case 'l':
+        load_file = optarg;
+        break;
+      case 'i':
+        input_file = optarg;
+        break;
+      case 'o':
+        output_file = optarg;
+        break;
+      case 's':
+        sysfs_root = optarg;
+        break;
+      default:
+        DisplayUsage(binary);
+        return -1;
+    }
+  }
+
+  PlacementConf placement;
+  if (placement_file.empty() || !GetProtoFromFile(placement_file, &placement)) {
+    std::cout << "MUST specify a valid placement conf with -c." << std::endl;
+    return -1;
+  }
+  CpuTopology topology;
+  if (!topology.Load(sysfs_root)) {
+    std::cout << "read cpu topology from " << sysfs_root << " failed."
+              << std::endl;
+    return -1;
+  }
+  std::cout << "host: " << topology.DebugString() << std::endl;
+
+  PlacementPlanner planner(topology, placement);
+  if (!load_file.empty()) {
+    LoadProfile profile;
+    if (!GetProtoFromFile(load_file, &profile)) {
+      std::cout << "parse load profile " << load_file << " failed."
+                << std::endl;
+      return -1;
+    }
+    planner.MergeLoadProfile(profile);
+  }
+
+  PlacementReport report;
+  CyberConfig config;
+  bool ok = false;
+  if (command == "plan") {
+    ok = planner.Plan(config.mutable_scheduler_conf(), &report);
+    if (output_file.empty()) {
+      std::cout << "dry run, planned conf:\n"
+                << config.DebugString() << std::endl;
+    } else if (!SetProtoToASCIIFile(config, output_file)) {
+      std::cout << "write " << output_file << " failed." << std::endl;
+      return -1;
+    }
+  } else {
+    if (input_file.empty() || !GetProtoFromFile(input_file, &config)) {
+      std::cout << "MUST specify a valid scheduler conf with -i."
+                << std::endl;
+      return -1;
+    }
+    ok = planner.Validate(config.scheduler_conf(), &report);
+  }
+  std::cout << report.DebugString();
+  return ok ? 0 : 1;
+}
@@ -30,6 +30,7 @@
 #include "cyber/message/message_traits.h"
 #include "cyber/message/raw_message.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/message_filter.h"
 
 namespace apollo {
 namespace cyber {
@@ -278,6 +279,13 @@ class IntraDispatcher : public Dispatcher {
   template <typename MessageT>
   std::shared_ptr<ListenerHandler<MessageT>> GetHandler(uint64_t channel_id);
 
+  // intra messages are never serialized, only the downsampling part of the
+  // reader qos applies
+  template <typename MessageT>
+  MessageListener<MessageT> FilterListener(
+      const RoleAttributes& self_attr,
+      const MessageListener<MessageT>& listener);
+
   ChannelChainPtr chain_;
 };
 
@@ -341,6 +349,22 @@ std::shared_ptr<ListenerHandler<MessageT>> IntraDispatcher::GetHandler(
   return handler;
 }
 
+template <typename MessageT>
+MessageListener<MessageT> IntraDispatcher::FilterListener(
+    const RoleAttributes& self_attr,
+    const MessageListener<MessageT>& listener) {
+  auto filter = std::make_shared<MessageFilter>(self_attr.qos_profile());
+  if (filter->IsPassThrough()) {
+    return listener;
+  }
+  return [listener, filter](const std::shared_ptr<MessageT>& message,
+                            const MessageInfo& message_info) {
+    if (filter->Accept()) {
+      listener(message, message_info);
+    }
+  };
+}
+
 template <typename MessageT>
 void IntraDispatcher::AddListener(const RoleAttributes& self_attr,
                                   const MessageListener<MessageT>& listener) {
@@ -352,8 +376,8 @@ void IntraDispatcher::AddListener(const RoleAttributes& self_attr,
   std::string message_type = message::GetMessageName<MessageT>();
   uint64_t self_id = self_attr.id();
 
-  bool created =
-      chain_->AddListener(self_id, channel_id, message_type, listener);
+  bool created = chain_->AddListener(self_id, channel_id, message_type,
+                                     FilterListener(self_attr, listener));
 
   auto handler = GetHandler<MessageT>(self_attr.channel_id());
   if (handler && created) {
@@ -381,7 +405,8 @@ void IntraDispatcher::AddListener(const RoleAttributes& self_attr,
   uint64_t oppo_id = opposite_attr.id();
 
   bool created =
-      chain_->AddListener(self_id, oppo_id, channel_id, message_type, listener);
+      chain_->AddListener(self_id, oppo_id, channel_id, message_type,
+                          FilterListener(self_attr, listener));
 
   auto handler = GetHandler<MessageT>(self_attr.channel_id());
   if (handler && created) {
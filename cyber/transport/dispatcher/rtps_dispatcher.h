@@ -27,6 +27,7 @@
 #include "cyber/common/macros.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/message_filter.h"
 #include "cyber/transport/rtps/attributes_filler.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/rtps/sub_listener.h"
@@ -81,11 +82,16 @@ class RtpsDispatcher : public Dispatcher {
 template <typename MessageT>
 void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
                                  const MessageListener<MessageT>& listener) {
-  auto listener_adapter = [listener](
+  auto filter = std::make_shared<MessageFilter>(self_attr.qos_profile());
+  auto listener_adapter = [listener, filter](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
+    if (!filter->Accept()) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    RETURN_IF(!filter->Parse(msg_str->data(),
+                             static_cast<int>(msg_str->size()), msg.get()));
     listener(msg, msg_info);
   };
 
@@ -97,11 +103,16 @@ template <typename MessageT>
 void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
                                  const RoleAttributes& opposite_attr,
                                  const MessageListener<MessageT>& listener) {
-  auto listener_adapter = [listener](
+  auto filter = std::make_shared<MessageFilter>(self_attr.qos_profile());
+  auto listener_adapter = [listener, filter](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
+    if (!filter->Accept()) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    RETURN_IF(!filter->Parse(msg_str->data(),
+                             static_cast<int>(msg_str->size()), msg.get()));
     listener(msg, msg_info);
   };
 
@@ -29,6 +29,7 @@
 #include "cyber/common/macros.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/message_filter.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/shm/segment_factory.h"
 
@@ -82,10 +83,15 @@ template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const MessageListener<MessageT>& listener) {
   // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
+  auto filter = std::make_shared<MessageFilter>(self_attr.qos_profile());
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    if (!filter->Accept()) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
+    RETURN_IF(!filter->Parse(
         rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
     listener(msg, msg_info);
   };
@@ -99,10 +105,15 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const RoleAttributes& opposite_attr,
                                 const MessageListener<MessageT>& listener) {
   // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
+  auto filter = std::make_shared<MessageFilter>(self_attr.qos_profile());
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    if (!filter->Accept()) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
+    RETURN_IF(!filter->Parse(
         rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
     listener(msg, msg_info);
   };
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/message/message_filter.h"
+
+#include <chrono>
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+MessageFilter::MessageFilter(const proto::QosProfile& qos_profile) {
+  if (qos_profile.max_rate() > 0.0) {
+    min_interval_ns_ = static_cast<uint64_t>(1e9 / qos_profile.max_rate());
+  }
+  keep_every_nth_ = qos_profile.keep_every_nth();
+  header_only_ = qos_profile.header_only();
+}
+
+bool MessageFilter::Accept() {
+  if (min_interval_ns_ == 0) {
+    return Accept(0);
+  }
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return Accept(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()));
+}
+
+bool MessageFilter::Accept(uint64_t now_ns) {
+  uint64_t index = received_.fetch_add(1);
+  if (keep_every_nth_ > 1 && index % keep_every_nth_ != 0) {
+    dropped_.fetch_add(1);
+    return false;
+  }
+
+  if (min_interval_ns_ > 0) {
+    uint64_t last = last_accept_ns_.load();
+    do {
+      if (last != 0 && now_ns < last + min_interval_ns_) {
+        dropped_.fetch_add(1);
+        return false;
+      }
+    } while (!last_accept_ns_.compare_exchange_weak(last, now_ns));
+  }
+
+  accepted_.fetch_add(1);
+  return true;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
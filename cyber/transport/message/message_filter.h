@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_MESSAGE_FILTER_H_
+#define CYBER_TRANSPORT_MESSAGE_MESSAGE_FILTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "cyber/proto/qos_profile.pb.h"
+
+#include "cyber/message/message_traits.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+class MessageFilter;
+using MessageFilterPtr = std::shared_ptr<MessageFilter>;
+
+/**
+ * @class MessageFilter
+ * @brief Reader side downsampling built from the `max_rate`,
+ * `keep_every_nth` and `header_only` fields of a reader's QosProfile. The
+ * dispatchers consult it before a message is deserialized so that dropped
+ * messages cost nothing but a counter update.
+ */
+class MessageFilter {
+ public:
+  explicit MessageFilter(const proto::QosProfile& qos_profile);
+  virtual ~MessageFilter() = default;
+
+  /**
+   * @brief Decide whether the message arriving at `now_ns` (steady clock)
+   * should be delivered to the reader. Thread safe.
+   */
+  bool Accept(uint64_t now_ns);
+  bool Accept();
+
+  /**
+   * @brief Deserialize the message, only the `header` field is parsed when
+   * `header_only` is enabled.
+   */
+  template <typename MessageT>
+  bool Parse(const void* data, int size, MessageT* message) const;
+
+  bool IsPassThrough() const {
+    return min_interval_ns_ == 0 && keep_every_nth_ <= 1 && !header_only_;
+  }
+  bool header_only() const { return header_only_; }
+  uint64_t accepted() const { return accepted_.load(); }
+  uint64_t dropped() const { return dropped_.load(); }
+
+ private:
+  uint64_t min_interval_ns_ = 0;
+  uint32_t keep_every_nth_ = 1;
+  bool header_only_ = false;
+
+  std::atomic<uint64_t> received_ = {0};
+  std::atomic<uint64_t> accepted_ = {0};
+  std::atomic<uint64_t> dropped_ = {0};
+  // 0 means no message has been accepted yet
+  std::atomic<uint64_t> last_accept_ns_ = {0};
+};
+
+template <typename MessageT>
+bool MessageFilter::Parse(const void* data, int size,
+                          MessageT* message) const {
+  if (header_only_) {
+    return message::ParseHeaderFromArray(data, size, message);
+  }
+  return message::ParseFromArray(data, size, message);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_MESSAGE_FILTER_H_
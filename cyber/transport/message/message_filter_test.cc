@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/message/message_filter.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cyber/proto/unit_test.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+TEST(MessageFilterTest, pass_through) {
+  proto::QosProfile qos;
+  MessageFilter filter(qos);
+  EXPECT_TRUE(filter.IsPassThrough());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(filter.Accept(0));
+  }
+  EXPECT_EQ(filter.accepted(), 10);
+  EXPECT_EQ(filter.dropped(), 0);
+}
+
+TEST(MessageFilterTest, keep_every_nth) {
+  proto::QosProfile qos;
+  qos.set_keep_every_nth(3);
+  MessageFilter filter(qos);
+  EXPECT_FALSE(filter.IsPassThrough());
+  int accepted = 0;
+  for (int i = 0; i < 9; ++i) {
+    if (filter.Accept(i)) {
+      EXPECT_EQ(i % 3, 0);
+      ++accepted;
+    }
+  }
+  EXPECT_EQ(accepted, 3);
+  EXPECT_EQ(filter.dropped(), 6);
+}
+
+TEST(MessageFilterTest, max_rate) {
+  proto::QosProfile qos;
+  qos.set_max_rate(2.0);
+  MessageFilter filter(qos);
+  const uint64_t kPeriodNs = 100000000;  // 10 Hz input
+  int accepted = 0;
+  for (uint64_t i = 1; i <= 20; ++i) {
+    if (filter.Accept(i * kPeriodNs)) {
+      ++accepted;
+    }
+  }
+  EXPECT_EQ(accepted, 4);
+  EXPECT_EQ(filter.accepted() + filter.dropped(), 20);
+}
+
+TEST(MessageFilterTest, header_only) {
+  proto::HeaderChatter chatter;
+  chatter.mutable_header()->set_class_name("MessageFilterTest");
+  chatter.set_seq(7);
+  chatter.set_content(std::string(1024, 'x'));
+  std::string str;
+  ASSERT_TRUE(chatter.SerializeToString(&str));
+
+  proto::QosProfile qos;
+  qos.set_header_only(true);
+  MessageFilter filter(qos);
+  proto::HeaderChatter parsed;
+  EXPECT_TRUE(
+      filter.Parse(str.data(), static_cast<int>(str.size()), &parsed));
+  EXPECT_EQ(parsed.header().class_name(), "MessageFilterTest");
+  EXPECT_FALSE(parsed.has_seq());
+  EXPECT_FALSE(parsed.has_content());
+
+  // messages without a header are fully parsed
+  proto::Chatter plain;
+  plain.set_seq(7);
+  ASSERT_TRUE(plain.SerializeToString(&str));
+  proto::Chatter plain_parsed;
+  EXPECT_TRUE(
+      filter.Parse(str.data(), static_cast<int>(str.size()), &plain_parsed));
+  EXPECT_EQ(plain_parsed.seq(), 7);
+
+  EXPECT_FALSE(filter.Parse(str.data(), 1, &parsed));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
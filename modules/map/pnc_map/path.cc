@@ -17,6 +17,7 @@
 #include "modules/map/pnc_map/path.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <unordered_map>
 
@@ -47,6 +48,39 @@ namespace {
 
 const double kSampleDistance = 0.25;
 
+// Segments are scanned in blocks of this size: the squared distances of a
+// block are computed first in a branch free loop, then the block is searched
+// for the minimum.
+constexpr int kDistanceBlockSize = 64;
+
+// Grid cells are at least this large, and are made larger for long paths
+// until there are no more than kMaxCellsPerSegment cells per segment.
+const double kMinGridCellSize = 2.0;
+const int kMaxCellsPerSegment = 4;
+const double kRingMargin = 1e-6;
+
+// The squared distance from (x, y) to a segment, computed like
+// LineSegment2d::DistanceSquareTo so that the index picks the segment a scan
+// over Path::segments() picks, also on near ties. Written with selects
+// instead of branches to keep the block loop vectorizable.
+inline double SegmentDistanceSquare(const double x, const double y,
+                                    const double start_x, const double start_y,
+                                    const double end_x, const double end_y,
+                                    const double unit_x, const double unit_y,
+                                    const double length) {
+  const double x0 = x - start_x;
+  const double y0 = y - start_y;
+  const double x1 = x - end_x;
+  const double y1 = y - end_y;
+  const double proj = x0 * unit_x + y0 * unit_y;
+  const double cross = x0 * unit_y - y0 * unit_x;
+  const double start_distance_sqr = x0 * x0 + y0 * y0;
+  const double end_distance_sqr = x1 * x1 + y1 * y1;
+  return length <= kMathEpsilon || proj <= 0.0
+             ? start_distance_sqr
+             : (proj >= length ? end_distance_sqr : cross * cross);
+}
+
 bool FindLaneSegment(const MapPathPoint& p1, const MapPathPoint& p2,
                      LaneSegment* const lane_segment) {
   for (const auto& wp1 : p1.lane_waypoints()) {
@@ -350,6 +384,7 @@ Path::Path(std::vector<MapPathPoint>&& path_points,
 
 void Path::Init() {
   InitPoints();
+  projection_index_ = PathProjectionIndex(*this);
   InitLaneSegments();
   InitPointIndex();
   InitWidth();
@@ -752,36 +787,14 @@ bool Path::GetProjectionWithHueristicParams(const Vec2d& point,
   int end_interpolation_index = static_cast<int>(
       std::fmin(num_segments_, GetIndexFromS(hueristic_end_s).id + 1));
   int min_index = start_interpolation_index;
-  for (int i = start_interpolation_index; i < end_interpolation_index; ++i) {
-    const double distance = segments_[i].DistanceSquareTo(point);
-    if (distance < *min_distance) {
-      min_index = i;
-      *min_distance = distance;
-    }
+  if (start_interpolation_index < end_interpolation_index) {
+    min_index = projection_index_.GetNearestSegmentInRange(
+        point, start_interpolation_index, end_interpolation_index,
+        min_distance);
   }
   *min_distance = std::sqrt(*min_distance);
-  const auto& nearest_seg = segments_[min_index];
-  const auto prod = nearest_seg.ProductOntoUnit(point);
-  const auto proj = nearest_seg.ProjectOntoUnit(point);
-  if (min_index == 0) {
-    *accumulate_s = std::min(proj, nearest_seg.length());
-    if (proj < 0) {
-      *lateral = prod;
-    } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-    }
-  } else if (min_index == num_segments_ - 1) {
-    *accumulate_s = accumulated_s_[min_index] + std::max(0.0, proj);
-    if (proj > 0) {
-      *lateral = prod;
-    } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-    }
-  } else {
-    *accumulate_s = accumulated_s_[min_index] +
-                    std::max(0.0, std::min(proj, nearest_seg.length()));
-    *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-  }
+  GetProjectionOntoSegment(point, min_index, *min_distance, accumulate_s,
+                           lateral);
   return true;
 }
 
@@ -799,39 +812,83 @@ bool Path::GetProjection(const Vec2d& point, double* accumulate_s,
                                         min_distance);
   }
   CHECK_GE(num_points_, 2);
-  *min_distance = std::numeric_limits<double>::infinity();
-  int min_index = 0;
-  for (int i = 0; i < num_segments_; ++i) {
-    const double distance = segments_[i].DistanceSquareTo(point);
-    if (distance < *min_distance) {
-      min_index = i;
-      *min_distance = distance;
-    }
+  const int min_index =
+      projection_index_.GetNearestSegment(point, -1, min_distance);
+  *min_distance = std::sqrt(*min_distance);
+  GetProjectionOntoSegment(point, min_index, *min_distance, accumulate_s,
+                           lateral);
+  return true;
+}
+
+bool Path::GetProjectionWithHint(const Vec2d& point, int* hint_segment,
+                                 double* accumulate_s, double* lateral,
+                                 double* min_distance) const {
+  if (hint_segment == nullptr) {
+    return false;
+  }
+  if (segments_.empty() || use_path_approximation_) {
+    return GetProjection(point, accumulate_s, lateral, min_distance);
   }
+  if (accumulate_s == nullptr || lateral == nullptr ||
+      min_distance == nullptr) {
+    return false;
+  }
+  CHECK_GE(num_points_, 2);
+  const int min_index =
+      projection_index_.GetNearestSegment(point, *hint_segment, min_distance);
   *min_distance = std::sqrt(*min_distance);
-  const auto& nearest_seg = segments_[min_index];
+  GetProjectionOntoSegment(point, min_index, *min_distance, accumulate_s,
+                           lateral);
+  *hint_segment = min_index;
+  return true;
+}
+
+bool Path::GetProjections(const std::vector<Vec2d>& points,
+                          std::vector<double>* accumulate_s,
+                          std::vector<double>* lateral) const {
+  if (accumulate_s == nullptr || lateral == nullptr) {
+    return false;
+  }
+  accumulate_s->resize(points.size());
+  lateral->resize(points.size());
+  int hint_segment = -1;
+  double distance = 0.0;
+  for (size_t i = 0; i < points.size(); ++i) {
+    if (!GetProjectionWithHint(points[i], &hint_segment, &(*accumulate_s)[i],
+                               &(*lateral)[i], &distance)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Path::GetProjectionOntoSegment(const Vec2d& point,
+                                    const int segment_index,
+                                    const double min_distance,
+                                    double* accumulate_s,
+                                    double* lateral) const {
+  const auto& nearest_seg = segments_[segment_index];
   const auto prod = nearest_seg.ProductOntoUnit(point);
   const auto proj = nearest_seg.ProjectOntoUnit(point);
-  if (min_index == 0) {
+  if (segment_index == 0) {
     *accumulate_s = std::min(proj, nearest_seg.length());
     if (proj < 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
     }
-  } else if (min_index == num_segments_ - 1) {
-    *accumulate_s = accumulated_s_[min_index] + std::max(0.0, proj);
+  } else if (segment_index == num_segments_ - 1) {
+    *accumulate_s = accumulated_s_[segment_index] + std::max(0.0, proj);
     if (proj > 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
     }
   } else {
-    *accumulate_s = accumulated_s_[min_index] +
+    *accumulate_s = accumulated_s_[segment_index] +
                     std::max(0.0, std::min(proj, nearest_seg.length()));
-    *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+    *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
   }
-  return true;
 }
 
 bool Path::GetHeadingAlongPath(const Vec2d& point, double* heading) const {
@@ -955,6 +1012,206 @@ double PathApproximation::compute_max_error(const Path& path, const int s,
   return sqrt(max_distance_sqr);
 }
 
+void PathProjectionIndex::Init(const Path& path) {
+  const auto& segments = path.segments();
+  num_segments_ = static_cast<int>(segments.size());
+  start_x_.resize(num_segments_);
+  start_y_.resize(num_segments_);
+  end_x_.resize(num_segments_);
+  end_y_.resize(num_segments_);
+  unit_x_.resize(num_segments_);
+  unit_y_.resize(num_segments_);
+  length_.resize(num_segments_);
+  for (int i = 0; i < num_segments_; ++i) {
+    const auto& segment = segments[i];
+    start_x_[i] = segment.start().x();
+    start_y_[i] = segment.start().y();
+    end_x_[i] = segment.end().x();
+    end_y_[i] = segment.end().y();
+    unit_x_[i] = segment.unit_direction().x();
+    unit_y_[i] = segment.unit_direction().y();
+    length_[i] = segment.length();
+  }
+  InitGrid();
+}
+
+void PathProjectionIndex::InitGrid() {
+  if (num_segments_ == 0) {
+    return;
+  }
+  double max_x = -std::numeric_limits<double>::infinity();
+  double max_y = -std::numeric_limits<double>::infinity();
+  min_x_ = std::numeric_limits<double>::infinity();
+  min_y_ = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < num_segments_; ++i) {
+    min_x_ = std::min({min_x_, start_x_[i], end_x_[i]});
+    min_y_ = std::min({min_y_, start_y_[i], end_y_[i]});
+    max_x = std::max({max_x, start_x_[i], end_x_[i]});
+    max_y = std::max({max_y, start_y_[i], end_y_[i]});
+  }
+  cell_size_ = kMinGridCellSize;
+  const double max_num_cells =
+      static_cast<double>(kMaxCellsPerSegment) * num_segments_;
+  while (((max_x - min_x_) / cell_size_ + 1.0) *
+             ((max_y - min_y_) / cell_size_ + 1.0) >
+         max_num_cells) {
+    cell_size_ *= 2.0;
+  }
+  num_cols_ = static_cast<int>((max_x - min_x_) / cell_size_) + 1;
+  num_rows_ = static_cast<int>((max_y - min_y_) / cell_size_) + 1;
+
+  // Bucket every segment into all cells its bounding box overlaps, counting
+  // first so that the buckets can be laid out in one array.
+  const int num_cells = num_cols_ * num_rows_;
+  std::vector<int> col_range(2 * num_segments_);
+  std::vector<int> row_range(2 * num_segments_);
+  cell_begin_.assign(num_cells + 1, 0);
+  for (int i = 0; i < num_segments_; ++i) {
+    const double end_x = end_x_[i];
+    const double end_y = end_y_[i];
+    col_range[2 * i] = std::min(
+        num_cols_ - 1,
+        static_cast<int>((std::min(start_x_[i], end_x) - min_x_) / cell_size_));
+    col_range[2 * i + 1] = std::min(
+        num_cols_ - 1,
+        static_cast<int>((std::max(start_x_[i], end_x) - min_x_) / cell_size_));
+    row_range[2 * i] = std::min(
+        num_rows_ - 1,
+        static_cast<int>((std::min(start_y_[i], end_y) - min_y_) / cell_size_));
+    row_range[2 * i + 1] = std::min(
+        num_rows_ - 1,
+        static_cast<int>((std::max(start_y_[i], end_y) - min_y_) / cell_size_));
+    for (int row = row_range[2 * i]; row <= row_range[2 * i + 1]; ++row) {
+      for (int col = col_range[2 * i]; col <= col_range[2 * i + 1]; ++col) {
+        ++cell_begin_[row * num_cols_ + col + 1];
+      }
+    }
+  }
+  for (int i = 0; i < num_cells; ++i) {
+    cell_begin_[i + 1] += cell_begin_[i];
+  }
+  cell_segments_.resize(cell_begin_[num_cells]);
+  std::vector<int> cell_fill(cell_begin_.begin(), cell_begin_.end() - 1);
+  for (int i = 0; i < num_segments_; ++i) {
+    for (int row = row_range[2 * i]; row <= row_range[2 * i + 1]; ++row) {
+      for (int col = col_range[2 * i]; col <= col_range[2 * i + 1]; ++col) {
+        cell_segments_[cell_fill[row * num_cols_ + col]++] = i;
+      }
+    }
+  }
+}
+
+int PathProjectionIndex::GetNearestSegmentInRange(
+    const Vec2d& point, const int begin, const int end,
+    double* min_distance_sqr) const {
+  *min_distance_sqr = std::numeric_limits<double>::infinity();
+  int min_index = -1;
+  const double x = point.x();
+  const double y = point.y();
+  double distance_sqr[kDistanceBlockSize];
+  for (int block = std::max(0, begin); block < std::min(end, num_segments_);
+       block += kDistanceBlockSize) {
+    const int block_size =
+        std::min(kDistanceBlockSize, std::min(end, num_segments_) - block);
+    const double* start_x = start_x_.data() + block;
+    const double* start_y = start_y_.data() + block;
+    const double* end_x = end_x_.data() + block;
+    const double* end_y = end_y_.data() + block;
+    const double* unit_x = unit_x_.data() + block;
+    const double* unit_y = unit_y_.data() + block;
+    const double* length = length_.data() + block;
+    for (int i = 0; i < block_size; ++i) {
+      distance_sqr[i] =
+          SegmentDistanceSquare(x, y, start_x[i], start_y[i], end_x[i],
+                                end_y[i], unit_x[i], unit_y[i], length[i]);
+    }
+    for (int i = 0; i < block_size; ++i) {
+      if (distance_sqr[i] < *min_distance_sqr) {
+        *min_distance_sqr = distance_sqr[i];
+        min_index = block + i;
+      }
+    }
+  }
+  return min_index;
+}
+
+void PathProjectionIndex::VisitCell(const int col, const int row,
+                                    const double x, const double y,
+                                    int* min_index,
+                                    double* min_distance_sqr) const {
+  const int cell = row * num_cols_ + col;
+  for (int k = cell_begin_[cell]; k < cell_begin_[cell + 1]; ++k) {
+    const int i = cell_segments_[k];
+    const double distance_sqr = SegmentDistanceSquare(
+        x, y, start_x_[i], start_y_[i], end_x_[i], end_y_[i], unit_x_[i],
+        unit_y_[i], length_[i]);
+    if (distance_sqr < *min_distance_sqr ||
+        (distance_sqr == *min_distance_sqr && i < *min_index)) {
+      *min_distance_sqr = distance_sqr;
+      *min_index = i;
+    }
+  }
+}
+
+int PathProjectionIndex::GetNearestSegment(const Vec2d& point, const int hint,
+                                           double* min_distance_sqr) const {
+  *min_distance_sqr = std::numeric_limits<double>::infinity();
+  if (num_segments_ == 0) {
+    return -1;
+  }
+  int min_index = -1;
+  // The segments around the hint give an upper bound of the distance, which
+  // lets the grid search below stop at the first rings.
+  static constexpr int kHintRange = 2;
+  if (hint >= 0 && hint < num_segments_) {
+    min_index = GetNearestSegmentInRange(point, hint - kHintRange,
+                                         hint + kHintRange + 1,
+                                         min_distance_sqr);
+  }
+
+  const double x = point.x();
+  const double y = point.y();
+  const int col = static_cast<int>(std::floor((x - min_x_) / cell_size_));
+  const int row = static_cast<int>(std::floor((y - min_y_) / cell_size_));
+  // Rings of cells around (col, row), ring r is where max(|dcol|, |drow|) is
+  // r. The cells of ring r are at least (r - 1) * cell_size_ away from the
+  // point, so the search stops once the nearest segment found is closer. The
+  // margin keeps rounding in the cell coordinates from cutting off a ring
+  // with a segment as near as the one found.
+  const int first_ring = std::max({0, -col, col - (num_cols_ - 1), -row,
+                                   row - (num_rows_ - 1)});
+  const int last_ring = std::max({col, num_cols_ - 1 - col, row,
+                                  num_rows_ - 1 - row});
+  for (int r = first_ring; r <= last_ring; ++r) {
+    if (r > 0 && min_index >= 0) {
+      const double ring_distance =
+          std::max(0.0, (r - 1) * cell_size_ - kRingMargin);
+      if (*min_distance_sqr < ring_distance * ring_distance) {
+        break;
+      }
+    }
+    const int row_begin = std::max(0, row - r);
+    const int row_end = std::min(num_rows_ - 1, row + r);
+    const int col_begin = std::max(0, col - r);
+    const int col_end = std::min(num_cols_ - 1, col + r);
+    for (int ring_row = row_begin; ring_row <= row_end; ++ring_row) {
+      if (std::abs(ring_row - row) == r) {
+        for (int ring_col = col_begin; ring_col <= col_end; ++ring_col) {
+          VisitCell(ring_col, ring_row, x, y, &min_index, min_distance_sqr);
+        }
+        continue;
+      }
+      if (col - r >= 0) {
+        VisitCell(col - r, ring_row, x, y, &min_index, min_distance_sqr);
+      }
+      if (r > 0 && col + r < num_cols_) {
+        VisitCell(col + r, ring_row, x, y, &min_index, min_distance_sqr);
+      }
+    }
+  }
+  return min_index;
+}
+
 bool PathApproximation::is_within_max_error(const Path& path, const int s,
                                             const int t) {
   if (s + 1 >= t) {
@@ -203,6 +203,68 @@ class PathApproximation {
   std::vector<int> sampled_max_original_projections_to_left_;
 };
 
+/**
+ * @brief Exact nearest segment search over the segments of a path. The
+ * segments are kept as flat arrays so that distances of consecutive segments
+ * can be computed in vectorized loops, and are bucketed into a uniform grid so
+ * that a query only looks at the segments around the point.
+ */
+class PathProjectionIndex {
+ public:
+  PathProjectionIndex() = default;
+  explicit PathProjectionIndex(const Path& path) { Init(path); }
+
+  bool empty() const { return num_segments_ == 0; }
+
+  /**
+   * @brief Find the segment nearest to point. The distances are computed like
+   * LineSegment2d::DistanceSquareTo and the smallest index wins among equally
+   * near segments, so the result is the segment a scan over Path::segments()
+   * with DistanceSquareTo picks.
+   * @param hint a segment expected to be close to point, e.g. the result of
+   * the previous query along a trajectory, or -1. It only makes the search
+   * shorter and does not change the result.
+   * @return the segment index, or -1 if the path has no segment.
+   */
+  int GetNearestSegment(const common::math::Vec2d& point, const int hint,
+                        double* min_distance_sqr) const;
+
+  /**
+   * @brief Find the segment nearest to point among segments [begin, end).
+   */
+  int GetNearestSegmentInRange(const common::math::Vec2d& point,
+                               const int begin, const int end,
+                               double* min_distance_sqr) const;
+
+ protected:
+  void Init(const Path& path);
+  void InitGrid();
+
+  void VisitCell(const int col, const int row, const double x, const double y,
+                 int* min_index, double* min_distance_sqr) const;
+
+ protected:
+  int num_segments_ = 0;
+  std::vector<double> start_x_;
+  std::vector<double> start_y_;
+  std::vector<double> end_x_;
+  std::vector<double> end_y_;
+  std::vector<double> unit_x_;
+  std::vector<double> unit_y_;
+  std::vector<double> length_;
+
+  // The grid covers the bounding box of the path. The segments overlapping
+  // cell i are cell_segments_[cell_begin_[i]] ... cell_segments_[cell_begin_[i
+  // + 1] - 1].
+  double min_x_ = 0.0;
+  double min_y_ = 0.0;
+  double cell_size_ = 1.0;
+  int num_cols_ = 0;
+  int num_rows_ = 0;
+  std::vector<int> cell_begin_;
+  std::vector<int> cell_segments_;
+};
+
 class InterpolatedIndex {
  public:
   InterpolatedIndex(int id, double offset) : id(id), offset(offset) {}
@@ -259,6 +321,25 @@ class Path {
   bool GetProjection(const common::math::Vec2d& point, double* accumulate_s,
                      double* lateral, double* distance) const;
 
+  /**
+   * @brief Project a point which is expected to be close to the segment
+   * hint_segment, e.g. the next point of a trajectory that was projected
+   * before. The result is the same as GetProjection.
+   * @param hint_segment in: the segment of the previous projection or -1,
+   * out: the segment of this projection, to be passed to the next query.
+   */
+  bool GetProjectionWithHint(const common::math::Vec2d& point,
+                             int* hint_segment, double* accumulate_s,
+                             double* lateral, double* distance) const;
+
+  /**
+   * @brief Project many points at once. Consecutive points are expected to be
+   * close to each other, e.g. the points of a trajectory or a polygon.
+   */
+  bool GetProjections(const std::vector<common::math::Vec2d>& points,
+                      std::vector<double>* accumulate_s,
+                      std::vector<double>* lateral) const;
+
   bool GetHeadingAlongPath(const common::math::Vec2d& point,
                            double* heading) const;
 
@@ -279,6 +360,9 @@ class Path {
     return segments_;
   }
   const PathApproximation* approximation() const { return &approximation_; }
+  const PathProjectionIndex* projection_index() const {
+    return &projection_index_;
+  }
   double length() const { return length_; }
 
   const PathOverlap* NextLaneOverlap(double s) const;
@@ -342,6 +426,11 @@ class Path {
 
   double GetSample(const std::vector<double>& samples, const double s) const;
 
+  void GetProjectionOntoSegment(const common::math::Vec2d& point,
+                                const int segment_index,
+                                const double min_distance,
+                                double* accumulate_s, double* lateral) const;
+
   using GetOverlapFromLaneFunc =
       std::function<const std::vector<OverlapInfoConstPtr>&(const LaneInfo&)>;
   void GetAllOverlaps(GetOverlapFromLaneFunc GetOverlaps_from_lane,
@@ -360,6 +449,7 @@ class Path {
   std::vector<common::math::LineSegment2d> segments_;
   bool use_path_approximation_ = false;
   PathApproximation approximation_;
+  PathProjectionIndex projection_index_;
 
   // Sampled every fixed length.
   int num_sample_points_ = 0;
@@ -16,7 +16,11 @@
 
 #include "modules/map/pnc_map/path.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
@@ -61,6 +65,39 @@ double RandomDouble(double s, double t) {
   return s + (t - s) / 16383.0 * (rand() & 16383);  // NOLINT
 }
 
+// Path::GetProjection as a scan over all segments with DistanceSquareTo, the
+// first of equally near segments wins.
+void ScanProjection(const Path& path, const Vec2d& point, double* accumulate_s,
+                    double* lateral) {
+  const auto& segments = path.segments();
+  const int num_segments = static_cast<int>(segments.size());
+  double min_distance = std::numeric_limits<double>::infinity();
+  int min_index = 0;
+  for (int i = 0; i < num_segments; ++i) {
+    const double distance = segments[i].DistanceSquareTo(point);
+    if (distance < min_distance) {
+      min_index = i;
+      min_distance = distance;
+    }
+  }
+  min_distance = std::sqrt(min_distance);
+  const auto& nearest_seg = segments[min_index];
+  const double prod = nearest_seg.ProductOntoUnit(point);
+  const double proj = nearest_seg.ProjectOntoUnit(point);
+  const double signed_distance = (prod > 0.0 ? 1 : -1) * min_distance;
+  if (min_index == 0) {
+    *accumulate_s = std::min(proj, nearest_seg.length());
+    *lateral = proj < 0 ? prod : signed_distance;
+  } else if (min_index == num_segments - 1) {
+    *accumulate_s = path.accumulated_s()[min_index] + std::max(0.0, proj);
+    *lateral = proj > 0 ? prod : signed_distance;
+  } else {
+    *accumulate_s = path.accumulated_s()[min_index] +
+                    std::max(0.0, std::min(proj, nearest_seg.length()));
+    *lateral = signed_distance;
+  }
+}
+
 }  // namespace
 
 TEST(TestSuite, LaneSegment) {
@@ -648,6 +685,123 @@ TEST(TestSuite, hdmap_s_path) {
   }
 }
 
+TEST(TestSuite, hdmap_path_projection_index) {
+  // A spiral that turns more than once, so that far parts of the path are
+  // close to each other.
+  const int kNumSegments = 400;
+  std::vector<MapPathPoint> points;
+  for (int i = 0; i <= kNumSegments; ++i) {
+    const double p = 3.0 * M_PI * static_cast<double>(i) / kNumSegments;
+    const double r = 20.0 + 3.0 * p + RandomDouble(-0.2, 0.2);
+    points.push_back(MakeMapPathPoint(r * cos(p), r * sin(p)));
+  }
+  const Path path(points);
+
+  const auto& segments = path.segments();
+  std::vector<Vec2d> queries;
+  for (int i = 0; i < 1000; ++i) {
+    queries.emplace_back(RandomDouble(-80.0, 80.0), RandomDouble(-80.0, 80.0));
+  }
+  // points far away from the path
+  queries.emplace_back(1000.0, -2000.0);
+  queries.emplace_back(-500.0, 0.0);
+
+  int hint_segment = -1;
+  for (const auto& query : queries) {
+    double expected_distance = std::numeric_limits<double>::infinity();
+    for (const auto& segment : segments) {
+      expected_distance =
+          std::min(expected_distance, segment.DistanceTo(query));
+    }
+    double accumulate_s = 0.0;
+    double lateral = 0.0;
+    double distance = 0.0;
+    EXPECT_TRUE(path.GetProjection(query, &accumulate_s, &lateral, &distance));
+    EXPECT_NEAR(distance, expected_distance, 1e-6);
+    const Vec2d projected = path.GetSmoothPoint(accumulate_s);
+    EXPECT_NEAR(projected.DistanceTo(query), expected_distance, 1e-6);
+
+    double hinted_s = 0.0;
+    double hinted_l = 0.0;
+    double hinted_distance = 0.0;
+    EXPECT_TRUE(path.GetProjectionWithHint(query, &hint_segment, &hinted_s,
+                                           &hinted_l, &hinted_distance));
+    EXPECT_NEAR(hinted_s, accumulate_s, 1e-6);
+    EXPECT_NEAR(hinted_l, lateral, 1e-6);
+    EXPECT_NEAR(hinted_distance, distance, 1e-6);
+  }
+
+  // a trajectory along the path with a lateral offset
+  std::vector<Vec2d> trajectory;
+  for (double s = -5.0; s < path.length() + 5.0; s += 0.5) {
+    const auto point = path.GetSmoothPoint(s);
+    trajectory.push_back(point + Vec2d::CreateUnitVec2d(point.heading() +
+                                                        M_PI_2) *
+                                     1.5);
+  }
+  std::vector<double> accumulate_s;
+  std::vector<double> lateral;
+  EXPECT_TRUE(path.GetProjections(trajectory, &accumulate_s, &lateral));
+  ASSERT_EQ(accumulate_s.size(), trajectory.size());
+  ASSERT_EQ(lateral.size(), trajectory.size());
+  for (size_t i = 0; i < trajectory.size(); ++i) {
+    double s = 0.0;
+    double l = 0.0;
+    EXPECT_TRUE(path.GetProjection(trajectory[i], &s, &l));
+    EXPECT_NEAR(accumulate_s[i], s, 1e-6);
+    EXPECT_NEAR(lateral[i], l, 1e-6);
+  }
+}
+
+TEST(TestSuite, hdmap_path_projection_index_same_as_scan) {
+  // A hairpin: the two legs are 4m apart, so the points between them are
+  // equally near to segments whose s differ by about 100m.
+  std::vector<MapPathPoint> points;
+  for (int i = 0; i <= 50; ++i) {
+    points.push_back(MakeMapPathPoint(static_cast<double>(i), 0.0));
+  }
+  for (int i = 50; i >= 0; --i) {
+    points.push_back(MakeMapPathPoint(static_cast<double>(i), 4.0));
+  }
+  // and a noisy spiral around it from the left, with near ties between its
+  // turns
+  for (int i = 0; i <= 400; ++i) {
+    const double p = M_PI + 3.0 * M_PI * static_cast<double>(i) / 400.0;
+    const double r = 60.0 + 3.0 * p + RandomDouble(-0.2, 0.2);
+    points.push_back(MakeMapPathPoint(r * cos(p), r * sin(p)));
+  }
+  const Path path(points);
+
+  std::vector<Vec2d> queries;
+  for (int i = 0; i <= 200; ++i) {
+    queries.emplace_back(-5.0 + 0.3 * i, 2.0);
+    queries.emplace_back(0.25 * i, 2.0 + RandomDouble(-1e-9, 1e-9));
+  }
+  for (int i = 0; i < 2000; ++i) {
+    queries.emplace_back(RandomDouble(-90.0, 90.0), RandomDouble(-90.0, 90.0));
+  }
+  queries.emplace_back(1000.0, -2000.0);
+
+  int hint_segment = -1;
+  for (const auto& query : queries) {
+    double expected_s = 0.0;
+    double expected_l = 0.0;
+    ScanProjection(path, query, &expected_s, &expected_l);
+
+    double accumulate_s = 0.0;
+    double lateral = 0.0;
+    EXPECT_TRUE(path.GetProjection(query, &accumulate_s, &lateral));
+    EXPECT_DOUBLE_EQ(expected_s, accumulate_s) << query.DebugString();
+    EXPECT_DOUBLE_EQ(expected_l, lateral) << query.DebugString();
+
+    double distance = 0.0;
+    EXPECT_TRUE(path.GetProjectionWithHint(query, &hint_segment, &accumulate_s,
+                                           &lateral, &distance));
+    EXPECT_DOUBLE_EQ(expected_s, accumulate_s) << query.DebugString();
+    EXPECT_DOUBLE_EQ(expected_l, lateral) << query.DebugString();
+  }
+}
+
 TEST(TestSuite, hdmap_path_get_smooth_point) {
   const double kRadius = 50.0;
   const int kNumSegments = 100;
@@ -16,11 +16,14 @@
 
 #pragma once
 
+#include <memory>
+
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/planning/common/ego_info.h"
 #include "modules/planning/common/frame.h"
 #include "modules/planning/common/history.h"
 #include "modules/planning/common/learning_based_data.h"
+#include "modules/planning/common/obstacle_boundary_cache.h"
 #include "modules/planning/common/planning_context.h"
 
 namespace apollo {
@@ -32,21 +35,42 @@ class DependencyInjector {
   ~DependencyInjector() = default;
 
   PlanningContext* planning_context() { return &planning_context_; }
-  FrameHistory* frame_history() { return &frame_history_; }
-  History* history() { return &history_; }
-  EgoInfo* ego_info() { return &ego_info_; }
+  FrameHistory* frame_history() {
+    return parent_ ? parent_->frame_history() : &frame_history_;
+  }
+  History* history() { return parent_ ? parent_->history() : &history_; }
+  EgoInfo* ego_info() { return parent_ ? parent_->ego_info() : &ego_info_; }
   apollo::common::VehicleStateProvider* vehicle_state() {
-    return &vehicle_state_;
+    return parent_ ? parent_->vehicle_state() : &vehicle_state_;
+  }
+  LearningBasedData* learning_based_data() {
+    return parent_ ? parent_->learning_based_data() : &learning_based_data_;
+  }
+  ObstacleBoundaryCache* obstacle_boundary_cache() {
+    return parent_ ? parent_->obstacle_boundary_cache()
+                   : &obstacle_boundary_cache_;
+  }
+
+  /**
+   * @brief An injector sharing everything with this one except the planning
+   * context, for tasks planning a reference line at the same time as others.
+   * The caller copies the planning status in and out around each run.
+   */
+  std::shared_ptr<DependencyInjector> Fork() {
+    auto fork = std::make_shared<DependencyInjector>();
+    fork->parent_ = this;
+    return fork;
   }
-  LearningBasedData* learning_based_data() { return &learning_based_data_; }
 
  private:
+  DependencyInjector* parent_ = nullptr;
   PlanningContext planning_context_;
   FrameHistory frame_history_;
   History history_;
   EgoInfo ego_info_;
   apollo::common::VehicleStateProvider vehicle_state_;
   LearningBasedData learning_based_data_;
+  ObstacleBoundaryCache obstacle_boundary_cache_;
 };
 
 }  // namespace planning
@@ -53,23 +53,46 @@ using apollo::prediction::PredictionObstacles;
 
 PadMessage::DrivingAction Frame::pad_msg_driving_action_ = PadMessage::NONE;
 
+namespace {
+
+std::shared_ptr<FrameArena> AcquireFrameArena() {
+  return FLAGS_enable_frame_arena ? FrameArena::Acquire() : nullptr;
+}
+
+std::pmr::memory_resource *FrameMemoryResource(FrameArena *arena) {
+  return arena != nullptr ? arena->resource()
+                          : std::pmr::get_default_resource();
+}
+
+}  // namespace
+
 FrameHistory::FrameHistory()
     : IndexedQueue<uint32_t, Frame>(FLAGS_max_frame_history_num) {}
 
 Frame::Frame(uint32_t sequence_num)
     : sequence_num_(sequence_num),
-      monitor_logger_buffer_(common::monitor::MonitorMessageItem::PLANNING) {}
+      arena_(AcquireFrameArena()),
+      obstacles_(FrameMemoryResource(arena_.get())),
+      traffic_lights_(FrameMemoryResource(arena_.get())),
+      monitor_logger_buffer_(common::monitor::MonitorMessageItem::PLANNING) {
+  InitArenaData();
+}
 
 Frame::Frame(uint32_t sequence_num, const LocalView &local_view,
              const common::TrajectoryPoint &planning_start_point,
              const common::VehicleState &vehicle_state,
              ReferenceLineProvider *reference_line_provider)
     : sequence_num_(sequence_num),
+      arena_(AcquireFrameArena()),
       local_view_(local_view),
       planning_start_point_(planning_start_point),
       vehicle_state_(vehicle_state),
+      obstacles_(FrameMemoryResource(arena_.get())),
+      traffic_lights_(FrameMemoryResource(arena_.get())),
       reference_line_provider_(reference_line_provider),
-      monitor_logger_buffer_(common::monitor::MonitorMessageItem::PLANNING) {}
+      monitor_logger_buffer_(common::monitor::MonitorMessageItem::PLANNING) {
+  InitArenaData();
+}
 
 Frame::Frame(uint32_t sequence_num, const LocalView &local_view,
              const common::TrajectoryPoint &planning_start_point,
@@ -77,6 +100,16 @@ Frame::Frame(uint32_t sequence_num, const LocalView &local_view,
     : Frame(sequence_num, local_view, planning_start_point, vehicle_state,
             nullptr) {}
 
+void Frame::InitArenaData() {
+  if (arena_ != nullptr) {
+    current_frame_planned_trajectory_ = arena_->CreateMessage<ADCTrajectory>();
+  } else {
+    owned_current_frame_planned_trajectory_ = std::make_unique<ADCTrajectory>();
+    current_frame_planned_trajectory_ =
+        owned_current_frame_planned_trajectory_.get();
+  }
+}
+
 const common::TrajectoryPoint &Frame::PlanningStartPoint() const {
   return planning_start_point_;
 }
@@ -169,7 +202,8 @@ bool Frame::CreateReferenceLineInfo(
       is_near_destination_ = true;
     }
     reference_line_info_.emplace_back(vehicle_state_, planning_start_point_,
-                                      *ref_line_iter, *segments_iter);
+                                      *ref_line_iter, *segments_iter,
+                                      FrameMemoryResource(arena_.get()));
     ++ref_line_iter;
     ++segments_iter;
   }
@@ -193,6 +227,7 @@ bool Frame::CreateReferenceLineInfo(
 
   bool has_valid_reference_line = false;
   for (auto &ref_info : reference_line_info_) {
+    ref_info.SetObstacleBoundaryCache(obstacle_boundary_cache_);
     if (!ref_info.Init(obstacles())) {
       AERROR << "Failed to init reference line";
     } else {
@@ -307,15 +342,19 @@ const Obstacle *Frame::CreateStaticObstacle(
 
 const Obstacle *Frame::CreateStaticVirtualObstacle(const std::string &id,
                                                    const Box2d &box) {
-  const auto *object = obstacles_.Find(id);
-  if (object) {
-    AWARN << "obstacle " << id << " already exist.";
-    return object;
-  }
-  auto *ptr =
-      obstacles_.Add(id, *Obstacle::CreateStaticVirtualObstacles(id, box));
+  // tasks on different reference lines may create the same stop obstacle
+  // concurrently, so find and add under one lock
+  bool created = false;
+  const auto *ptr = obstacles_.FindOrAdd(
+      id,
+      [&id, &box]() {
+        return *Obstacle::CreateStaticVirtualObstacles(id, box);
+      },
+      &created);
   if (!ptr) {
     AERROR << "Failed to create virtual obstacle " << id;
+  } else if (!created) {
+    AWARN << "obstacle " << id << " already exist.";
   }
   return ptr;
 }
@@ -361,9 +400,8 @@ Status Frame::InitFrameData(
          << FLAGS_align_prediction_time;
 
   if (FLAGS_align_prediction_time) {
-    auto prediction = *(local_view_.prediction_obstacles);
-    AlignPredictionTime(vehicle_state_.timestamp(), &prediction);
-    local_view_.prediction_obstacles->CopyFrom(prediction);
+    AlignPredictionTime(vehicle_state_.timestamp(),
+                        local_view_.prediction_obstacles.get());
   }
   for (auto &ptr :
        Obstacle::CreateObstacles(*local_view_.prediction_obstacles)) {
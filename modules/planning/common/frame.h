@@ -22,6 +22,8 @@
 
 #include <list>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -42,9 +44,11 @@
 #include "modules/common/monitor_log/monitor_log_buffer.h"
 #include "modules/common/status/status.h"
 #include "modules/planning/common/ego_info.h"
+#include "modules/planning/common/frame_arena.h"
 #include "modules/planning/common/indexed_queue.h"
 #include "modules/planning/common/local_view.h"
 #include "modules/planning/common/obstacle.h"
+#include "modules/planning/common/obstacle_boundary_cache.h"
 #include "modules/planning/common/open_space_info.h"
 #include "modules/planning/common/reference_line_info.h"
 #include "modules/planning/common/trajectory/publishable_trajectory.h"
@@ -132,13 +136,13 @@ class Frame {
       prediction::PredictionObstacles *prediction_obstacles);
 
   void set_current_frame_planned_trajectory(
-      ADCTrajectory current_frame_planned_trajectory) {
-    current_frame_planned_trajectory_ =
-        std::move(current_frame_planned_trajectory);
+      const ADCTrajectory &current_frame_planned_trajectory) {
+    current_frame_planned_trajectory_->CopyFrom(
+        current_frame_planned_trajectory);
   }
 
   const ADCTrajectory &current_frame_planned_trajectory() const {
-    return current_frame_planned_trajectory_;
+    return *current_frame_planned_trajectory_;
   }
 
   void set_current_frame_planned_path(
@@ -173,6 +177,21 @@ class Frame {
     return pad_msg_driving_action_;
   }
 
+  /**
+   * @brief The arena of the data of this frame, nullptr when
+   * FLAGS_enable_frame_arena is off.
+   */
+  FrameArena *arena() const { return arena_.get(); }
+
+  /**
+   * @brief The cache the reference line infos of this frame reuse obstacle
+   * boundaries from, set before Init. No cache is used by default.
+   */
+  void set_obstacle_boundary_cache(
+      ObstacleBoundaryCache *obstacle_boundary_cache) {
+    obstacle_boundary_cache_ = obstacle_boundary_cache;
+  }
+
  private:
   common::Status InitFrameData(
       const common::VehicleStateProvider *vehicle_state_provider,
@@ -197,6 +216,8 @@ class Frame {
 
   void AddObstacle(const Obstacle &obstacle);
 
+  void InitArenaData();
+
   void ReadTrafficLights();
 
   void ReadPadMsgDrivingAction();
@@ -209,6 +230,10 @@ class Frame {
  private:
   static PadMessage::DrivingAction pad_msg_driving_action_;
   uint32_t sequence_num_ = 0;
+  // shared with nothing else, it is returned to the pool of arenas when the
+  // frame is dropped from FrameHistory
+  std::shared_ptr<FrameArena> arena_;
+  ObstacleBoundaryCache *obstacle_boundary_cache_ = nullptr;
   LocalView local_view_;
   const hdmap::HDMap *hdmap_ = nullptr;
   common::TrajectoryPoint planning_start_point_;
@@ -222,13 +247,16 @@ class Frame {
    **/
   const ReferenceLineInfo *drive_reference_line_info_ = nullptr;
 
+  // with the obstacles of the reference line infos, on the arena when there
+  // is one
   ThreadSafeIndexedObstacles obstacles_;
 
-  std::unordered_map<std::string, const perception::TrafficLight *>
+  std::pmr::unordered_map<std::string, const perception::TrafficLight *>
       traffic_lights_;
 
-  // current frame published trajectory
-  ADCTrajectory current_frame_planned_trajectory_;
+  // current frame published trajectory, on the arena when there is one
+  ADCTrajectory *current_frame_planned_trajectory_ = nullptr;
+  std::unique_ptr<ADCTrajectory> owned_current_frame_planned_trajectory_;
 
   // current frame path for future possible speed fallback
   DiscretizedPath current_frame_planned_path_;
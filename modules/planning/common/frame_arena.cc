@@ -0,0 +1,157 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * @file frame_arena.cc
+ **/
+
+#include "modules/planning/common/frame_arena.h"
+
+#include <vector>
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// Sizes of the preallocated buffers of a new arena, enough for the per cycle
+// data of a usual urban scene. They grow to fit larger frames.
+constexpr size_t kInitialBufferSize = 256 * 1024;
+constexpr size_t kProtoInitialBlockSize = 256 * 1024;
+
+// Frames live on in FrameHistory after their cycle, so a few arenas are in use
+// at any time.
+constexpr size_t kMaxPooledArenas = 8;
+
+google::protobuf::ArenaOptions ProtoArenaOptions(char* initial_block,
+                                                 const size_t size) {
+  google::protobuf::ArenaOptions options;
+  options.initial_block = initial_block;
+  options.initial_block_size = size;
+  return options;
+}
+
+}  // namespace
+
+FrameArena::FrameArena()
+    : buffer_size_(kInitialBufferSize),
+      buffer_(new char[buffer_size_]),
+      heap_resource_(std::pmr::new_delete_resource()),
+      monotonic_resource_(std::in_place, buffer_.get(), buffer_size_,
+                          &heap_resource_),
+      counting_resource_(&*monotonic_resource_),
+      proto_block_size_(kProtoInitialBlockSize),
+      proto_initial_block_(new char[proto_block_size_]),
+      proto_arena_(std::in_place, ProtoArenaOptions(proto_initial_block_.get(),
+                                                    proto_block_size_)) {}
+
+std::shared_ptr<FrameArena> FrameArena::Acquire() {
+  // Never destroyed, arenas may be released after static destruction starts.
+  static auto* pool_mutex = new std::mutex();
+  static auto* pool = new std::vector<std::unique_ptr<FrameArena>>();
+
+  std::unique_ptr<FrameArena> arena;
+  {
+    std::lock_guard<std::mutex> lock(*pool_mutex);
+    if (!pool->empty()) {
+      arena = std::move(pool->back());
+      pool->pop_back();
+    }
+  }
+  if (arena == nullptr) {
+    arena.reset(new FrameArena());
+  }
+  return std::shared_ptr<FrameArena>(arena.release(), [](FrameArena* arena) {
+    arena->Reset();
+    std::lock_guard<std::mutex> lock(*pool_mutex);
+    if (pool->size() < kMaxPooledArenas) {
+      pool->emplace_back(arena);
+    } else {
+      delete arena;
+    }
+  });
+}
+
+void FrameArena::Reset() {
+  // the resources are rebuilt in place, counting_resource_ keeps pointing to
+  // the monotonic resource
+  const uint64_t heap_bytes = heap_resource_.allocated_bytes();
+  if (heap_bytes > 0) {
+    monotonic_resource_.reset();
+    buffer_size_ += heap_bytes;
+    buffer_.reset(new char[buffer_size_]);
+    monotonic_resource_.emplace(buffer_.get(), buffer_size_, &heap_resource_);
+  } else {
+    monotonic_resource_->release();
+  }
+  heap_resource_.Reset();
+  counting_resource_.Reset();
+
+  const uint64_t proto_space = proto_arena_->SpaceAllocated();
+  if (proto_space > proto_block_size_) {
+    proto_arena_.reset();
+    proto_block_size_ = proto_space;
+    proto_initial_block_.reset(new char[proto_block_size_]);
+    proto_arena_.emplace(
+        ProtoArenaOptions(proto_initial_block_.get(), proto_block_size_));
+  } else {
+    proto_arena_->Reset();
+  }
+}
+
+void FrameArena::RecordStats(FrameArenaStats* stats) const {
+  stats->set_num_allocations(counting_resource_.num_allocations());
+  stats->set_allocated_bytes(counting_resource_.allocated_bytes());
+  stats->set_proto_arena_bytes(proto_arena_->SpaceUsed());
+  const uint64_t proto_space = proto_arena_->SpaceAllocated();
+  stats->set_heap_allocated_bytes(
+      heap_resource_.allocated_bytes() +
+      (proto_space > proto_block_size_ ? proto_space - proto_block_size_ : 0));
+}
+
+uint64_t FrameArena::CountingResource::num_allocations() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_allocations_;
+}
+
+uint64_t FrameArena::CountingResource::allocated_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return allocated_bytes_;
+}
+
+void FrameArena::CountingResource::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_allocations_ = 0;
+  allocated_bytes_ = 0;
+}
+
+void* FrameArena::CountingResource::do_allocate(std::size_t bytes,
+                                                std::size_t alignment) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++num_allocations_;
+  allocated_bytes_ += bytes;
+  return upstream_->allocate(bytes, alignment);
+}
+
+void FrameArena::CountingResource::do_deallocate(void* p, std::size_t bytes,
+                                                 std::size_t alignment) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  upstream_->deallocate(p, bytes, alignment);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,126 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+/**
+ * @file frame_arena.h
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+
+#include "google/protobuf/arena.h"
+
+#include "modules/common_msgs/planning_msgs/planning.pb.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class FrameArena
+ * @brief Memory for the objects that live as long as one planning Frame: a
+ * protobuf Arena for messages and a monotonic memory resource for planning
+ * owned std::pmr containers. Nothing is freed one object at a time, all of it
+ * is released at once when the frame is destroyed.
+ *
+ * Both are served from buffers preallocated by the arena and reused by every
+ * frame. Only what does not fit is taken from the heap, and on Reset the
+ * buffers grow by that much, so a frame no larger than the ones before it
+ * does not allocate from the heap.
+ */
+class FrameArena {
+ public:
+  FrameArena();
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  /**
+   * @brief Get an arena from the pool of arenas released by destroyed frames,
+   * or a new one. It is reset and returned to the pool when the last owner
+   * lets it go.
+   */
+  static std::shared_ptr<FrameArena> Acquire();
+
+  template <typename T>
+  T* CreateMessage() {
+    return google::protobuf::Arena::CreateMessage<T>(&*proto_arena_);
+  }
+
+  google::protobuf::Arena* proto_arena() { return &*proto_arena_; }
+
+  /**
+   * @brief The memory resource for std::pmr containers. It can be used from
+   * several threads.
+   */
+  std::pmr::memory_resource* resource() { return &counting_resource_; }
+
+  /**
+   * @brief Release everything allocated from the arena, and grow the
+   * preallocated buffers if the frame did not fit into them.
+   */
+  void Reset();
+
+  void RecordStats(FrameArenaStats* stats) const;
+
+ private:
+  // Counts the allocations made from its upstream and serializes them, since
+  // monotonic_buffer_resource is not thread safe.
+  class CountingResource : public std::pmr::memory_resource {
+   public:
+    explicit CountingResource(std::pmr::memory_resource* upstream)
+        : upstream_(upstream) {}
+
+    uint64_t num_allocations() const;
+    uint64_t allocated_bytes() const;
+    void Reset();
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_ = nullptr;
+    mutable std::mutex mutex_;
+    uint64_t num_allocations_ = 0;
+    uint64_t allocated_bytes_ = 0;
+  };
+
+  // release() returns the monotonic resource to the start of buffer_, the
+  // blocks it took from the heap when buffer_ was full are freed.
+  size_t buffer_size_ = 0;
+  std::unique_ptr<char[]> buffer_;
+  CountingResource heap_resource_;
+  std::optional<std::pmr::monotonic_buffer_resource> monotonic_resource_;
+  CountingResource counting_resource_;
+
+  // Reset keeps the initial block of the protobuf arena, and frees the rest.
+  size_t proto_block_size_ = 0;
+  std::unique_ptr<char[]> proto_initial_block_;
+  std::optional<google::protobuf::Arena> proto_arena_;
+};
+
+}  // namespace planning
+}  // namespace apollo
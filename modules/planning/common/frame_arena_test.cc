@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/common/frame_arena.h"
+
+#include <memory_resource>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+TEST(FrameArenaTest, CountsAllocations) {
+  FrameArena arena;
+  std::pmr::vector<double> values(arena.resource());
+  values.reserve(100);
+
+  FrameArenaStats stats;
+  arena.RecordStats(&stats);
+  EXPECT_EQ(1, stats.num_allocations());
+  EXPECT_EQ(100 * sizeof(double), stats.allocated_bytes());
+}
+
+TEST(FrameArenaTest, CreateMessage) {
+  FrameArena arena;
+  auto* trajectory = arena.CreateMessage<ADCTrajectory>();
+  ASSERT_NE(nullptr, trajectory);
+  EXPECT_EQ(arena.proto_arena(), trajectory->GetArena());
+  for (int i = 0; i < 100; ++i) {
+    trajectory->add_trajectory_point()->set_v(i);
+  }
+
+  FrameArenaStats stats;
+  arena.RecordStats(&stats);
+  EXPECT_GT(stats.proto_arena_bytes(), 0);
+}
+
+TEST(FrameArenaTest, Reset) {
+  FrameArena arena;
+  {
+    std::pmr::vector<int> values(arena.resource());
+    values.resize(1000);
+  }
+  arena.CreateMessage<ADCTrajectory>()->add_trajectory_point();
+  arena.Reset();
+
+  FrameArenaStats stats;
+  arena.RecordStats(&stats);
+  EXPECT_EQ(0, stats.num_allocations());
+  EXPECT_EQ(0, stats.allocated_bytes());
+  EXPECT_EQ(0, stats.proto_arena_bytes());
+}
+
+TEST(FrameArenaTest, NoHeapAllocationsOnSecondCycle) {
+  FrameArena arena;
+  // larger than the preallocated buffers
+  const auto run_cycle = [&arena]() {
+    std::pmr::vector<std::pmr::vector<double>> rows(arena.resource());
+    for (int i = 0; i < 100; ++i) {
+      rows.emplace_back(1000, static_cast<double>(i));
+    }
+    auto* trajectory = arena.CreateMessage<ADCTrajectory>();
+    for (int i = 0; i < 5000; ++i) {
+      trajectory->add_trajectory_point()->mutable_path_point()->set_s(i);
+    }
+    FrameArenaStats stats;
+    arena.RecordStats(&stats);
+    return stats;
+  };
+
+  const auto first = run_cycle();
+  EXPECT_GT(first.heap_allocated_bytes(), 0);
+  arena.Reset();
+
+  const auto second = run_cycle();
+  EXPECT_EQ(first.num_allocations(), second.num_allocations());
+  EXPECT_EQ(first.allocated_bytes(), second.allocated_bytes());
+  EXPECT_EQ(0, second.heap_allocated_bytes());
+  arena.Reset();
+
+  const auto third = run_cycle();
+  EXPECT_EQ(0, third.heap_allocated_bytes());
+}
+
+TEST(FrameArenaTest, Acquire) {
+  FrameArena* released = nullptr;
+  {
+    auto arena = FrameArena::Acquire();
+    std::pmr::vector<int> values({1, 2, 3}, arena->resource());
+    released = arena.get();
+  }
+  auto arena = FrameArena::Acquire();
+  EXPECT_EQ(released, arena.get());
+
+  FrameArenaStats stats;
+  arena->RecordStats(&stats);
+  EXPECT_EQ(0, stats.num_allocations());
+}
+
+}  // namespace planning
+}  // namespace apollo
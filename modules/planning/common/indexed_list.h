@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <unordered_map>
 #include <vector>
 
@@ -34,6 +35,15 @@ namespace planning {
 template <typename I, typename T>
 class IndexedList {
  public:
+  IndexedList() = default;
+
+  /**
+   * @brief The objects are stored in memory from the resource, which must
+   * outlive the container. Copies of the container use the default resource.
+   */
+  explicit IndexedList(std::pmr::memory_resource* resource)
+      : object_dict_(resource) {}
+
   /**
    * @brief copy object into the container. If the id is already exist,
    * overwrite the object in the container.
@@ -86,7 +96,7 @@ class IndexedList {
    * @brief List all the items in the container.
    * @return the unordered_map of ids and objects in the container.
    */
-  const std::unordered_map<I, T>& Dict() const { return object_dict_; }
+  const std::pmr::unordered_map<I, T>& Dict() const { return object_dict_; }
 
   /**
    * @brief Copy the container with objects.
@@ -102,12 +112,17 @@ class IndexedList {
 
  private:
   std::vector<const T*> object_list_;
-  std::unordered_map<I, T> object_dict_;
+  std::pmr::unordered_map<I, T> object_dict_;
 };
 
 template <typename I, typename T>
 class ThreadSafeIndexedList : public IndexedList<I, T> {
  public:
+  ThreadSafeIndexedList() = default;
+
+  explicit ThreadSafeIndexedList(std::pmr::memory_resource* resource)
+      : IndexedList<I, T>(resource) {}
+
   T* Add(const I id, const T& object) {
     boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
     return IndexedList<I, T>::Add(id, object);
@@ -118,6 +133,29 @@ class ThreadSafeIndexedList : public IndexedList<I, T> {
     return IndexedList<I, T>::Find(id);
   }
 
+  /**
+   * @brief Find object by id in the container, or copy the object returned
+   * by create into the container if there is none. The lookup and the
+   * insertion are done under one writer lock, so concurrent callers with the
+   * same id get the same object.
+   * @param id the id of the object
+   * @param create called only when the id is not in the container.
+   * @param created set to whether the object was added, may be nullptr.
+   * @return The pointer to the object in the container.
+   */
+  template <typename Creator>
+  T* FindOrAdd(const I id, const Creator& create, bool* created = nullptr) {
+    boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
+    auto* obj = IndexedList<I, T>::Find(id);
+    if (created != nullptr) {
+      *created = obj == nullptr;
+    }
+    if (obj != nullptr) {
+      return obj;
+    }
+    return IndexedList<I, T>::Add(id, create());
+  }
+
   std::vector<const T*> Items() const {
     boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
     return IndexedList<I, T>::Items();
@@ -20,6 +20,12 @@
 
 #include "modules/planning/common/indexed_list.h"
 
+#include <atomic>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "modules/common/util/util.h"
@@ -78,5 +84,71 @@ TEST(IndexedList, Copy) {
   ASSERT_EQ(nullptr, a_object.Find(4));
 }
 
+TEST(IndexedList, MemoryResource) {
+  char buffer[4096];
+  std::pmr::monotonic_buffer_resource resource(
+      buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  StringIndexedList object(&resource);
+  const auto* one = object.Add(1, "one");
+  ASSERT_NE(nullptr, one);
+  EXPECT_GE(reinterpret_cast<const char*>(one), buffer);
+  EXPECT_LT(reinterpret_cast<const char*>(one), buffer + sizeof(buffer));
+  ASSERT_EQ(1, object.Items().size());
+
+  // copies do not share the memory of the copied container
+  StringIndexedList copy(object);
+  EXPECT_EQ(std::pmr::get_default_resource(),
+            copy.Dict().get_allocator().resource());
+  ASSERT_NE(nullptr, copy.Find(1));
+  EXPECT_EQ("one", *copy.Find(1));
+}
+
+TEST(ThreadSafeIndexedList, FindOrAdd) {
+  ThreadSafeIndexedList<int, std::string> object;
+  bool created = false;
+  const auto* one =
+      object.FindOrAdd(1, []() { return std::string("one"); }, &created);
+  ASSERT_NE(nullptr, one);
+  EXPECT_TRUE(created);
+  EXPECT_EQ("one", *one);
+  const auto* one_again =
+      object.FindOrAdd(1, []() { return std::string("uno"); }, &created);
+  EXPECT_FALSE(created);
+  EXPECT_EQ(one, one_again);
+  EXPECT_EQ("one", *one_again);
+}
+
+TEST(ThreadSafeIndexedList, ConcurrentFindOrAdd) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIds = 100;
+  ThreadSafeIndexedList<int, std::string> object;
+  std::atomic<int> num_created(0);
+  std::vector<std::vector<const std::string*>> found(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&object, &num_created, &found, t]() {
+      for (int id = 0; id < kNumIds; ++id) {
+        bool created = false;
+        found[t].push_back(object.FindOrAdd(
+            id, [id]() { return std::to_string(id); }, &created));
+        if (created) {
+          ++num_created;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kNumIds, num_created.load());
+  EXPECT_EQ(kNumIds, object.Items().size());
+  for (int t = 0; t < kNumThreads; ++t) {
+    for (int id = 0; id < kNumIds; ++id) {
+      EXPECT_EQ(found[0][id], found[t][id]);
+      EXPECT_EQ(std::to_string(id), *found[t][id]);
+    }
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
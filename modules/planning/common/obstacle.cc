@@ -313,24 +313,9 @@ double Obstacle::MinRadiusStopDistance(
 
 void Obstacle::BuildReferenceLineStBoundary(const ReferenceLine& reference_line,
                                             const double adc_start_s) {
-  const auto& adc_param =
-      VehicleConfigHelper::Instance()->GetConfig().vehicle_param();
-  const double half_adc_width = adc_param.width() / 2;
-  if (is_static_ || trajectory_.trajectory_point().empty()) {
-    std::vector<std::pair<STPoint, STPoint>> point_pairs;
-    double start_s = sl_boundary_.start_s();
-    double end_s = sl_boundary_.end_s();
-    if (end_s - start_s < kStBoundaryDeltaS) {
-      end_s = start_s + kStBoundaryDeltaS;
-    }
-    if (!reference_line.IsBlockRoad(perception_bounding_box_, half_adc_width)) {
-      return;
-    }
-    point_pairs.emplace_back(STPoint(start_s - adc_start_s, 0.0),
-                             STPoint(end_s - adc_start_s, 0.0));
-    point_pairs.emplace_back(STPoint(start_s - adc_start_s, FLAGS_st_max_t),
-                             STPoint(end_s - adc_start_s, FLAGS_st_max_t));
-    reference_line_st_boundary_ = STBoundary(point_pairs);
+  if (HasStaticReferenceLineStBoundary()) {
+    BuildStaticReferenceLineStBoundary(IsBlockingReferenceLine(reference_line),
+                                       adc_start_s);
   } else {
     if (BuildTrajectoryStBoundary(reference_line, adc_start_s,
                                   &reference_line_st_boundary_)) {
@@ -345,6 +330,36 @@ void Obstacle::BuildReferenceLineStBoundary(const ReferenceLine& reference_line,
   }
 }
 
+bool Obstacle::HasStaticReferenceLineStBoundary() const {
+  return is_static_ || trajectory_.trajectory_point().empty();
+}
+
+bool Obstacle::IsBlockingReferenceLine(
+    const ReferenceLine& reference_line) const {
+  const auto& adc_param =
+      VehicleConfigHelper::Instance()->GetConfig().vehicle_param();
+  const double half_adc_width = adc_param.width() / 2;
+  return reference_line.IsBlockRoad(perception_bounding_box_, half_adc_width);
+}
+
+void Obstacle::BuildStaticReferenceLineStBoundary(const bool is_blocking,
+                                                  const double adc_start_s) {
+  std::vector<std::pair<STPoint, STPoint>> point_pairs;
+  double start_s = sl_boundary_.start_s();
+  double end_s = sl_boundary_.end_s();
+  if (end_s - start_s < kStBoundaryDeltaS) {
+    end_s = start_s + kStBoundaryDeltaS;
+  }
+  if (!is_blocking) {
+    return;
+  }
+  point_pairs.emplace_back(STPoint(start_s - adc_start_s, 0.0),
+                           STPoint(end_s - adc_start_s, 0.0));
+  point_pairs.emplace_back(STPoint(start_s - adc_start_s, FLAGS_st_max_t),
+                           STPoint(end_s - adc_start_s, FLAGS_st_max_t));
+  reference_line_st_boundary_ = STBoundary(point_pairs);
+}
+
 bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
                                          const double adc_start_s,
                                          STBoundary* const st_boundary) {
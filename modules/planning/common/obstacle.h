@@ -198,6 +198,25 @@ class Obstacle {
   void BuildReferenceLineStBoundary(const ReferenceLine& reference_line,
                                     const double adc_start_s);
 
+  /**
+   * @brief Whether the reference line st boundary is built from the sl
+   * boundary only, i.e. the obstacle is static or has no trajectory.
+   */
+  bool HasStaticReferenceLineStBoundary() const;
+
+  /**
+   * @brief Whether a static obstacle blocks the reference line, and so gets
+   * a reference line st boundary.
+   */
+  bool IsBlockingReferenceLine(const ReferenceLine& reference_line) const;
+
+  /**
+   * @brief Build the reference line st boundary of a static obstacle from
+   * its sl boundary, with the result of IsBlockingReferenceLine.
+   */
+  void BuildStaticReferenceLineStBoundary(const bool is_blocking,
+                                          const double adc_start_s);
+
   void SetPerceptionSlBoundary(const SLBoundary& sl_boundary);
 
   /**
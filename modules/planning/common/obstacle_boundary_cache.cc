@@ -0,0 +1,212 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/common/obstacle_boundary_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "modules/common/math/math_utils.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+// distance between the points sampled to match reference lines
+constexpr double kAnchorSpacing = 10.0;
+// boundaries are computed again after being shifted this many times, so
+// that the errors of the shifts within tolerance don't add up
+constexpr int kMaxReuses = 10;
+}  // namespace
+
+void ObstacleBoundaryCache::StartCycle() {
+  last_lines_ = std::move(lines_);
+  lines_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_queries_ = 0;
+  num_hits_ = 0;
+  num_matched_lines_ = 0;
+}
+
+int ObstacleBoundaryCache::AddReferenceLine(
+    const ReferenceLine& reference_line) {
+  Line line;
+  const double length = reference_line.Length();
+  for (double s = 0.0; s < length; s += kAnchorSpacing) {
+    const auto ref_point = reference_line.GetReferencePoint(s);
+    line.anchors.push_back({ref_point.x(), ref_point.y(), s});
+  }
+  const auto end_point = reference_line.GetReferencePoint(length);
+  line.anchors.push_back({end_point.x(), end_point.y(), length});
+
+  for (size_t i = 0; i < last_lines_.size(); ++i) {
+    if (MatchLine(last_lines_[i], reference_line, &line)) {
+      line.last_line_index = static_cast<int>(i);
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++num_matched_lines_;
+      break;
+    }
+  }
+  lines_.push_back(std::move(line));
+  return static_cast<int>(lines_.size()) - 1;
+}
+
+bool ObstacleBoundaryCache::MatchLine(const Line& last_line,
+                                      const ReferenceLine& reference_line,
+                                      Line* const line) const {
+  const double tolerance = FLAGS_obstacle_boundary_cache_tolerance;
+  const double length = reference_line.Length();
+  double min_s = std::numeric_limits<double>::max();
+  double max_s = std::numeric_limits<double>::lowest();
+  double delta_s = 0.0;
+  int num_covered_anchors = 0;
+  for (const auto& anchor : last_line.anchors) {
+    common::SLPoint sl_point;
+    if (!reference_line.XYToSL(common::math::Vec2d(anchor.x, anchor.y),
+                               &sl_point)) {
+      return false;
+    }
+    if (sl_point.s() < 0.0 || sl_point.s() > length) {
+      continue;
+    }
+    // a sample the new line covers but does not go through, the geometry
+    // has changed
+    if (std::fabs(sl_point.l()) > tolerance) {
+      return false;
+    }
+    const double anchor_delta_s = anchor.s - sl_point.s();
+    if (num_covered_anchors == 0) {
+      delta_s = anchor_delta_s;
+    } else if (std::fabs(anchor_delta_s - delta_s) > tolerance) {
+      return false;
+    }
+    min_s = std::fmin(min_s, anchor.s);
+    max_s = std::fmax(max_s, anchor.s);
+    ++num_covered_anchors;
+  }
+  if (num_covered_anchors < 2) {
+    return false;
+  }
+  line->delta_s = delta_s;
+  line->min_s = min_s;
+  line->max_s = max_s;
+  return true;
+}
+
+bool ObstacleBoundaryCache::IsSameObstacle(const Entry& entry,
+                                           const Obstacle& obstacle) const {
+  const double tolerance = FLAGS_obstacle_boundary_cache_tolerance;
+  const auto& box = obstacle.PerceptionBoundingBox();
+  return entry.is_static == obstacle.IsStatic() &&
+         std::fabs(entry.center_x - box.center_x()) <= tolerance &&
+         std::fabs(entry.center_y - box.center_y()) <= tolerance &&
+         std::fabs(entry.length - box.length()) <= tolerance &&
+         std::fabs(entry.width - box.width()) <= tolerance &&
+         std::fabs(common::math::NormalizeAngle(entry.heading -
+                                                box.heading())) <= tolerance;
+}
+
+bool ObstacleBoundaryCache::GetBoundaries(const int line_index,
+                                          const Obstacle& obstacle,
+                                          Boundaries* const boundaries) {
+  CHECK_GE(line_index, 0);
+  CHECK_LT(static_cast<size_t>(line_index), lines_.size());
+  const Line& line = lines_[line_index];
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_queries_;
+  }
+  if (line.last_line_index < 0) {
+    return false;
+  }
+  const Line& last_line = last_lines_[line.last_line_index];
+  const auto iter = last_line.entries.find(obstacle.Id());
+  if (iter == last_line.entries.end()) {
+    return false;
+  }
+  const Entry& entry = iter->second;
+  const auto& sl_boundary = entry.boundaries.perception_sl_boundary;
+  if (entry.num_reuses >= kMaxReuses || !IsSameObstacle(entry, obstacle) ||
+      sl_boundary.start_s() < line.min_s || sl_boundary.end_s() > line.max_s) {
+    return false;
+  }
+
+  *boundaries = entry.boundaries;
+  auto* perception_sl_boundary = &boundaries->perception_sl_boundary;
+  perception_sl_boundary->set_start_s(sl_boundary.start_s() - line.delta_s);
+  perception_sl_boundary->set_end_s(sl_boundary.end_s() - line.delta_s);
+  for (auto& point : *perception_sl_boundary->mutable_boundary_point()) {
+    point.set_s(point.s() - line.delta_s);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++num_hits_;
+  return true;
+}
+
+void ObstacleBoundaryCache::SetBoundaries(const int line_index,
+                                          const Obstacle& obstacle,
+                                          const Boundaries& boundaries,
+                                          const bool is_reused) {
+  CHECK_GE(line_index, 0);
+  CHECK_LT(static_cast<size_t>(line_index), lines_.size());
+  Line& line = lines_[line_index];
+
+  Entry entry;
+  entry.boundaries = boundaries;
+  if (is_reused) {
+    // keep the state the boundaries were computed from, so that an obstacle
+    // creeping by less than the tolerance per cycle is eventually updated
+    const Line& last_line = last_lines_[line.last_line_index];
+    const Entry& last_entry = last_line.entries.at(obstacle.Id());
+    entry.center_x = last_entry.center_x;
+    entry.center_y = last_entry.center_y;
+    entry.heading = last_entry.heading;
+    entry.length = last_entry.length;
+    entry.width = last_entry.width;
+    entry.num_reuses = last_entry.num_reuses + 1;
+  } else {
+    const auto& box = obstacle.PerceptionBoundingBox();
+    entry.center_x = box.center_x();
+    entry.center_y = box.center_y();
+    entry.heading = box.heading();
+    entry.length = box.length();
+    entry.width = box.width();
+  }
+  entry.is_static = obstacle.IsStatic();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  line.entries[obstacle.Id()] = std::move(entry);
+}
+
+void ObstacleBoundaryCache::RecordStats(
+    ObstacleBoundaryCacheStats* const stats) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats->set_num_queries(num_queries_);
+  stats->set_num_hits(num_hits_);
+  stats->set_num_reference_lines(lines_.size());
+  stats->set_num_matched_reference_lines(num_matched_lines_);
+}
+
+}  // namespace planning
+}  // namespace apollo
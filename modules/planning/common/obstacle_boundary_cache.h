@@ -0,0 +1,141 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/common_msgs/planning_msgs/planning.pb.h"
+#include "modules/common_msgs/planning_msgs/sl_boundary.pb.h"
+
+#include "modules/planning/common/obstacle.h"
+#include "modules/planning/reference_line/reference_line.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class ObstacleBoundaryCache
+ * @brief Keeps the reference line boundaries of the obstacles of the last
+ * planning cycle, so that an obstacle whose perception box and static state
+ * are unchanged within FLAGS_obstacle_boundary_cache_tolerance reuses them on
+ * a reference line with the same geometry, instead of projecting its box
+ * again.
+ *
+ * Reference lines are matched across cycles by projecting points sampled
+ * along the last cycle's line onto the new one: every sample the new line
+ * covers must lie on it, and all of them must agree on the shift of the s
+ * axis. Only obstacles lying on the matched part of the line are reused.
+ */
+class ObstacleBoundaryCache {
+ public:
+  // The boundaries of an obstacle on a reference line, in the s of that line.
+  struct Boundaries {
+    SLBoundary perception_sl_boundary;
+    // whether a static obstacle blocks the reference line, only known when
+    // its reference line st boundary was built
+    bool has_is_blocking = false;
+    bool is_blocking = false;
+  };
+
+  ObstacleBoundaryCache() = default;
+
+  /**
+   * @brief Starts a planning cycle: the reference lines and boundaries added
+   * in the last cycle become the ones to reuse, and the stats are cleared.
+   */
+  void StartCycle();
+
+  /**
+   * @brief Adds a reference line of this cycle and matches it with the lines
+   * of the last cycle. Not thread safe, call it before adding obstacles.
+   * @return The index of the line for the lookups.
+   */
+  int AddReferenceLine(const ReferenceLine& reference_line);
+
+  /**
+   * @brief Looks up the boundaries of an obstacle computed in the last cycle
+   * and shifts them onto the reference line. Thread safe.
+   */
+  bool GetBoundaries(const int line_index, const Obstacle& obstacle,
+                     Boundaries* const boundaries);
+
+  /**
+   * @brief Records the boundaries of an obstacle on the reference line, for
+   * the next cycle. Thread safe.
+   * @param is_reused Whether the boundaries come from GetBoundaries.
+   */
+  void SetBoundaries(const int line_index, const Obstacle& obstacle,
+                     const Boundaries& boundaries, const bool is_reused);
+
+  void RecordStats(ObstacleBoundaryCacheStats* const stats) const;
+
+ private:
+  struct Anchor {
+    double x = 0.0;
+    double y = 0.0;
+    double s = 0.0;
+  };
+
+  struct Entry {
+    // the obstacle state the boundaries were computed from
+    double center_x = 0.0;
+    double center_y = 0.0;
+    double heading = 0.0;
+    double length = 0.0;
+    double width = 0.0;
+    bool is_static = false;
+    // number of cycles the boundaries were reused since computed
+    int num_reuses = 0;
+    Boundaries boundaries;
+  };
+
+  struct Line {
+    std::vector<Anchor> anchors;
+    std::unordered_map<std::string, Entry> entries;
+    // the line of the last cycle this one matches, and the s on it minus
+    // the s on this line; only obstacles within [min_s, max_s] of the last
+    // line are reused
+    int last_line_index = -1;
+    double delta_s = 0.0;
+    double min_s = 0.0;
+    double max_s = 0.0;
+  };
+
+  bool MatchLine(const Line& last_line, const ReferenceLine& reference_line,
+                 Line* const line) const;
+
+  bool IsSameObstacle(const Entry& entry, const Obstacle& obstacle) const;
+
+  std::vector<Line> last_lines_;
+  std::vector<Line> lines_;
+
+  mutable std::mutex mutex_;
+  uint64_t num_queries_ = 0;
+  uint64_t num_hits_ = 0;
+  uint64_t num_matched_lines_ = 0;
+};
+
+}  // namespace planning
+}  // namespace apollo
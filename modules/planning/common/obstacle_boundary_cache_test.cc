@@ -0,0 +1,126 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/common/obstacle_boundary_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// a straight reference line along y = l from x = start_x to x = end_x
+ReferenceLine MakeReferenceLine(const double start_x, const double end_x,
+                                const double l) {
+  std::vector<ReferencePoint> ref_points;
+  for (double x = start_x; x <= end_x; x += 1.0) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(common::math::Vec2d(x, l), 0.0), 0.0, 0.0);
+  }
+  return ReferenceLine(ref_points);
+}
+
+Obstacle MakeObstacle(const double x, const double y) {
+  perception::PerceptionObstacle perception_obstacle;
+  perception_obstacle.set_id(1);
+  perception_obstacle.mutable_position()->set_x(x);
+  perception_obstacle.mutable_position()->set_y(y);
+  perception_obstacle.set_theta(0.0);
+  perception_obstacle.set_length(4.0);
+  perception_obstacle.set_width(2.0);
+  perception_obstacle.set_height(1.5);
+  return Obstacle("1", perception_obstacle,
+                  prediction::ObstaclePriority::NORMAL, true);
+}
+
+ObstacleBoundaryCache::Boundaries MakeBoundaries(const double start_s,
+                                                 const double end_s) {
+  ObstacleBoundaryCache::Boundaries boundaries;
+  boundaries.perception_sl_boundary.set_start_s(start_s);
+  boundaries.perception_sl_boundary.set_end_s(end_s);
+  boundaries.perception_sl_boundary.set_start_l(-1.0);
+  boundaries.perception_sl_boundary.set_end_l(1.0);
+  boundaries.has_is_blocking = true;
+  boundaries.is_blocking = true;
+  return boundaries;
+}
+
+}  // namespace
+
+TEST(ObstacleBoundaryCacheTest, reuse_on_shifted_reference_line) {
+  ObstacleBoundaryCache cache;
+  const Obstacle obstacle = MakeObstacle(52.0, 0.0);
+  ObstacleBoundaryCache::Boundaries boundaries;
+
+  cache.StartCycle();
+  int line_index = cache.AddReferenceLine(MakeReferenceLine(0.0, 100.0, 0.0));
+  EXPECT_FALSE(cache.GetBoundaries(line_index, obstacle, &boundaries));
+  cache.SetBoundaries(line_index, obstacle, MakeBoundaries(50.0, 54.0), false);
+
+  // the line of the next cycle starts 5m further
+  cache.StartCycle();
+  line_index = cache.AddReferenceLine(MakeReferenceLine(5.0, 105.0, 0.0));
+  ASSERT_TRUE(cache.GetBoundaries(line_index, obstacle, &boundaries));
+  EXPECT_NEAR(45.0, boundaries.perception_sl_boundary.start_s(), 1e-6);
+  EXPECT_NEAR(49.0, boundaries.perception_sl_boundary.end_s(), 1e-6);
+  EXPECT_DOUBLE_EQ(-1.0, boundaries.perception_sl_boundary.start_l());
+  EXPECT_DOUBLE_EQ(1.0, boundaries.perception_sl_boundary.end_l());
+  EXPECT_TRUE(boundaries.has_is_blocking);
+  EXPECT_TRUE(boundaries.is_blocking);
+  cache.SetBoundaries(line_index, obstacle, boundaries, true);
+
+  ObstacleBoundaryCacheStats stats;
+  cache.RecordStats(&stats);
+  EXPECT_EQ(1U, stats.num_queries());
+  EXPECT_EQ(1U, stats.num_hits());
+  EXPECT_EQ(1U, stats.num_reference_lines());
+  EXPECT_EQ(1U, stats.num_matched_reference_lines());
+
+  // the obstacle moved
+  cache.StartCycle();
+  line_index = cache.AddReferenceLine(MakeReferenceLine(5.0, 105.0, 0.0));
+  EXPECT_FALSE(
+      cache.GetBoundaries(line_index, MakeObstacle(52.5, 0.0), &boundaries));
+}
+
+TEST(ObstacleBoundaryCacheTest, no_reuse_on_changed_reference_line) {
+  ObstacleBoundaryCache cache;
+  const Obstacle obstacle = MakeObstacle(52.0, 0.0);
+  ObstacleBoundaryCache::Boundaries boundaries;
+
+  cache.StartCycle();
+  int line_index = cache.AddReferenceLine(MakeReferenceLine(0.0, 100.0, 0.0));
+  cache.SetBoundaries(line_index, obstacle, MakeBoundaries(50.0, 54.0), false);
+
+  // a line of a neighbor lane
+  cache.StartCycle();
+  line_index = cache.AddReferenceLine(MakeReferenceLine(0.0, 100.0, 3.5));
+  EXPECT_FALSE(cache.GetBoundaries(line_index, obstacle, &boundaries));
+
+  ObstacleBoundaryCacheStats stats;
+  cache.RecordStats(&stats);
+  EXPECT_EQ(1U, stats.num_queries());
+  EXPECT_EQ(0U, stats.num_hits());
+  EXPECT_EQ(0U, stats.num_matched_reference_lines());
+}
+
+}  // namespace planning
+}  // namespace apollo
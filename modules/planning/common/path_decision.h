@@ -21,6 +21,7 @@
 #pragma once
 
 #include <limits>
+#include <memory_resource>
 #include <string>
 
 #include "modules/common_msgs/planning_msgs/decision.pb.h"
@@ -40,6 +41,12 @@ class PathDecision {
  public:
   PathDecision() = default;
 
+  /**
+   * @brief The obstacles are copied into memory from the resource.
+   */
+  explicit PathDecision(std::pmr::memory_resource *resource)
+      : obstacles_(resource) {}
+
   Obstacle *AddObstacle(const Obstacle &obstacle);
 
   const IndexedList<std::string, Obstacle> &obstacles() const;
@@ -25,6 +25,17 @@ DEFINE_int32(planning_loop_rate, 10, "Loop rate for planning node");
 DEFINE_int32(history_max_record_num, 5,
              "the number of planning history frame to keep");
 DEFINE_int32(max_frame_history_num, 1, "The maximum history frame number");
+DEFINE_bool(enable_frame_arena, false,
+            "Allocate the per cycle data of the planning frame from an arena "
+            "that is released at once when the frame leaves the history.");
+DEFINE_bool(enable_obstacle_boundary_cache, false,
+            "Reuse the sl boundaries and the static st boundaries of the "
+            "obstacles of the last cycle for obstacles which haven't moved on "
+            "reference lines which haven't changed.");
+DEFINE_double(obstacle_boundary_cache_tolerance, 0.02,
+              "The distance in meters and heading difference in radians "
+              "within which obstacles and reference lines are taken as "
+              "unchanged by the obstacle boundary cache.");
 
 // scenario related
 DEFINE_string(scenario_bare_intersection_unprotected_config_file,
@@ -155,6 +166,11 @@ DEFINE_double(reference_line_stitch_overlap_distance, 20,
 
 DEFINE_bool(enable_smooth_reference_line, true,
             "enable smooth the map reference line");
+DEFINE_bool(enable_incremental_reference_line_smoothing, false,
+            "When stitching, keep every anchor point of the extended reference "
+            "line that falls on the previous reference line fixed to it and "
+            "project along the lines with hinted search windows. Only used "
+            "with the discrete points smoother.");
 
 DEFINE_bool(prioritize_change_lane, false,
             "change lane strategy has higher priority, always use a valid "
@@ -326,6 +342,15 @@ DEFINE_bool(use_multi_thread_to_add_obstacles, false,
             "use multiple thread to add obstacles.");
 DEFINE_bool(enable_multi_thread_in_dp_st_graph, false,
             "Enable multiple thread to calculation curve cost in dp_st_graph.");
+DEFINE_bool(enable_dp_st_graph_cost_tables, true,
+            "Calculate the obstacle costs of dp_st_graph a column at a time "
+            "and prune the predecessors of a point by their acceleration "
+            "before evaluating their costs, with the same results.");
+DEFINE_bool(enable_parallel_reference_line_planning, false,
+            "Plan the candidate reference lines of lane follow on their own "
+            "threads instead of one after another. Each line starts from the "
+            "planning status of the previous cycle, not the one the lines "
+            "before it left; their changes are chained in order afterwards.");
 
 /// Lattice Planner
 DEFINE_double(numerical_epsilon, 1e-6, "Epsilon in lattice planner.");
@@ -385,6 +410,19 @@ DEFINE_double(polynomial_minimal_param, 0.01,
               "Minimal time parameter in polynomials.");
 DEFINE_double(lattice_stop_buffer, 0.02,
               "The buffer before the stop s to check trajectories.");
+DEFINE_bool(enable_lattice_batch_evaluation, true,
+            "Evaluate the lattice trajectory pairs on trajectories sampled "
+            "once into arrays and check collisions against the predicted "
+            "boxes stored as arrays, with the same results.");
+DEFINE_bool(enable_lattice_compact_trajectory, false,
+            "Combine and check the lattice trajectory candidates as compact "
+            "trajectories that keep one array per field and are reused "
+            "between the candidates, only the chosen one is converted to "
+            "protobuf points.");
+DEFINE_bool(enable_path_time_obstacle_index, true,
+            "Answer the lattice path blocking interval queries from an "
+            "interval tree over the path time obstacles instead of scanning "
+            "all of them, with the same results.");
 
 DEFINE_bool(lateral_optimization, true,
             "whether using optimization for lateral trajectory generation");
@@ -477,6 +515,10 @@ DEFINE_bool(
 
 DEFINE_bool(enable_osqp_debug, false,
             "True to turn on OSQP verbose debug output in log.");
+DEFINE_bool(enable_persistent_piecewise_jerk_solver, false,
+            "True to keep the OSQP workspace of the piecewise jerk path and "
+            "speed optimizers across cycles and warm start from the last "
+            "stitched solution.");
 
 DEFINE_bool(export_chart, false, "export chart in planning");
 DEFINE_bool(enable_record_debug, true,
@@ -502,6 +544,8 @@ DEFINE_double(smoother_stop_distance, 10.0,
 
 DEFINE_bool(enable_parallel_hybrid_a, false,
             "True to enable hybrid a* parallel implementation.");
+DEFINE_int32(hybrid_a_star_thread_num, 4,
+             "Number of threads expanding a hybrid a* node in parallel.");
 
 DEFINE_double(open_space_standstill_acceleration, 0.0,
               "(unit: meter/sec^2) for open space stand still at destination");
@@ -524,6 +568,11 @@ DEFINE_double(side_pass_driving_width_l_buffer, 0.1,
 DEFINE_bool(use_st_drivable_boundary, false,
             "True to use st_drivable boundary in speed planning");
 
+DEFINE_bool(enable_st_boundary_footprint_index, true,
+            "True to map obstacles onto the st graph through an index of the "
+            "ADC footprints along the path instead of rebuilding them for "
+            "every obstacle trajectory point");
+
 DEFINE_bool(enable_reuse_path_in_lane_follow, false,
             "True to enable reuse path in lane follow");
 DEFINE_bool(
@@ -22,6 +22,9 @@ DECLARE_bool(planning_test_mode);
 
 DECLARE_int32(history_max_record_num);
 DECLARE_int32(max_frame_history_num);
+DECLARE_bool(enable_frame_arena);
+DECLARE_bool(enable_obstacle_boundary_cache);
+DECLARE_double(obstacle_boundary_cache_tolerance);
 
 // scenarios related
 DECLARE_string(scenario_bare_intersection_unprotected_config_file);
@@ -63,6 +66,7 @@ DECLARE_double(look_forward_extend_distance);
 DECLARE_double(reference_line_stitch_overlap_distance);
 
 DECLARE_bool(enable_smooth_reference_line);
+DECLARE_bool(enable_incremental_reference_line_smoothing);
 
 DECLARE_bool(prioritize_change_lane);
 DECLARE_double(change_lane_min_length);
@@ -150,6 +154,8 @@ DECLARE_bool(enable_sqp_solver);
 /// thread pool
 DECLARE_bool(use_multi_thread_to_add_obstacles);
 DECLARE_bool(enable_multi_thread_in_dp_st_graph);
+DECLARE_bool(enable_dp_st_graph_cost_tables);
+DECLARE_bool(enable_parallel_reference_line_planning);
 
 DECLARE_double(numerical_epsilon);
 DECLARE_double(default_cruise_speed);
@@ -196,6 +202,9 @@ DECLARE_double(time_min_density);
 DECLARE_double(comfort_acceleration_factor);
 DECLARE_double(polynomial_minimal_param);
 DECLARE_double(lattice_stop_buffer);
+DECLARE_bool(enable_lattice_batch_evaluation);
+DECLARE_bool(enable_lattice_compact_trajectory);
+DECLARE_bool(enable_path_time_obstacle_index);
 DECLARE_double(max_s_lateral_optimization);
 DECLARE_double(default_delta_s_lateral_optimization);
 DECLARE_double(bound_buffer);
@@ -226,6 +235,7 @@ DECLARE_bool(use_iterative_anchoring_smoother);
 DECLARE_bool(enable_parallel_trajectory_smoothing);
 
 DECLARE_bool(enable_osqp_debug);
+DECLARE_bool(enable_persistent_piecewise_jerk_solver);
 DECLARE_bool(export_chart);
 DECLARE_bool(enable_record_debug);
 
@@ -242,6 +252,7 @@ DECLARE_double(smoother_stop_distance);
 DECLARE_double(side_pass_driving_width_l_buffer);
 
 DECLARE_bool(enable_parallel_hybrid_a);
+DECLARE_int32(hybrid_a_star_thread_num);
 
 DECLARE_double(open_space_standstill_acceleration);
 
@@ -254,6 +265,7 @@ DECLARE_double(short_path_length_threshold);
 DECLARE_uint64(trajectory_stitching_preserved_length);
 
 DECLARE_bool(use_st_drivable_boundary);
+DECLARE_bool(enable_st_boundary_footprint_index);
 
 DECLARE_bool(use_smoothed_dp_guide_line);
 
@@ -52,10 +52,12 @@ std::unordered_map<std::string, bool>
 ReferenceLineInfo::ReferenceLineInfo(const common::VehicleState& vehicle_state,
                                      const TrajectoryPoint& adc_planning_point,
                                      const ReferenceLine& reference_line,
-                                     const hdmap::RouteSegments& segments)
+                                     const hdmap::RouteSegments& segments,
+                                     std::pmr::memory_resource* resource)
     : vehicle_state_(vehicle_state),
       adc_planning_point_(adc_planning_point),
       reference_line_(reference_line),
+      path_decision_(resource),
       lanes_(segments) {}
 
 bool ReferenceLineInfo::Init(const std::vector<const Obstacle*>& obstacles) {
@@ -95,6 +97,10 @@ bool ReferenceLineInfo::Init(const std::vector<const Obstacle*>& obstacles) {
     return false;
   }
   is_on_reference_line_ = reference_line_.IsOnLane(adc_sl_boundary_);
+  if (obstacle_boundary_cache_ != nullptr) {
+    obstacle_boundary_cache_line_index_ =
+        obstacle_boundary_cache_->AddReferenceLine(reference_line_);
+  }
   if (!AddObstacles(obstacles)) {
     AERROR << "Failed to add obstacles to reference line";
     return false;
@@ -366,8 +372,14 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
     return nullptr;
   }
 
-  SLBoundary perception_sl;
-  if (!reference_line_.GetSLBoundary(obstacle->PerceptionBoundingBox(),
+  ObstacleBoundaryCache::Boundaries boundaries;
+  const bool is_cached =
+      obstacle_boundary_cache_ != nullptr &&
+      obstacle_boundary_cache_->GetBoundaries(
+          obstacle_boundary_cache_line_index_, *obstacle, &boundaries);
+  SLBoundary& perception_sl = boundaries.perception_sl_boundary;
+  if (!is_cached &&
+      !reference_line_.GetSLBoundary(obstacle->PerceptionBoundingBox(),
                                      &perception_sl)) {
     AERROR << "Failed to get sl boundary for obstacle: " << obstacle->Id();
     return mutable_obstacle;
@@ -390,8 +402,19 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
     ADEBUG << "NO build reference line st boundary. id:" << obstacle->Id();
   } else {
     ADEBUG << "build reference line st boundary. id:" << obstacle->Id();
-    mutable_obstacle->BuildReferenceLineStBoundary(reference_line_,
-                                                   adc_sl_boundary_.start_s());
+    if (obstacle_boundary_cache_ != nullptr &&
+        mutable_obstacle->HasStaticReferenceLineStBoundary()) {
+      if (!boundaries.has_is_blocking) {
+        boundaries.has_is_blocking = true;
+        boundaries.is_blocking =
+            mutable_obstacle->IsBlockingReferenceLine(reference_line_);
+      }
+      mutable_obstacle->BuildStaticReferenceLineStBoundary(
+          boundaries.is_blocking, adc_sl_boundary_.start_s());
+    } else {
+      mutable_obstacle->BuildReferenceLineStBoundary(
+          reference_line_, adc_sl_boundary_.start_s());
+    }
 
     ADEBUG << "reference line st boundary: t["
            << mutable_obstacle->reference_line_st_boundary().min_t() << ", "
@@ -399,6 +422,10 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
            << mutable_obstacle->reference_line_st_boundary().min_s() << ", "
            << mutable_obstacle->reference_line_st_boundary().max_s() << "]";
   }
+  if (obstacle_boundary_cache_ != nullptr) {
+    obstacle_boundary_cache_->SetBoundaries(obstacle_boundary_cache_line_index_,
+                                            *obstacle, boundaries, is_cached);
+  }
   return mutable_obstacle;
 }
 
@@ -23,6 +23,7 @@
 #include <limits>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -36,6 +37,7 @@
 
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/map/pnc_map/pnc_map.h"
+#include "modules/planning/common/obstacle_boundary_cache.h"
 #include "modules/planning/common/path/path_data.h"
 #include "modules/planning/common/path_boundary.h"
 #include "modules/planning/common/path_decision.h"
@@ -57,10 +59,15 @@ class ReferenceLineInfo {
   enum class LaneType { LeftForward, LeftReverse, RightForward, RightReverse };
   ReferenceLineInfo() = default;
 
+  /**
+   * @param resource the memory of the obstacles on this reference line.
+   */
   ReferenceLineInfo(const common::VehicleState& vehicle_state,
                     const common::TrajectoryPoint& adc_planning_point,
                     const ReferenceLine& reference_line,
-                    const hdmap::RouteSegments& segments);
+                    const hdmap::RouteSegments& segments,
+                    std::pmr::memory_resource* resource =
+                        std::pmr::get_default_resource());
 
   bool Init(const std::vector<const Obstacle*>& obstacles);
 
@@ -113,6 +120,10 @@ class ReferenceLineInfo {
   const planning_internal::Debug& debug() const { return debug_; }
   LatencyStats* mutable_latency_stats() { return &latency_stats_; }
   const LatencyStats& latency_stats() const { return latency_stats_; }
+  double planning_time_ms() const { return planning_time_ms_; }
+  void set_planning_time_ms(const double time_ms) {
+    planning_time_ms_ = time_ms;
+  }
 
   const PathData& path_data() const;
   const PathData& fallback_path_data() const;
@@ -183,6 +194,14 @@ class ReferenceLineInfo {
     offset_to_other_reference_line_ = offset;
   }
 
+  /**
+   * @brief Reuse obstacle boundaries of the last cycle from the cache, and
+   * record the ones of this cycle to it. Set before Init.
+   */
+  void SetObstacleBoundaryCache(ObstacleBoundaryCache* cache) {
+    obstacle_boundary_cache_ = cache;
+  }
+
   const std::vector<PathBoundary>& GetCandidatePathBoundaries() const;
 
   void SetCandidatePathBoundaries(
@@ -294,6 +313,10 @@ class ReferenceLineInfo {
 
   PathDecision path_decision_;
 
+  ObstacleBoundaryCache* obstacle_boundary_cache_ = nullptr;
+  // the index of this reference line in obstacle_boundary_cache_
+  int obstacle_boundary_cache_line_index_ = -1;
+
   Obstacle* blocking_obstacle_ = nullptr;
 
   std::vector<PathBoundary> candidate_path_boundaries_;
@@ -315,6 +338,7 @@ class ReferenceLineInfo {
 
   planning_internal::Debug debug_;
   LatencyStats latency_stats_;
+  double planning_time_ms_ = 0.0;
 
   hdmap::RouteSegments lanes_;
 
@@ -20,9 +20,17 @@
 
 #include "modules/planning/common/reference_line_info.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/common/math/polygon2d.h"
 #include "modules/common_msgs/planning_msgs/planning.pb.h"
+#include "modules/planning/common/planning_gflags.h"
 
 namespace apollo {
 namespace planning {
@@ -50,5 +58,196 @@ TEST_F(ReferenceLineInfoTest, BasicTest) {
             ADCTrajectory::SPEED_FALLBACK);
 }
 
+namespace {
+
+// the same as in obstacle_boundary_cache.cc
+constexpr int kMaxReuses = 10;
+constexpr double kLineLength = 100.0;
+
+// a straight reference line along the x axis starting at start_x, with the
+// ego vehicle 5m after its start
+std::unique_ptr<ReferenceLineInfo> MakeReferenceLineInfo(
+    const double start_x) {
+  std::vector<ReferencePoint> ref_points;
+  for (int i = 0; i <= static_cast<int>(kLineLength); ++i) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(common::math::Vec2d(start_x + i, 0.0), 0.0), 0.0,
+        0.0);
+  }
+  common::VehicleState vehicle_state;
+  vehicle_state.set_x(start_x + 5.0);
+  vehicle_state.set_y(0.0);
+  common::TrajectoryPoint adc_planning_point;
+  adc_planning_point.mutable_path_point()->set_x(start_x + 5.0);
+  adc_planning_point.mutable_path_point()->set_y(0.0);
+  return std::make_unique<ReferenceLineInfo>(vehicle_state, adc_planning_point,
+                                             ReferenceLine(ref_points),
+                                             hdmap::RouteSegments());
+}
+
+Obstacle MakeStaticObstacle(const std::string& id, const double x,
+                            const double y, const double theta) {
+  perception::PerceptionObstacle perception_obstacle;
+  perception_obstacle.mutable_position()->set_x(x);
+  perception_obstacle.mutable_position()->set_y(y);
+  perception_obstacle.set_theta(theta);
+  perception_obstacle.set_length(4.0);
+  perception_obstacle.set_width(2.0);
+  return Obstacle(id, perception_obstacle, prediction::ObstaclePriority::NORMAL,
+                  true);
+}
+
+// an obstacle driving along the line, its boxes are the same every cycle
+Obstacle MakeMovingObstacle(const std::string& id, const double x) {
+  perception::PerceptionObstacle perception_obstacle;
+  perception_obstacle.mutable_position()->set_x(x);
+  perception_obstacle.mutable_position()->set_y(0.0);
+  perception_obstacle.set_theta(0.0);
+  perception_obstacle.set_length(4.5);
+  perception_obstacle.set_width(2.0);
+  prediction::Trajectory trajectory;
+  for (double t = 0.0; t <= FLAGS_st_max_t; t += 0.1) {
+    auto* point = trajectory.add_trajectory_point();
+    point->mutable_path_point()->set_x(x + 5.0 * t);
+    point->mutable_path_point()->set_y(0.0);
+    point->mutable_path_point()->set_theta(0.0);
+    point->set_v(5.0);
+    point->set_relative_time(t);
+  }
+  return Obstacle(id, perception_obstacle, trajectory,
+                  prediction::ObstaclePriority::NORMAL, false);
+}
+
+common::math::Polygon2d SLPolygon(const SLBoundary& sl_boundary) {
+  std::vector<common::math::Vec2d> points;
+  for (const auto& point : sl_boundary.boundary_point()) {
+    points.emplace_back(point.s(), point.l());
+  }
+  return common::math::Polygon2d(points);
+}
+
+// On a straight line the middle points of the box edges project onto the
+// edges, so whether they are among the boundary points depends on rounding.
+// Compare the polygons the points span instead of the points.
+void ExpectNearSLBoundary(const SLBoundary& sl_boundary,
+                          const SLBoundary& expected, const double tolerance) {
+  EXPECT_NEAR(sl_boundary.start_s(), expected.start_s(), tolerance);
+  EXPECT_NEAR(sl_boundary.end_s(), expected.end_s(), tolerance);
+  EXPECT_NEAR(sl_boundary.start_l(), expected.start_l(), tolerance);
+  EXPECT_NEAR(sl_boundary.end_l(), expected.end_l(), tolerance);
+  const auto polygon = SLPolygon(sl_boundary);
+  const auto expected_polygon = SLPolygon(expected);
+  for (const auto& point : sl_boundary.boundary_point()) {
+    EXPECT_LE(expected_polygon.DistanceToBoundary({point.s(), point.l()}),
+              tolerance);
+  }
+  for (const auto& point : expected.boundary_point()) {
+    EXPECT_LE(polygon.DistanceToBoundary({point.s(), point.l()}), tolerance);
+  }
+}
+
+void ExpectNearSTPoints(const std::vector<STPoint>& points,
+                        const std::vector<STPoint>& expected,
+                        const double tolerance) {
+  ASSERT_EQ(points.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(points[i].s(), expected[i].s(), tolerance);
+    EXPECT_NEAR(points[i].t(), expected[i].t(), tolerance);
+  }
+}
+
+}  // namespace
+
+TEST(ReferenceLineInfoObstacleBoundaryCacheTest, SameAsFreshBoundaries) {
+  common::VehicleConfig vehicle_config;
+  auto* vehicle_param = vehicle_config.mutable_vehicle_param();
+  vehicle_param->set_front_edge_to_center(3.89);
+  vehicle_param->set_back_edge_to_center(1.043);
+  vehicle_param->set_left_edge_to_center(1.055);
+  vehicle_param->set_right_edge_to_center(1.055);
+  vehicle_param->set_length(4.933);
+  vehicle_param->set_width(2.11);
+  common::VehicleConfigHelper::Init(vehicle_config);
+
+  const double tolerance = FLAGS_obstacle_boundary_cache_tolerance;
+  const bool enable_obstacle_boundary_cache =
+      FLAGS_enable_obstacle_boundary_cache;
+  FLAGS_enable_obstacle_boundary_cache = true;
+
+  // the cache OnLanePlanning keeps across cycles
+  ObstacleBoundaryCache cache;
+  for (int cycle = 0; cycle <= kMaxReuses + 2; ++cycle) {
+    // the line moves forward with the ego vehicle
+    const double start_x = 0.7 * cycle;
+    // blocking, off the lane and moving obstacles which don't change, and a
+    // static one creeping forward by less than the tolerance every cycle
+    std::vector<Obstacle> obstacle_storage = {
+        MakeStaticObstacle("blocking", 40.0, 0.3, 0.2),
+        MakeStaticObstacle("off_lane", 55.0, 4.5, -0.4),
+        MakeMovingObstacle("moving", 30.0),
+        MakeStaticObstacle("creeping", 70.0 + 0.75 * tolerance * cycle, -0.5,
+                           0.0)};
+    std::vector<const Obstacle*> obstacles;
+    for (const auto& obstacle : obstacle_storage) {
+      obstacles.push_back(&obstacle);
+    }
+
+    cache.StartCycle();
+    auto reference_line_info = MakeReferenceLineInfo(start_x);
+    reference_line_info->SetObstacleBoundaryCache(&cache);
+    ASSERT_TRUE(reference_line_info->Init(obstacles));
+    auto expected_reference_line_info = MakeReferenceLineInfo(start_x);
+    ASSERT_TRUE(expected_reference_line_info->Init(obstacles));
+    const PathDecision& path_decision = *reference_line_info->path_decision();
+    const PathDecision& expected_path_decision =
+        *expected_reference_line_info->path_decision();
+
+    // the unchanged obstacles are computed again after kMaxReuses reuses
+    const uint64_t num_unchanged_hits =
+        cycle == 0 || cycle == kMaxReuses + 1 ? 0 : 3;
+    // the creeping obstacle is computed again once it moved further than the
+    // tolerance from where its boundaries were computed
+    const bool is_creeping_hit = cycle % 2 == 1;
+    ObstacleBoundaryCacheStats stats;
+    cache.RecordStats(&stats);
+    EXPECT_EQ(stats.num_queries(), obstacles.size()) << "cycle " << cycle;
+    EXPECT_EQ(stats.num_hits(),
+              num_unchanged_hits + (is_creeping_hit ? 1U : 0U))
+        << "cycle " << cycle;
+    EXPECT_EQ(stats.num_matched_reference_lines(), cycle == 0 ? 0U : 1U);
+
+    for (const auto* expected : expected_path_decision.obstacles().Items()) {
+      SCOPED_TRACE("cycle " + std::to_string(cycle) + " obstacle " +
+                   expected->Id());
+      const auto* obstacle = path_decision.Find(expected->Id());
+      ASSERT_NE(obstacle, nullptr);
+      // a reused boundary of the creeping obstacle is up to the tolerance
+      // behind
+      const double max_diff =
+          expected->Id() == "creeping" && is_creeping_hit ? tolerance : 1e-6;
+      ExpectNearSLBoundary(obstacle->PerceptionSLBoundary(),
+                           expected->PerceptionSLBoundary(), max_diff);
+      EXPECT_EQ(obstacle->IsLaneBlocking(), expected->IsLaneBlocking());
+
+      const auto& st_boundary = obstacle->reference_line_st_boundary();
+      const auto& expected_st_boundary =
+          expected->reference_line_st_boundary();
+      ASSERT_EQ(st_boundary.IsEmpty(), expected_st_boundary.IsEmpty());
+      ExpectNearSTPoints(st_boundary.lower_points(),
+                         expected_st_boundary.lower_points(), max_diff);
+      ExpectNearSTPoints(st_boundary.upper_points(),
+                         expected_st_boundary.upper_points(), max_diff);
+    }
+    // only the obstacle on the lane blocks it
+    EXPECT_FALSE(expected_path_decision.Find("blocking")
+                     ->reference_line_st_boundary()
+                     .IsEmpty());
+    EXPECT_TRUE(expected_path_decision.Find("off_lane")
+                    ->reference_line_st_boundary()
+                    .IsEmpty());
+  }
+  FLAGS_enable_obstacle_boundary_cache = enable_obstacle_boundary_cache;
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -0,0 +1,386 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file compact_trajectory.cc
+ **/
+
+#include "modules/planning/common/trajectory/compact_trajectory.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "cyber/common/log.h"
+#include "modules/common/math/linear_interpolation.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+using apollo::common::TrajectoryPoint;
+using apollo::common::math::lerp;
+using apollo::common::math::slerp;
+
+namespace {
+
+enum FieldBit : uint32_t {
+  kPathPoint = 1u << 0,
+  kX = 1u << 1,
+  kY = 1u << 2,
+  kZ = 1u << 3,
+  kTheta = 1u << 4,
+  kKappa = 1u << 5,
+  kS = 1u << 6,
+  kDkappa = 1u << 7,
+  kDdkappa = 1u << 8,
+  kLaneId = 1u << 9,
+  kXDerivative = 1u << 10,
+  kYDerivative = 1u << 11,
+  kV = 1u << 12,
+  kA = 1u << 13,
+  kRelativeTime = 1u << 14,
+  kDa = 1u << 15,
+  kSteer = 1u << 16,
+  kGaussianInfo = 1u << 17,
+};
+
+constexpr uint32_t kKinematicFields = kPathPoint | kX | kY | kS | kTheta |
+                                      kKappa | kV | kA | kRelativeTime;
+
+uint32_t HasFields(const TrajectoryPoint& trajectory_point) {
+  uint32_t has_fields = 0;
+  auto set_if = [&has_fields](const bool has, const FieldBit bit) {
+    if (has) {
+      has_fields |= bit;
+    }
+  };
+  const PathPoint& path_point = trajectory_point.path_point();
+  set_if(trajectory_point.has_path_point(), kPathPoint);
+  set_if(path_point.has_x(), kX);
+  set_if(path_point.has_y(), kY);
+  set_if(path_point.has_z(), kZ);
+  set_if(path_point.has_theta(), kTheta);
+  set_if(path_point.has_kappa(), kKappa);
+  set_if(path_point.has_s(), kS);
+  set_if(path_point.has_dkappa(), kDkappa);
+  set_if(path_point.has_ddkappa(), kDdkappa);
+  set_if(path_point.has_lane_id(), kLaneId);
+  set_if(path_point.has_x_derivative(), kXDerivative);
+  set_if(path_point.has_y_derivative(), kYDerivative);
+  set_if(trajectory_point.has_v(), kV);
+  set_if(trajectory_point.has_a(), kA);
+  set_if(trajectory_point.has_relative_time(), kRelativeTime);
+  set_if(trajectory_point.has_da(), kDa);
+  set_if(trajectory_point.has_steer(), kSteer);
+  set_if(trajectory_point.has_gaussian_info(), kGaussianInfo);
+  return has_fields;
+}
+
+}  // namespace
+
+CompactTrajectory::CompactTrajectory(
+    const std::vector<TrajectoryPoint>& trajectory_points) {
+  Reserve(trajectory_points.size());
+  for (const auto& trajectory_point : trajectory_points) {
+    PushBack(trajectory_point);
+  }
+}
+
+void CompactTrajectory::Clear() {
+  has_fields_.clear();
+  x_.clear();
+  y_.clear();
+  z_.clear();
+  theta_.clear();
+  kappa_.clear();
+  s_.clear();
+  dkappa_.clear();
+  ddkappa_.clear();
+  lane_id_.clear();
+  x_derivative_.clear();
+  y_derivative_.clear();
+  v_.clear();
+  a_.clear();
+  relative_time_.clear();
+  da_.clear();
+  steer_.clear();
+  gaussian_info_.clear();
+}
+
+void CompactTrajectory::Reserve(const size_t size) {
+  has_fields_.reserve(size);
+  x_.reserve(size);
+  y_.reserve(size);
+  z_.reserve(size);
+  theta_.reserve(size);
+  kappa_.reserve(size);
+  s_.reserve(size);
+  dkappa_.reserve(size);
+  ddkappa_.reserve(size);
+  lane_id_.reserve(size);
+  x_derivative_.reserve(size);
+  y_derivative_.reserve(size);
+  v_.reserve(size);
+  a_.reserve(size);
+  relative_time_.reserve(size);
+  da_.reserve(size);
+  steer_.reserve(size);
+}
+
+void CompactTrajectory::AppendTrajectoryPoint(const KinematicPoint& point) {
+  if (!empty()) {
+    CHECK_GT(point.relative_time, relative_time_.back());
+  }
+  has_fields_.push_back(kKinematicFields);
+  x_.push_back(point.x);
+  y_.push_back(point.y);
+  z_.push_back(0.0);
+  theta_.push_back(point.theta);
+  kappa_.push_back(point.kappa);
+  s_.push_back(point.s);
+  dkappa_.push_back(0.0);
+  ddkappa_.push_back(0.0);
+  lane_id_.emplace_back();
+  x_derivative_.push_back(0.0);
+  y_derivative_.push_back(0.0);
+  v_.push_back(point.v);
+  a_.push_back(point.a);
+  relative_time_.push_back(point.relative_time);
+  da_.push_back(0.0);
+  steer_.push_back(0.0);
+}
+
+void CompactTrajectory::AppendTrajectoryPoint(
+    const TrajectoryPoint& trajectory_point) {
+  if (!empty()) {
+    CHECK_GT(trajectory_point.relative_time(), relative_time_.back());
+  }
+  PushBack(trajectory_point);
+}
+
+void CompactTrajectory::PushBack(const TrajectoryPoint& trajectory_point) {
+  const PathPoint& path_point = trajectory_point.path_point();
+  has_fields_.push_back(HasFields(trajectory_point));
+  x_.push_back(path_point.x());
+  y_.push_back(path_point.y());
+  z_.push_back(path_point.z());
+  theta_.push_back(path_point.theta());
+  kappa_.push_back(path_point.kappa());
+  s_.push_back(path_point.s());
+  dkappa_.push_back(path_point.dkappa());
+  ddkappa_.push_back(path_point.ddkappa());
+  lane_id_.push_back(path_point.lane_id());
+  x_derivative_.push_back(path_point.x_derivative());
+  y_derivative_.push_back(path_point.y_derivative());
+  v_.push_back(trajectory_point.v());
+  a_.push_back(trajectory_point.a());
+  relative_time_.push_back(trajectory_point.relative_time());
+  da_.push_back(trajectory_point.da());
+  steer_.push_back(trajectory_point.steer());
+  if (trajectory_point.has_gaussian_info()) {
+    gaussian_info_.emplace_back(NumOfPoints() - 1,
+                                trajectory_point.gaussian_info());
+  }
+}
+
+void CompactTrajectory::Append(const CompactTrajectory& other,
+                               const size_t begin, const size_t end) {
+  CHECK_LE(begin, end);
+  CHECK_LE(end, other.NumOfPoints());
+  if (begin == end) {
+    return;
+  }
+  if (!empty()) {
+    CHECK_GT(other.relative_time_[begin], relative_time_.back());
+  }
+  const size_t offset = NumOfPoints();
+  auto append = [begin, end](const auto& from, auto* to) {
+    to->insert(to->end(), from.begin() + begin, from.begin() + end);
+  };
+  append(other.has_fields_, &has_fields_);
+  append(other.x_, &x_);
+  append(other.y_, &y_);
+  append(other.z_, &z_);
+  append(other.theta_, &theta_);
+  append(other.kappa_, &kappa_);
+  append(other.s_, &s_);
+  append(other.dkappa_, &dkappa_);
+  append(other.ddkappa_, &ddkappa_);
+  append(other.lane_id_, &lane_id_);
+  append(other.x_derivative_, &x_derivative_);
+  append(other.y_derivative_, &y_derivative_);
+  append(other.v_, &v_);
+  append(other.a_, &a_);
+  append(other.relative_time_, &relative_time_);
+  append(other.da_, &da_);
+  append(other.steer_, &steer_);
+  for (const auto& gaussian_info : other.gaussian_info_) {
+    if (gaussian_info.first >= begin && gaussian_info.first < end) {
+      gaussian_info_.emplace_back(offset + gaussian_info.first - begin,
+                                  gaussian_info.second);
+    }
+  }
+}
+
+TrajectoryPoint CompactTrajectory::TrajectoryPointAt(const size_t index) const {
+  CHECK_LT(index, NumOfPoints());
+  const uint32_t has_fields = has_fields_[index];
+  TrajectoryPoint trajectory_point;
+  if (has_fields & kPathPoint) {
+    PathPoint* path_point = trajectory_point.mutable_path_point();
+    if (has_fields & kX) {
+      path_point->set_x(x_[index]);
+    }
+    if (has_fields & kY) {
+      path_point->set_y(y_[index]);
+    }
+    if (has_fields & kZ) {
+      path_point->set_z(z_[index]);
+    }
+    if (has_fields & kTheta) {
+      path_point->set_theta(theta_[index]);
+    }
+    if (has_fields & kKappa) {
+      path_point->set_kappa(kappa_[index]);
+    }
+    if (has_fields & kS) {
+      path_point->set_s(s_[index]);
+    }
+    if (has_fields & kDkappa) {
+      path_point->set_dkappa(dkappa_[index]);
+    }
+    if (has_fields & kDdkappa) {
+      path_point->set_ddkappa(ddkappa_[index]);
+    }
+    if (has_fields & kLaneId) {
+      path_point->set_lane_id(lane_id_[index]);
+    }
+    if (has_fields & kXDerivative) {
+      path_point->set_x_derivative(x_derivative_[index]);
+    }
+    if (has_fields & kYDerivative) {
+      path_point->set_y_derivative(y_derivative_[index]);
+    }
+  }
+  if (has_fields & kV) {
+    trajectory_point.set_v(v_[index]);
+  }
+  if (has_fields & kA) {
+    trajectory_point.set_a(a_[index]);
+  }
+  if (has_fields & kRelativeTime) {
+    trajectory_point.set_relative_time(relative_time_[index]);
+  }
+  if (has_fields & kDa) {
+    trajectory_point.set_da(da_[index]);
+  }
+  if (has_fields & kSteer) {
+    trajectory_point.set_steer(steer_[index]);
+  }
+  if (has_fields & kGaussianInfo) {
+    const auto it = std::lower_bound(
+        gaussian_info_.begin(), gaussian_info_.end(), index,
+        [](const std::pair<size_t, common::GaussianInfo>& gaussian_info,
+           const size_t index) { return gaussian_info.first < index; });
+    CHECK(it != gaussian_info_.end() && it->first == index);
+    trajectory_point.mutable_gaussian_info()->CopyFrom(it->second);
+  }
+  return trajectory_point;
+}
+
+TrajectoryPoint CompactTrajectory::Evaluate(const double relative_time) const {
+  const size_t index =
+      std::distance(relative_time_.begin(),
+                    std::lower_bound(relative_time_.begin(),
+                                     relative_time_.end(), relative_time));
+  if (index == 0) {
+    return TrajectoryPointAt(0);
+  } else if (index == NumOfPoints()) {
+    AWARN << "When evaluate trajectory, relative_time(" << relative_time
+          << ") is too large";
+    return TrajectoryPointAt(NumOfPoints() - 1);
+  }
+
+  // the interpolation of InterpolateUsingLinearApproximation of
+  // TrajectoryPoint, on the arrays
+  TrajectoryPoint trajectory_point;
+  const size_t i0 = index - 1;
+  const size_t i1 = index;
+  if (!(has_fields_[i0] & kPathPoint) || !(has_fields_[i1] & kPathPoint)) {
+    trajectory_point.mutable_path_point();
+    return trajectory_point;
+  }
+  const double t0 = relative_time_[i0];
+  const double t1 = relative_time_[i1];
+  const double t = relative_time;
+  trajectory_point.set_v(lerp(v_[i0], t0, v_[i1], t1, t));
+  trajectory_point.set_a(lerp(a_[i0], t0, a_[i1], t1, t));
+  trajectory_point.set_relative_time(t);
+  trajectory_point.set_steer(slerp(steer_[i0], t0, steer_[i1], t1, t));
+
+  PathPoint* path_point = trajectory_point.mutable_path_point();
+  path_point->set_x(lerp(x_[i0], t0, x_[i1], t1, t));
+  path_point->set_y(lerp(y_[i0], t0, y_[i1], t1, t));
+  path_point->set_theta(slerp(theta_[i0], t0, theta_[i1], t1, t));
+  path_point->set_kappa(lerp(kappa_[i0], t0, kappa_[i1], t1, t));
+  path_point->set_dkappa(lerp(dkappa_[i0], t0, dkappa_[i1], t1, t));
+  path_point->set_ddkappa(lerp(ddkappa_[i0], t0, ddkappa_[i1], t1, t));
+  path_point->set_s(lerp(s_[i0], t0, s_[i1], t1, t));
+  return trajectory_point;
+}
+
+size_t CompactTrajectory::QueryLowerBoundPoint(const double relative_time,
+                                               const double epsilon) const {
+  ACHECK(!empty());
+
+  if (relative_time >= relative_time_.back()) {
+    return NumOfPoints() - 1;
+  }
+  auto func = [&epsilon](const double t, const double relative_time) {
+    return t + epsilon < relative_time;
+  };
+  auto it_lower = std::lower_bound(relative_time_.begin(),
+                                   relative_time_.end(), relative_time, func);
+  return std::distance(relative_time_.begin(), it_lower);
+}
+
+size_t CompactTrajectory::QueryNearestPoint(
+    const common::math::Vec2d& position) const {
+  double dist_sqr_min = std::numeric_limits<double>::max();
+  size_t index_min = 0;
+  for (size_t i = 0; i < x_.size(); ++i) {
+    const double dx = x_[i] - position.x();
+    const double dy = y_[i] - position.y();
+    const double dist_sqr = dx * dx + dy * dy;
+    if (dist_sqr < dist_sqr_min) {
+      dist_sqr_min = dist_sqr;
+      index_min = i;
+    }
+  }
+  return index_min;
+}
+
+DiscretizedTrajectory CompactTrajectory::ToDiscretizedTrajectory() const {
+  DiscretizedTrajectory trajectory;
+  trajectory.reserve(NumOfPoints());
+  for (size_t i = 0; i < NumOfPoints(); ++i) {
+    trajectory.push_back(TrajectoryPointAt(i));
+  }
+  return trajectory;
+}
+
+}  // namespace planning
+}  // namespace apollo
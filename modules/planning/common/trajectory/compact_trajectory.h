@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file compact_trajectory.h
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "modules/common_msgs/basic_msgs/pnc_point.pb.h"
+
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/common/trajectory/discretized_trajectory.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class CompactTrajectory
+ * @brief A discretized trajectory stored as one array per field of
+ * common::TrajectoryPoint instead of an array of protobuf points. Searching,
+ * evaluating and refilling it touch plain arrays only, and a cleared
+ * trajectory keeps its capacity.
+ *
+ * The conversion from and to protobuf keeps every field, including lane ids,
+ * derivatives and gaussian infos, and which fields are set. Unknown fields of
+ * the protobuf points are dropped.
+ */
+class CompactTrajectory {
+ public:
+  /**
+   * @brief The fields planning computes for the points of a new trajectory.
+   * The other fields of an appended point are left unset.
+   */
+  struct KinematicPoint {
+    double x = 0.0;
+    double y = 0.0;
+    double s = 0.0;
+    double theta = 0.0;
+    double kappa = 0.0;
+    double v = 0.0;
+    double a = 0.0;
+    double relative_time = 0.0;
+  };
+
+  CompactTrajectory() = default;
+
+  explicit CompactTrajectory(
+      const std::vector<common::TrajectoryPoint>& trajectory_points);
+
+  size_t NumOfPoints() const { return relative_time_.size(); }
+
+  bool empty() const { return relative_time_.empty(); }
+
+  void Clear();
+
+  void Reserve(const size_t size);
+
+  void AppendTrajectoryPoint(const KinematicPoint& point);
+
+  void AppendTrajectoryPoint(const common::TrajectoryPoint& trajectory_point);
+
+  /**
+   * @brief Append points [begin, end) of other, e.g. the stitched part of the
+   * previous trajectory.
+   */
+  void Append(const CompactTrajectory& other, const size_t begin,
+              const size_t end);
+
+  common::TrajectoryPoint TrajectoryPointAt(const size_t index) const;
+
+  /**
+   * @brief The same point DiscretizedTrajectory::Evaluate returns.
+   */
+  common::TrajectoryPoint Evaluate(const double relative_time) const;
+
+  size_t QueryLowerBoundPoint(const double relative_time,
+                              const double epsilon = 1.0e-5) const;
+
+  size_t QueryNearestPoint(const common::math::Vec2d& position) const;
+
+  const std::vector<double>& x() const { return x_; }
+  const std::vector<double>& y() const { return y_; }
+  const std::vector<double>& theta() const { return theta_; }
+  const std::vector<double>& kappa() const { return kappa_; }
+  const std::vector<double>& s() const { return s_; }
+  const std::vector<double>& v() const { return v_; }
+  const std::vector<double>& a() const { return a_; }
+  const std::vector<double>& relative_time() const { return relative_time_; }
+
+  DiscretizedTrajectory ToDiscretizedTrajectory() const;
+
+ private:
+  void PushBack(const common::TrajectoryPoint& trajectory_point);
+
+  // which fields of a point are set, one bit per field
+  std::vector<uint32_t> has_fields_;
+
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> z_;
+  std::vector<double> theta_;
+  std::vector<double> kappa_;
+  std::vector<double> s_;
+  std::vector<double> dkappa_;
+  std::vector<double> ddkappa_;
+  std::vector<std::string> lane_id_;
+  std::vector<double> x_derivative_;
+  std::vector<double> y_derivative_;
+
+  std::vector<double> v_;
+  std::vector<double> a_;
+  std::vector<double> relative_time_;
+  std::vector<double> da_;
+  std::vector<double> steer_;
+
+  // few points carry a gaussian info, they are kept by point index
+  std::vector<std::pair<size_t, common::GaussianInfo>> gaussian_info_;
+};
+
+}  // namespace planning
+}  // namespace apollo
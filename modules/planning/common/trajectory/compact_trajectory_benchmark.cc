@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+// Compares DiscretizedTrajectory with CompactTrajectory on the operations
+// planning runs every cycle: evaluating at a relative time, searching the
+// lower bound point, stitching a prefix of the previous trajectory in front
+// of a new one and refilling a lattice candidate. The trajectories are 8s
+// long, sampled every 0.02s.
+
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/common/trajectory/compact_trajectory.h"
+#include "modules/planning/common/trajectory/discretized_trajectory.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr int kNumPoints = 400;
+constexpr double kTimeResolution = 0.02;
+constexpr double kSpeed = 10.0;
+constexpr double kCurvature = 0.01;
+constexpr int kNumQueries = 100;
+
+std::vector<common::TrajectoryPoint> MakeTrajectoryPoints(
+    const double start_time) {
+  std::vector<common::TrajectoryPoint> trajectory_points(kNumPoints);
+  for (int i = 0; i < kNumPoints; ++i) {
+    const double t = start_time + i * kTimeResolution;
+    const double s = kSpeed * t;
+    auto& point = trajectory_points[i];
+    point.set_relative_time(t);
+    point.set_v(kSpeed);
+    point.set_a(0.0);
+    auto* path_point = point.mutable_path_point();
+    path_point->set_s(s);
+    path_point->set_x(std::sin(kCurvature * s) / kCurvature);
+    path_point->set_y((1.0 - std::cos(kCurvature * s)) / kCurvature);
+    path_point->set_theta(kCurvature * s);
+    path_point->set_kappa(kCurvature);
+  }
+  return trajectory_points;
+}
+
+std::vector<double> QueryTimes() {
+  std::vector<double> times;
+  for (int i = 0; i < kNumQueries; ++i) {
+    times.push_back(kNumPoints * kTimeResolution * (i + 0.5) / kNumQueries);
+  }
+  return times;
+}
+
+void BM_DiscretizedEvaluate(benchmark::State& state) {
+  const DiscretizedTrajectory trajectory(MakeTrajectoryPoints(0.0));
+  const auto times = QueryTimes();
+  for (auto _ : state) {
+    for (const double t : times) {
+      benchmark::DoNotOptimize(trajectory.Evaluate(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+}
+
+void BM_CompactEvaluate(benchmark::State& state) {
+  const CompactTrajectory trajectory(MakeTrajectoryPoints(0.0));
+  const auto times = QueryTimes();
+  for (auto _ : state) {
+    for (const double t : times) {
+      benchmark::DoNotOptimize(trajectory.Evaluate(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+}
+
+void BM_DiscretizedQueryLowerBound(benchmark::State& state) {
+  const DiscretizedTrajectory trajectory(MakeTrajectoryPoints(0.0));
+  const auto times = QueryTimes();
+  for (auto _ : state) {
+    for (const double t : times) {
+      benchmark::DoNotOptimize(trajectory.QueryLowerBoundPoint(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+}
+
+void BM_CompactQueryLowerBound(benchmark::State& state) {
+  const CompactTrajectory trajectory(MakeTrajectoryPoints(0.0));
+  const auto times = QueryTimes();
+  for (auto _ : state) {
+    for (const double t : times) {
+      benchmark::DoNotOptimize(trajectory.QueryLowerBoundPoint(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+}
+
+// The previous trajectory up to 0.1s after the matched point, followed by the
+// new trajectory starting there.
+void BM_DiscretizedStitch(benchmark::State& state) {
+  const DiscretizedTrajectory prev_trajectory(MakeTrajectoryPoints(0.0));
+  const size_t matched_index =
+      prev_trajectory.QueryLowerBoundPoint(0.1 + kTimeResolution);
+  const DiscretizedTrajectory new_trajectory(MakeTrajectoryPoints(
+      prev_trajectory[matched_index].relative_time() + kTimeResolution));
+  for (auto _ : state) {
+    DiscretizedTrajectory stitched(new_trajectory);
+    stitched.PrependTrajectoryPoints(std::vector<common::TrajectoryPoint>(
+        prev_trajectory.begin(), prev_trajectory.begin() + matched_index + 1));
+    benchmark::DoNotOptimize(stitched.data());
+  }
+}
+
+void BM_CompactStitch(benchmark::State& state) {
+  const CompactTrajectory prev_trajectory(MakeTrajectoryPoints(0.0));
+  const size_t matched_index =
+      prev_trajectory.QueryLowerBoundPoint(0.1 + kTimeResolution);
+  const CompactTrajectory new_trajectory(MakeTrajectoryPoints(
+      prev_trajectory.relative_time()[matched_index] + kTimeResolution));
+  for (auto _ : state) {
+    CompactTrajectory stitched;
+    stitched.Reserve(matched_index + 1 + new_trajectory.NumOfPoints());
+    stitched.Append(prev_trajectory, 0, matched_index + 1);
+    stitched.Append(new_trajectory, 0, new_trajectory.NumOfPoints());
+    benchmark::DoNotOptimize(stitched.relative_time().data());
+  }
+}
+
+// The points TrajectoryCombiner appends for every lattice candidate, into a new
+// trajectory of protobuf points or into the reused compact trajectory.
+void BM_DiscretizedCandidate(benchmark::State& state) {
+  const auto trajectory_points = MakeTrajectoryPoints(0.0);
+  for (auto _ : state) {
+    DiscretizedTrajectory trajectory;
+    for (const auto& point : trajectory_points) {
+      common::TrajectoryPoint trajectory_point;
+      auto* path_point = trajectory_point.mutable_path_point();
+      path_point->set_x(point.path_point().x());
+      path_point->set_y(point.path_point().y());
+      path_point->set_s(point.path_point().s());
+      path_point->set_theta(point.path_point().theta());
+      path_point->set_kappa(point.path_point().kappa());
+      trajectory_point.set_v(point.v());
+      trajectory_point.set_a(point.a());
+      trajectory_point.set_relative_time(point.relative_time());
+      trajectory.AppendTrajectoryPoint(trajectory_point);
+    }
+    benchmark::DoNotOptimize(trajectory.data());
+  }
+}
+
+void BM_CompactCandidate(benchmark::State& state) {
+  const auto trajectory_points = MakeTrajectoryPoints(0.0);
+  CompactTrajectory trajectory;
+  for (auto _ : state) {
+    trajectory.Clear();
+    for (const auto& point : trajectory_points) {
+      CompactTrajectory::KinematicPoint kinematic_point;
+      kinematic_point.x = point.path_point().x();
+      kinematic_point.y = point.path_point().y();
+      kinematic_point.s = point.path_point().s();
+      kinematic_point.theta = point.path_point().theta();
+      kinematic_point.kappa = point.path_point().kappa();
+      kinematic_point.v = point.v();
+      kinematic_point.a = point.a();
+      kinematic_point.relative_time = point.relative_time();
+      trajectory.AppendTrajectoryPoint(kinematic_point);
+    }
+    benchmark::DoNotOptimize(trajectory.relative_time().data());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_DiscretizedEvaluate);
+BENCHMARK(BM_CompactEvaluate);
+BENCHMARK(BM_DiscretizedQueryLowerBound);
+BENCHMARK(BM_CompactQueryLowerBound);
+BENCHMARK(BM_DiscretizedStitch);
+BENCHMARK(BM_CompactStitch);
+BENCHMARK(BM_DiscretizedCandidate);
+BENCHMARK(BM_CompactCandidate);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
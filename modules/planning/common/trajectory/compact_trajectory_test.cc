@@ -0,0 +1,196 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/common/trajectory/compact_trajectory.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/util/message_differencer.h"
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::TrajectoryPoint;
+using google::protobuf::util::MessageDifferencer;
+
+namespace {
+
+// Points on an arc, every field is set on some points and unset on others.
+std::vector<TrajectoryPoint> ArcPoints(const size_t num_points) {
+  std::vector<TrajectoryPoint> points;
+  for (size_t i = 0; i < num_points; ++i) {
+    const double t = 0.1 * static_cast<double>(i);
+    const double theta = 0.05 * t;
+    TrajectoryPoint point;
+    point.set_relative_time(t);
+    point.set_v(10.0 + 0.1 * t);
+    if (i % 3 != 1) {
+      point.set_a(0.1 * std::sin(t));
+    }
+    if (i % 4 == 0) {
+      point.set_da(-0.2 * t);
+      point.set_steer(0.01 * t);
+    }
+    if (i % 5 != 4) {
+      auto* path_point = point.mutable_path_point();
+      path_point->set_x(100.0 * std::sin(theta));
+      path_point->set_y(100.0 * (1.0 - std::cos(theta)));
+      path_point->set_theta(theta);
+      path_point->set_kappa(0.01);
+      path_point->set_s(100.0 * theta);
+      if (i % 2 == 0) {
+        path_point->set_z(0.5);
+        path_point->set_dkappa(1e-4 * t);
+        path_point->set_ddkappa(-1e-5 * t);
+        path_point->set_lane_id("lane_" + std::to_string(i / 10));
+        path_point->set_x_derivative(std::cos(theta));
+        path_point->set_y_derivative(std::sin(theta));
+      }
+    }
+    if (i % 7 == 3) {
+      auto* gaussian_info = point.mutable_gaussian_info();
+      gaussian_info->set_sigma_x(0.1 * t);
+      gaussian_info->set_sigma_y(0.2 * t);
+      gaussian_info->set_correlation(0.3);
+      gaussian_info->set_area_probability(0.4);
+      gaussian_info->set_ellipse_a(1.0);
+      gaussian_info->set_ellipse_b(0.5);
+      gaussian_info->set_theta_a(theta);
+    }
+    points.push_back(point);
+  }
+  return points;
+}
+
+void ExpectSamePoints(const DiscretizedTrajectory& trajectory,
+                      const std::vector<TrajectoryPoint>& expected) {
+  ASSERT_EQ(trajectory.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_TRUE(MessageDifferencer::Equals(trajectory[i], expected[i]))
+        << "point " << i << ": " << trajectory[i].ShortDebugString()
+        << " expected: " << expected[i].ShortDebugString();
+  }
+}
+
+}  // namespace
+
+TEST(CompactTrajectoryTest, LosslessConversion) {
+  const std::vector<TrajectoryPoint> points = ArcPoints(100);
+  const CompactTrajectory compact_trajectory(points);
+  EXPECT_EQ(compact_trajectory.NumOfPoints(), points.size());
+  ExpectSamePoints(compact_trajectory.ToDiscretizedTrajectory(), points);
+
+  CompactTrajectory appended_trajectory;
+  for (const auto& point : points) {
+    appended_trajectory.AppendTrajectoryPoint(point);
+  }
+  ExpectSamePoints(appended_trajectory.ToDiscretizedTrajectory(), points);
+}
+
+TEST(CompactTrajectoryTest, AppendKinematicPoint) {
+  CompactTrajectory compact_trajectory;
+  DiscretizedTrajectory expected;
+  for (int i = 0; i < 10; ++i) {
+    CompactTrajectory::KinematicPoint point;
+    point.x = 1.0 * i;
+    point.y = 0.5 * i;
+    point.s = 1.1 * i;
+    point.theta = 0.1 * i;
+    point.kappa = 0.01 * i;
+    point.v = 2.0 * i;
+    point.a = -0.1 * i;
+    point.relative_time = 0.1 * i;
+    compact_trajectory.AppendTrajectoryPoint(point);
+
+    TrajectoryPoint trajectory_point;
+    trajectory_point.mutable_path_point()->set_x(point.x);
+    trajectory_point.mutable_path_point()->set_y(point.y);
+    trajectory_point.mutable_path_point()->set_s(point.s);
+    trajectory_point.mutable_path_point()->set_theta(point.theta);
+    trajectory_point.mutable_path_point()->set_kappa(point.kappa);
+    trajectory_point.set_v(point.v);
+    trajectory_point.set_a(point.a);
+    trajectory_point.set_relative_time(point.relative_time);
+    expected.AppendTrajectoryPoint(trajectory_point);
+  }
+  ExpectSamePoints(compact_trajectory.ToDiscretizedTrajectory(), expected);
+
+  // a cleared trajectory is refilled from the start
+  compact_trajectory.Clear();
+  EXPECT_TRUE(compact_trajectory.empty());
+  compact_trajectory.AppendTrajectoryPoint(expected[3]);
+  ExpectSamePoints(compact_trajectory.ToDiscretizedTrajectory(),
+                   {expected[3]});
+}
+
+TEST(CompactTrajectoryTest, SameQueriesAsDiscretizedTrajectory) {
+  const std::vector<TrajectoryPoint> points = ArcPoints(100);
+  const DiscretizedTrajectory discretized_trajectory(points);
+  const CompactTrajectory compact_trajectory(points);
+
+  for (double t = -0.5; t < 10.5; t += 0.037) {
+    EXPECT_TRUE(MessageDifferencer::Equals(compact_trajectory.Evaluate(t),
+                                           discretized_trajectory.Evaluate(t)))
+        << "t = " << t;
+    EXPECT_EQ(compact_trajectory.QueryLowerBoundPoint(t),
+              discretized_trajectory.QueryLowerBoundPoint(t));
+    EXPECT_EQ(compact_trajectory.QueryLowerBoundPoint(t, 0.05),
+              discretized_trajectory.QueryLowerBoundPoint(t, 0.05));
+  }
+  // the exact sample times
+  for (const auto& point : points) {
+    const double t = point.relative_time();
+    EXPECT_TRUE(MessageDifferencer::Equals(compact_trajectory.Evaluate(t),
+                                           discretized_trajectory.Evaluate(t)));
+    EXPECT_EQ(compact_trajectory.QueryLowerBoundPoint(t),
+              discretized_trajectory.QueryLowerBoundPoint(t));
+  }
+  for (double x = -5.0; x < 60.0; x += 1.3) {
+    for (double y = -5.0; y < 15.0; y += 2.1) {
+      EXPECT_EQ(compact_trajectory.QueryNearestPoint({x, y}),
+                discretized_trajectory.QueryNearestPoint({x, y}));
+    }
+  }
+}
+
+TEST(CompactTrajectoryTest, Append) {
+  const std::vector<TrajectoryPoint> points = ArcPoints(100);
+  const CompactTrajectory compact_trajectory(points);
+
+  // the stitching keeps a part of the previous trajectory and appends the new
+  // points behind it
+  CompactTrajectory stitched_trajectory;
+  stitched_trajectory.Append(compact_trajectory, 10, 10);
+  EXPECT_TRUE(stitched_trajectory.empty());
+  stitched_trajectory.Append(compact_trajectory, 10, 40);
+  stitched_trajectory.Append(compact_trajectory, 40, 40);
+  stitched_trajectory.Append(compact_trajectory, 45, 100);
+
+  std::vector<TrajectoryPoint> expected(points.begin() + 10,
+                                        points.begin() + 40);
+  expected.insert(expected.end(), points.begin() + 45, points.end());
+  ExpectSamePoints(stitched_trajectory.ToDiscretizedTrajectory(), expected);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -20,6 +20,8 @@
 
 #include "modules/planning/constraint_checker/collision_checker.h"
 
+#include <cmath>
+#include <limits>
 #include <utility>
 
 #include "modules/common_msgs/prediction_msgs/prediction_obstacle.pb.h"
@@ -39,6 +41,30 @@ using apollo::common::math::Box2d;
 using apollo::common::math::PathMatcher;
 using apollo::common::math::Vec2d;
 
+namespace {
+
+// The pose of the points, from both trajectory representations.
+double X(const DiscretizedTrajectory& trajectory, const size_t i) {
+  return trajectory[i].path_point().x();
+}
+double X(const CompactTrajectory& trajectory, const size_t i) {
+  return trajectory.x()[i];
+}
+double Y(const DiscretizedTrajectory& trajectory, const size_t i) {
+  return trajectory[i].path_point().y();
+}
+double Y(const CompactTrajectory& trajectory, const size_t i) {
+  return trajectory.y()[i];
+}
+double Theta(const DiscretizedTrajectory& trajectory, const size_t i) {
+  return trajectory[i].path_point().theta();
+}
+double Theta(const CompactTrajectory& trajectory, const size_t i) {
+  return trajectory.theta()[i];
+}
+
+}  // namespace
+
 CollisionChecker::CollisionChecker(
     const std::vector<const Obstacle*>& obstacles, const double ego_vehicle_s,
     const double ego_vehicle_d,
@@ -83,28 +109,31 @@ bool CollisionChecker::InCollision(
   return false;
 }
 
-bool CollisionChecker::InCollision(
-    const DiscretizedTrajectory& discretized_trajectory) {
-  CHECK_LE(discretized_trajectory.NumOfPoints(),
-           predicted_bounding_rectangles_.size());
+template <typename Trajectory>
+bool CollisionChecker::InCollisionWithPredictions(
+    const Trajectory& trajectory) {
+  CHECK_LE(trajectory.NumOfPoints(), predicted_bounding_rectangles_.size());
   const auto& vehicle_config =
       common::VehicleConfigHelper::Instance()->GetConfig();
   double ego_length = vehicle_config.vehicle_param().length();
   double ego_width = vehicle_config.vehicle_param().width();
 
-  for (size_t i = 0; i < discretized_trajectory.NumOfPoints(); ++i) {
-    const auto& trajectory_point =
-        discretized_trajectory.TrajectoryPointAt(static_cast<std::uint32_t>(i));
-    double ego_theta = trajectory_point.path_point().theta();
-    Box2d ego_box(
-        {trajectory_point.path_point().x(), trajectory_point.path_point().y()},
-        ego_theta, ego_length, ego_width);
+  for (size_t i = 0; i < trajectory.NumOfPoints(); ++i) {
+    double ego_theta = Theta(trajectory, i);
+    Box2d ego_box({X(trajectory, i), Y(trajectory, i)}, ego_theta, ego_length,
+                  ego_width);
     double shift_distance =
         ego_length / 2.0 - vehicle_config.vehicle_param().back_edge_to_center();
     Vec2d shift_vec{shift_distance * std::cos(ego_theta),
                     shift_distance * std::sin(ego_theta)};
     ego_box.Shift(shift_vec);
 
+    if (!predicted_boxes_.empty()) {
+      if (predicted_boxes_[i].HasOverlap(ego_box)) {
+        return true;
+      }
+      continue;
+    }
     for (const auto& obstacle_box : predicted_bounding_rectangles_[i]) {
       if (ego_box.HasOverlap(obstacle_box)) {
         return true;
@@ -114,6 +143,113 @@ bool CollisionChecker::InCollision(
   return false;
 }
 
+bool CollisionChecker::InCollision(
+    const DiscretizedTrajectory& discretized_trajectory) {
+  return InCollisionWithPredictions(discretized_trajectory);
+}
+
+bool CollisionChecker::InCollision(
+    const CompactTrajectory& compact_trajectory) {
+  return InCollisionWithPredictions(compact_trajectory);
+}
+
+CollisionChecker::PredictedBoxes::PredictedBoxes(
+    const std::vector<Box2d>& boxes) {
+  const size_t num_boxes = boxes.size();
+  center_x.reserve(num_boxes);
+  center_y.reserve(num_boxes);
+  cos_heading.reserve(num_boxes);
+  sin_heading.reserve(num_boxes);
+  half_length.reserve(num_boxes);
+  half_width.reserve(num_boxes);
+  min_x.reserve(num_boxes);
+  max_x.reserve(num_boxes);
+  min_y.reserve(num_boxes);
+  max_y.reserve(num_boxes);
+  bound_min_x = std::numeric_limits<double>::infinity();
+  bound_max_x = -std::numeric_limits<double>::infinity();
+  bound_min_y = std::numeric_limits<double>::infinity();
+  bound_max_y = -std::numeric_limits<double>::infinity();
+  for (const auto& box : boxes) {
+    center_x.push_back(box.center_x());
+    center_y.push_back(box.center_y());
+    cos_heading.push_back(box.cos_heading());
+    sin_heading.push_back(box.sin_heading());
+    half_length.push_back(box.half_length());
+    half_width.push_back(box.half_width());
+    min_x.push_back(box.min_x());
+    max_x.push_back(box.max_x());
+    min_y.push_back(box.min_y());
+    max_y.push_back(box.max_y());
+    bound_min_x = std::fmin(bound_min_x, box.min_x());
+    bound_max_x = std::fmax(bound_max_x, box.max_x());
+    bound_min_y = std::fmin(bound_min_y, box.min_y());
+    bound_max_y = std::fmax(bound_max_y, box.max_y());
+  }
+}
+
+// The same tests as Box2d::HasOverlap, the axis aligned bounds and then the
+// separating axes of both boxes, without branches so that the loop over the
+// boxes can be vectorized.
+bool CollisionChecker::PredictedBoxes::HasOverlap(const Box2d& ego_box) const {
+  if (ego_box.max_x() < bound_min_x || ego_box.min_x() > bound_max_x ||
+      ego_box.max_y() < bound_min_y || ego_box.min_y() > bound_max_y) {
+    return false;
+  }
+
+  const double ego_x = ego_box.center_x();
+  const double ego_y = ego_box.center_y();
+  const double ego_cos = ego_box.cos_heading();
+  const double ego_sin = ego_box.sin_heading();
+  const double ego_half_length = ego_box.half_length();
+  const double ego_half_width = ego_box.half_width();
+  const double ego_min_x = ego_box.min_x();
+  const double ego_max_x = ego_box.max_x();
+  const double ego_min_y = ego_box.min_y();
+  const double ego_max_y = ego_box.max_y();
+  const double dx1 = ego_cos * ego_half_length;
+  const double dy1 = ego_sin * ego_half_length;
+  const double dx2 = ego_sin * ego_half_width;
+  const double dy2 = -ego_cos * ego_half_width;
+
+  bool overlap = false;
+  const size_t num_boxes = center_x.size();
+  for (size_t k = 0; k < num_boxes; ++k) {
+    const double shift_x = center_x[k] - ego_x;
+    const double shift_y = center_y[k] - ego_y;
+    const double dx3 = cos_heading[k] * half_length[k];
+    const double dy3 = sin_heading[k] * half_length[k];
+    const double dx4 = sin_heading[k] * half_width[k];
+    const double dy4 = -cos_heading[k] * half_width[k];
+
+    const bool bounds_overlap = !(max_x[k] < ego_min_x) &
+                                !(min_x[k] > ego_max_x) &
+                                !(max_y[k] < ego_min_y) &
+                                !(min_y[k] > ego_max_y);
+    const bool ego_length_axis =
+        std::abs(shift_x * ego_cos + shift_y * ego_sin) <=
+        std::abs(dx3 * ego_cos + dy3 * ego_sin) +
+            std::abs(dx4 * ego_cos + dy4 * ego_sin) + ego_half_length;
+    const bool ego_width_axis =
+        std::abs(shift_x * ego_sin - shift_y * ego_cos) <=
+        std::abs(dx3 * ego_sin - dy3 * ego_cos) +
+            std::abs(dx4 * ego_sin - dy4 * ego_cos) + ego_half_width;
+    const bool length_axis =
+        std::abs(shift_x * cos_heading[k] + shift_y * sin_heading[k]) <=
+        std::abs(dx1 * cos_heading[k] + dy1 * sin_heading[k]) +
+            std::abs(dx2 * cos_heading[k] + dy2 * sin_heading[k]) +
+            half_length[k];
+    const bool width_axis =
+        std::abs(shift_x * sin_heading[k] - shift_y * cos_heading[k]) <=
+        std::abs(dx1 * sin_heading[k] - dy1 * cos_heading[k]) +
+            std::abs(dx2 * sin_heading[k] - dy2 * cos_heading[k]) +
+            half_width[k];
+    overlap |= bounds_overlap & ego_length_axis & ego_width_axis &
+               length_axis & width_axis;
+  }
+  return overlap;
+}
+
 void CollisionChecker::BuildPredictedEnvironment(
     const std::vector<const Obstacle*>& obstacles, const double ego_vehicle_s,
     const double ego_vehicle_d,
@@ -150,6 +286,9 @@ void CollisionChecker::BuildPredictedEnvironment(
       box.LateralExtend(2.0 * FLAGS_lat_collision_buffer);
       predicted_env.push_back(std::move(box));
     }
+    if (FLAGS_enable_lattice_batch_evaluation) {
+      predicted_boxes_.emplace_back(predicted_env);
+    }
     predicted_bounding_rectangles_.push_back(std::move(predicted_env));
     relative_time += FLAGS_trajectory_time_resolution;
   }
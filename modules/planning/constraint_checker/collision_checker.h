@@ -23,9 +23,12 @@
 #include <memory>
 #include <vector>
 
+#include "gtest/gtest_prod.h"
+
 #include "modules/common/math/box2d.h"
 #include "modules/planning/common/obstacle.h"
 #include "modules/planning/common/reference_line_info.h"
+#include "modules/planning/common/trajectory/compact_trajectory.h"
 #include "modules/planning/common/trajectory/discretized_trajectory.h"
 #include "modules/planning/lattice/behavior/path_time_graph.h"
 
@@ -43,6 +46,8 @@ class CollisionChecker {
 
   bool InCollision(const DiscretizedTrajectory& discretized_trajectory);
 
+  bool InCollision(const CompactTrajectory& compact_trajectory);
+
   static bool InCollision(const std::vector<const Obstacle*>& obstacles,
                           const DiscretizedTrajectory& ego_trajectory,
                           const double ego_length, const double ego_width,
@@ -54,6 +59,9 @@ class CollisionChecker {
       const double ego_vehicle_d,
       const std::vector<common::PathPoint>& discretized_reference_line);
 
+  template <typename Trajectory>
+  bool InCollisionWithPredictions(const Trajectory& trajectory);
+
   bool IsEgoVehicleInLane(const double ego_vehicle_s,
                           const double ego_vehicle_d);
 
@@ -61,10 +69,38 @@ class CollisionChecker {
       const Obstacle* obstacle, const double ego_vehicle_s,
       const std::vector<apollo::common::PathPoint>& discretized_reference_line);
 
+  /**
+   * @brief The predicted boxes of one time step, one array per box attribute,
+   * and the bounding box of all of them.
+   */
+  struct PredictedBoxes {
+    explicit PredictedBoxes(const std::vector<common::math::Box2d>& boxes);
+
+    bool HasOverlap(const common::math::Box2d& ego_box) const;
+
+    std::vector<double> center_x;
+    std::vector<double> center_y;
+    std::vector<double> cos_heading;
+    std::vector<double> sin_heading;
+    std::vector<double> half_length;
+    std::vector<double> half_width;
+    std::vector<double> min_x;
+    std::vector<double> max_x;
+    std::vector<double> min_y;
+    std::vector<double> max_y;
+    double bound_min_x = 0.0;
+    double bound_max_x = 0.0;
+    double bound_min_y = 0.0;
+    double bound_max_y = 0.0;
+  };
+
+  FRIEND_TEST(CollisionCheckerTest, PredictedBoxesHasOverlap);
+
  private:
   const ReferenceLineInfo* ptr_reference_line_info_;
   std::shared_ptr<PathTimeGraph> ptr_path_time_graph_;
   std::vector<std::vector<common::math::Box2d>> predicted_bounding_rectangles_;
+  std::vector<PredictedBoxes> predicted_boxes_;
 };
 
 }  // namespace planning
@@ -0,0 +1,171 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/constraint_checker/collision_checker.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+using apollo::common::TrajectoryPoint;
+using apollo::common::math::Box2d;
+
+TEST(CollisionCheckerTest, PredictedBoxesHasOverlap) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> position(-10.0, 10.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> length(0.5, 8.0);
+  std::uniform_real_distribution<double> width(0.5, 3.0);
+  std::uniform_int_distribution<int> num_boxes(0, 8);
+  auto random_box = [&]() {
+    return Box2d({position(generator), position(generator)},
+                 heading(generator), length(generator), width(generator));
+  };
+
+  int num_overlaps = 0;
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<Box2d> boxes;
+    const int n = num_boxes(generator);
+    for (int k = 0; k < n; ++k) {
+      boxes.push_back(random_box());
+    }
+    const CollisionChecker::PredictedBoxes predicted_boxes(boxes);
+
+    for (int j = 0; j < 10; ++j) {
+      const Box2d ego_box = random_box();
+      bool expected = false;
+      for (const auto& box : boxes) {
+        expected = expected || ego_box.HasOverlap(box);
+      }
+      EXPECT_EQ(predicted_boxes.HasOverlap(ego_box), expected);
+      num_overlaps += expected ? 1 : 0;
+    }
+  }
+  // both outcomes are covered
+  EXPECT_GT(num_overlaps, 1000);
+  EXPECT_LT(num_overlaps, 9000);
+}
+
+TEST(CollisionCheckerTest, CompactTrajectoryInCollision) {
+  common::VehicleConfig vehicle_config;
+  auto* vehicle_param = vehicle_config.mutable_vehicle_param();
+  vehicle_param->set_back_edge_to_center(1.043);
+  vehicle_param->set_length(4.933);
+  vehicle_param->set_width(2.11);
+  common::VehicleConfigHelper::Init(vehicle_config);
+
+  std::vector<ReferencePoint> reference_points;
+  std::vector<PathPoint> discretized_reference_line;
+  for (double x = 0.0; x <= 100.0; x += 1.0) {
+    reference_points.emplace_back(hdmap::MapPathPoint({x, 0.0}, 0.0), 0.0,
+                                  0.0);
+    PathPoint point;
+    point.set_x(x);
+    point.set_s(x);
+    discretized_reference_line.push_back(point);
+  }
+  TrajectoryPoint adc_planning_point;
+  const ReferenceLineInfo reference_line_info(
+      common::VehicleState(), adc_planning_point,
+      ReferenceLine(reference_points), hdmap::RouteSegments());
+
+  // static obstacles on the lane and one driving against the ego vehicle
+  std::vector<Obstacle> obstacle_storage;
+  for (int i = 0; i < 4; ++i) {
+    perception::PerceptionObstacle perception_obstacle;
+    perception_obstacle.mutable_position()->set_x(15.0 + 20.0 * i);
+    perception_obstacle.mutable_position()->set_y(i % 2 == 0 ? 1.0 : -1.5);
+    perception_obstacle.set_theta(0.1 * i);
+    perception_obstacle.set_length(4.0);
+    perception_obstacle.set_width(2.0);
+    obstacle_storage.emplace_back(std::to_string(i), perception_obstacle,
+                                  prediction::ObstaclePriority::NORMAL, true);
+  }
+  perception::PerceptionObstacle perception_obstacle;
+  perception_obstacle.mutable_position()->set_x(80.0);
+  perception_obstacle.mutable_position()->set_y(0.0);
+  perception_obstacle.set_theta(M_PI);
+  perception_obstacle.set_length(4.5);
+  perception_obstacle.set_width(2.0);
+  prediction::Trajectory prediction_trajectory;
+  for (double t = 0.0; t <= FLAGS_trajectory_time_length; t += 0.1) {
+    auto* point = prediction_trajectory.add_trajectory_point();
+    point->mutable_path_point()->set_x(80.0 - 8.0 * t);
+    point->mutable_path_point()->set_y(0.0);
+    point->mutable_path_point()->set_theta(M_PI);
+    point->set_v(8.0);
+    point->set_relative_time(t);
+  }
+  obstacle_storage.emplace_back("moving", perception_obstacle,
+                                prediction_trajectory,
+                                prediction::ObstaclePriority::NORMAL, false);
+  std::vector<const Obstacle*> obstacles;
+  for (const auto& obstacle : obstacle_storage) {
+    obstacles.push_back(&obstacle);
+  }
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> speed(2.0, 15.0);
+  std::uniform_real_distribution<double> lateral(-8.0, 8.0);
+  std::uniform_real_distribution<double> heading(-0.2, 0.2);
+  const bool enable_lattice_batch_evaluation =
+      FLAGS_enable_lattice_batch_evaluation;
+  for (const bool batch_evaluation : {false, true}) {
+    FLAGS_enable_lattice_batch_evaluation = batch_evaluation;
+    // the ego vehicle is out of the lane, all obstacles are considered
+    CollisionChecker collision_checker(obstacles, 0.0, 5.0,
+                                       discretized_reference_line,
+                                       &reference_line_info, nullptr);
+    int num_collisions = 0;
+    for (int i = 0; i < 200; ++i) {
+      const double v = speed(generator);
+      const double l = lateral(generator);
+      const double theta = heading(generator);
+      std::vector<TrajectoryPoint> points;
+      for (double t = 0.0; t < FLAGS_trajectory_time_length;
+           t += FLAGS_trajectory_time_resolution) {
+        TrajectoryPoint point;
+        point.mutable_path_point()->set_x(v * t);
+        point.mutable_path_point()->set_y(l);
+        point.mutable_path_point()->set_theta(theta);
+        point.set_v(v);
+        point.set_relative_time(t);
+        points.push_back(point);
+      }
+      const bool expected =
+          collision_checker.InCollision(DiscretizedTrajectory(points));
+      EXPECT_EQ(collision_checker.InCollision(CompactTrajectory(points)),
+                expected);
+      num_collisions += expected ? 1 : 0;
+    }
+    // both outcomes are covered
+    EXPECT_GT(num_collisions, 20);
+    EXPECT_LT(num_collisions, 180);
+  }
+  FLAGS_enable_lattice_batch_evaluation = enable_lattice_batch_evaluation;
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -31,17 +31,43 @@ template <typename T>
 bool WithinRange(const T v, const T lower, const T upper) {
   return lower <= v && v <= upper;
 }
-}  // namespace
 
-ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
-    const DiscretizedTrajectory& trajectory) {
+// The fields the checks read, from both trajectory representations.
+double RelativeTime(const DiscretizedTrajectory& trajectory, const size_t i) {
+  return trajectory[i].relative_time();
+}
+double RelativeTime(const CompactTrajectory& trajectory, const size_t i) {
+  return trajectory.relative_time()[i];
+}
+double V(const DiscretizedTrajectory& trajectory, const size_t i) {
+  return trajectory[i].v();
+}
+double V(const CompactTrajectory& trajectory, const size_t i) {
+  return trajectory.v()[i];
+}
+double A(const DiscretizedTrajectory& trajectory, const size_t i) {
+  return trajectory[i].a();
+}
+double A(const CompactTrajectory& trajectory, const size_t i) {
+  return trajectory.a()[i];
+}
+double Kappa(const DiscretizedTrajectory& trajectory, const size_t i) {
+  return trajectory[i].path_point().kappa();
+}
+double Kappa(const CompactTrajectory& trajectory, const size_t i) {
+  return trajectory.kappa()[i];
+}
+
+template <typename Trajectory>
+ConstraintChecker::Result ValidTrajectoryImpl(const Trajectory& trajectory) {
+  using Result = ConstraintChecker::Result;
   const double kMaxCheckRelativeTime = FLAGS_trajectory_time_length;
-  for (const auto& p : trajectory) {
-    double t = p.relative_time();
+  for (size_t i = 0; i < trajectory.NumOfPoints(); ++i) {
+    double t = RelativeTime(trajectory, i);
     if (t > kMaxCheckRelativeTime) {
       break;
     }
-    double lon_v = p.v();
+    double lon_v = V(trajectory, i);
     if (!WithinRange(lon_v, FLAGS_speed_lower_bound, FLAGS_speed_upper_bound)) {
       ADEBUG << "Velocity at relative time " << t
              << " exceeds bound, value: " << lon_v << ", bound ["
@@ -50,7 +76,7 @@ ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
       return Result::LON_VELOCITY_OUT_OF_BOUND;
     }
 
-    double lon_a = p.a();
+    double lon_a = A(trajectory, i);
     if (!WithinRange(lon_a, FLAGS_longitudinal_acceleration_lower_bound,
                      FLAGS_longitudinal_acceleration_upper_bound)) {
       ADEBUG << "Longitudinal acceleration at relative time " << t
@@ -60,7 +86,7 @@ ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
       return Result::LON_ACCELERATION_OUT_OF_BOUND;
     }
 
-    double kappa = p.path_point().kappa();
+    double kappa = Kappa(trajectory, i);
     if (!WithinRange(kappa, -FLAGS_kappa_bound, FLAGS_kappa_bound)) {
       ADEBUG << "Kappa at relative time " << t
              << " exceeds bound, value: " << kappa << ", bound ["
@@ -70,17 +96,14 @@ ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
   }
 
   for (size_t i = 1; i < trajectory.NumOfPoints(); ++i) {
-    const auto& p0 = trajectory.TrajectoryPointAt(static_cast<uint32_t>(i - 1));
-    const auto& p1 = trajectory.TrajectoryPointAt(static_cast<uint32_t>(i));
-
-    if (p1.relative_time() > kMaxCheckRelativeTime) {
+    if (RelativeTime(trajectory, i) > kMaxCheckRelativeTime) {
       break;
     }
 
-    double t = p0.relative_time();
+    double t = RelativeTime(trajectory, i - 1);
 
-    double dt = p1.relative_time() - p0.relative_time();
-    double d_lon_a = p1.a() - p0.a();
+    double dt = RelativeTime(trajectory, i) - RelativeTime(trajectory, i - 1);
+    double d_lon_a = A(trajectory, i) - A(trajectory, i - 1);
     double lon_jerk = d_lon_a / dt;
     if (!WithinRange(lon_jerk, FLAGS_longitudinal_jerk_lower_bound,
                      FLAGS_longitudinal_jerk_upper_bound)) {
@@ -91,7 +114,7 @@ ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
       return Result::LON_JERK_OUT_OF_BOUND;
     }
 
-    double lat_a = p1.v() * p1.v() * p1.path_point().kappa();
+    double lat_a = V(trajectory, i) * V(trajectory, i) * Kappa(trajectory, i);
     if (!WithinRange(lat_a, -FLAGS_lateral_acceleration_bound,
                      FLAGS_lateral_acceleration_bound)) {
       ADEBUG << "Lateral acceleration at relative time " << t
@@ -121,5 +144,17 @@ ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
   return Result::VALID;
 }
 
+}  // namespace
+
+ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
+    const DiscretizedTrajectory& trajectory) {
+  return ValidTrajectoryImpl(trajectory);
+}
+
+ConstraintChecker::Result ConstraintChecker::ValidTrajectory(
+    const CompactTrajectory& trajectory) {
+  return ValidTrajectoryImpl(trajectory);
+}
+
 }  // namespace planning
 }  // namespace apollo
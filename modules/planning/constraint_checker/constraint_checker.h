@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "modules/planning/common/trajectory/compact_trajectory.h"
 #include "modules/planning/common/trajectory/discretized_trajectory.h"
 
 namespace apollo {
@@ -39,6 +40,7 @@ class ConstraintChecker {
   };
   ConstraintChecker() = delete;
   static Result ValidTrajectory(const DiscretizedTrajectory& trajectory);
+  static Result ValidTrajectory(const CompactTrajectory& trajectory);
 };
 
 }  // namespace planning
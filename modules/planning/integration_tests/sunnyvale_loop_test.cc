@@ -194,6 +194,22 @@ TEST_F(SunnyvaleLoopTest, change_lane) {
   RUN_GOLDEN_TEST(0);
 }
 
+/*
+ * test change lane with the reference lines planned in parallel
+ * The change lane test case, which has to give the same result
+ */
+TEST_F(SunnyvaleLoopTest, change_lane_in_parallel) {
+  FLAGS_enable_parallel_reference_line_planning = true;
+  std::string seq_num = "9";
+  FLAGS_test_routing_response_file = seq_num + "_routing.pb.txt";
+  FLAGS_test_prediction_file = seq_num + "_prediction.pb.txt";
+  FLAGS_test_localization_file = seq_num + "_localization.pb.txt";
+  FLAGS_test_chassis_file = seq_num + "_chassis.pb.txt";
+  PlanningTestBase::SetUp();
+  EXPECT_TRUE(RunPlanning("change_lane", 0, false));
+  FLAGS_enable_parallel_reference_line_planning = false;
+}
+
 /*
  * test mission complete
  */
@@ -106,6 +106,10 @@ void PathTimeGraph::SetupObstacles(
   for (auto& path_time_obstacle : path_time_obstacle_map_) {
     path_time_obstacles_.push_back(path_time_obstacle.second);
   }
+
+  if (FLAGS_enable_path_time_obstacle_index) {
+    path_time_obstacle_index_ = PathTimeObstacleIndex(path_time_obstacles_);
+  }
 }
 
 void PathTimeGraph::SetStaticObstacle(
@@ -216,6 +220,9 @@ bool PathTimeGraph::GetPathTimeObstacle(const std::string& obstacle_id,
 std::vector<std::pair<double, double>> PathTimeGraph::GetPathBlockingIntervals(
     const double t) const {
   ACHECK(time_range_.first <= t && t <= time_range_.second);
+  if (FLAGS_enable_path_time_obstacle_index) {
+    return path_time_obstacle_index_.GetPathBlockingIntervals(t);
+  }
   std::vector<std::pair<double, double>> intervals;
   for (const auto& pt_obstacle : path_time_obstacles_) {
     if (t > pt_obstacle.max_t() || t < pt_obstacle.min_t()) {
@@ -240,6 +247,12 @@ std::vector<std::vector<std::pair<double, double>>>
 PathTimeGraph::GetPathBlockingIntervals(const double t_start,
                                         const double t_end,
                                         const double t_resolution) {
+  if (FLAGS_enable_path_time_obstacle_index) {
+    ACHECK(t_start > t_end || (time_range_.first <= t_start &&
+                               t_end <= time_range_.second));
+    return path_time_obstacle_index_.GetPathBlockingIntervals(t_start, t_end,
+                                                              t_resolution);
+  }
   std::vector<std::vector<std::pair<double, double>>> intervals;
   for (double t = t_start; t <= t_end; t += t_resolution) {
     intervals.push_back(GetPathBlockingIntervals(t));
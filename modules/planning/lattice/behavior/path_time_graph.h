@@ -33,6 +33,7 @@
 #include "modules/planning/common/reference_line_info.h"
 #include "modules/planning/common/speed/st_boundary.h"
 #include "modules/planning/common/speed/st_point.h"
+#include "modules/planning/lattice/behavior/path_time_obstacle_index.h"
 #include "modules/planning/reference_line/reference_line.h"
 
 namespace apollo {
@@ -103,6 +104,7 @@ class PathTimeGraph {
 
   std::unordered_map<std::string, STBoundary> path_time_obstacle_map_;
   std::vector<STBoundary> path_time_obstacles_;
+  PathTimeObstacleIndex path_time_obstacle_index_;
   std::vector<SLBoundary> static_obs_sl_boundaries_;
 };
 
@@ -0,0 +1,216 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/lattice/behavior/path_time_obstacle_index.h"
+
+#include <algorithm>
+#include <set>
+
+#include "modules/common/math/linear_interpolation.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::lerp;
+
+PathTimeObstacleIndex::PathTimeObstacleIndex(
+    const std::vector<STBoundary>& path_time_obstacles) {
+  edges_.resize(path_time_obstacles.size());
+  std::vector<size_t> indexes;
+  for (size_t i = 0; i < path_time_obstacles.size(); ++i) {
+    const auto& pt_obstacle = path_time_obstacles[i];
+    edges_[i].min_t = pt_obstacle.min_t();
+    edges_[i].max_t = pt_obstacle.max_t();
+    // an obstacle with an empty time span never blocks the path, and its
+    // corner points may not exist at all
+    if (!(edges_[i].min_t <= edges_[i].max_t)) {
+      continue;
+    }
+    edges_[i].bottom_left = pt_obstacle.bottom_left_point();
+    edges_[i].bottom_right = pt_obstacle.bottom_right_point();
+    edges_[i].upper_left = pt_obstacle.upper_left_point();
+    edges_[i].upper_right = pt_obstacle.upper_right_point();
+    indexes.push_back(i);
+  }
+
+  sorted_by_min_t_ = indexes;
+  std::stable_sort(sorted_by_min_t_.begin(), sorted_by_min_t_.end(),
+                   [this](const size_t lhs, const size_t rhs) {
+                     return edges_[lhs].min_t < edges_[rhs].min_t;
+                   });
+  sorted_by_max_t_ = indexes;
+  std::stable_sort(sorted_by_max_t_.begin(), sorted_by_max_t_.end(),
+                   [this](const size_t lhs, const size_t rhs) {
+                     return edges_[lhs].max_t < edges_[rhs].max_t;
+                   });
+
+  root_ = BuildNode(indexes);
+}
+
+int PathTimeObstacleIndex::BuildNode(const std::vector<size_t>& indexes) {
+  if (indexes.empty()) {
+    return -1;
+  }
+
+  // the median end point is an end point of some span, so the node always
+  // takes at least one obstacle and the recursion terminates
+  std::vector<double> end_points;
+  end_points.reserve(indexes.size() * 2);
+  for (const size_t index : indexes) {
+    end_points.push_back(edges_[index].min_t);
+    end_points.push_back(edges_[index].max_t);
+  }
+  auto median = end_points.begin() + end_points.size() / 2;
+  std::nth_element(end_points.begin(), median, end_points.end());
+  const double center = *median;
+
+  std::vector<size_t> left_indexes;
+  std::vector<size_t> right_indexes;
+  Node node;
+  node.center = center;
+  for (const size_t index : indexes) {
+    if (edges_[index].max_t < center) {
+      left_indexes.push_back(index);
+    } else if (edges_[index].min_t > center) {
+      right_indexes.push_back(index);
+    } else {
+      node.by_min_t.push_back(index);
+    }
+  }
+  node.by_max_t = node.by_min_t;
+  std::sort(node.by_min_t.begin(), node.by_min_t.end(),
+            [this](const size_t lhs, const size_t rhs) {
+              return edges_[lhs].min_t < edges_[rhs].min_t;
+            });
+  std::sort(node.by_max_t.begin(), node.by_max_t.end(),
+            [this](const size_t lhs, const size_t rhs) {
+              return edges_[lhs].max_t > edges_[rhs].max_t;
+            });
+
+  const int node_index = static_cast<int>(nodes_.size());
+  nodes_.push_back(std::move(node));
+  const int left = BuildNode(left_indexes);
+  const int right = BuildNode(right_indexes);
+  nodes_[node_index].left = left;
+  nodes_[node_index].right = right;
+  return node_index;
+}
+
+std::vector<size_t> PathTimeObstacleIndex::QueryObstacles(
+    const double t) const {
+  std::vector<size_t> indexes;
+  int node_index = root_;
+  while (node_index >= 0) {
+    const Node& node = nodes_[node_index];
+    if (t < node.center) {
+      for (const size_t index : node.by_min_t) {
+        if (edges_[index].min_t > t) {
+          break;
+        }
+        indexes.push_back(index);
+      }
+      node_index = node.left;
+    } else if (t > node.center) {
+      for (const size_t index : node.by_max_t) {
+        if (edges_[index].max_t < t) {
+          break;
+        }
+        indexes.push_back(index);
+      }
+      node_index = node.right;
+    } else {
+      indexes.insert(indexes.end(), node.by_min_t.begin(),
+                     node.by_min_t.end());
+      break;
+    }
+  }
+  std::sort(indexes.begin(), indexes.end());
+  return indexes;
+}
+
+std::vector<std::pair<double, double>>
+PathTimeObstacleIndex::GetPathBlockingIntervals(const double t) const {
+  std::vector<std::pair<double, double>> intervals;
+  for (const size_t index : QueryObstacles(t)) {
+    intervals.push_back(GetPathBlockingInterval(index, t));
+  }
+  return intervals;
+}
+
+std::vector<std::vector<std::pair<double, double>>>
+PathTimeObstacleIndex::GetPathBlockingIntervals(
+    const double t_start, const double t_end,
+    const double t_resolution) const {
+  std::vector<std::vector<std::pair<double, double>>> intervals;
+  // obstacles with min_t <= t <= max_t for the current sample, ordered by
+  // their index
+  std::set<size_t> active_indexes;
+  size_t next_start = 0;
+  size_t next_end = 0;
+  for (double t = t_start; t <= t_end; t += t_resolution) {
+    while (next_start < sorted_by_min_t_.size() &&
+           edges_[sorted_by_min_t_[next_start]].min_t <= t) {
+      active_indexes.insert(sorted_by_min_t_[next_start]);
+      ++next_start;
+    }
+    // every span ending before t started before t as well, so it has been
+    // inserted already
+    while (next_end < sorted_by_max_t_.size() &&
+           edges_[sorted_by_max_t_[next_end]].max_t < t) {
+      active_indexes.erase(sorted_by_max_t_[next_end]);
+      ++next_end;
+    }
+    std::vector<std::pair<double, double>> intervals_at_t;
+    intervals_at_t.reserve(active_indexes.size());
+    for (const size_t index : active_indexes) {
+      intervals_at_t.push_back(GetPathBlockingInterval(index, t));
+    }
+    intervals.push_back(std::move(intervals_at_t));
+  }
+  return intervals;
+}
+
+std::pair<double, double> PathTimeObstacleIndex::GetPathBlockingInterval(
+    const STBoundary& path_time_obstacle, const double t) {
+  double s_upper = lerp(path_time_obstacle.upper_left_point().s(),
+                        path_time_obstacle.upper_left_point().t(),
+                        path_time_obstacle.upper_right_point().s(),
+                        path_time_obstacle.upper_right_point().t(), t);
+
+  double s_lower = lerp(path_time_obstacle.bottom_left_point().s(),
+                        path_time_obstacle.bottom_left_point().t(),
+                        path_time_obstacle.bottom_right_point().s(),
+                        path_time_obstacle.bottom_right_point().t(), t);
+  return std::make_pair(s_lower, s_upper);
+}
+
+std::pair<double, double> PathTimeObstacleIndex::GetPathBlockingInterval(
+    const size_t index, const double t) const {
+  const ObstacleEdges& edges = edges_[index];
+  double s_upper = lerp(edges.upper_left.s(), edges.upper_left.t(),
+                        edges.upper_right.s(), edges.upper_right.t(), t);
+
+  double s_lower = lerp(edges.bottom_left.s(), edges.bottom_left.t(),
+                        edges.bottom_right.s(), edges.bottom_right.t(), t);
+  return std::make_pair(s_lower, s_upper);
+}
+
+}  // namespace planning
+}  // namespace apollo
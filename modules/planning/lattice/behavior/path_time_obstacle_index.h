@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "modules/planning/common/speed/st_boundary.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @brief Time index over the path time obstacles of a PathTimeGraph.
+ * The [min_t, max_t] spans of the obstacles are kept in a centered interval
+ * tree, so finding the obstacles blocking the path at a time takes
+ * O(log(n) + k) instead of scanning all of them. Obstacles are reported in
+ * the order of the vector the index is built from, and the blocking s
+ * intervals are interpolated on the same corner points, so the results match
+ * the linear scan of PathTimeGraph exactly.
+ */
+class PathTimeObstacleIndex {
+ public:
+  PathTimeObstacleIndex() = default;
+
+  explicit PathTimeObstacleIndex(
+      const std::vector<STBoundary>& path_time_obstacles);
+
+  /**
+   * @brief indexes of the obstacles with min_t <= t <= max_t, ascending
+   */
+  std::vector<size_t> QueryObstacles(const double t) const;
+
+  std::vector<std::pair<double, double>> GetPathBlockingIntervals(
+      const double t) const;
+
+  /**
+   * @brief blocking intervals at t_start, t_start + t_resolution, ... up to
+   * t_end, found by sweeping the time samples over the obstacles sorted by
+   * min_t and max_t instead of querying each sample separately.
+   */
+  std::vector<std::vector<std::pair<double, double>>> GetPathBlockingIntervals(
+      const double t_start, const double t_end,
+      const double t_resolution) const;
+
+  size_t size() const { return edges_.size(); }
+
+  /**
+   * @brief the s interval an obstacle blocks at time t, lerped on its
+   * bottom and upper edges
+   */
+  static std::pair<double, double> GetPathBlockingInterval(
+      const STBoundary& path_time_obstacle, const double t);
+
+ private:
+  // corner points of an obstacle, enough to interpolate its s extent
+  struct ObstacleEdges {
+    double min_t = 0.0;
+    double max_t = 0.0;
+    STPoint bottom_left;
+    STPoint bottom_right;
+    STPoint upper_left;
+    STPoint upper_right;
+  };
+
+  struct Node {
+    double center = 0.0;
+    // obstacles spanning the center, sorted by ascending min_t and by
+    // descending max_t
+    std::vector<size_t> by_min_t;
+    std::vector<size_t> by_max_t;
+    int left = -1;
+    int right = -1;
+  };
+
+  int BuildNode(const std::vector<size_t>& indexes);
+
+  std::pair<double, double> GetPathBlockingInterval(const size_t index,
+                                                    const double t) const;
+
+  std::vector<ObstacleEdges> edges_;
+  std::vector<Node> nodes_;
+  int root_ = -1;
+  // the indexed obstacles sorted by ascending min_t and max_t for sweeping
+  std::vector<size_t> sorted_by_min_t_;
+  std::vector<size_t> sorted_by_max_t_;
+};
+
+}  // namespace planning
+}  // namespace apollo
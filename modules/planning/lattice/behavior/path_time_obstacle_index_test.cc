@@ -0,0 +1,163 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/lattice/behavior/path_time_obstacle_index.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// the linear scan of PathTimeGraph::GetPathBlockingIntervals
+std::vector<std::pair<double, double>> ScanPathBlockingIntervals(
+    const std::vector<STBoundary>& path_time_obstacles, const double t) {
+  std::vector<std::pair<double, double>> intervals;
+  for (const auto& pt_obstacle : path_time_obstacles) {
+    if (t > pt_obstacle.max_t() || t < pt_obstacle.min_t()) {
+      continue;
+    }
+    intervals.push_back(
+        PathTimeObstacleIndex::GetPathBlockingInterval(pt_obstacle, t));
+  }
+  return intervals;
+}
+
+STBoundary MakeObstacle(const double t0, const double t1, const double s0,
+                        const double s1, const double length) {
+  std::vector<std::pair<STPoint, STPoint>> point_pairs;
+  point_pairs.emplace_back(STPoint(s0, t0), STPoint(s0 + length, t0));
+  point_pairs.emplace_back(STPoint(s1, t1), STPoint(s1 + length, t1));
+  return STBoundary(point_pairs);
+}
+
+// obstacles spanning random parts of [0, 8], half of them starting and
+// ending exactly on the 0.1s sampling grid, plus ones with no points
+std::vector<STBoundary> MakeObstacles(const size_t num_obstacles,
+                                      std::mt19937* generator) {
+  std::uniform_real_distribution<double> time(0.0, 8.0);
+  std::uniform_int_distribution<int> time_step(0, 80);
+  std::uniform_real_distribution<double> s(0.0, 100.0);
+  std::uniform_real_distribution<double> length(0.5, 10.0);
+  std::vector<STBoundary> obstacles;
+  for (size_t i = 0; i < num_obstacles; ++i) {
+    double t0 = 0.0;
+    double t1 = 0.0;
+    if (i % 2 == 0) {
+      t0 = time(*generator);
+      t1 = time(*generator);
+    } else {
+      t0 = time_step(*generator) * 0.1;
+      t1 = time_step(*generator) * 0.1;
+    }
+    if (t1 < t0) {
+      std::swap(t0, t1);
+    }
+    t1 += 1e-3;
+    obstacles.push_back(MakeObstacle(t0, t1, s(*generator), s(*generator),
+                                     length(*generator)));
+    if (i % 7 == 0) {
+      obstacles.emplace_back();
+    }
+  }
+  return obstacles;
+}
+
+void ExpectSameIntervals(
+    const std::vector<std::pair<double, double>>& expected,
+    const std::vector<std::pair<double, double>>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].first, actual[i].first);
+    EXPECT_EQ(expected[i].second, actual[i].second);
+  }
+}
+
+}  // namespace
+
+TEST(PathTimeObstacleIndexTest, empty) {
+  PathTimeObstacleIndex index;
+  EXPECT_TRUE(index.GetPathBlockingIntervals(1.0).empty());
+
+  PathTimeObstacleIndex index_of_empty_obstacles(
+      std::vector<STBoundary>(3, STBoundary()));
+  EXPECT_EQ(3U, index_of_empty_obstacles.size());
+  EXPECT_TRUE(index_of_empty_obstacles.GetPathBlockingIntervals(1.0).empty());
+  const auto intervals =
+      index_of_empty_obstacles.GetPathBlockingIntervals(0.0, 8.0, 0.1);
+  EXPECT_EQ(81U, intervals.size());
+  for (const auto& intervals_at_t : intervals) {
+    EXPECT_TRUE(intervals_at_t.empty());
+  }
+}
+
+TEST(PathTimeObstacleIndexTest, query_obstacles) {
+  std::vector<STBoundary> obstacles;
+  obstacles.push_back(MakeObstacle(0.0, 4.0, 10.0, 20.0, 5.0));
+  obstacles.push_back(MakeObstacle(2.0, 3.0, 30.0, 30.0, 5.0));
+  obstacles.push_back(STBoundary());
+  obstacles.push_back(MakeObstacle(3.0, 8.0, 0.0, 50.0, 5.0));
+  PathTimeObstacleIndex index(obstacles);
+
+  EXPECT_EQ(std::vector<size_t>({0}), index.QueryObstacles(1.0));
+  EXPECT_EQ(std::vector<size_t>({0, 1}), index.QueryObstacles(2.0));
+  EXPECT_EQ(std::vector<size_t>({0, 1, 3}), index.QueryObstacles(3.0));
+  EXPECT_EQ(std::vector<size_t>({0, 3}), index.QueryObstacles(4.0));
+  EXPECT_EQ(std::vector<size_t>({3}), index.QueryObstacles(6.0));
+  EXPECT_TRUE(index.QueryObstacles(8.5).empty());
+
+  const auto intervals = index.GetPathBlockingIntervals(2.0);
+  ASSERT_EQ(2U, intervals.size());
+  EXPECT_DOUBLE_EQ(15.0, intervals[0].first);
+  EXPECT_DOUBLE_EQ(20.0, intervals[0].second);
+  EXPECT_DOUBLE_EQ(30.0, intervals[1].first);
+  EXPECT_DOUBLE_EQ(35.0, intervals[1].second);
+}
+
+TEST(PathTimeObstacleIndexTest, same_as_linear_scan) {
+  std::mt19937 generator(20240501);
+  for (const size_t num_obstacles : {1, 2, 5, 16, 64, 200}) {
+    const auto obstacles = MakeObstacles(num_obstacles, &generator);
+    PathTimeObstacleIndex index(obstacles);
+
+    std::uniform_real_distribution<double> time(-1.0, 9.0);
+    for (int i = 0; i < 200; ++i) {
+      const double t = time(generator);
+      ExpectSameIntervals(ScanPathBlockingIntervals(obstacles, t),
+                          index.GetPathBlockingIntervals(t));
+    }
+
+    for (const double t_resolution : {0.1, 0.25}) {
+      const auto intervals =
+          index.GetPathBlockingIntervals(0.0, 8.0, t_resolution);
+      size_t i = 0;
+      for (double t = 0.0; t <= 8.0; t += t_resolution) {
+        ASSERT_LT(i, intervals.size());
+        ExpectSameIntervals(ScanPathBlockingIntervals(obstacles, t),
+                            intervals[i]);
+        ExpectSameIntervals(intervals[i], index.GetPathBlockingIntervals(t));
+        ++i;
+      }
+      EXPECT_EQ(i, intervals.size());
+    }
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -30,15 +30,21 @@ using apollo::common::TrajectoryPoint;
 using apollo::common::math::CartesianFrenetConverter;
 using apollo::common::math::PathMatcher;
 
-DiscretizedTrajectory TrajectoryCombiner::Combine(
-    const std::vector<PathPoint>& reference_line, const Curve1d& lon_trajectory,
-    const Curve1d& lat_trajectory, const double init_relative_time) {
-  DiscretizedTrajectory combined_trajectory;
-
+namespace {
+
+// Sample the combined trajectory and pass its points to append_point.
+template <typename AppendPoint>
+void CombineTrajectory(const std::vector<PathPoint>& reference_line,
+                       const Curve1d& lon_trajectory,
+                       const Curve1d& lat_trajectory,
+                       const double init_relative_time,
+                       const AppendPoint& append_point) {
   double s0 = lon_trajectory.Evaluate(0, 0.0);
   double s_ref_max = reference_line.back().s();
   double accumulated_trajectory_s = 0.0;
-  PathPoint prev_trajectory_point;
+  bool has_prev_trajectory_point = false;
+  double prev_x = 0.0;
+  double prev_y = 0.0;
 
   double last_s = -FLAGS_numerical_epsilon;
   double t_param = 0.0;
@@ -67,12 +73,7 @@ DiscretizedTrajectory TrajectoryCombiner::Combine(
 
     PathPoint matched_ref_point = PathMatcher::MatchToPath(reference_line, s);
 
-    double x = 0.0;
-    double y = 0.0;
-    double theta = 0.0;
-    double kappa = 0.0;
-    double v = 0.0;
-    double a = 0.0;
+    CompactTrajectory::KinematicPoint point;
 
     const double rs = matched_ref_point.s();
     const double rx = matched_ref_point.x();
@@ -84,34 +85,63 @@ DiscretizedTrajectory TrajectoryCombiner::Combine(
     std::array<double, 3> s_conditions = {rs, s_dot, s_ddot};
     std::array<double, 3> d_conditions = {d, d_prime, d_pprime};
     CartesianFrenetConverter::frenet_to_cartesian(
-        rs, rx, ry, rtheta, rkappa, rdkappa, s_conditions, d_conditions, &x, &y,
-        &theta, &kappa, &v, &a);
+        rs, rx, ry, rtheta, rkappa, rdkappa, s_conditions, d_conditions,
+        &point.x, &point.y, &point.theta, &point.kappa, &point.v, &point.a);
 
-    if (prev_trajectory_point.has_x() && prev_trajectory_point.has_y()) {
-      double delta_x = x - prev_trajectory_point.x();
-      double delta_y = y - prev_trajectory_point.y();
+    if (has_prev_trajectory_point) {
+      double delta_x = point.x - prev_x;
+      double delta_y = point.y - prev_y;
       double delta_s = std::hypot(delta_x, delta_y);
       accumulated_trajectory_s += delta_s;
     }
 
-    TrajectoryPoint trajectory_point;
-    trajectory_point.mutable_path_point()->set_x(x);
-    trajectory_point.mutable_path_point()->set_y(y);
-    trajectory_point.mutable_path_point()->set_s(accumulated_trajectory_s);
-    trajectory_point.mutable_path_point()->set_theta(theta);
-    trajectory_point.mutable_path_point()->set_kappa(kappa);
-    trajectory_point.set_v(v);
-    trajectory_point.set_a(a);
-    trajectory_point.set_relative_time(t_param + init_relative_time);
-
-    combined_trajectory.AppendTrajectoryPoint(trajectory_point);
+    point.s = accumulated_trajectory_s;
+    point.relative_time = t_param + init_relative_time;
+    append_point(point);
 
     t_param = t_param + FLAGS_trajectory_time_resolution;
 
-    prev_trajectory_point = trajectory_point.path_point();
+    has_prev_trajectory_point = true;
+    prev_x = point.x;
+    prev_y = point.y;
   }
+}
+
+}  // namespace
+
+DiscretizedTrajectory TrajectoryCombiner::Combine(
+    const std::vector<PathPoint>& reference_line, const Curve1d& lon_trajectory,
+    const Curve1d& lat_trajectory, const double init_relative_time) {
+  DiscretizedTrajectory combined_trajectory;
+  CombineTrajectory(
+      reference_line, lon_trajectory, lat_trajectory, init_relative_time,
+      [&combined_trajectory](const CompactTrajectory::KinematicPoint& point) {
+        TrajectoryPoint trajectory_point;
+        trajectory_point.mutable_path_point()->set_x(point.x);
+        trajectory_point.mutable_path_point()->set_y(point.y);
+        trajectory_point.mutable_path_point()->set_s(point.s);
+        trajectory_point.mutable_path_point()->set_theta(point.theta);
+        trajectory_point.mutable_path_point()->set_kappa(point.kappa);
+        trajectory_point.set_v(point.v);
+        trajectory_point.set_a(point.a);
+        trajectory_point.set_relative_time(point.relative_time);
+        combined_trajectory.AppendTrajectoryPoint(trajectory_point);
+      });
   return combined_trajectory;
 }
 
+void TrajectoryCombiner::Combine(const std::vector<PathPoint>& reference_line,
+                                 const Curve1d& lon_trajectory,
+                                 const Curve1d& lat_trajectory,
+                                 const double init_relative_time,
+                                 CompactTrajectory* combined_trajectory) {
+  combined_trajectory->Clear();
+  CombineTrajectory(
+      reference_line, lon_trajectory, lat_trajectory, init_relative_time,
+      [combined_trajectory](const CompactTrajectory::KinematicPoint& point) {
+        combined_trajectory->AppendTrajectoryPoint(point);
+      });
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -24,6 +24,7 @@
 
 #include "modules/common_msgs/basic_msgs/pnc_point.pb.h"
 
+#include "modules/planning/common/trajectory/compact_trajectory.h"
 #include "modules/planning/common/trajectory/discretized_trajectory.h"
 #include "modules/planning/math/curve1d/curve1d.h"
 
@@ -36,6 +37,16 @@ class TrajectoryCombiner {
       const std::vector<common::PathPoint>& reference_line,
       const Curve1d& lon_trajectory, const Curve1d& lat_trajectory,
       const double init_relative_time);
+
+  /**
+   * @brief Combine into combined_trajectory, which is cleared first and keeps
+   * its capacity. The points are the same as the ones of the overload above.
+   */
+  static void Combine(const std::vector<common::PathPoint>& reference_line,
+                      const Curve1d& lon_trajectory,
+                      const Curve1d& lat_trajectory,
+                      const double init_relative_time,
+                      CompactTrajectory* combined_trajectory);
 };
 
 }  // namespace planning
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/lattice/trajectory_generation/trajectory_combiner.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "google/protobuf/util/message_differencer.h"
+#include "gtest/gtest.h"
+
+#include "modules/planning/constraint_checker/constraint_checker.h"
+#include "modules/planning/lattice/trajectory_generation/lattice_trajectory1d.h"
+#include "modules/planning/math/curve1d/quartic_polynomial_curve1d.h"
+#include "modules/planning/math/curve1d/quintic_polynomial_curve1d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+using google::protobuf::util::MessageDifferencer;
+
+namespace {
+
+// A reference line whose curvature changes along s.
+std::vector<PathPoint> CurvedReferenceLine() {
+  std::vector<PathPoint> reference_line;
+  double x = 0.0;
+  double y = 0.0;
+  double theta = 0.0;
+  const double ds = 0.5;
+  for (double s = 0.0; s <= 300.0; s += ds) {
+    const double kappa = 0.02 * std::sin(0.02 * s);
+    PathPoint point;
+    point.set_x(x);
+    point.set_y(y);
+    point.set_s(s);
+    point.set_theta(theta);
+    point.set_kappa(kappa);
+    point.set_dkappa(0.0004 * std::cos(0.02 * s));
+    reference_line.push_back(point);
+    x += ds * std::cos(theta);
+    y += ds * std::sin(theta);
+    theta += ds * kappa;
+  }
+  return reference_line;
+}
+
+}  // namespace
+
+TEST(TrajectoryCombinerTest, CompactSameAsDiscretized) {
+  const std::vector<PathPoint> reference_line = CurvedReferenceLine();
+  const double init_relative_time = 0.35;
+
+  CompactTrajectory compact_trajectory;
+  std::set<ConstraintChecker::Result> results;
+  for (const double v0 : {0.0, 5.0, 15.0}) {
+    for (const double v1 : {0.0, 10.0, 25.0, 45.0}) {
+      for (const double duration : {1.0, 4.0, 8.0}) {
+        auto lon_trajectory = std::make_shared<LatticeTrajectory1d>(
+            std::make_shared<QuarticPolynomialCurve1d>(
+                std::array<double, 3>{10.0, v0, 0.0},
+                std::array<double, 2>{v1, 0.0}, duration));
+        for (const double d1 : {-3.0, 0.0, 0.5}) {
+          for (const double length : {5.0, 30.0}) {
+            auto lat_trajectory = std::make_shared<LatticeTrajectory1d>(
+                std::make_shared<QuinticPolynomialCurve1d>(
+                    std::array<double, 3>{0.3, 0.0, 0.0},
+                    std::array<double, 3>{d1, 0.0, 0.0}, length));
+
+            const DiscretizedTrajectory expected = TrajectoryCombiner::Combine(
+                reference_line, *lon_trajectory, *lat_trajectory,
+                init_relative_time);
+            // the compact trajectory is reused like in the lattice planner
+            TrajectoryCombiner::Combine(reference_line, *lon_trajectory,
+                                        *lat_trajectory, init_relative_time,
+                                        &compact_trajectory);
+
+            const DiscretizedTrajectory trajectory =
+                compact_trajectory.ToDiscretizedTrajectory();
+            ASSERT_EQ(trajectory.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+              EXPECT_TRUE(
+                  MessageDifferencer::Equals(trajectory[i], expected[i]))
+                  << "point " << i << ": " << trajectory[i].ShortDebugString()
+                  << " expected: " << expected[i].ShortDebugString();
+            }
+
+            const auto result = ConstraintChecker::ValidTrajectory(expected);
+            EXPECT_EQ(ConstraintChecker::ValidTrajectory(compact_trajectory),
+                      result);
+            results.insert(result);
+          }
+        }
+      }
+    }
+  }
+  // valid trajectories and several kinds of failures are covered
+  EXPECT_EQ(results.count(ConstraintChecker::Result::VALID), 1);
+  EXPECT_GE(results.size(), 4);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -64,6 +64,7 @@ TrajectoryEvaluator::TrajectoryEvaluator(
   if (planning_target.has_stop_point()) {
     stop_point = planning_target.stop_point().s();
   }
+  std::vector<PtrTrajectory1d> valid_lon_trajectories;
   for (const auto& lon_trajectory : lon_trajectories) {
     double lon_end_s = lon_trajectory->Evaluate(0, end_time);
     if (init_s[0] < stop_point &&
@@ -74,17 +75,25 @@ TrajectoryEvaluator::TrajectoryEvaluator(
     if (!ConstraintChecker1d::IsValidLongitudinalTrajectory(*lon_trajectory)) {
       continue;
     }
-    for (const auto& lat_trajectory : lat_trajectories) {
-      /**
-       * The validity of the code needs to be verified.
-      if (!ConstraintChecker1d::IsValidLateralTrajectory(*lat_trajectory,
-                                                         *lon_trajectory)) {
-        continue;
+    valid_lon_trajectories.push_back(lon_trajectory);
+  }
+
+  if (FLAGS_enable_lattice_batch_evaluation) {
+    EvaluateBatch(planning_target, valid_lon_trajectories, lat_trajectories);
+  } else {
+    for (const auto& lon_trajectory : valid_lon_trajectories) {
+      for (const auto& lat_trajectory : lat_trajectories) {
+        /**
+         * The validity of the code needs to be verified.
+        if (!ConstraintChecker1d::IsValidLateralTrajectory(*lat_trajectory,
+                                                           *lon_trajectory)) {
+          continue;
+        }
+        */
+        double cost = Evaluate(planning_target, lon_trajectory, lat_trajectory);
+        cost_queue_.emplace(Trajectory1dPair(lon_trajectory, lat_trajectory),
+                            cost);
       }
-      */
-      double cost = Evaluate(planning_target, lon_trajectory, lat_trajectory);
-      cost_queue_.emplace(Trajectory1dPair(lon_trajectory, lat_trajectory),
-                          cost);
     }
   }
   ADEBUG << "Number of valid 1d trajectory pairs: " << cost_queue_.size();
@@ -162,6 +171,100 @@ double TrajectoryEvaluator::Evaluate(
          lat_comfort_cost * FLAGS_weight_lat_comfort;
 }
 
+void TrajectoryEvaluator::EvaluateBatch(
+    const PlanningTarget& planning_target,
+    const std::vector<PtrTrajectory1d>& lon_trajectories,
+    const std::vector<PtrTrajectory1d>& lat_trajectories) {
+  // The grids are accumulated like the loops of the single pair costs, so
+  // that the samples are the same.
+  std::vector<double> t_grid;
+  for (double t = 0.0; t < FLAGS_trajectory_time_length;
+       t += FLAGS_trajectory_time_resolution) {
+    t_grid.push_back(t);
+  }
+  std::vector<double> s_grid;
+  for (double s = 0.0; s < FLAGS_speed_lon_decision_horizon;
+       s += FLAGS_trajectory_space_resolution) {
+    s_grid.push_back(s);
+  }
+  const size_t num_t = t_grid.size();
+  const size_t num_s = s_grid.size();
+  const size_t num_lat = lat_trajectories.size();
+
+  // Running sums of the lateral offset costs over the space grid, the cost
+  // within an evaluation horizon is read from them.
+  std::vector<double> offset_sqr_sums(num_lat * (num_s + 1), 0.0);
+  std::vector<double> offset_abs_sums(num_lat * (num_s + 1), 0.0);
+  for (size_t j = 0; j < num_lat; ++j) {
+    const auto& lat_trajectory = lat_trajectories[j];
+    const double lat_offset_start = lat_trajectory->Evaluate(0, 0.0);
+    double* sqr_sums = &offset_sqr_sums[j * (num_s + 1)];
+    double* abs_sums = &offset_abs_sums[j * (num_s + 1)];
+    for (size_t k = 0; k < num_s; ++k) {
+      const double lat_offset = lat_trajectory->Evaluate(0, s_grid[k]);
+      const double cost = lat_offset / FLAGS_lat_offset_bound;
+      const double weight = lat_offset * lat_offset_start < 0.0
+                                ? FLAGS_weight_opposite_side_offset
+                                : FLAGS_weight_same_side_offset;
+      sqr_sums[k + 1] = sqr_sums[k] + cost * cost * weight;
+      abs_sums[k + 1] = abs_sums[k] + std::fabs(cost) * weight;
+    }
+  }
+
+  std::vector<double> relative_s(num_t);
+  std::vector<double> s_dot(num_t);
+  std::vector<double> s_dotdot(num_t);
+  std::vector<double> l_prime(num_t);
+  std::vector<double> l_primeprime(num_t);
+  for (const auto& lon_trajectory : lon_trajectories) {
+    const double lon_cost =
+        LonObjectiveCost(lon_trajectory, planning_target, reference_s_dot_) *
+            FLAGS_weight_lon_objective +
+        LonComfortCost(lon_trajectory) * FLAGS_weight_lon_jerk +
+        LonCollisionCost(lon_trajectory) * FLAGS_weight_lon_collision +
+        CentripetalAccelerationCost(lon_trajectory) *
+            FLAGS_weight_centripetal_acceleration;
+
+    const double evaluation_horizon =
+        std::min(FLAGS_speed_lon_decision_horizon,
+                 lon_trajectory->Evaluate(0, lon_trajectory->ParamLength()));
+    const size_t num_offsets = static_cast<size_t>(
+        std::lower_bound(s_grid.begin(), s_grid.end(), evaluation_horizon) -
+        s_grid.begin());
+
+    for (size_t k = 0; k < num_t; ++k) {
+      relative_s[k] = lon_trajectory->Evaluate(0, t_grid[k]) - init_s_[0];
+      s_dot[k] = lon_trajectory->Evaluate(1, t_grid[k]);
+      s_dotdot[k] = lon_trajectory->Evaluate(2, t_grid[k]);
+    }
+
+    for (size_t j = 0; j < num_lat; ++j) {
+      const auto& lat_trajectory = lat_trajectories[j];
+      for (size_t k = 0; k < num_t; ++k) {
+        l_prime[k] = lat_trajectory->Evaluate(1, relative_s[k]);
+        l_primeprime[k] = lat_trajectory->Evaluate(2, relative_s[k]);
+      }
+      double lat_comfort_cost = 0.0;
+      for (size_t k = 0; k < num_t; ++k) {
+        lat_comfort_cost = std::max(
+            lat_comfort_cost, std::fabs(l_primeprime[k] * s_dot[k] * s_dot[k] +
+                                        l_prime[k] * s_dotdot[k]));
+      }
+
+      const size_t offset_index = j * (num_s + 1) + num_offsets;
+      const double lat_offset_cost =
+          offset_sqr_sums[offset_index] /
+          (offset_abs_sums[offset_index] + FLAGS_numerical_epsilon);
+
+      const double cost = lon_cost +
+                          lat_offset_cost * FLAGS_weight_lat_offset +
+                          lat_comfort_cost * FLAGS_weight_lat_comfort;
+      cost_queue_.emplace(Trajectory1dPair(lon_trajectory, lat_trajectory),
+                          cost);
+    }
+  }
+}
+
 double TrajectoryEvaluator::LatOffsetCost(
     const PtrTrajectory1d& lat_trajectory,
     const std::vector<double>& s_values) const {
@@ -75,6 +75,17 @@ class TrajectoryEvaluator {
                   const std::shared_ptr<Curve1d>& lat_trajectory,
                   std::vector<double>* cost_components = nullptr) const;
 
+  /**
+   * @brief Evaluate all the pairs of the given trajectories into cost_queue_,
+   * with the same costs as Evaluate. The longitudinal costs are computed once
+   * per longitudinal trajectory and the lateral costs on trajectories sampled
+   * once into contiguous arrays.
+   */
+  void EvaluateBatch(
+      const PlanningTarget& planning_target,
+      const std::vector<std::shared_ptr<Curve1d>>& lon_trajectories,
+      const std::vector<std::shared_ptr<Curve1d>>& lat_trajectories);
+
   double LatOffsetCost(const std::shared_ptr<Curve1d>& lat_trajectory,
                        const std::vector<double>& s_values) const;
 
@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/lattice/trajectory_generation/trajectory_evaluator.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/lattice/trajectory_generation/lattice_trajectory1d.h"
+#include "modules/planning/math/curve1d/quartic_polynomial_curve1d.h"
+#include "modules/planning/math/curve1d/quintic_polynomial_curve1d.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+const std::array<double, 3> kInitS = {0.0, 10.0, 0.0};
+const std::array<double, 3> kInitD = {0.5, 0.0, 0.0};
+
+// cruising trajectories like Trajectory1dGenerator::GenerateTrajectory1DBundle
+std::vector<std::shared_ptr<Curve1d>> LonTrajectories() {
+  std::vector<std::shared_ptr<Curve1d>> trajectories;
+  for (const double v : {6.0, 8.0, 10.0, 12.0, 14.0}) {
+    for (const double t : {1.0, 2.0, 4.0, 6.0, 8.0}) {
+      trajectories.push_back(std::make_shared<LatticeTrajectory1d>(
+          std::shared_ptr<Curve1d>(
+              new QuarticPolynomialCurve1d(kInitS, {v, 0.0}, t))));
+    }
+  }
+  return trajectories;
+}
+
+std::vector<std::shared_ptr<Curve1d>> LatTrajectories() {
+  std::vector<std::shared_ptr<Curve1d>> trajectories;
+  for (const double d : {-0.5, 0.0, 0.5}) {
+    for (const double s : {10.0, 20.0, 40.0, 80.0}) {
+      trajectories.push_back(std::make_shared<LatticeTrajectory1d>(
+          std::shared_ptr<Curve1d>(
+              new QuinticPolynomialCurve1d(kInitD, {d, 0.0, 0.0}, s))));
+    }
+  }
+  return trajectories;
+}
+
+}  // namespace
+
+TEST(TrajectoryEvaluatorTest, BatchEvaluationSameAsPairs) {
+  // an arc of radius 100m
+  constexpr double kKappa = 0.01;
+  std::vector<common::PathPoint> reference_line;
+  for (int i = 0; i <= 200; ++i) {
+    const double s = static_cast<double>(i);
+    common::PathPoint point;
+    point.set_x(std::sin(s * kKappa) / kKappa);
+    point.set_y((1.0 - std::cos(s * kKappa)) / kKappa);
+    point.set_theta(s * kKappa);
+    point.set_kappa(kKappa);
+    point.set_dkappa(0.0);
+    point.set_s(s);
+    reference_line.push_back(point);
+  }
+  auto path_time_graph = std::make_shared<PathTimeGraph>(
+      std::vector<const Obstacle*>(), reference_line, nullptr, 0.0, 200.0,
+      0.0, FLAGS_trajectory_time_length, kInitD);
+  auto ptr_reference_line =
+      std::make_shared<std::vector<common::PathPoint>>(reference_line);
+
+  PlanningTarget planning_target;
+  planning_target.set_cruise_speed(10.0);
+  const auto lon_trajectories = LonTrajectories();
+  const auto lat_trajectories = LatTrajectories();
+
+  const bool enable_lattice_batch_evaluation =
+      FLAGS_enable_lattice_batch_evaluation;
+  FLAGS_enable_lattice_batch_evaluation = false;
+  TrajectoryEvaluator expected(kInitS, planning_target, lon_trajectories,
+                               lat_trajectories, path_time_graph,
+                               ptr_reference_line);
+  FLAGS_enable_lattice_batch_evaluation = true;
+  TrajectoryEvaluator batch(kInitS, planning_target, lon_trajectories,
+                            lat_trajectories, path_time_graph,
+                            ptr_reference_line);
+  FLAGS_enable_lattice_batch_evaluation = enable_lattice_batch_evaluation;
+
+  ASSERT_GT(expected.num_of_trajectory_pairs(), lat_trajectories.size());
+  ASSERT_EQ(batch.num_of_trajectory_pairs(),
+            expected.num_of_trajectory_pairs());
+  // the same costs, popped in the same order
+  while (expected.has_more_trajectory_pairs()) {
+    ASSERT_TRUE(batch.has_more_trajectory_pairs());
+    EXPECT_NEAR(batch.top_trajectory_pair_cost(),
+                expected.top_trajectory_pair_cost(), 1e-9);
+    const auto expected_pair = expected.next_top_trajectory_pair();
+    const auto batch_pair = batch.next_top_trajectory_pair();
+    EXPECT_EQ(batch_pair.first, expected_pair.first);
+    EXPECT_EQ(batch_pair.second, expected_pair.second);
+  }
+  EXPECT_FALSE(batch.has_more_trajectory_pairs());
+}
+
+}  // namespace planning
+}  // namespace apollo
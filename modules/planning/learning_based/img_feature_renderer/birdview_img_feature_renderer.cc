@@ -16,6 +16,9 @@
 
 #include "modules/planning/learning_based/img_feature_renderer/birdview_img_feature_renderer.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <string>
 #include <utility>
 #include <vector>
@@ -46,25 +49,50 @@ bool BirdviewImgFeatureRenderer::Init(const PlanningSemanticMapConfig& config) {
   // the basemap is not yet initialized in HDMapUtil
   apollo::hdmap::HDMapUtil::BaseMap();
 
-  const std::string map_name =
-      FLAGS_map_dir.substr(FLAGS_map_dir.find_last_of("/") + 1);
-  if (map_name != "sunnyvale_with_two_offices" && map_name != "sunnyvale") {
-    AERROR << "Map other than sunnyvale_with_two_offices are not supported";
-  }
-  // TODO(Jinyun): add sunnyvale map or draw basemap online
-  if (map_name == "sunnyvale") {
-    AWARN << "use sunnyvale_with_two_offices for sunnyvale for now";
-  }
+  if (config_.enable_static_map_tile_cache()) {
+    // base maps of any map are drawn from the hd map tile by tile on demand
+    roadmap_tile_cache_.reset(new StaticMapTileCache(
+        config_.resolution(), config_.static_map_tile_size(),
+        config_.max_static_map_tiles(), CV_8UC3,
+        [this](const int min_col, const int min_row, cv::Mat* tile) {
+          DrawRoadMapTile(min_col, min_row, tile);
+        }));
+    speedlimit_tile_cache_.reset(new StaticMapTileCache(
+        config_.resolution(), config_.static_map_tile_size(),
+        config_.max_static_map_tiles(), CV_8UC3,
+        [this](const int min_col, const int min_row, cv::Mat* tile) {
+          DrawSpeedlimitMapTile(min_col, min_row, tile);
+        }));
+  } else {
+    roadmap_tile_cache_.reset();
+    speedlimit_tile_cache_.reset();
+
+    const std::string map_name =
+        FLAGS_map_dir.substr(FLAGS_map_dir.find_last_of("/") + 1);
+    if (map_name != "sunnyvale_with_two_offices" && map_name != "sunnyvale") {
+      AERROR << "Map other than sunnyvale_with_two_offices are not supported";
+    }
+    // TODO(Jinyun): add sunnyvale map or draw basemap online
+    if (map_name == "sunnyvale") {
+      AWARN << "use sunnyvale_with_two_offices for sunnyvale for now";
+    }
 
-  // TODO(Jinyun): move to a more managable place
-  map_bottom_left_point_x_ = 585875.3316302994;
-  map_bottom_left_point_y_ = 4139916.6342316796;
-  bool roadmap_img_status = LoadRoadMap(ROADMAP_IMG_PATH);
-  bool speedlimit_img_status = LoadSpeedlimitMap(SPEEDLIMITMAP_IMG_PATH);
+    // TODO(Jinyun): move to a more managable place
+    map_bottom_left_point_x_ = 585875.3316302994;
+    map_bottom_left_point_y_ = 4139916.6342316796;
+    bool roadmap_img_status = LoadRoadMap(ROADMAP_IMG_PATH);
+    bool speedlimit_img_status = LoadSpeedlimitMap(SPEEDLIMITMAP_IMG_PATH);
 
-  if (!roadmap_img_status || !speedlimit_img_status) {
-    AERROR << "Base map image read failed";
-    return false;
+    if (!roadmap_img_status || !speedlimit_img_status) {
+      AERROR << "Base map image read failed";
+      return false;
+    }
+
+    if (base_roadmap_img_.size[0] != base_speedlimit_img_.size[0] ||
+        base_roadmap_img_.size[1] != base_speedlimit_img_.size[1]) {
+      AERROR << "base map sizes doesn't match";
+      return false;
+    }
   }
 
   ego_cur_point_img_ =
@@ -80,12 +108,6 @@ bool BirdviewImgFeatureRenderer::Init(const PlanningSemanticMapConfig& config) {
     return false;
   }
 
-  if (base_roadmap_img_.size[0] != base_speedlimit_img_.size[0] ||
-      base_roadmap_img_.size[1] != base_speedlimit_img_.size[1]) {
-    AERROR << "base map sizes doesn't match";
-    return false;
-  }
-
   std::vector<cv::Mat> merge_imgs = {ego_cur_point_img_, ego_cur_box_img_};
   cv::merge(merge_imgs, stacked_ego_cur_status_img_);
 
@@ -125,43 +147,53 @@ bool BirdviewImgFeatureRenderer::RenderMultiChannelEnv(
   const double current_y = current_path_point.y();
   const double current_heading = current_path_point.theta();
 
+  layer_time_ms_.clear();
+  auto layer_start_time = std::chrono::steady_clock::now();
   if (!RenderEgoPastPoint(learning_data_frame, current_time_sec, current_x,
                           current_y, current_heading, &ego_past)) {
     AERROR << "RenderEgoPastPoint failed";
     return false;
   }
+  RecordLayerTime("ego_past", &layer_start_time);
   if (!RenderObsPastBox(learning_data_frame, current_time_sec, &obs_past)) {
     AERROR << "RenderObsPastBox failed";
     return false;
   }
+  RecordLayerTime("obs_past", &layer_start_time);
   if (!RenderObsFutureBox(learning_data_frame, current_time_sec, &obs_future)) {
     AERROR << "RenderObsFutureBox failed";
     return false;
   }
+  RecordLayerTime("obs_future", &layer_start_time);
   if (!RenderLocalRoadMap(current_x, current_y, current_heading, &road_map)) {
     AERROR << "RenderLocalRoadMap failed";
     return false;
   }
+  RecordLayerTime("road_map", &layer_start_time);
   if (!RenderRouting(learning_data_frame, current_x, current_y, current_heading,
                      &routing)) {
     AERROR << "RenderRouting failed";
     return false;
   }
+  RecordLayerTime("routing", &layer_start_time);
   if (!RenderLocalSpeedlimitMap(current_x, current_y, current_heading,
                                 &speed_limit)) {
     AERROR << "RenderLocalSpeedlimitMap failed";
     return false;
   }
+  RecordLayerTime("speed_limit", &layer_start_time);
   if (!RenderTrafficLight(learning_data_frame, current_x, current_y,
                           current_heading, &traffic_light)) {
     AERROR << "RenderTrafficLight failed";
     return false;
   }
+  RecordLayerTime("traffic_light", &layer_start_time);
 
   std::vector<cv::Mat> merge_imgs = {ego_cur_box_img_, ego_past,     obs_past,
                                      obs_future,       road_map,     routing,
                                      speed_limit,      traffic_light};
   cv::merge(merge_imgs, *img_feature);
+  RecordLayerTime("merge", &layer_start_time);
   return true;
 }
 
@@ -186,37 +218,46 @@ bool BirdviewImgFeatureRenderer::RenderBGREnv(
   const double current_y = current_path_point.y();
   const double current_heading = current_path_point.theta();
 
+  layer_time_ms_.clear();
+  auto layer_start_time = std::chrono::steady_clock::now();
   if (!RenderLocalRoadMap(current_x, current_y, current_heading, &bgr_canvas)) {
     AERROR << "RenderLocalRoadMap failed";
     return false;
   }
+  RecordLayerTime("road_map", &layer_start_time);
   if (!RenderRouting(learning_data_frame, current_x, current_y, current_heading,
                      &bgr_canvas)) {
     AERROR << "RenderRouting failed";
     return false;
   }
+  RecordLayerTime("routing", &layer_start_time);
   if (!RenderTrafficLight(learning_data_frame, current_x, current_y,
                           current_heading, &bgr_canvas)) {
     AERROR << "RenderTrafficLight failed";
     return false;
   }
+  RecordLayerTime("traffic_light", &layer_start_time);
   if (!RenderObsPastBox(learning_data_frame, current_time_sec, &bgr_canvas)) {
     AERROR << "RenderObsPastBox failed";
     return false;
   }
+  RecordLayerTime("obs_past", &layer_start_time);
   if (!RenderObsFutureBox(learning_data_frame, current_time_sec, &bgr_canvas)) {
     AERROR << "RenderObsFutureBox failed";
     return false;
   }
+  RecordLayerTime("obs_future", &layer_start_time);
   if (!RenderEgoCurrentBox(&bgr_canvas)) {
     AERROR << "RenderEgoCurrentBox failed";
     return false;
   }
+  RecordLayerTime("ego_box", &layer_start_time);
   if (!RenderEgoPastPoint(learning_data_frame, current_time_sec, current_x,
                           current_y, current_heading, &bgr_canvas)) {
     AERROR << "RenderEgoPastPoint failed";
     return false;
   }
+  RecordLayerTime("ego_past", &layer_start_time);
 
   bgr_canvas.copyTo(*img_feature);
 
@@ -255,6 +296,10 @@ bool BirdviewImgFeatureRenderer::LoadSpeedlimitMap(
 bool BirdviewImgFeatureRenderer::RenderLocalRoadMap(
     const double ego_current_x, const double ego_current_y,
     const double ego_current_heading, cv::Mat* img_feature) {
+  if (roadmap_tile_cache_ != nullptr) {
+    return CropByPose(ego_current_x, ego_current_y, ego_current_heading,
+                      roadmap_tile_cache_.get(), img_feature);
+  }
   return CropByPose(ego_current_x, ego_current_y, ego_current_heading,
                     base_roadmap_img_, img_feature);
 }
@@ -262,6 +307,10 @@ bool BirdviewImgFeatureRenderer::RenderLocalRoadMap(
 bool BirdviewImgFeatureRenderer::RenderLocalSpeedlimitMap(
     const double ego_current_x, const double ego_current_y,
     const double ego_current_heading, cv::Mat* img_feature) {
+  if (speedlimit_tile_cache_ != nullptr) {
+    return CropByPose(ego_current_x, ego_current_y, ego_current_heading,
+                      speedlimit_tile_cache_.get(), img_feature);
+  }
   return CropByPose(ego_current_x, ego_current_y, ego_current_heading,
                     base_speedlimit_img_, img_feature);
 }
@@ -621,12 +670,34 @@ bool BirdviewImgFeatureRenderer::CropByPose(const double ego_x,
   cv::Rect rough_rect(ego_img_idx.x - rough_radius,
                       ego_img_idx.y - rough_radius, 2 * rough_radius,
                       2 * rough_radius);
+  return WarpByPose(ego_heading, base_map(rough_rect), rough_radius,
+                    img_feature);
+}
+
+bool BirdviewImgFeatureRenderer::CropByPose(const double ego_x,
+                                            const double ego_y,
+                                            const double ego_heading,
+                                            StaticMapTileCache* tile_cache,
+                                            cv::Mat* img_feature) {
+  const int rough_radius = static_cast<int>(sqrt(
+      config_.height() * config_.height() + config_.width() * config_.width()));
+  cv::Mat rough_patch;
+  tile_cache->GetRegion(tile_cache->GetCol(ego_x) - rough_radius,
+                        tile_cache->GetRow(ego_y) - rough_radius,
+                        2 * rough_radius, 2 * rough_radius, &rough_patch);
+  return WarpByPose(ego_heading, rough_patch, rough_radius, img_feature);
+}
+
+bool BirdviewImgFeatureRenderer::WarpByPose(const double ego_heading,
+                                            const cv::Mat& rough_patch,
+                                            const int rough_radius,
+                                            cv::Mat* img_feature) {
   cv::Mat rotation_matrix =
       cv::getRotationMatrix2D(cv::Point2i(rough_radius, rough_radius),
                               90.0 - ego_heading * 180.0 / M_PI, 1.0);
   cv::Mat rotated_mat;
-  cv::warpAffine(base_map(rough_rect), rotated_mat, rotation_matrix,
-                 base_map(rough_rect).size());
+  cv::warpAffine(rough_patch, rotated_mat, rotation_matrix,
+                 rough_patch.size());
 
   cv::Rect fine_rect(rough_radius - config_.ego_idx_x(),
                      rough_radius - config_.ego_idx_y(), config_.height(),
@@ -636,6 +707,159 @@ bool BirdviewImgFeatureRenderer::CropByPose(const double ego_x,
   return true;
 }
 
+void BirdviewImgFeatureRenderer::DrawRoadMapTile(const int min_col,
+                                                 const int min_row,
+                                                 cv::Mat* tile) {
+  const double tile_length = tile->cols * config_.resolution();
+  common::PointENU tile_center;
+  tile_center.set_x((min_col + 0.5 * tile->cols) * config_.resolution());
+  tile_center.set_y(-(min_row + 0.5 * tile->rows) * config_.resolution());
+  // lane boundaries are drawn thicker than a pixel, so look a bit further
+  const double search_radius = tile_length * M_SQRT1_2 + 1.0;
+  const auto& base_map = apollo::hdmap::HDMapUtil::BaseMap();
+
+  std::vector<apollo::hdmap::RoadInfoConstPtr> roads;
+  base_map.GetRoads(tile_center, search_radius, &roads);
+  for (const auto& road : roads) {
+    for (const auto& section : road->road().section()) {
+      std::vector<cv::Point> polygon;
+      for (const auto& edge : section.boundary().outer_polygon().edge()) {
+        if (edge.type() == hdmap::BoundaryEdge::LEFT_BOUNDARY) {
+          for (const auto& segment : edge.curve().segment()) {
+            for (const auto& point : segment.line_segment().point()) {
+              polygon.push_back(
+                  GetTilePointImgIdx(point.x(), point.y(), min_col, min_row));
+            }
+          }
+        } else if (edge.type() == hdmap::BoundaryEdge::RIGHT_BOUNDARY) {
+          for (const auto& segment : edge.curve().segment()) {
+            for (const auto& point : segment.line_segment().point()) {
+              polygon.insert(
+                  polygon.begin(),
+                  GetTilePointImgIdx(point.x(), point.y(), min_col, min_row));
+            }
+          }
+        }
+      }
+      cv::fillPoly(*tile,
+                   std::vector<std::vector<cv::Point>>({std::move(polygon)}),
+                   cv::Scalar(64, 64, 64));
+    }
+  }
+
+  std::vector<apollo::hdmap::JunctionInfoConstPtr> junctions;
+  base_map.GetJunctions(tile_center, search_radius, &junctions);
+  for (const auto& junction : junctions) {
+    std::vector<cv::Point> polygon;
+    for (const auto& point : junction->junction().polygon().point()) {
+      polygon.push_back(
+          GetTilePointImgIdx(point.x(), point.y(), min_col, min_row));
+    }
+    cv::fillPoly(*tile,
+                 std::vector<std::vector<cv::Point>>({std::move(polygon)}),
+                 cv::Scalar(128, 128, 128));
+  }
+
+  std::vector<apollo::hdmap::CrosswalkInfoConstPtr> crosswalks;
+  base_map.GetCrosswalks(tile_center, search_radius, &crosswalks);
+  for (const auto& crosswalk : crosswalks) {
+    std::vector<cv::Point> polygon;
+    for (const auto& point : crosswalk->crosswalk().polygon().point()) {
+      polygon.push_back(
+          GetTilePointImgIdx(point.x(), point.y(), min_col, min_row));
+    }
+    cv::fillPoly(*tile,
+                 std::vector<std::vector<cv::Point>>({std::move(polygon)}),
+                 cv::Scalar(192, 192, 192));
+  }
+
+  std::vector<apollo::hdmap::LaneInfoConstPtr> lanes;
+  base_map.GetLanes(tile_center, search_radius, &lanes);
+  for (const auto& lane : lanes) {
+    // Not drawing boundary for virtual city_driving lane
+    if (lane->lane().type() == hdmap::Lane::CITY_DRIVING &&
+        lane->lane().left_boundary().virtual_() &&
+        lane->lane().right_boundary().virtual_()) {
+      continue;
+    }
+    for (const auto* boundary :
+         {&lane->lane().left_boundary(), &lane->lane().right_boundary()}) {
+      for (const auto& segment : boundary->curve().segment()) {
+        const int segment_point_size = segment.line_segment().point_size();
+        for (int i = 0; i < segment_point_size - 1; ++i) {
+          const auto& p0 = GetTilePointImgIdx(
+              segment.line_segment().point(i).x(),
+              segment.line_segment().point(i).y(), min_col, min_row);
+          const auto& p1 = GetTilePointImgIdx(
+              segment.line_segment().point(i + 1).x(),
+              segment.line_segment().point(i + 1).y(), min_col, min_row);
+          cv::line(*tile, p0, p1, cv::Scalar(255, 255, 255), 2);
+        }
+      }
+    }
+  }
+}
+
+void BirdviewImgFeatureRenderer::DrawSpeedlimitMapTile(const int min_col,
+                                                       const int min_row,
+                                                       cv::Mat* tile) {
+  const double tile_length = tile->cols * config_.resolution();
+  common::PointENU tile_center;
+  tile_center.set_x((min_col + 0.5 * tile->cols) * config_.resolution());
+  tile_center.set_y(-(min_row + 0.5 * tile->rows) * config_.resolution());
+
+  std::vector<apollo::hdmap::LaneInfoConstPtr> lanes;
+  apollo::hdmap::HDMapUtil::BaseMap().GetLanes(
+      tile_center, tile_length * M_SQRT1_2, &lanes);
+  for (const auto& lane : lanes) {
+    // lane area enclosed by its left boundary and reversed right boundary
+    std::vector<cv::Point> polygon;
+    for (const auto& segment : lane->lane().left_boundary().curve().segment()) {
+      for (const auto& point : segment.line_segment().point()) {
+        polygon.push_back(
+            GetTilePointImgIdx(point.x(), point.y(), min_col, min_row));
+      }
+    }
+    for (const auto& segment :
+         lane->lane().right_boundary().curve().segment()) {
+      for (const auto& point : segment.line_segment().point()) {
+        polygon.insert(
+            polygon.begin(),
+            GetTilePointImgIdx(point.x(), point.y(), min_col, min_row));
+      }
+    }
+    const double speed_ratio = std::min(
+        lane->lane().speed_limit() / config_.city_driving_max_speed(), 1.0);
+    cv::fillPoly(*tile,
+                 std::vector<std::vector<cv::Point>>({std::move(polygon)}),
+                 cv::Scalar::all(255.0 * speed_ratio));
+  }
+}
+
+cv::Point2i BirdviewImgFeatureRenderer::GetTilePointImgIdx(
+    const double point_x, const double point_y, const int min_col,
+    const int min_row) {
+  return cv::Point2i(
+      static_cast<int>(std::floor(point_x / config_.resolution())) - min_col,
+      static_cast<int>(std::floor(-point_y / config_.resolution())) - min_row);
+}
+
+void BirdviewImgFeatureRenderer::RecordLayerTime(
+    const std::string& layer,
+    std::chrono::steady_clock::time_point* layer_start_time) {
+  if (!config_.enable_render_timing()) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  layer_time_ms_.emplace_back(
+      layer,
+      std::chrono::duration<double, std::milli>(now - *layer_start_time)
+          .count());
+  ADEBUG << "birdview img layer[" << layer
+         << "] time: " << layer_time_ms_.back().second << " ms";
+  *layer_start_time = now;
+}
+
 cv::Point2i BirdviewImgFeatureRenderer::GetPointImgIdx(
     const double local_point_x, const double local_point_y,
     const int center_point_idx_x, const int center_point_idx_y) {
@@ -21,10 +21,13 @@
 
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "gtest/gtest_prod.h"
 #include "opencv2/opencv.hpp"
 
 #include "modules/planning/proto/learning_data.pb.h"
@@ -32,6 +35,7 @@
 
 #include "cyber/common/macros.h"
 #include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/learning_based/img_feature_renderer/static_map_tile_cache.h"
 
 namespace apollo {
 namespace planning {
@@ -89,6 +93,14 @@ class BirdviewImgFeatureRenderer {
   bool RenderCurrentEgoBox(const LearningDataFrame& learning_data_frame,
                            cv::Mat* img_feature);
 
+  /**
+   * @brief rendering time(ms) of every layer in the last RenderMultiChannelEnv
+   * or RenderBGREnv call, only filled when enable_render_timing is set
+   */
+  const std::vector<std::pair<std::string, double>>& layer_time_ms() const {
+    return layer_time_ms_;
+  }
+
  private:
   /**
    * @brief load a rgb road map from current map
@@ -241,6 +253,66 @@ class BirdviewImgFeatureRenderer {
                   const double ego_heading, const cv::Mat& base_map,
                   cv::Mat* img_feature);
 
+  /**
+   * @brief crop a img by ego around ego position from a static map tile cache
+   * @param ego_x ego point x coordinates
+   * @param ego_y ego point y coordinates
+   * @param ego_heading ego point heading
+   * @param tile_cache the static map layer to crop on
+   * @param img_feature a pointer to opencv img to render on
+   */
+  bool CropByPose(const double ego_x, const double ego_y,
+                  const double ego_heading, StaticMapTileCache* tile_cache,
+                  cv::Mat* img_feature);
+
+  /**
+   * @brief rotate a square patch centering around ego so that ego heads
+   * upward and crop the local map img from it
+   * @param ego_heading ego point heading
+   * @param rough_patch square patch with ego at its center
+   * @param rough_radius half of the patch size
+   * @param img_feature a pointer to opencv img to render on
+   */
+  bool WarpByPose(const double ego_heading, const cv::Mat& rough_patch,
+                  const int rough_radius, cv::Mat* img_feature);
+
+  /**
+   * @brief draw roads, junctions, crosswalks and lanes of a road map tile
+   * @param min_col global pixel column of the tile's left most pixels
+   * @param min_row global pixel row of the tile's top most pixels
+   * @param tile a pointer to opencv img to render on
+   */
+  void DrawRoadMapTile(const int min_col, const int min_row, cv::Mat* tile);
+
+  /**
+   * @brief draw lanes of a speed limit map tile, brighter for faster lanes
+   * @param min_col global pixel column of the tile's left most pixels
+   * @param min_row global pixel row of the tile's top most pixels
+   * @param tile a pointer to opencv img to render on
+   */
+  void DrawSpeedlimitMapTile(const int min_col, const int min_row,
+                             cv::Mat* tile);
+
+  /**
+   * @brief transform a world point to its index on a static map tile
+   * @param point_x world x coordinates
+   * @param point_y world y coordinates
+   * @param min_col global pixel column of the tile's left most pixels
+   * @param min_row global pixel row of the tile's top most pixels
+   * @return point indexes on the tile in cv::Point2i
+   */
+  cv::Point2i GetTilePointImgIdx(const double point_x, const double point_y,
+                                 const int min_col, const int min_row);
+
+  /**
+   * @brief record the time since layer_start_time for a layer and reset
+   * layer_start_time to now
+   * @param layer layer name
+   * @param layer_start_time a pointer to the layer start time
+   */
+  void RecordLayerTime(const std::string& layer,
+                       std::chrono::steady_clock::time_point* layer_start_time);
+
   /**
    * @brief transform a relative x,y double coordinates in "y axis point up"
    * axis to img "y axis point down" integer coordinates
@@ -295,6 +367,11 @@ class BirdviewImgFeatureRenderer {
   cv::Mat ego_cur_point_img_;
   cv::Mat ego_cur_box_img_;
   cv::Mat stacked_ego_cur_status_img_;
+  std::unique_ptr<StaticMapTileCache> roadmap_tile_cache_;
+  std::unique_ptr<StaticMapTileCache> speedlimit_tile_cache_;
+  std::vector<std::pair<std::string, double>> layer_time_ms_;
+
+  FRIEND_TEST(BirdviewImgFeatureRendererTest, CropByPoseFromTileCache);
 
   DECLARE_SINGLETON(BirdviewImgFeatureRenderer)
 };
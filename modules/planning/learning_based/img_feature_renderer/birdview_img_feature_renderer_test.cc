@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/learning_based/img_feature_renderer/birdview_img_feature_renderer.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr double kResolution = 0.2;
+constexpr int kBaseMapSize = 1200;
+// global pixel of the top left pixel of the base map
+constexpr int kOriginCol = -200;
+constexpr int kOriginRow = -901;
+
+}  // namespace
+
+TEST(BirdviewImgFeatureRendererTest, CropByPoseFromTileCache) {
+  PlanningSemanticMapConfig config;
+  config.set_resolution(kResolution);
+  config.set_height(200);
+  config.set_width(200);
+  config.set_ego_idx_x(100);
+  config.set_ego_idx_y(160);
+  auto* renderer = BirdviewImgFeatureRenderer::Instance();
+  renderer->config_ = config;
+
+  cv::Mat base_map(kBaseMapSize, kBaseMapSize, CV_8UC3);
+  cv::randu(base_map, cv::Scalar::all(0), cv::Scalar::all(256));
+  renderer->base_roadmap_img_ = base_map;
+  // the bottom of the base map is one row below the last pixel row, the same
+  // as for the map imgs the renderer loads
+  renderer->map_bottom_left_point_x_ = kOriginCol * kResolution;
+  renderer->map_bottom_left_point_y_ =
+      -(kOriginRow + kBaseMapSize + 1) * kResolution;
+
+  // the tiles are copied from the same base map, pixels outside of it are black
+  StaticMapTileCache tile_cache(
+      kResolution, 100, 64, CV_8UC3,
+      [&base_map](const int min_col, const int min_row, cv::Mat* tile) {
+        tile->setTo(cv::Scalar::all(0));
+        const cv::Rect tile_rect(min_col - kOriginCol, min_row - kOriginRow,
+                                 tile->cols, tile->rows);
+        const cv::Rect rect =
+            tile_rect & cv::Rect(0, 0, base_map.cols, base_map.rows);
+        if (rect.area() > 0) {
+          base_map(rect).copyTo((*tile)(rect - tile_rect.tl()));
+        }
+      });
+
+  // ego global pixels, the rough patches around them cross tile borders and
+  // cover negative and positive rows and cols
+  const std::vector<std::pair<int, int>> ego_pixels = {
+      {100, -100}, {137, 10}, {250, -250}, {299, -301}, {500, -500},
+      {700, -600}};
+  for (const auto& ego_pixel : ego_pixels) {
+    // ego at the pixel center so that both paths find the same pixel
+    const double ego_x = (ego_pixel.first + 0.5) * kResolution;
+    const double ego_y = -(ego_pixel.second + 0.5) * kResolution;
+    for (const double ego_heading :
+         {-2.5, -M_PI_2, -0.3, 0.0, 0.7, M_PI_2, 3.0}) {
+      cv::Mat expected;
+      ASSERT_TRUE(renderer->CropByPose(ego_x, ego_y, ego_heading, base_map,
+                                       &expected));
+      cv::Mat img_feature;
+      ASSERT_TRUE(renderer->CropByPose(ego_x, ego_y, ego_heading, &tile_cache,
+                                       &img_feature));
+      ASSERT_EQ(img_feature.size(), expected.size());
+      ASSERT_EQ(img_feature.type(), expected.type());
+      EXPECT_EQ(cv::norm(img_feature, expected, cv::NORM_INF), 0.0)
+          << "ego pixel (" << ego_pixel.first << ", " << ego_pixel.second
+          << "), ego_heading " << ego_heading;
+    }
+  }
+  EXPECT_GT(tile_cache.tiles_num(), 1);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/learning_based/img_feature_renderer/static_map_tile_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+StaticMapTileCache::StaticMapTileCache(const double resolution,
+                                       const int tile_size,
+                                       const int max_tiles_num,
+                                       const int img_type,
+                                       TileDrawer tile_drawer)
+    : resolution_(resolution),
+      tile_size_(tile_size),
+      max_tiles_num_(static_cast<size_t>(std::max(max_tiles_num, 1))),
+      img_type_(img_type),
+      tile_drawer_(std::move(tile_drawer)) {
+  CHECK_GT(resolution_, 0.0);
+  CHECK_GT(tile_size_, 0);
+}
+
+int StaticMapTileCache::GetCol(const double x) const {
+  return static_cast<int>(std::floor(x / resolution_));
+}
+
+int StaticMapTileCache::GetRow(const double y) const {
+  return static_cast<int>(std::floor(-y / resolution_));
+}
+
+void StaticMapTileCache::GetRegion(const int min_col, const int min_row,
+                                   const int cols, const int rows,
+                                   cv::Mat* region) {
+  region->create(rows, cols, img_type_);
+  const int max_col = min_col + cols;
+  const int max_row = min_row + rows;
+  for (int tile_row = FloorDiv(min_row, tile_size_);
+       tile_row * tile_size_ < max_row; ++tile_row) {
+    for (int tile_col = FloorDiv(min_col, tile_size_);
+         tile_col * tile_size_ < max_col; ++tile_col) {
+      const int tile_min_col = tile_col * tile_size_;
+      const int tile_min_row = tile_row * tile_size_;
+      // overlap of the tile and the region in global pixel indexes
+      const int begin_col = std::max(min_col, tile_min_col);
+      const int end_col = std::min(max_col, tile_min_col + tile_size_);
+      const int begin_row = std::max(min_row, tile_min_row);
+      const int end_row = std::min(max_row, tile_min_row + tile_size_);
+      const cv::Rect tile_rect(begin_col - tile_min_col,
+                               begin_row - tile_min_row, end_col - begin_col,
+                               end_row - begin_row);
+      const cv::Rect region_rect(begin_col - min_col, begin_row - min_row,
+                                 end_col - begin_col, end_row - begin_row);
+      GetTile(tile_col, tile_row)(tile_rect).copyTo((*region)(region_rect));
+    }
+  }
+}
+
+const cv::Mat& StaticMapTileCache::GetTile(const int tile_col,
+                                           const int tile_row) {
+  const uint64_t key =
+      (static_cast<uint64_t>(static_cast<uint32_t>(tile_col)) << 32) |
+      static_cast<uint32_t>(tile_row);
+  ++use_counter_;
+  auto iter = tiles_.find(key);
+  if (iter != tiles_.end()) {
+    iter->second.last_used = use_counter_;
+    return iter->second.img;
+  }
+
+  if (tiles_.size() >= max_tiles_num_) {
+    auto least_recently_used = std::min_element(
+        tiles_.begin(), tiles_.end(), [](const auto& lhs, const auto& rhs) {
+          return lhs.second.last_used < rhs.second.last_used;
+        });
+    tiles_.erase(least_recently_used);
+  }
+
+  Tile& tile = tiles_[key];
+  tile.img = cv::Mat::zeros(tile_size_, tile_size_, img_type_);
+  tile.last_used = use_counter_;
+  tile_drawer_(tile_col * tile_size_, tile_row * tile_size_, &tile.img);
+  ADEBUG << "drew static map tile [" << tile_col << ", " << tile_row << "]";
+  return tile.img;
+}
+
+int StaticMapTileCache::FloorDiv(const int value, const int divisor) {
+  const int quotient = value / divisor;
+  return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Define the static map tile cache class
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "gtest/gtest_prod.h"
+#include "opencv2/opencv.hpp"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @brief Lazily rasterized static map layer. The world is split into square
+ * tiles on a global pixel grid with column = floor(x / resolution) and
+ * row = floor(-y / resolution), so that rows grow downward like img rows.
+ * A tile is drawn once on first use and kept until it is the least recently
+ * used one and the cache is full.
+ */
+class StaticMapTileCache {
+ public:
+  /**
+   * @brief draws the static content of a tile
+   * @param min_col global pixel column of the tile's left most pixels
+   * @param min_row global pixel row of the tile's top most pixels
+   * @param tile a pointer to the zero initialized tile img to draw on
+   */
+  using TileDrawer =
+      std::function<void(const int min_col, const int min_row, cv::Mat* tile)>;
+
+  StaticMapTileCache(const double resolution, const int tile_size,
+                     const int max_tiles_num, const int img_type,
+                     TileDrawer tile_drawer);
+
+  /**
+   * @brief global pixel column of a world x coordinates
+   */
+  int GetCol(const double x) const;
+
+  /**
+   * @brief global pixel row of a world y coordinates
+   */
+  int GetRow(const double y) const;
+
+  /**
+   * @brief copy a region of the layer, drawing missing tiles on the way
+   * @param min_col global pixel column of the region's left most pixels
+   * @param min_row global pixel row of the region's top most pixels
+   * @param cols region width in pixel
+   * @param rows region height in pixel
+   * @param region a pointer to opencv img to copy into
+   */
+  void GetRegion(const int min_col, const int min_row, const int cols,
+                 const int rows, cv::Mat* region);
+
+  size_t tiles_num() const { return tiles_.size(); }
+
+ private:
+  struct Tile {
+    cv::Mat img;
+    uint64_t last_used = 0;
+  };
+
+  const cv::Mat& GetTile(const int tile_col, const int tile_row);
+
+  static int FloorDiv(const int value, const int divisor);
+
+  FRIEND_TEST(StaticMapTileCacheTest, FloorDiv);
+
+  double resolution_ = 0.0;
+  int tile_size_ = 0;
+  size_t max_tiles_num_ = 0;
+  int img_type_ = 0;
+  TileDrawer tile_drawer_;
+  // keyed by tile column in the high and tile row in the low 32 bits
+  std::unordered_map<uint64_t, Tile> tiles_;
+  uint64_t use_counter_ = 0;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/learning_based/img_feature_renderer/static_map_tile_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr int kTileSize = 4;
+
+// a value that only depends on the global pixel
+uchar PixelValue(const int col, const int row) {
+  return static_cast<uchar>(((col * 7 + row * 13) % 256 + 256) % 256);
+}
+
+void DrawPixelValues(const int min_col, const int min_row, cv::Mat* tile) {
+  for (int row = 0; row < tile->rows; ++row) {
+    for (int col = 0; col < tile->cols; ++col) {
+      tile->at<uchar>(row, col) = PixelValue(min_col + col, min_row + row);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(StaticMapTileCacheTest, FloorDiv) {
+  EXPECT_EQ(StaticMapTileCache::FloorDiv(0, 4), 0);
+  EXPECT_EQ(StaticMapTileCache::FloorDiv(3, 4), 0);
+  EXPECT_EQ(StaticMapTileCache::FloorDiv(4, 4), 1);
+  EXPECT_EQ(StaticMapTileCache::FloorDiv(-1, 4), -1);
+  EXPECT_EQ(StaticMapTileCache::FloorDiv(-4, 4), -1);
+  EXPECT_EQ(StaticMapTileCache::FloorDiv(-5, 4), -2);
+  EXPECT_EQ(StaticMapTileCache::FloorDiv(-8, 4), -2);
+}
+
+TEST(StaticMapTileCacheTest, GetColRow) {
+  StaticMapTileCache tile_cache(0.2, kTileSize, 64, CV_8UC1, DrawPixelValues);
+  EXPECT_EQ(tile_cache.GetCol(0.1), 0);
+  EXPECT_EQ(tile_cache.GetCol(-0.1), -1);
+  EXPECT_EQ(tile_cache.GetCol(1.0), 5);
+  // rows grow downward
+  EXPECT_EQ(tile_cache.GetRow(0.1), -1);
+  EXPECT_EQ(tile_cache.GetRow(-0.1), 0);
+  EXPECT_EQ(tile_cache.GetRow(1.0), -5);
+}
+
+TEST(StaticMapTileCacheTest, GetRegionAcrossTiles) {
+  StaticMapTileCache tile_cache(0.2, kTileSize, 64, CV_8UC1, DrawPixelValues);
+
+  // columns [-6, 5) and rows [-3, 6) cover tile columns [-2, 1] and tile rows
+  // [-1, 1]
+  constexpr int kMinCol = -6;
+  constexpr int kMinRow = -3;
+  cv::Mat region;
+  tile_cache.GetRegion(kMinCol, kMinRow, 11, 9, &region);
+  ASSERT_EQ(region.cols, 11);
+  ASSERT_EQ(region.rows, 9);
+  ASSERT_EQ(region.type(), CV_8UC1);
+  EXPECT_EQ(tile_cache.tiles_num(), 12);
+  for (int row = 0; row < region.rows; ++row) {
+    for (int col = 0; col < region.cols; ++col) {
+      EXPECT_EQ(region.at<uchar>(row, col),
+                PixelValue(kMinCol + col, kMinRow + row))
+          << "col " << col << " row " << row;
+    }
+  }
+}
+
+TEST(StaticMapTileCacheTest, LeastRecentlyUsedEviction) {
+  int draws = 0;
+  StaticMapTileCache tile_cache(
+      0.2, kTileSize, 2, CV_8UC1,
+      [&draws](const int min_col, const int min_row, cv::Mat* tile) {
+        ++draws;
+        DrawPixelValues(min_col, min_row, tile);
+      });
+  // one pixel of the tile in column tile_col of tile row 0
+  auto get_tile = [&tile_cache](const int tile_col) {
+    cv::Mat pixel;
+    tile_cache.GetRegion(tile_col * kTileSize, 0, 1, 1, &pixel);
+    EXPECT_EQ(pixel.at<uchar>(0, 0), PixelValue(tile_col * kTileSize, 0));
+  };
+
+  get_tile(0);
+  get_tile(1);
+  EXPECT_EQ(draws, 2);
+  get_tile(0);
+  EXPECT_EQ(draws, 2);
+
+  // tile 1 is the least recently used one
+  get_tile(2);
+  EXPECT_EQ(draws, 3);
+  EXPECT_EQ(tile_cache.tiles_num(), 2);
+  get_tile(0);
+  EXPECT_EQ(draws, 3);
+  get_tile(1);
+  EXPECT_EQ(draws, 4);
+  EXPECT_EQ(tile_cache.tiles_num(), 2);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Runs the trajectory imitation test model on the cpu for the test data
+// frame, rendering included: once as configured by default, once with the
+// reused input tensors, and once more with the model optimized for inference
+// as well, each with 1, 2 and 4 intra op threads.
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/proto/learning_data.pb.h"
+#include "modules/planning/proto/planning_semantic_map_config.pb.h"
+#include "modules/planning/proto/task_config.pb.h"
+
+#include "cyber/common/file.h"
+#include "modules/common/configs/config_gflags.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/learning_based/img_feature_renderer/birdview_img_feature_renderer.h"
+#include "modules/planning/learning_based/model_inference/trajectory_imitation_libtorch_inference.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr char kTaskConfigFile[] =
+    "/apollo/modules/planning/testdata/model_inference_test/"
+    "test_libtorch_inference_task_config.pb.txt";
+constexpr char kDataFrameFile[] =
+    "/apollo/modules/planning/testdata/model_inference_test/"
+    "learning_data_sunnyvale_with_two_offices.bin";
+constexpr char kRendererConfigFile[] =
+    "/apollo/modules/planning/conf/planning_semantic_map_config.pb.txt";
+
+void BM_Inference(benchmark::State& state, bool reuse_input_tensors,
+                  bool optimize_for_inference) {
+  FLAGS_map_dir = "/apollo/modules/map/data/sunnyvale_with_two_offices";
+  FLAGS_base_map_filename = "base_map.bin";
+
+  LearningModelInferenceTaskConfig config;
+  LearningDataFrame data_frame;
+  PlanningSemanticMapConfig renderer_config;
+  if (!cyber::common::GetProtoFromFile(kTaskConfigFile, &config) ||
+      !cyber::common::GetProtoFromFile(kDataFrameFile, &data_frame) ||
+      !cyber::common::GetProtoFromFile(kRendererConfigFile,
+                                       &renderer_config)) {
+    state.SkipWithError("failed to load test data");
+    return;
+  }
+  if (!BirdviewImgFeatureRenderer::Instance()->Init(renderer_config)) {
+    state.SkipWithError("failed to init renderer");
+    return;
+  }
+
+  config.set_use_cuda(false);
+  config.set_intra_op_threads(static_cast<int>(state.range(0)));
+  config.set_reuse_input_tensors(reuse_input_tensors);
+  config.set_optimize_for_inference(optimize_for_inference);
+  TrajectoryImitationLibtorchInference inference(config);
+  if (!inference.LoadModel()) {
+    state.SkipWithError("failed to load model");
+    return;
+  }
+
+  for (auto _ : state) {
+    LearningDataFrame frame = data_frame;
+    if (!inference.DoInference(&frame)) {
+      state.SkipWithError("inference failed");
+      return;
+    }
+    benchmark::DoNotOptimize(frame);
+  }
+}
+
+void BM_DefaultInference(benchmark::State& state) {
+  BM_Inference(state, false, false);
+}
+
+void BM_ReusedTensorInference(benchmark::State& state) {
+  BM_Inference(state, true, false);
+}
+
+void BM_OptimizedInference(benchmark::State& state) {
+  BM_Inference(state, true, true);
+}
+
+}  // namespace
+
+BENCHMARK(BM_DefaultInference)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReusedTensorInference)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OptimizedInference)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -89,6 +89,32 @@ TEST_F(ModelInferenceTest, trajectory_imitation_libtorch_inference) {
       << "Failed to inference trajectory_imitation_model";
 }
 
+TEST_F(ModelInferenceTest, reuse_input_tensors) {
+  LearningModelInferenceTaskConfig config;
+  config.set_reuse_input_tensors(false);
+  TrajectoryImitationLibtorchInference per_channel_inference(config);
+  config.set_reuse_input_tensors(true);
+  TrajectoryImitationLibtorchInference reuse_inference(config);
+
+  cv::Mat input_feature(200, 200, CV_8UC(12));
+  for (int i = 0; i < 2; ++i) {
+    // randu takes at most 4 channel bounds, fill a single channel view
+    cv::Mat input_feature_values = input_feature.reshape(1);
+    cv::randu(input_feature_values, 0.0, 256.0);
+    // (x / 255 - 0.5) / 0.5 channel by channel
+    const torch::Tensor expected =
+        per_channel_inference.PreprocessInputFeature(input_feature);
+    // x * 2 / 255 - 1, split into the planes of the reused tensor
+    const torch::Tensor input_feature_tensor =
+        reuse_inference.PreprocessInputFeature(input_feature);
+    ASSERT_EQ(input_feature_tensor.sizes(), expected.sizes());
+    EXPECT_EQ(input_feature_tensor.data_ptr(),
+              reuse_inference.input_feature_tensor_.data_ptr());
+    EXPECT_TRUE(torch::allclose(input_feature_tensor, expected,
+                                /*rtol=*/0.0, /*atol=*/1e-6));
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
 
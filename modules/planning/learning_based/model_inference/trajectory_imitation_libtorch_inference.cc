@@ -82,7 +82,14 @@ bool TrajectoryImitationLibtorchInference::LoadModel() {
     model_ = torch::jit::load(config_.cpu_model_file(), device_);
   }
 
-  torch::set_num_threads(1);
+  if (config_.optimize_for_inference()) {
+    model_.eval();
+    model_ = torch::jit::optimize_for_inference(model_);
+  }
+  input_feature_tensor_ = torch::Tensor();
+  current_v_tensor_ = torch::Tensor();
+
+  torch::set_num_threads(config_.intra_op_threads());
   switch (config_.model_type()) {
     case LearningModelInferenceTaskConfig::CNN: {
       if (!LoadCNNModel()) {
@@ -104,6 +111,48 @@ bool TrajectoryImitationLibtorchInference::LoadModel() {
   return true;
 }
 
+torch::Tensor TrajectoryImitationLibtorchInference::PreprocessInputFeature(
+    const cv::Mat& input_feature) {
+  if (!config_.reuse_input_tensors()) {
+    // the returned cpu tensor shares the memory of input_feature_float_
+    input_feature.convertTo(input_feature_float_, CV_32F, 1.0 / 255);
+    torch::Tensor input_feature_tensor = torch::from_blob(
+        input_feature_float_.data,
+        {1, input_feature_float_.rows, input_feature_float_.cols,
+         input_feature_float_.channels()});
+    input_feature_tensor = input_feature_tensor.permute({0, 3, 1, 2});
+    for (int i = 0; i < input_feature_float_.channels(); ++i) {
+      input_feature_tensor[0][i] = input_feature_tensor[0][i].sub(0.5).div(0.5);
+    }
+    return input_feature_tensor.to(device_);
+  }
+
+  const int channels = input_feature.channels();
+  const int rows = input_feature.rows;
+  const int cols = input_feature.cols;
+  if (!input_feature_tensor_.defined() ||
+      input_feature_tensor_.size(1) != channels ||
+      input_feature_tensor_.size(2) != rows ||
+      input_feature_tensor_.size(3) != cols) {
+    // page locked host memory lets the copy to a cuda device run async
+    input_feature_tensor_ = torch::empty(
+        {1, channels, rows, cols},
+        torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(
+            device_.is_cuda()));
+    float* data = input_feature_tensor_.data_ptr<float>();
+    input_feature_planes_.clear();
+    for (int i = 0; i < channels; ++i) {
+      input_feature_planes_.emplace_back(rows, cols, CV_32FC1,
+                                         data + i * rows * cols);
+    }
+  }
+  // (x / 255 - 0.5) / 0.5 in a single conversion, then deinterleave the
+  // channels straight into the planes of the input tensor
+  input_feature.convertTo(input_feature_float_, CV_32F, 2.0 / 255, -1.0);
+  cv::split(input_feature_float_, input_feature_planes_);
+  return input_feature_tensor_.to(device_, /*non_blocking=*/true);
+}
+
 void TrajectoryImitationLibtorchInference::output_postprocessing(
     const at::Tensor& torch_output_tensor,
     LearningDataFrame* const learning_data_frame) {
@@ -175,16 +224,7 @@ bool TrajectoryImitationLibtorchInference::DoCNNMODELInference(
 
   auto input_preprocessing_start_time = std::chrono::system_clock::now();
 
-  cv::Mat input_feature_float;
-  input_feature.convertTo(input_feature_float, CV_32F, 1.0 / 255);
-  torch::Tensor input_feature_tensor =
-      torch::from_blob(input_feature_float.data,
-                       {1, input_feature_float.rows, input_feature_float.cols,
-                        input_feature_float.channels()});
-  input_feature_tensor = input_feature_tensor.permute({0, 3, 1, 2});
-  for (int i = 0; i < input_feature_float.channels(); ++i) {
-    input_feature_tensor[0][i] = input_feature_tensor[0][i].sub(0.5).div(0.5);
-  }
+  torch::Tensor input_feature_tensor = PreprocessInputFeature(input_feature);
 
   auto input_preprocessing_end_time = std::chrono::system_clock::now();
   std::chrono::duration<double> preprocessing_diff =
@@ -195,7 +235,8 @@ bool TrajectoryImitationLibtorchInference::DoCNNMODELInference(
   auto inference_start_time = std::chrono::system_clock::now();
 
   std::vector<torch::jit::IValue> torch_inputs;
-  torch_inputs.push_back(input_feature_tensor.to(device_));
+  torch_inputs.push_back(std::move(input_feature_tensor));
+  c10::InferenceMode inference_mode;
   at::Tensor torch_output_tensor =
       model_.forward(torch_inputs).toTensor().to(torch::kCPU);
 
@@ -235,16 +276,7 @@ bool TrajectoryImitationLibtorchInference::DoCNNLSTMMODELInference(
 
   auto input_preprocessing_start_time = std::chrono::system_clock::now();
 
-  cv::Mat input_feature_float;
-  input_feature.convertTo(input_feature_float, CV_32F, 1.0 / 255);
-  torch::Tensor input_feature_tensor =
-      torch::from_blob(input_feature_float.data,
-                       {1, input_feature_float.rows, input_feature_float.cols,
-                        input_feature_float.channels()});
-  input_feature_tensor = input_feature_tensor.permute({0, 3, 1, 2});
-  for (int i = 0; i < input_feature_float.channels(); ++i) {
-    input_feature_tensor[0][i] = input_feature_tensor[0][i].sub(0.5).div(0.5);
-  }
+  torch::Tensor input_feature_tensor = PreprocessInputFeature(input_feature);
 
   const auto& current_traj_point =
       learning_data_frame
@@ -252,9 +284,18 @@ bool TrajectoryImitationLibtorchInference::DoCNNLSTMMODELInference(
               learning_data_frame->adc_trajectory_point_size() - 1)
           .trajectory_point();
 
-  torch::Tensor current_v_tensor = torch::zeros({1, 1});
   const double current_v = current_traj_point.v();
-  current_v_tensor[0][0] = current_v;
+  torch::Tensor current_v_tensor;
+  if (config_.reuse_input_tensors()) {
+    if (!current_v_tensor_.defined()) {
+      current_v_tensor_ = torch::zeros({1, 1});
+    }
+    current_v_tensor_.data_ptr<float>()[0] = static_cast<float>(current_v);
+    current_v_tensor = current_v_tensor_;
+  } else {
+    current_v_tensor = torch::zeros({1, 1});
+    current_v_tensor[0][0] = current_v;
+  }
 
   auto input_preprocessing_end_time = std::chrono::system_clock::now();
   std::chrono::duration<double> preprocessing_diff =
@@ -266,8 +307,9 @@ bool TrajectoryImitationLibtorchInference::DoCNNLSTMMODELInference(
 
   std::vector<torch::jit::IValue> torch_inputs;
   torch_inputs.push_back(
-      c10::ivalue::Tuple::create({std::move(input_feature_tensor.to(device_)),
+      c10::ivalue::Tuple::create({std::move(input_feature_tensor),
                                   std::move(current_v_tensor.to(device_))}));
+  c10::InferenceMode inference_mode;
   at::Tensor torch_output_tensor =
       model_.forward(torch_inputs).toTensor().to(torch::kCPU);
 
@@ -22,7 +22,10 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include "gtest/gtest_prod.h"
+#include "opencv2/opencv.hpp"
 #include "torch/extension.h"
 #include "torch/script.h"
 
@@ -83,6 +86,13 @@ class TrajectoryImitationLibtorchInference : public ModelInference {
    */
   bool DoCNNLSTMMODELInference(LearningDataFrame* const learning_data_frame);
 
+  /**
+   * @brief normalize the rendered img into a [1, channels, rows, cols] input
+   * tensor on the inference device
+   * @param input_feature multi-channel img from the feature renderer
+   */
+  torch::Tensor PreprocessInputFeature(const cv::Mat& input_feature);
+
   /**
    * @brief postprocessing model trajectory output
    */
@@ -91,6 +101,15 @@ class TrajectoryImitationLibtorchInference : public ModelInference {
 
   torch::jit::script::Module model_;
   torch::Device device_;
+
+  cv::Mat input_feature_float_;
+  // preallocated input tensors and the img headers sharing the memory of
+  // every channel plane of input_feature_tensor_, used if reuse_input_tensors
+  torch::Tensor input_feature_tensor_;
+  torch::Tensor current_v_tensor_;
+  std::vector<cv::Mat> input_feature_planes_;
+
+  FRIEND_TEST(ModelInferenceTest, reuse_input_tensors);
 };
 
 }  // namespace planning
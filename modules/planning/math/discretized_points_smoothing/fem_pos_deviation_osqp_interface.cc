@@ -91,6 +91,18 @@ bool FemPosDeviationOsqpInterface::Solve() {
   settings->scaled_termination = scaled_termination_;
   settings->warm_start = warm_start_;
 
+  if (solver_ != nullptr) {
+    bool res = OptimizeWithSolver(
+        num_of_variables_, lower_bounds.size(), &P_data, &P_indices,
+        &P_indptr, &A_data, &A_indices, &A_indptr, &lower_bounds,
+        &upper_bounds, &q, primal_warm_start, data, settings);
+    c_free(data->A);
+    c_free(data->P);
+    c_free(data);
+    c_free(settings);
+    return res;
+  }
+
   OSQPWorkspace* work = nullptr;
 
   bool res = OptimizeWithOsqp(num_of_variables_, lower_bounds.size(), &P_data,
@@ -308,5 +320,45 @@ bool FemPosDeviationOsqpInterface::OptimizeWithOsqp(
   return true;
 }
 
+bool FemPosDeviationOsqpInterface::OptimizeWithSolver(
+    const size_t kernel_dim, const size_t num_affine_constraint,
+    std::vector<c_float>* P_data, std::vector<c_int>* P_indices,
+    std::vector<c_int>* P_indptr, std::vector<c_float>* A_data,
+    std::vector<c_int>* A_indices, std::vector<c_int>* A_indptr,
+    std::vector<c_float>* lower_bounds, std::vector<c_float>* upper_bounds,
+    std::vector<c_float>* q, const std::vector<c_float>& primal_warm_start,
+    OSQPData* data, OSQPSettings* settings) {
+  CHECK_EQ(lower_bounds->size(), upper_bounds->size());
+
+  data->n = kernel_dim;
+  data->m = num_affine_constraint;
+  data->P = csc_matrix(data->n, data->n, P_data->size(), P_data->data(),
+                       P_indices->data(), P_indptr->data());
+  data->q = q->data();
+  data->A = csc_matrix(data->m, data->n, A_data->size(), A_data->data(),
+                       A_indices->data(), A_indptr->data());
+  data->l = lower_bounds->data();
+  data->u = upper_bounds->data();
+
+  // a live workspace already holds the last iterate, which is closer to the
+  // new optimum than the reference points
+  std::vector<c_float> primal;
+  if (!solver_->Solve(data, settings,
+                      solver_->has_workspace() ? std::vector<c_float>()
+                                               : primal_warm_start,
+                      &primal)) {
+    return false;
+  }
+
+  x_.resize(num_of_points_);
+  y_.resize(num_of_points_);
+  for (int i = 0; i < num_of_points_; ++i) {
+    int index = i * 2;
+    x_.at(i) = primal[index];
+    y_.at(i) = primal[index + 1];
+  }
+  return true;
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -25,6 +25,8 @@
 
 #include "osqp/osqp.h"
 
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
+
 namespace apollo {
 namespace planning {
 
@@ -67,6 +69,14 @@ class FemPosDeviationOsqpInterface {
 
   void set_warm_start(const bool warm_start) { warm_start_ = warm_start; }
 
+  /**
+   * @brief Solve with a solver that keeps its osqp workspace across calls,
+   * nullptr to set one up from scratch. The first solve warm starts from the
+   * reference points, later ones only push the new bounds and continue from
+   * the last iterate. The solver must outlive Solve.
+   */
+  void set_solver(PiecewiseJerkSolver* solver) { solver_ = solver; }
+
   bool Solve();
 
   const std::vector<double>& opt_x() const { return x_; }
@@ -97,6 +107,15 @@ class FemPosDeviationOsqpInterface {
       std::vector<c_float>* q, std::vector<c_float>* primal_warm_start,
       OSQPData* data, OSQPWorkspace** work, OSQPSettings* settings);
 
+  bool OptimizeWithSolver(
+      const size_t kernel_dim, const size_t num_affine_constraint,
+      std::vector<c_float>* P_data, std::vector<c_int>* P_indices,
+      std::vector<c_int>* P_indptr, std::vector<c_float>* A_data,
+      std::vector<c_int>* A_indices, std::vector<c_int>* A_indptr,
+      std::vector<c_float>* lower_bounds, std::vector<c_float>* upper_bounds,
+      std::vector<c_float>* q, const std::vector<c_float>& primal_warm_start,
+      OSQPData* data, OSQPSettings* settings);
+
  private:
   // Reference points and deviation bounds
   std::vector<std::pair<double, double>> ref_points_;
@@ -114,6 +133,8 @@ class FemPosDeviationOsqpInterface {
   bool scaled_termination_ = true;
   bool warm_start_ = true;
 
+  PiecewiseJerkSolver* solver_ = nullptr;
+
   // Optimization problem definitions
   int num_of_points_ = 0;
   int num_of_variables_ = 0;
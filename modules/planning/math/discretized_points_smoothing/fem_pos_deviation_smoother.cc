@@ -20,12 +20,17 @@
 
 #include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_smoother.h"
 
+#include <algorithm>
+#include <future>
+
 #include <coin/IpIpoptApplication.hpp>
 #include <coin/IpSolveStatistics.hpp>
 
 #include "cyber/common/log.h"
+#include "cyber/task/task.h"
 #include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_ipopt_interface.h"
 #include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_osqp_interface.h"
+#include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_sparse_sqp_interface.h"
 #include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_sqp_osqp_interface.h"
 
 namespace apollo {
@@ -39,7 +44,9 @@ bool FemPosDeviationSmoother::Solve(
     const std::vector<double>& bounds, std::vector<double>* opt_x,
     std::vector<double>* opt_y) {
   if (config_.apply_curvature_constraint()) {
-    if (config_.use_sqp()) {
+    if (config_.use_sqp() && config_.use_sparse_sqp()) {
+      return SparseSqpWithOsqp(raw_point2d, bounds, opt_x, opt_y);
+    } else if (config_.use_sqp()) {
       return SqpWithOsqp(raw_point2d, bounds, opt_x, opt_y);
     } else {
       return NlpWithIpopt(raw_point2d, bounds, opt_x, opt_y);
@@ -70,6 +77,7 @@ bool FemPosDeviationSmoother::QpWithOsqp(
   solver.set_verbose(config_.verbose());
   solver.set_scaled_termination(config_.scaled_termination());
   solver.set_warm_start(config_.warm_start());
+  solver.set_solver(solver_);
 
   solver.set_ref_points(raw_point2d);
   solver.set_bounds_around_refs(bounds);
@@ -132,6 +140,150 @@ bool FemPosDeviationSmoother::SqpWithOsqp(
   return true;
 }
 
+bool FemPosDeviationSmoother::SparseSqpWithOsqp(
+    const std::vector<std::pair<double, double>>& raw_point2d,
+    const std::vector<double>& bounds, std::vector<double>* opt_x,
+    std::vector<double>* opt_y) {
+  if (opt_x == nullptr || opt_y == nullptr) {
+    AERROR << "opt_x or opt_y is nullptr";
+    return false;
+  }
+
+  if (raw_point2d.size() != bounds.size()) {
+    AERROR << "raw_point2d and bounds size not equal";
+    return false;
+  }
+
+  const size_t num_of_points = raw_point2d.size();
+  const int window_overlap = config_.sqp_window_overlap();
+  size_t window_size = num_of_points;
+  if (config_.sqp_window_size() > 0 &&
+      static_cast<size_t>(config_.sqp_window_size()) < num_of_points) {
+    if (config_.sqp_window_size() < 3 || window_overlap < 1 ||
+        2 * window_overlap > config_.sqp_window_size()) {
+      AERROR << "invalid sqp window size " << config_.sqp_window_size()
+             << " with overlap " << window_overlap;
+      return false;
+    }
+    window_size = static_cast<size_t>(config_.sqp_window_size());
+  }
+
+  // the last window is moved back to end at the last point rather than cut,
+  // so that every window keeps the structure of its osqp workspace
+  std::vector<size_t> window_starts;
+  for (size_t start = 0; start + window_size < num_of_points;
+       start += window_size - window_overlap) {
+    window_starts.push_back(start);
+  }
+  window_starts.push_back(num_of_points - window_size);
+
+  std::vector<std::unique_ptr<PiecewiseJerkSolver>> local_solvers;
+  auto* solvers = sqp_solvers_ != nullptr ? sqp_solvers_ : &local_solvers;
+  while (solvers->size() < window_starts.size()) {
+    solvers->push_back(std::make_unique<PiecewiseJerkSolver>());
+  }
+
+  std::vector<std::vector<std::pair<double, double>>> window_opt_xy(
+      window_starts.size());
+  auto solve_window = [&](const size_t index) {
+    const size_t start = window_starts[index];
+    const std::vector<std::pair<double, double>> window_points(
+        raw_point2d.begin() + start, raw_point2d.begin() + start + window_size);
+    const std::vector<double> window_bounds(
+        bounds.begin() + start, bounds.begin() + start + window_size);
+    return SparseSqpWindowWithOsqp(window_points, window_bounds,
+                                   (*solvers)[index].get(),
+                                   &window_opt_xy[index]);
+  };
+
+  // the first window on the calling thread
+  std::vector<std::future<bool>> results;
+  for (size_t i = 1; i < window_starts.size(); ++i) {
+    results.push_back(cyber::Async(solve_window, i));
+  }
+  bool status = solve_window(0);
+  for (auto& result : results) {
+    status = result.get() && status;
+  }
+  if (!status) {
+    AERROR << "sparse sqp fails on " << window_starts.size() << " windows";
+    return false;
+  }
+
+  // a window weighs its points down linearly towards its ends inside the
+  // line, so consecutive windows are blended linearly over their overlap
+  std::vector<double> sum_x(num_of_points, 0.0);
+  std::vector<double> sum_y(num_of_points, 0.0);
+  std::vector<double> sum_weight(num_of_points, 0.0);
+  const double taper_length = static_cast<double>(window_overlap + 1);
+  for (size_t k = 0; k < window_starts.size(); ++k) {
+    const size_t start = window_starts[k];
+    const size_t end = start + window_size;
+    for (size_t i = start; i < end; ++i) {
+      double weight = 1.0;
+      if (start > 0) {
+        weight = std::min(weight,
+                          static_cast<double>(i - start + 1) / taper_length);
+      }
+      if (end < num_of_points) {
+        weight =
+            std::min(weight, static_cast<double>(end - i) / taper_length);
+      }
+      sum_x[i] += weight * window_opt_xy[k][i - start].first;
+      sum_y[i] += weight * window_opt_xy[k][i - start].second;
+      sum_weight[i] += weight;
+    }
+  }
+
+  opt_x->resize(num_of_points);
+  opt_y->resize(num_of_points);
+  for (size_t i = 0; i < num_of_points; ++i) {
+    (*opt_x)[i] = sum_x[i] / sum_weight[i];
+    (*opt_y)[i] = sum_y[i] / sum_weight[i];
+  }
+  return true;
+}
+
+bool FemPosDeviationSmoother::SparseSqpWindowWithOsqp(
+    const std::vector<std::pair<double, double>>& raw_point2d,
+    const std::vector<double>& bounds, PiecewiseJerkSolver* solver,
+    std::vector<std::pair<double, double>>* opt_xy) {
+  FemPosDeviationSparseSqpInterface sqp_solver;
+
+  sqp_solver.set_weight_fem_pos_deviation(config_.weight_fem_pos_deviation());
+  sqp_solver.set_weight_path_length(config_.weight_path_length());
+  sqp_solver.set_weight_ref_deviation(config_.weight_ref_deviation());
+  sqp_solver.set_weight_curvature_constraint_slack_var(
+      config_.weight_curvature_constraint_slack_var());
+
+  sqp_solver.set_curvature_constraint(config_.curvature_constraint());
+
+  sqp_solver.set_sqp_sub_max_iter(config_.sqp_sub_max_iter());
+  sqp_solver.set_sqp_ftol(config_.sqp_ftol());
+  sqp_solver.set_sqp_pen_max_iter(config_.sqp_pen_max_iter());
+  sqp_solver.set_sqp_ctol(config_.sqp_ctol());
+
+  sqp_solver.set_max_iter(config_.max_iter());
+  sqp_solver.set_time_limit(config_.time_limit());
+  sqp_solver.set_verbose(config_.verbose());
+  sqp_solver.set_scaled_termination(config_.scaled_termination());
+  sqp_solver.set_warm_start(config_.warm_start());
+  sqp_solver.set_solver(solver);
+
+  sqp_solver.set_ref_points(raw_point2d);
+  sqp_solver.set_bounds_around_refs(bounds);
+
+  if (!sqp_solver.Solve()) {
+    return false;
+  }
+
+  ADEBUG << "sparse sqp solved " << sqp_solver.num_of_subproblems()
+         << " subproblems with " << sqp_solver.num_of_setups()
+         << " osqp setups";
+  *opt_xy = sqp_solver.opt_xy();
+  return true;
+}
+
 bool FemPosDeviationSmoother::NlpWithIpopt(
     const std::vector<std::pair<double, double>>& raw_point2d,
     const std::vector<double>& bounds, std::vector<double>* opt_x,
@@ -20,11 +20,14 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "modules/planning/proto/math/fem_pos_deviation_smoother_config.pb.h"
 
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
+
 namespace apollo {
 namespace planning {
 
@@ -48,6 +51,23 @@ class FemPosDeviationSmoother {
  public:
   explicit FemPosDeviationSmoother(const FemPosDeviationSmootherConfig& config);
 
+  /**
+   * @brief Keep the osqp workspace of the QP formulation in solver across
+   * solves of the same number of points, nullptr to set one up every solve.
+   * Unused with the curvature constraint. The solver must outlive Solve.
+   */
+  void set_solver(PiecewiseJerkSolver* solver) { solver_ = solver; }
+
+  /**
+   * @brief Keep the osqp workspaces of the sparse sqp across solves, one per
+   * window, nullptr to set them up every solve. Solvers are added as more
+   * windows are needed. The solvers must outlive Solve.
+   */
+  void set_sqp_solvers(
+      std::vector<std::unique_ptr<PiecewiseJerkSolver>>* sqp_solvers) {
+    sqp_solvers_ = sqp_solvers;
+  }
+
   bool Solve(const std::vector<std::pair<double, double>>& raw_point2d,
              const std::vector<double>& bounds, std::vector<double>* opt_x,
              std::vector<double>* opt_y);
@@ -64,8 +84,20 @@ class FemPosDeviationSmoother {
                    const std::vector<double>& bounds,
                    std::vector<double>* opt_x, std::vector<double>* opt_y);
 
+  bool SparseSqpWithOsqp(
+      const std::vector<std::pair<double, double>>& raw_point2d,
+      const std::vector<double>& bounds, std::vector<double>* opt_x,
+      std::vector<double>* opt_y);
+
  private:
+  bool SparseSqpWindowWithOsqp(
+      const std::vector<std::pair<double, double>>& raw_point2d,
+      const std::vector<double>& bounds, PiecewiseJerkSolver* solver,
+      std::vector<std::pair<double, double>>* opt_xy);
+
   FemPosDeviationSmootherConfig config_;
+  PiecewiseJerkSolver* solver_ = nullptr;
+  std::vector<std::unique_ptr<PiecewiseJerkSolver>>* sqp_solvers_ = nullptr;
 };
 }  // namespace planning
 }  // namespace apollo
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_smoother.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr size_t kNumOfPoints = 50;
+constexpr int kWindowSize = 20;
+constexpr int kWindowOverlap = 5;
+
+std::vector<std::pair<double, double>> RefPoints(const double phase) {
+  std::vector<std::pair<double, double>> points;
+  for (size_t i = 0; i < kNumOfPoints; ++i) {
+    const double s = static_cast<double>(i) * 0.5;
+    points.emplace_back(s, 2.0 * std::sin(0.3 * s + phase) +
+                               (i % 3 == 0 ? 0.1 : 0.0));
+  }
+  return points;
+}
+
+FemPosDeviationSmootherConfig SparseSqpConfig(const int window_size) {
+  FemPosDeviationSmootherConfig config;
+  config.set_weight_fem_pos_deviation(1.0e3);
+  config.set_apply_curvature_constraint(true);
+  config.set_weight_curvature_constraint_slack_var(1.0e3);
+  config.set_use_sqp(true);
+  config.set_use_sparse_sqp(true);
+  config.set_sqp_ftol(1.0e-2);
+  config.set_max_iter(4000);
+  config.set_sqp_window_size(window_size);
+  config.set_sqp_window_overlap(kWindowOverlap);
+  return config;
+}
+
+}  // namespace
+
+TEST(FemPosDeviationSmootherTest, SparseSqpWindows) {
+  const auto ref_points = RefPoints(0.0);
+  const std::vector<double> bounds(kNumOfPoints, 0.25);
+
+  std::vector<double> opt_x;
+  std::vector<double> opt_y;
+  FemPosDeviationSmoother smoother(SparseSqpConfig(kWindowSize));
+  ASSERT_TRUE(smoother.Solve(ref_points, bounds, &opt_x, &opt_y));
+  ASSERT_EQ(opt_x.size(), kNumOfPoints);
+  ASSERT_EQ(opt_y.size(), kNumOfPoints);
+
+  // windows start every 15 points, the last one is moved back to end at the
+  // last point: [0, 20), [15, 35) and [30, 50)
+  const std::vector<size_t> window_starts = {0, 15, 30};
+  std::vector<double> sum_x(kNumOfPoints, 0.0);
+  std::vector<double> sum_y(kNumOfPoints, 0.0);
+  std::vector<double> sum_weight(kNumOfPoints, 0.0);
+  FemPosDeviationSmoother window_smoother(SparseSqpConfig(0));
+  for (const size_t start : window_starts) {
+    const size_t end = start + kWindowSize;
+    std::vector<double> window_x;
+    std::vector<double> window_y;
+    ASSERT_TRUE(window_smoother.Solve(
+        {ref_points.begin() + start, ref_points.begin() + end},
+        {bounds.begin() + start, bounds.begin() + end}, &window_x,
+        &window_y));
+    // weights falling linearly over the overlap towards inner window ends
+    for (size_t i = start; i < end; ++i) {
+      double weight = 1.0;
+      if (start > 0) {
+        weight = std::min(weight, static_cast<double>(i - start + 1) /
+                                      (kWindowOverlap + 1));
+      }
+      if (end < kNumOfPoints) {
+        weight = std::min(
+            weight, static_cast<double>(end - i) / (kWindowOverlap + 1));
+      }
+      sum_x[i] += weight * window_x[i - start];
+      sum_y[i] += weight * window_y[i - start];
+      sum_weight[i] += weight;
+    }
+  }
+
+  for (size_t i = 0; i < kNumOfPoints; ++i) {
+    ASSERT_GT(sum_weight[i], 0.0);
+    EXPECT_NEAR(opt_x[i], sum_x[i] / sum_weight[i], 1e-6);
+    EXPECT_NEAR(opt_y[i], sum_y[i] / sum_weight[i], 1e-6);
+    EXPECT_LE(std::abs(opt_x[i] - ref_points[i].first), bounds[i] + 1e-3);
+    EXPECT_LE(std::abs(opt_y[i] - ref_points[i].second), bounds[i] + 1e-3);
+  }
+}
+
+TEST(FemPosDeviationSmootherTest, SparseSqpReuseWorkspaces) {
+  const std::vector<double> bounds(kNumOfPoints, 0.25);
+  std::vector<std::unique_ptr<PiecewiseJerkSolver>> solvers;
+  std::vector<double> opt_x;
+  std::vector<double> opt_y;
+
+  FemPosDeviationSmoother first(SparseSqpConfig(kWindowSize));
+  first.set_sqp_solvers(&solvers);
+  ASSERT_TRUE(first.Solve(RefPoints(0.0), bounds, &opt_x, &opt_y));
+  ASSERT_EQ(solvers.size(), 3);
+  for (const auto& solver : solvers) {
+    EXPECT_TRUE(solver->has_workspace());
+  }
+
+  // the next cycle keeps the window structure and only updates
+  FemPosDeviationSmoother second(SparseSqpConfig(kWindowSize));
+  second.set_sqp_solvers(&solvers);
+  ASSERT_TRUE(second.Solve(RefPoints(0.1), bounds, &opt_x, &opt_y));
+  ASSERT_EQ(solvers.size(), 3);
+  for (const auto& solver : solvers) {
+    EXPECT_FALSE(solver->stats().setup);
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,397 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_sparse_sqp_interface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+bool FemPosDeviationSparseSqpInterface::Solve() {
+  // Sanity Check
+  if (ref_points_.empty()) {
+    AERROR << "reference points empty, solver early terminates";
+    return false;
+  }
+
+  if (ref_points_.size() != bounds_around_refs_.size()) {
+    AERROR << "ref_points and bounds size not equal, solver early terminates";
+    return false;
+  }
+
+  if (ref_points_.size() < 3) {
+    AERROR << "ref_points size smaller than 3, solver early terminates";
+    return false;
+  }
+
+  if (ref_points_.size() >
+      static_cast<size_t>(std::numeric_limits<int>::max() / 3)) {
+    AERROR << "ref_points size too large, solver early terminates";
+    return false;
+  }
+
+  // Calculate optimization states definitions
+  num_of_points_ = static_cast<int>(ref_points_.size());
+  num_of_pos_variables_ = num_of_points_ * 2;
+  num_of_slack_variables_ = num_of_points_ - 2;
+  num_of_variables_ = num_of_pos_variables_ + num_of_slack_variables_;
+
+  num_of_variable_constraints_ = num_of_variables_;
+  num_of_curvature_constraints_ = num_of_points_ - 2;
+  num_of_constraints_ =
+      num_of_variable_constraints_ + num_of_curvature_constraints_;
+
+  num_of_subproblems_ = 0;
+  num_of_setups_ = 0;
+
+  BuildKernel();
+  BuildAffineConstraintStructure();
+
+  // Bounds of the variables, the same for every subproblem
+  lower_bounds_.resize(num_of_constraints_);
+  upper_bounds_.resize(num_of_constraints_);
+  for (int i = 0; i < num_of_points_; ++i) {
+    const auto& ref_point_xy = ref_points_[i];
+    upper_bounds_[i * 2] = ref_point_xy.first + bounds_around_refs_[i];
+    upper_bounds_[i * 2 + 1] = ref_point_xy.second + bounds_around_refs_[i];
+    lower_bounds_[i * 2] = ref_point_xy.first - bounds_around_refs_[i];
+    lower_bounds_[i * 2 + 1] = ref_point_xy.second - bounds_around_refs_[i];
+  }
+  for (int i = 0; i < num_of_slack_variables_; ++i) {
+    upper_bounds_[num_of_pos_variables_ + i] = 1e20;
+    lower_bounds_[num_of_pos_variables_ + i] = 0.0;
+  }
+
+  OSQPSettings settings;
+  osqp_set_default_settings(&settings);
+  settings.max_iter = max_iter_;
+  settings.time_limit = time_limit_;
+  settings.verbose = verbose_;
+  settings.scaled_termination = scaled_termination_;
+  settings.warm_start = warm_start_;
+  settings.polish = true;
+  settings.eps_abs = 1e-5;
+  settings.eps_rel = 1e-5;
+  settings.eps_prim_inf = 1e-5;
+  settings.eps_dual_inf = 1e-5;
+
+  PiecewiseJerkSolver local_solver;
+  PiecewiseJerkSolver* solver = solver_ != nullptr ? solver_ : &local_solver;
+
+  // Initial solution
+  double weight_slack_var = weight_curvature_constraint_slack_var_;
+  opt_xy_ = ref_points_;
+  slack_.assign(num_of_slack_variables_, 0.0);
+  UpdateOffset(weight_slack_var);
+  UpdateAffineConstraint(opt_xy_);
+  if (!OptimizeWithSolver(solver, &settings)) {
+    AERROR << "initial iteration solving fails";
+    return false;
+  }
+
+  // Sequential solution
+  int pen_itr = 0;
+  double ctol = 0.0;
+  double last_fvalue = objective_;
+
+  while (pen_itr < sqp_pen_max_iter_) {
+    int sub_itr = 1;
+    bool fconverged = false;
+
+    while (sub_itr < sqp_sub_max_iter_) {
+      UpdateOffset(weight_slack_var);
+      UpdateAffineConstraint(opt_xy_);
+      if (!OptimizeWithSolver(solver, &settings)) {
+        AERROR << "iteration at " << sub_itr
+               << ", solving fails with max sub iter " << sqp_sub_max_iter_;
+        return false;
+      }
+
+      const double cur_fvalue = objective_;
+      const double ftol = std::abs((last_fvalue - cur_fvalue) / last_fvalue);
+
+      if (ftol < sqp_ftol_) {
+        ADEBUG << "merit function value converges at sub itr num " << sub_itr;
+        ADEBUG << "merit function value converges to " << cur_fvalue
+               << ", with ftol " << ftol << ", under max_ftol " << sqp_ftol_;
+        fconverged = true;
+        break;
+      }
+
+      last_fvalue = cur_fvalue;
+      ++sub_itr;
+    }
+
+    if (!fconverged) {
+      AERROR << "Max number of iteration reached";
+      return false;
+    }
+
+    ctol = CalculateConstraintViolation(opt_xy_);
+
+    ADEBUG << "ctol is " << ctol << ", at pen itr " << pen_itr;
+
+    if (ctol < sqp_ctol_) {
+      ADEBUG << "constraint satisfied at pen itr num " << pen_itr << ", with "
+             << num_of_subproblems_ << " subproblems and " << num_of_setups_
+             << " osqp setups";
+      return true;
+    }
+
+    weight_slack_var *= 10;
+    ++pen_itr;
+  }
+
+  ADEBUG << "constraint not satisfied with total itr num " << pen_itr;
+  ADEBUG << "constraint voilation value drops to " << ctol
+         << ", higher than max_ctol " << sqp_ctol_;
+  return true;
+}
+
+void FemPosDeviationSparseSqpInterface::BuildKernel() {
+  // The same three quadratic penalties as FemPosDeviationSqpOsqpInterface,
+  // summed up per point. Every term couples one coordinate of neighboring
+  // points only, so the upper triangle column of a position variable holds
+  // the same coordinate of the point two before, of the point before and of
+  // the point itself; the slack columns are empty.
+  std::vector<double> diagonal(num_of_points_, weight_ref_deviation_);
+  // coupling with the point before and with the point two before
+  std::vector<double> off_diagonal_1(num_of_points_, 0.0);
+  std::vector<double> off_diagonal_2(num_of_points_, 0.0);
+
+  // x * (p(i) - 2 * p(i + 1) + p(i + 2))^2
+  for (int i = 0; i + 2 < num_of_points_; ++i) {
+    diagonal[i] += weight_fem_pos_deviation_;
+    diagonal[i + 1] += 4.0 * weight_fem_pos_deviation_;
+    diagonal[i + 2] += weight_fem_pos_deviation_;
+    off_diagonal_1[i + 1] -= 2.0 * weight_fem_pos_deviation_;
+    off_diagonal_1[i + 2] -= 2.0 * weight_fem_pos_deviation_;
+    off_diagonal_2[i + 2] += weight_fem_pos_deviation_;
+  }
+
+  // y * (p(i + 1) - p(i))^2
+  for (int i = 0; i + 1 < num_of_points_; ++i) {
+    diagonal[i] += weight_path_length_;
+    diagonal[i + 1] += weight_path_length_;
+    off_diagonal_1[i + 1] -= weight_path_length_;
+  }
+
+  P_data_.clear();
+  P_indices_.clear();
+  P_indptr_.clear();
+  for (int col = 0; col < num_of_pos_variables_; ++col) {
+    const int point_index = col / 2;
+    P_indptr_.push_back(static_cast<c_int>(P_data_.size()));
+    // Rescale by 2.0 as the quadratic term in osqp default qp problem setup
+    // is set as (1/2) * x' * P * x
+    if (point_index >= 2) {
+      P_data_.push_back(off_diagonal_2[point_index] * 2.0);
+      P_indices_.push_back(col - 4);
+    }
+    if (point_index >= 1) {
+      P_data_.push_back(off_diagonal_1[point_index] * 2.0);
+      P_indices_.push_back(col - 2);
+    }
+    P_data_.push_back(diagonal[point_index] * 2.0);
+    P_indices_.push_back(col);
+  }
+  for (int col = num_of_pos_variables_; col <= num_of_variables_; ++col) {
+    P_indptr_.push_back(static_cast<c_int>(P_data_.size()));
+  }
+}
+
+void FemPosDeviationSparseSqpInterface::BuildAffineConstraintStructure() {
+  A_indices_.clear();
+  A_indptr_.clear();
+  A_curvature_index_.assign(num_of_pos_variables_ * 3, -1);
+
+  for (int col = 0; col < num_of_pos_variables_; ++col) {
+    const int point_index = col / 2;
+    A_indptr_.push_back(static_cast<c_int>(A_indices_.size()));
+    A_indices_.push_back(col);
+    // the curvature row i is centered at point i + 1
+    for (int j = 0; j < 3; ++j) {
+      const int row = point_index - 2 + j;
+      if (row < 0 || row >= num_of_curvature_constraints_) {
+        continue;
+      }
+      A_curvature_index_[col * 3 + j] = static_cast<int>(A_indices_.size());
+      A_indices_.push_back(num_of_variable_constraints_ + row);
+    }
+  }
+
+  for (int col = num_of_pos_variables_; col < num_of_variables_; ++col) {
+    A_indptr_.push_back(static_cast<c_int>(A_indices_.size()));
+    A_indices_.push_back(col);
+    A_indices_.push_back(num_of_variable_constraints_ + col -
+                         num_of_pos_variables_);
+  }
+  A_indptr_.push_back(static_cast<c_int>(A_indices_.size()));
+
+  // the rows on the variables and the slack coefficients never change
+  A_data_.assign(A_indices_.size(), 0.0);
+  for (int col = 0; col < num_of_variables_; ++col) {
+    A_data_[A_indptr_[col]] = 1.0;
+  }
+  for (int col = num_of_pos_variables_; col < num_of_variables_; ++col) {
+    A_data_[A_indptr_[col] + 1] = -1.0;
+  }
+}
+
+void FemPosDeviationSparseSqpInterface::UpdateOffset(
+    const double weight_slack_var) {
+  q_.resize(num_of_variables_);
+  for (int i = 0; i < num_of_points_; ++i) {
+    const auto& ref_point_xy = ref_points_[i];
+    q_[2 * i] = -2.0 * weight_ref_deviation_ * ref_point_xy.first;
+    q_[2 * i + 1] = -2.0 * weight_ref_deviation_ * ref_point_xy.second;
+  }
+  for (int i = 0; i < num_of_slack_variables_; ++i) {
+    q_[num_of_pos_variables_ + i] = weight_slack_var;
+  }
+}
+
+void FemPosDeviationSparseSqpInterface::UpdateAffineConstraint(
+    const std::vector<std::pair<double, double>>& points) {
+  CHECK_EQ(points.size(), static_cast<size_t>(num_of_points_));
+
+  const double average_interval_length =
+      CalculateAverageIntervalLength(points);
+  const double interval_sqr = average_interval_length * average_interval_length;
+  const double curvature_constraint_sqr =
+      (interval_sqr * curvature_constraint_) *
+      (interval_sqr * curvature_constraint_);
+
+  // g = dx^2 + dy^2 with d = p(f) - 2 * p(m) + p(l) is linearized as
+  // g0 + grad' * (p - p0), where grad' * p0 = 2 * g0, so the row is
+  // grad' * p - slack <= bound + g0 with grad = 2 * d * (1, -2, 1)
+  for (int i = 0; i < num_of_curvature_constraints_; ++i) {
+    const double dx =
+        points[i].first - 2.0 * points[i + 1].first + points[i + 2].first;
+    const double dy =
+        points[i].second - 2.0 * points[i + 1].second + points[i + 2].second;
+    const double coefficients[3][2] = {{2.0 * dx, 2.0 * dy},
+                                       {-4.0 * dx, -4.0 * dy},
+                                       {2.0 * dx, 2.0 * dy}};
+    // row i is the (2 - k)-th curvature row of its k-th point i + k
+    for (int k = 0; k < 3; ++k) {
+      const int col = (i + k) * 2;
+      const int j = 2 - k;
+      A_data_[A_curvature_index_[col * 3 + j]] = coefficients[k][0];
+      A_data_[A_curvature_index_[(col + 1) * 3 + j]] = coefficients[k][1];
+    }
+
+    upper_bounds_[num_of_variable_constraints_ + i] =
+        curvature_constraint_sqr + dx * dx + dy * dy;
+    lower_bounds_[num_of_variable_constraints_ + i] = -1e20;
+  }
+
+  // the subproblem starts from the point it is linearized at
+  primal_.resize(num_of_variables_);
+  for (int i = 0; i < num_of_points_; ++i) {
+    primal_[2 * i] = points[i].first;
+    primal_[2 * i + 1] = points[i].second;
+  }
+  for (int i = 0; i < num_of_slack_variables_; ++i) {
+    primal_[num_of_pos_variables_ + i] = slack_[i];
+  }
+}
+
+bool FemPosDeviationSparseSqpInterface::OptimizeWithSolver(
+    PiecewiseJerkSolver* solver, OSQPSettings* settings) {
+  OSQPData data;
+  data.n = num_of_variables_;
+  data.m = num_of_constraints_;
+  data.P = csc_matrix(data.n, data.n, P_data_.size(), P_data_.data(),
+                      P_indices_.data(), P_indptr_.data());
+  data.q = q_.data();
+  data.A = csc_matrix(data.m, data.n, A_data_.size(), A_data_.data(),
+                      A_indices_.data(), A_indptr_.data());
+  data.l = lower_bounds_.data();
+  data.u = upper_bounds_.data();
+
+  std::vector<c_float> primal;
+  const bool res = solver->Solve(&data, settings, primal_, &primal);
+  c_free(data.A);
+  c_free(data.P);
+
+  ++num_of_subproblems_;
+  if (solver->stats().setup) {
+    ++num_of_setups_;
+  }
+  if (!res) {
+    return false;
+  }
+  objective_ = solver->stats().objective;
+
+  // Extract primal results
+  opt_xy_.resize(num_of_points_);
+  slack_.resize(num_of_slack_variables_);
+  for (int i = 0; i < num_of_points_; ++i) {
+    opt_xy_[i] = std::make_pair(primal[2 * i], primal[2 * i + 1]);
+  }
+  for (int i = 0; i < num_of_slack_variables_; ++i) {
+    slack_[i] = primal[num_of_pos_variables_ + i];
+  }
+  return true;
+}
+
+double FemPosDeviationSparseSqpInterface::CalculateAverageIntervalLength(
+    const std::vector<std::pair<double, double>>& points) const {
+  double total_length = 0.0;
+  for (size_t i = 1; i < points.size(); ++i) {
+    total_length += std::hypot(points[i].first - points[i - 1].first,
+                               points[i].second - points[i - 1].second);
+  }
+  return total_length / static_cast<double>(points.size() - 1);
+}
+
+double FemPosDeviationSparseSqpInterface::CalculateConstraintViolation(
+    const std::vector<std::pair<double, double>>& points) const {
+  CHECK_GT(points.size(), 2U);
+
+  const double average_interval_length =
+      CalculateAverageIntervalLength(points);
+  const double interval_sqr = average_interval_length * average_interval_length;
+  const double curvature_constraint_sqr =
+      (interval_sqr * curvature_constraint_) *
+      (interval_sqr * curvature_constraint_);
+
+  double max_cviolation = 0.0;
+  for (size_t i = 1; i + 1 < points.size(); ++i) {
+    const double dx =
+        points[i - 1].first - 2.0 * points[i].first + points[i + 1].first;
+    const double dy =
+        points[i - 1].second - 2.0 * points[i].second + points[i + 1].second;
+    max_cviolation = std::max(max_cviolation,
+                              dx * dx + dy * dy - curvature_constraint_sqr);
+  }
+  return max_cviolation;
+}
+
+}  // namespace planning
+}  // namespace apollo
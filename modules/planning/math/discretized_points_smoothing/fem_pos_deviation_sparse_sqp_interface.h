@@ -0,0 +1,207 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "osqp/osqp.h"
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
+
+namespace apollo {
+namespace planning {
+
+/*
+ * @brief:
+ * The sqp formulation of FemPosDeviationSqpOsqpInterface, with the sparsity
+ * structure of the subproblems built once per solve. The kernel and the
+ * constraint rows on the variables are the same for every subproblem, so
+ * an iteration only writes the values of the linearized curvature rows, the
+ * curvature bounds and the slack penalty in place, and the osqp workspace of
+ * a PiecewiseJerkSolver is updated instead of set up. Given a solver kept by
+ * the caller, the workspace also survives across solves of the same number
+ * of points.
+ */
+class FemPosDeviationSparseSqpInterface {
+ public:
+  FemPosDeviationSparseSqpInterface() = default;
+
+  virtual ~FemPosDeviationSparseSqpInterface() = default;
+
+  void set_ref_points(
+      const std::vector<std::pair<double, double>>& ref_points) {
+    ref_points_ = ref_points;
+  }
+
+  void set_bounds_around_refs(const std::vector<double>& bounds_around_refs) {
+    bounds_around_refs_ = bounds_around_refs;
+  }
+
+  void set_weight_fem_pos_deviation(const double weight_fem_pos_deviation) {
+    weight_fem_pos_deviation_ = weight_fem_pos_deviation;
+  }
+
+  void set_weight_path_length(const double weight_path_length) {
+    weight_path_length_ = weight_path_length;
+  }
+
+  void set_weight_ref_deviation(const double weight_ref_deviation) {
+    weight_ref_deviation_ = weight_ref_deviation;
+  }
+
+  void set_weight_curvature_constraint_slack_var(
+      const double weight_curvature_constraint_slack_var) {
+    weight_curvature_constraint_slack_var_ =
+        weight_curvature_constraint_slack_var;
+  }
+
+  void set_curvature_constraint(const double curvature_constraint) {
+    curvature_constraint_ = curvature_constraint;
+  }
+
+  void set_max_iter(const int max_iter) { max_iter_ = max_iter; }
+
+  void set_time_limit(const double time_limit) { time_limit_ = time_limit; }
+
+  void set_verbose(const bool verbose) { verbose_ = verbose; }
+
+  void set_scaled_termination(const bool scaled_termination) {
+    scaled_termination_ = scaled_termination;
+  }
+
+  void set_warm_start(const bool warm_start) { warm_start_ = warm_start; }
+
+  void set_sqp_pen_max_iter(const int sqp_pen_max_iter) {
+    sqp_pen_max_iter_ = sqp_pen_max_iter;
+  }
+
+  void set_sqp_ftol(const double sqp_ftol) { sqp_ftol_ = sqp_ftol; }
+
+  void set_sqp_sub_max_iter(const int sqp_sub_max_iter) {
+    sqp_sub_max_iter_ = sqp_sub_max_iter;
+  }
+
+  void set_sqp_ctol(const double sqp_ctol) { sqp_ctol_ = sqp_ctol; }
+
+  /**
+   * @brief Solve with a solver that keeps its osqp workspace across calls,
+   * nullptr to set one up for this solve only. The solver must outlive
+   * Solve.
+   */
+  void set_solver(PiecewiseJerkSolver* solver) { solver_ = solver; }
+
+  bool Solve();
+
+  const std::vector<std::pair<double, double>>& opt_xy() const {
+    return opt_xy_;
+  }
+
+  /**
+   * @brief Number of subproblems solved by the last Solve, and how many of
+   * them had to set up the osqp workspace from scratch.
+   */
+  int num_of_subproblems() const { return num_of_subproblems_; }
+
+  int num_of_setups() const { return num_of_setups_; }
+
+ private:
+  void BuildKernel();
+
+  void BuildAffineConstraintStructure();
+
+  void UpdateOffset(const double weight_slack_var);
+
+  void UpdateAffineConstraint(
+      const std::vector<std::pair<double, double>>& points);
+
+  bool OptimizeWithSolver(PiecewiseJerkSolver* solver,
+                          OSQPSettings* settings);
+
+  double CalculateAverageIntervalLength(
+      const std::vector<std::pair<double, double>>& points) const;
+
+  double CalculateConstraintViolation(
+      const std::vector<std::pair<double, double>>& points) const;
+
+ private:
+  // Init states and constraints
+  std::vector<std::pair<double, double>> ref_points_;
+  std::vector<double> bounds_around_refs_;
+  double curvature_constraint_ = 0.2;
+
+  // Weights in optimization cost function
+  double weight_fem_pos_deviation_ = 1.0e5;
+  double weight_path_length_ = 1.0;
+  double weight_ref_deviation_ = 1.0;
+  double weight_curvature_constraint_slack_var_ = 1.0e5;
+
+  // Settings of osqp
+  int max_iter_ = 4000;
+  double time_limit_ = 0.0;
+  bool verbose_ = false;
+  bool scaled_termination_ = true;
+  bool warm_start_ = true;
+
+  // Settings of sqp
+  int sqp_pen_max_iter_ = 100;
+  double sqp_ftol_ = 1e-2;
+  int sqp_sub_max_iter_ = 100;
+  double sqp_ctol_ = 1e-2;
+
+  PiecewiseJerkSolver* solver_ = nullptr;
+
+  // Optimization problem definitions
+  int num_of_points_ = 0;
+  int num_of_pos_variables_ = 0;
+  int num_of_slack_variables_ = 0;
+  int num_of_variables_ = 0;
+  int num_of_variable_constraints_ = 0;
+  int num_of_curvature_constraints_ = 0;
+  int num_of_constraints_ = 0;
+
+  // The subproblem in csc form, only the values of A, q and the bounds
+  // change between iterations
+  std::vector<c_float> P_data_;
+  std::vector<c_int> P_indices_;
+  std::vector<c_int> P_indptr_;
+  std::vector<c_float> A_data_;
+  std::vector<c_int> A_indices_;
+  std::vector<c_int> A_indptr_;
+  std::vector<c_float> lower_bounds_;
+  std::vector<c_float> upper_bounds_;
+  std::vector<c_float> q_;
+  // position in A_data_ of the coefficients of each position variable in
+  // the curvature rows centered at the point before it, at the point itself
+  // and at the point after it, -1 where there is no such row
+  std::vector<int> A_curvature_index_;
+  std::vector<c_float> primal_;
+
+  // Optimized_result
+  std::vector<std::pair<double, double>> opt_xy_;
+  std::vector<double> slack_;
+  double objective_ = 0.0;
+  int num_of_subproblems_ = 0;
+  int num_of_setups_ = 0;
+};
+
+}  // namespace planning
+}  // namespace apollo
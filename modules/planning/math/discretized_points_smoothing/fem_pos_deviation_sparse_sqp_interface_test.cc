@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_sparse_sqp_interface.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_sqp_osqp_interface.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// points every 0.5m on a circle of radius 4, kinked every third point, so
+// that the curvature constraint of 0.2 is active
+std::vector<std::pair<double, double>> RefPoints(const size_t num_of_points,
+                                                 const double phase) {
+  constexpr double kRadius = 4.0;
+  constexpr double kStep = 0.5;
+  std::vector<std::pair<double, double>> points;
+  for (size_t i = 0; i < num_of_points; ++i) {
+    const double theta = static_cast<double>(i) * kStep / kRadius + phase;
+    const double radius = kRadius + (i % 3 == 0 ? 0.1 : 0.0);
+    points.emplace_back(radius * std::sin(theta),
+                        kRadius - radius * std::cos(theta));
+  }
+  return points;
+}
+
+template <typename Interface>
+void SetupInterface(const std::vector<std::pair<double, double>>& ref_points,
+                    Interface* interface) {
+  interface->set_weight_fem_pos_deviation(1.0e3);
+  interface->set_weight_path_length(1.0);
+  interface->set_weight_ref_deviation(1.0);
+  interface->set_weight_curvature_constraint_slack_var(1.0e3);
+  interface->set_curvature_constraint(0.2);
+  interface->set_sqp_sub_max_iter(100);
+  interface->set_sqp_ftol(1.0e-2);
+  interface->set_sqp_pen_max_iter(3);
+  // FemPosDeviationSqpOsqpInterface measures the violation with a flipped
+  // sign of the first term, never stop on it so that both run the same
+  // penalty iterations
+  interface->set_sqp_ctol(-1.0);
+  interface->set_max_iter(4000);
+  interface->set_verbose(false);
+  interface->set_ref_points(ref_points);
+  interface->set_bounds_around_refs(
+      std::vector<double>(ref_points.size(), 0.25));
+}
+
+}  // namespace
+
+TEST(FemPosDeviationSparseSqpInterfaceTest, SameAsSqpOsqpInterface) {
+  const auto ref_points = RefPoints(20, 0.0);
+
+  FemPosDeviationSqpOsqpInterface expected;
+  SetupInterface(ref_points, &expected);
+  ASSERT_TRUE(expected.Solve());
+
+  FemPosDeviationSparseSqpInterface sparse;
+  SetupInterface(ref_points, &sparse);
+  ASSERT_TRUE(sparse.Solve());
+  EXPECT_GT(sparse.num_of_subproblems(), 1);
+  // without a solver kept by the caller, the first subproblem sets up
+  EXPECT_EQ(sparse.num_of_setups(), 1);
+
+  ASSERT_EQ(sparse.opt_xy().size(), expected.opt_xy().size());
+  for (size_t i = 0; i < ref_points.size(); ++i) {
+    EXPECT_NEAR(sparse.opt_xy()[i].first, expected.opt_xy()[i].first, 1e-4);
+    EXPECT_NEAR(sparse.opt_xy()[i].second, expected.opt_xy()[i].second,
+                1e-4);
+  }
+}
+
+TEST(FemPosDeviationSparseSqpInterfaceTest, ReuseWorkspace) {
+  PiecewiseJerkSolver solver;
+
+  FemPosDeviationSparseSqpInterface first;
+  SetupInterface(RefPoints(20, 0.0), &first);
+  first.set_solver(&solver);
+  ASSERT_TRUE(first.Solve());
+  EXPECT_EQ(first.num_of_setups(), 1);
+
+  // the next cycle moved along the curve, same number of points
+  const auto ref_points = RefPoints(20, 0.1);
+  FemPosDeviationSparseSqpInterface second;
+  SetupInterface(ref_points, &second);
+  second.set_solver(&solver);
+  ASSERT_TRUE(second.Solve());
+  EXPECT_GT(second.num_of_subproblems(), 0);
+  EXPECT_EQ(second.num_of_setups(), 0);
+
+  // warm started from the last cycle, osqp stops at another iterate within
+  // its tolerance
+  FemPosDeviationSqpOsqpInterface expected;
+  SetupInterface(ref_points, &expected);
+  ASSERT_TRUE(expected.Solve());
+  for (size_t i = 0; i < ref_points.size(); ++i) {
+    EXPECT_NEAR(second.opt_xy()[i].first, expected.opt_xy()[i].first, 1e-3);
+    EXPECT_NEAR(second.opt_xy()[i].second, expected.opt_xy()[i].second,
+                1e-3);
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
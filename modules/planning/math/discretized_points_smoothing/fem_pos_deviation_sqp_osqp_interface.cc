@@ -415,6 +415,11 @@ void FemPosDeviationSqpOsqpInterface::CalculateAffineConstraint(
                                     lin_cache[i][1] * scale_factor);
   }
 
+  // rebuilt every sqp iteration, osqp takes the leading values of A on an
+  // update, so appending to the last linearization would leave it unchanged
+  A_data->clear();
+  A_indices->clear();
+  A_indptr->clear();
   int ind_a = 0;
   for (int i = 0; i < num_of_variables_; ++i) {
     A_indptr->push_back(ind_a);
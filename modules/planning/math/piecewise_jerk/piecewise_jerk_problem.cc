@@ -88,6 +88,9 @@ OSQPData* PiecewiseJerkProblem::FormulateProblem() {
 }
 
 bool PiecewiseJerkProblem::Optimize(const int max_iter) {
+  if (solver_ != nullptr) {
+    return OptimizeWithSolver(max_iter);
+  }
   OSQPData* data = FormulateProblem();
 
   OSQPSettings* settings = SolverDefaultSettings();
@@ -116,15 +119,7 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
   }
 
   // extract primal results
-  x_.resize(num_of_knots_);
-  dx_.resize(num_of_knots_);
-  ddx_.resize(num_of_knots_);
-  for (size_t i = 0; i < num_of_knots_; ++i) {
-    x_.at(i) = osqp_work->solution->x[i] / scale_factor_[0];
-    dx_.at(i) = osqp_work->solution->x[i + num_of_knots_] / scale_factor_[1];
-    ddx_.at(i) =
-        osqp_work->solution->x[i + 2 * num_of_knots_] / scale_factor_[2];
-  }
+  ExtractPrimal(osqp_work->solution->x);
 
   // Cleanup
   osqp_cleanup(osqp_work);
@@ -133,6 +128,45 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
   return true;
 }
 
+bool PiecewiseJerkProblem::OptimizeWithSolver(const int max_iter) {
+  OSQPData* data = FormulateProblem();
+
+  OSQPSettings* settings = SolverDefaultSettings();
+  settings->max_iter = max_iter;
+
+  std::vector<c_float> warm_start;
+  if (warm_start_x_.size() == num_of_knots_) {
+    warm_start.resize(3 * num_of_knots_);
+    for (size_t i = 0; i < num_of_knots_; ++i) {
+      warm_start[i] = warm_start_x_[i] * scale_factor_[0];
+      warm_start[i + num_of_knots_] = warm_start_dx_[i] * scale_factor_[1];
+      warm_start[i + 2 * num_of_knots_] =
+          warm_start_ddx_[i] * scale_factor_[2];
+    }
+  }
+
+  std::vector<c_float> primal;
+  const bool success = solver_->Solve(data, settings, warm_start, &primal);
+  if (success) {
+    ExtractPrimal(primal.data());
+  }
+
+  FreeData(data);
+  c_free(settings);
+  return success;
+}
+
+void PiecewiseJerkProblem::ExtractPrimal(const c_float* primal) {
+  x_.resize(num_of_knots_);
+  dx_.resize(num_of_knots_);
+  ddx_.resize(num_of_knots_);
+  for (size_t i = 0; i < num_of_knots_; ++i) {
+    x_.at(i) = primal[i] / scale_factor_[0];
+    dx_.at(i) = primal[i + num_of_knots_] / scale_factor_[1];
+    ddx_.at(i) = primal[i + 2 * num_of_knots_] / scale_factor_[2];
+  }
+}
+
 void PiecewiseJerkProblem::CalculateAffineConstraint(
     std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
     std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
@@ -338,6 +372,17 @@ void PiecewiseJerkProblem::set_end_state_ref(
   has_end_state_ref_ = true;
 }
 
+void PiecewiseJerkProblem::set_warm_start(std::vector<double> x,
+                                          std::vector<double> dx,
+                                          std::vector<double> ddx) {
+  CHECK_EQ(x.size(), num_of_knots_);
+  CHECK_EQ(dx.size(), num_of_knots_);
+  CHECK_EQ(ddx.size(), num_of_knots_);
+  warm_start_x_ = std::move(x);
+  warm_start_dx_ = std::move(dx);
+  warm_start_ddx_ = std::move(ddx);
+}
+
 void PiecewiseJerkProblem::FreeData(OSQPData* data) {
   delete[] data->q;
   delete[] data->l;
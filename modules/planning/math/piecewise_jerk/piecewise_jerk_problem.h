@@ -20,11 +20,13 @@
 
 #pragma once
 
+#include <array>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include "osqp/osqp.h"
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
 
 namespace apollo {
 namespace planning {
@@ -108,6 +110,19 @@ class PiecewiseJerkProblem {
   void set_end_state_ref(const std::array<double, 3>& weight_end_state,
                          const std::array<double, 3>& end_state_ref);
 
+  /**
+   * @brief Solve with a solver that keeps its osqp workspace across calls
+   * instead of setting one up from scratch, nullptr to restore the default.
+   * The solver must outlive Optimize.
+   */
+  void set_solver(PiecewiseJerkSolver* solver) { solver_ = solver; }
+
+  /**
+   * @brief Set the primal guess osqp starts from, only used with a solver
+   */
+  void set_warm_start(std::vector<double> x, std::vector<double> dx,
+                      std::vector<double> ddx);
+
   virtual bool Optimize(const int max_iter = 4000);
 
   const std::vector<double>& opt_x() const { return x_; }
@@ -136,6 +151,10 @@ class PiecewiseJerkProblem {
 
   void FreeData(OSQPData* data);
 
+  bool OptimizeWithSolver(const int max_iter);
+
+  void ExtractPrimal(const c_float* primal);
+
   template <typename T>
   T* CopyData(const std::vector<T>& vec) {
     T* data = new T[vec.size()];
@@ -175,6 +194,11 @@ class PiecewiseJerkProblem {
   bool has_end_state_ref_ = false;
   std::array<double, 3> weight_end_state_ = {{0.0, 0.0, 0.0}};
   std::array<double, 3> end_state_ref_;
+
+  PiecewiseJerkSolver* solver_ = nullptr;
+  std::vector<double> warm_start_x_;
+  std::vector<double> warm_start_dx_;
+  std::vector<double> warm_start_ddx_;
 };
 
 }  // namespace planning
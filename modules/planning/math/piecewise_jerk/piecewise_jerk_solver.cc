@@ -0,0 +1,236 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+template <typename T>
+bool IsSameArray(const std::vector<T>& vec, const T* data, const size_t size) {
+  return vec.size() == size && std::equal(vec.begin(), vec.end(), data);
+}
+
+c_int NumNonZeros(const csc& mat) { return mat.p[mat.n]; }
+
+}  // namespace
+
+PiecewiseJerkSolver::~PiecewiseJerkSolver() { Reset(); }
+
+void PiecewiseJerkSolver::Reset() {
+  if (work_ != nullptr) {
+    osqp_cleanup(work_);
+    work_ = nullptr;
+  }
+  n_ = 0;
+  m_ = 0;
+}
+
+bool PiecewiseJerkSolver::Solve(OSQPData* data, OSQPSettings* settings,
+                                const std::vector<c_float>& warm_start_x,
+                                std::vector<c_float>* primal) {
+  CHECK_NOTNULL(data);
+  CHECK_NOTNULL(settings);
+  CHECK_NOTNULL(primal);
+  const auto start_time = std::chrono::steady_clock::now();
+  stats_ = PiecewiseJerkSolverStats();
+
+  const bool updated = work_ != nullptr && IsSameStructure(*data) &&
+                       IsSameSetupSettings(*settings) &&
+                       UpdateWorkspace(*data, *settings);
+  if (!updated) {
+    Reset();
+    work_ = osqp_setup(data, settings);
+    if (work_ == nullptr) {
+      AERROR << "osqp setup failed";
+      return false;
+    }
+    n_ = data->n;
+    m_ = data->m;
+    P_indices_.assign(data->P->i, data->P->i + NumNonZeros(*data->P));
+    P_indptr_.assign(data->P->p, data->P->p + data->n + 1);
+    P_upper_.clear();
+    for (c_int col = 0; col < data->n; ++col) {
+      for (c_int k = P_indptr_[col]; k < P_indptr_[col + 1]; ++k) {
+        if (P_indices_[k] <= col) {
+          P_upper_.push_back(k);
+        }
+      }
+    }
+    A_indices_.assign(data->A->i, data->A->i + NumNonZeros(*data->A));
+    A_indptr_.assign(data->A->p, data->A->p + data->n + 1);
+    settings_ = *settings;
+    stats_.setup = true;
+  }
+  SaveData(*data);
+
+  if (static_cast<c_int>(warm_start_x.size()) == n_) {
+    osqp_warm_start_x(work_, warm_start_x.data());
+    stats_.warm_started = true;
+  }
+
+  osqp_solve(work_);
+
+  stats_.iterations = static_cast<int>(work_->info->iter);
+  stats_.status = static_cast<int>(work_->info->status_val);
+  stats_.objective = work_->info->obj_val;
+  stats_.time_ms = std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - start_time)
+                       .count();
+  ADEBUG << "osqp " << (stats_.setup ? "setup" : "update") << " and solve in "
+         << stats_.time_ms << " ms, " << stats_.iterations << " iterations"
+         << (stats_.warm_started ? ", warm started" : "");
+
+  const auto status = work_->info->status_val;
+  if (status < 0 || (status != 1 && status != 2)) {
+    AERROR << "failed optimization status:\t" << work_->info->status;
+    // do not start the next cycle from a diverged iterate
+    Reset();
+    return false;
+  } else if (work_->solution == nullptr) {
+    AERROR << "The solution from OSQP is nullptr";
+    Reset();
+    return false;
+  }
+  primal->assign(work_->solution->x, work_->solution->x + n_);
+  return true;
+}
+
+bool PiecewiseJerkSolver::IsSameStructure(const OSQPData& data) const {
+  return data.n == n_ && data.m == m_ &&
+         IsSameArray(P_indptr_, data.P->p, data.n + 1) &&
+         IsSameArray(P_indices_, data.P->i, NumNonZeros(*data.P)) &&
+         IsSameArray(A_indptr_, data.A->p, data.n + 1) &&
+         IsSameArray(A_indices_, data.A->i, NumNonZeros(*data.A));
+}
+
+bool PiecewiseJerkSolver::IsSameSetupSettings(
+    const OSQPSettings& settings) const {
+  return settings.rho == settings_.rho && settings.sigma == settings_.sigma &&
+         settings.scaling == settings_.scaling &&
+         settings.adaptive_rho == settings_.adaptive_rho &&
+         settings.adaptive_rho_interval == settings_.adaptive_rho_interval &&
+         settings.adaptive_rho_tolerance == settings_.adaptive_rho_tolerance &&
+         settings.adaptive_rho_fraction == settings_.adaptive_rho_fraction &&
+         settings.linsys_solver == settings_.linsys_solver;
+}
+
+void PiecewiseJerkSolver::UpdateSettings(const OSQPSettings& settings) {
+  osqp_update_max_iter(work_, settings.max_iter);
+  osqp_update_eps_abs(work_, settings.eps_abs);
+  osqp_update_eps_rel(work_, settings.eps_rel);
+  osqp_update_eps_prim_inf(work_, settings.eps_prim_inf);
+  osqp_update_eps_dual_inf(work_, settings.eps_dual_inf);
+  osqp_update_alpha(work_, settings.alpha);
+  osqp_update_delta(work_, settings.delta);
+  osqp_update_polish(work_, settings.polish);
+  osqp_update_polish_refine_iter(work_, settings.polish_refine_iter);
+  osqp_update_verbose(work_, settings.verbose);
+  osqp_update_scaled_termination(work_, settings.scaled_termination);
+  osqp_update_check_termination(work_, settings.check_termination);
+  osqp_update_warm_start(work_, settings.warm_start);
+  osqp_update_time_limit(work_, settings.time_limit);
+}
+
+bool PiecewiseJerkSolver::UpdateWorkspace(const OSQPData& data,
+                                          const OSQPSettings& settings) {
+  UpdateSettings(settings);
+  if (osqp_update_lin_cost(work_, data.q) != 0 ||
+      osqp_update_bounds(work_, data.l, data.u) != 0) {
+    AERROR << "osqp update of the vectors failed";
+    return false;
+  }
+
+  // new matrix values cost a numerical refactorization, skip it when the
+  // kernel or the constraints are unchanged
+  const c_int P_nnz = NumNonZeros(*data.P);
+  const c_int A_nnz = NumNonZeros(*data.A);
+  const bool P_changed = !IsSameArray(P_data_, data.P->x, P_nnz);
+  const bool A_changed = !IsSameArray(A_data_, data.A->x, A_nnz);
+  const c_float* P_x = data.P->x;
+  const c_int P_upper_nnz = static_cast<c_int>(P_upper_.size());
+  if (P_changed && P_upper_nnz < P_nnz) {
+    P_upper_data_.resize(P_upper_.size());
+    for (size_t k = 0; k < P_upper_.size(); ++k) {
+      P_upper_data_[k] = data.P->x[P_upper_[k]];
+    }
+    P_x = P_upper_data_.data();
+  }
+  c_int exitflag = 0;
+  if (P_changed && A_changed) {
+    exitflag = osqp_update_P_A(work_, P_x, OSQP_NULL, P_upper_nnz, data.A->x,
+                               OSQP_NULL, A_nnz);
+  } else if (P_changed) {
+    exitflag = osqp_update_P(work_, P_x, OSQP_NULL, P_upper_nnz);
+  } else if (A_changed) {
+    exitflag = osqp_update_A(work_, data.A->x, OSQP_NULL, A_nnz);
+  }
+  if (exitflag != 0) {
+    AERROR << "osqp update of the matrices failed";
+    return false;
+  }
+  return true;
+}
+
+void PiecewiseJerkSolver::SaveData(const OSQPData& data) {
+  P_data_.assign(data.P->x, data.P->x + NumNonZeros(*data.P));
+  A_data_.assign(data.A->x, data.A->x + NumNonZeros(*data.A));
+}
+
+void ShiftPiecewiseJerkSolution(const std::vector<double>& x,
+                                const std::vector<double>& dx,
+                                const std::vector<double>& ddx,
+                                const double delta, const double offset,
+                                const size_t num_of_knots,
+                                std::vector<double>* shifted_x,
+                                std::vector<double>* shifted_dx,
+                                std::vector<double>* shifted_ddx) {
+  CHECK_NOTNULL(shifted_x);
+  CHECK_NOTNULL(shifted_dx);
+  CHECK_NOTNULL(shifted_ddx);
+  CHECK_GT(delta, 0.0);
+  shifted_x->clear();
+  shifted_dx->clear();
+  shifted_ddx->clear();
+  if (x.empty() || dx.size() != x.size() || ddx.size() != x.size()) {
+    return;
+  }
+  const double max_index = static_cast<double>(x.size() - 1);
+  for (size_t i = 0; i < num_of_knots; ++i) {
+    const double index = std::min(
+        std::max(static_cast<double>(i) + offset / delta, 0.0), max_index);
+    const size_t lower = static_cast<size_t>(index);
+    const size_t upper = std::min(lower + 1, x.size() - 1);
+    const double ratio = index - static_cast<double>(lower);
+    shifted_x->push_back(x[lower] + ratio * (x[upper] - x[lower]));
+    shifted_dx->push_back(dx[lower] + ratio * (dx[upper] - dx[lower]));
+    shifted_ddx->push_back(ddx[lower] + ratio * (ddx[upper] - ddx[lower]));
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <vector>
+
+#include "osqp/osqp.h"
+
+namespace apollo {
+namespace planning {
+
+struct PiecewiseJerkSolverStats {
+  // the osqp workspace was set up from scratch instead of updated
+  bool setup = false;
+  bool warm_started = false;
+  int iterations = 0;
+  int status = 0;
+  double objective = 0.0;
+  // setup or update plus solve
+  double time_ms = 0.0;
+};
+
+/*
+ * @brief:
+ * Keeps an osqp workspace alive across planning cycles. As long as the
+ * dimensions and the sparsity pattern of P and A do not change, a new
+ * problem only updates the changed vectors and matrix values of the
+ * workspace, which skips the symbolic factorization of the setup and lets
+ * osqp start from the previous iterate or from a given primal guess.
+ */
+class PiecewiseJerkSolver {
+ public:
+  PiecewiseJerkSolver() = default;
+
+  ~PiecewiseJerkSolver();
+
+  PiecewiseJerkSolver(const PiecewiseJerkSolver&) = delete;
+  PiecewiseJerkSolver& operator=(const PiecewiseJerkSolver&) = delete;
+
+  /**
+   * @brief Solve the problem in data, the workspace copies what it needs so
+   * data and settings stay owned by the caller. A reused workspace takes
+   * over the new settings, a change of a setting that osqp only reads in
+   * the setup, like rho, sigma or scaling, sets it up again.
+   *
+   * @param warm_start_x: primal guess in problem variables, ignored if empty
+   * @param primal: solution on success
+   */
+  bool Solve(OSQPData* data, OSQPSettings* settings,
+             const std::vector<c_float>& warm_start_x,
+             std::vector<c_float>* primal);
+
+  /**
+   * @brief Drop the workspace, the next solve sets up from scratch.
+   */
+  void Reset();
+
+  /**
+   * @brief Whether a workspace is alive. With warm starting enabled in the
+   * settings, a solve without warm_start_x then continues from the last
+   * primal and dual iterate.
+   */
+  bool has_workspace() const { return work_ != nullptr; }
+
+  const PiecewiseJerkSolverStats& stats() const { return stats_; }
+
+ private:
+  bool IsSameStructure(const OSQPData& data) const;
+
+  // whether the settings that osqp only reads in the setup are unchanged
+  bool IsSameSetupSettings(const OSQPSettings& settings) const;
+
+  void UpdateSettings(const OSQPSettings& settings);
+
+  // false if osqp rejects the update, the workspace is set up again then
+  bool UpdateWorkspace(const OSQPData& data, const OSQPSettings& settings);
+
+  void SaveData(const OSQPData& data);
+
+ private:
+  OSQPWorkspace* work_ = nullptr;
+
+  c_int n_ = 0;
+  c_int m_ = 0;
+  std::vector<c_int> P_indices_;
+  std::vector<c_int> P_indptr_;
+  std::vector<c_float> P_data_;
+  // osqp keeps the upper triangle of P only, position in P of each value it
+  // expects on an update
+  std::vector<c_int> P_upper_;
+  std::vector<c_float> P_upper_data_;
+  std::vector<c_int> A_indices_;
+  std::vector<c_int> A_indptr_;
+  std::vector<c_float> A_data_;
+  OSQPSettings settings_{};
+
+  PiecewiseJerkSolverStats stats_;
+};
+
+/**
+ * @brief Resample a piecewise jerk solution with knots every delta onto
+ * num_of_knots knots of the same spacing, starting offset after its first
+ * knot. State is linearly interpolated and held past the last knot.
+ */
+void ShiftPiecewiseJerkSolution(const std::vector<double>& x,
+                                const std::vector<double>& dx,
+                                const std::vector<double>& ddx,
+                                const double delta, const double offset,
+                                const size_t num_of_knots,
+                                std::vector<double>* shifted_x,
+                                std::vector<double>* shifted_dx,
+                                std::vector<double>* shifted_ddx);
+
+}  // namespace planning
+}  // namespace apollo
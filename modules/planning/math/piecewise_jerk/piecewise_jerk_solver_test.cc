@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
+
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_speed_problem.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr double kDeltaT = 0.1;
+
+// a speed profile stopping before stop_s
+void SetupProblem(const double stop_s, const double kappa_penalty,
+                  PiecewiseJerkSpeedProblem* problem) {
+  problem->set_weight_ddx(1.0);
+  problem->set_weight_dddx(10.0);
+  problem->set_x_bounds(0.0, stop_s);
+  problem->set_dx_bounds(0.0, 15.0);
+  problem->set_ddx_bounds(-4.0, 2.0);
+  problem->set_dddx_bound(-4.0, 2.0);
+  problem->set_dx_ref(10.0, 10.0);
+  problem->set_penalty_dx(std::vector<double>(50, kappa_penalty));
+}
+
+// min 0.5 x'Px + q'x, s.t. l <= Ax <= u, solved by x = (0.3, 0.7)
+struct SmallQp {
+  c_float P_x[3] = {4.0, 1.0, 2.0};
+  c_int P_i[3] = {0, 0, 1};
+  c_int P_p[3] = {0, 1, 3};
+  c_float q[2] = {1.0, 1.0};
+  c_float A_x[4] = {1.0, 1.0, 1.0, 1.0};
+  c_int A_i[4] = {0, 1, 0, 2};
+  c_int A_p[3] = {0, 2, 4};
+  c_float l[3] = {1.0, 0.0, 0.0};
+  c_float u[3] = {1.0, 0.7, 0.7};
+  csc P{3, 2, 2, P_p, P_i, P_x, -1};
+  csc A{4, 3, 2, A_p, A_i, A_x, -1};
+  OSQPData data{2, 3, &P, &A, q, l, u};
+};
+
+}  // namespace
+
+TEST(PiecewiseJerkSolverTest, ReuseWorkspace) {
+  const std::array<double, 3> init_s = {0.0, 8.0, 0.0};
+  PiecewiseJerkSolver solver;
+
+  PiecewiseJerkSpeedProblem first(50, kDeltaT, init_s);
+  SetupProblem(40.0, 0.0, &first);
+  first.set_solver(&solver);
+  ASSERT_TRUE(first.Optimize());
+  EXPECT_TRUE(solver.stats().setup);
+  EXPECT_FALSE(solver.stats().warm_started);
+  EXPECT_GT(solver.stats().iterations, 0);
+
+  // same structure with new bounds and kernel values
+  PiecewiseJerkSpeedProblem expected(50, kDeltaT, init_s);
+  SetupProblem(30.0, 1.0, &expected);
+  ASSERT_TRUE(expected.Optimize());
+
+  PiecewiseJerkSpeedProblem second(50, kDeltaT, init_s);
+  SetupProblem(30.0, 1.0, &second);
+  second.set_solver(&solver);
+  second.set_warm_start(first.opt_x(), first.opt_dx(), first.opt_ddx());
+  ASSERT_TRUE(second.Optimize());
+  EXPECT_FALSE(solver.stats().setup);
+  EXPECT_TRUE(solver.stats().warm_started);
+  for (size_t i = 0; i < 50; ++i) {
+    EXPECT_NEAR(second.opt_x()[i], expected.opt_x()[i], 1e-2);
+    EXPECT_NEAR(second.opt_dx()[i], expected.opt_dx()[i], 1e-2);
+  }
+
+  // a different number of knots needs a new workspace
+  PiecewiseJerkSpeedProblem third(40, kDeltaT, init_s);
+  third.set_weight_ddx(1.0);
+  third.set_x_bounds(0.0, 30.0);
+  third.set_ddx_bounds(-4.0, 2.0);
+  third.set_dddx_bound(-4.0, 2.0);
+  third.set_solver(&solver);
+  ASSERT_TRUE(third.Optimize());
+  EXPECT_TRUE(solver.stats().setup);
+  EXPECT_EQ(third.opt_x().size(), 40);
+}
+
+TEST(PiecewiseJerkSolverTest, UpdateSettings) {
+  SmallQp qp;
+  OSQPSettings settings;
+  osqp_set_default_settings(&settings);
+  settings.verbose = false;
+  PiecewiseJerkSolver solver;
+  std::vector<c_float> primal;
+  ASSERT_TRUE(solver.Solve(&qp.data, &settings, {}, &primal));
+  EXPECT_TRUE(solver.stats().setup);
+  EXPECT_NEAR(primal[0], 0.3, 1e-2);
+  EXPECT_NEAR(primal[1], 0.7, 1e-2);
+
+  // the reused workspace has to stop after one cold started iteration
+  settings.max_iter = 1;
+  settings.warm_start = false;
+  EXPECT_FALSE(solver.Solve(&qp.data, &settings, {}, &primal));
+  EXPECT_FALSE(solver.stats().setup);
+  EXPECT_EQ(solver.stats().iterations, 1);
+
+  settings.max_iter = 4000;
+  settings.warm_start = true;
+  ASSERT_TRUE(solver.Solve(&qp.data, &settings, {}, &primal));
+  EXPECT_TRUE(solver.stats().setup);
+  ASSERT_TRUE(solver.Solve(&qp.data, &settings, {}, &primal));
+  EXPECT_FALSE(solver.stats().setup);
+
+  // rho is only read in the setup
+  settings.rho = 0.5;
+  ASSERT_TRUE(solver.Solve(&qp.data, &settings, {}, &primal));
+  EXPECT_TRUE(solver.stats().setup);
+  EXPECT_NEAR(primal[0], 0.3, 1e-2);
+  EXPECT_NEAR(primal[1], 0.7, 1e-2);
+}
+
+TEST(PiecewiseJerkSolverTest, UpdateFullKernel) {
+  // both triangles of P, osqp only keeps the upper one
+  SmallQp qp;
+  c_float P_x[4] = {4.0, 1.0, 1.0, 2.0};
+  c_int P_i[4] = {0, 1, 0, 1};
+  c_int P_p[3] = {0, 2, 4};
+  csc P{4, 2, 2, P_p, P_i, P_x, -1};
+  qp.data.P = &P;
+  OSQPSettings settings;
+  osqp_set_default_settings(&settings);
+  settings.verbose = false;
+  settings.eps_abs = 1e-6;
+  settings.eps_rel = 1e-6;
+  PiecewiseJerkSolver solver;
+  std::vector<c_float> primal;
+  ASSERT_TRUE(solver.Solve(&qp.data, &settings, {}, &primal));
+
+  P_x[0] = 1.0;
+  P_x[3] = 8.0;
+  ASSERT_TRUE(solver.Solve(&qp.data, &settings, {}, &primal));
+  EXPECT_FALSE(solver.stats().setup);
+  PiecewiseJerkSolver expected_solver;
+  std::vector<c_float> expected;
+  ASSERT_TRUE(expected_solver.Solve(&qp.data, &settings, {}, &expected));
+  EXPECT_NEAR(primal[0], expected[0], 1e-4);
+  EXPECT_NEAR(primal[1], expected[1], 1e-4);
+}
+
+TEST(PiecewiseJerkSolverTest, ShiftPiecewiseJerkSolution) {
+  const std::vector<double> x = {0.0, 1.0, 2.0, 3.0};
+  const std::vector<double> dx = {10.0, 10.0, 10.0, 10.0};
+  const std::vector<double> ddx = {0.0, 1.0, 2.0, 3.0};
+  std::vector<double> shifted_x;
+  std::vector<double> shifted_dx;
+  std::vector<double> shifted_ddx;
+  ShiftPiecewiseJerkSolution(x, dx, ddx, kDeltaT, 0.15, 4, &shifted_x,
+                             &shifted_dx, &shifted_ddx);
+  ASSERT_EQ(shifted_x.size(), 4);
+  EXPECT_NEAR(shifted_x[0], 1.5, 1e-9);
+  EXPECT_NEAR(shifted_x[1], 2.5, 1e-9);
+  EXPECT_NEAR(shifted_ddx[1], 2.5, 1e-9);
+  // held past the last knot
+  EXPECT_NEAR(shifted_x[2], 3.0, 1e-9);
+  EXPECT_NEAR(shifted_x[3], 3.0, 1e-9);
+  EXPECT_NEAR(shifted_dx[3], 10.0, 1e-9);
+
+  ShiftPiecewiseJerkSolution({}, {}, {}, kDeltaT, 0.0, 4, &shifted_x,
+                             &shifted_dx, &shifted_ddx);
+  EXPECT_TRUE(shifted_x.empty());
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -211,6 +211,10 @@ Status OnLanePlanning::InitFrame(const uint32_t sequence_num,
     }
   }
 
+  if (FLAGS_enable_obstacle_boundary_cache) {
+    injector_->obstacle_boundary_cache()->StartCycle();
+    frame_->set_obstacle_boundary_cache(injector_->obstacle_boundary_cache());
+  }
   auto status = frame_->Init(
       injector_->vehicle_state(), reference_lines, segments,
       reference_line_provider_->FutureRouteWaypoints(), injector_->ego_info());
@@ -405,6 +409,15 @@ void OnLanePlanning::RunOnce(const LocalView& local_view,
   ADEBUG << "total planning time spend: " << time_diff_ms << " ms.";
 
   ptr_trajectory_pb->mutable_latency_stats()->set_total_time_ms(time_diff_ms);
+  if (frame_->arena() != nullptr) {
+    frame_->arena()->RecordStats(ptr_trajectory_pb->mutable_latency_stats()
+                                     ->mutable_frame_arena_stats());
+  }
+  if (FLAGS_enable_obstacle_boundary_cache) {
+    injector_->obstacle_boundary_cache()->RecordStats(
+        ptr_trajectory_pb->mutable_latency_stats()
+            ->mutable_obstacle_boundary_cache_stats());
+  }
   ADEBUG << "Planning latency: "
          << ptr_trajectory_pb->latency_stats().DebugString();
 
@@ -616,6 +629,22 @@ Status OnLanePlanning::Plan(
     }
     ptr_trajectory_pb->mutable_latency_stats()->MergeFrom(
         best_ref_info->latency_stats());
+    const auto reused_ratios = reference_line_provider_->LastReusedRatios();
+    for (const auto& reference_line_info : frame_->reference_line_info()) {
+      auto* reference_line_stats = ptr_trajectory_pb->mutable_latency_stats()
+                                       ->add_reference_line_stats();
+      reference_line_stats->set_id(reference_line_info.Lanes().Id());
+      const auto reused_ratio =
+          reused_ratios.find(reference_line_info.Lanes().Id());
+      if (reused_ratio != reused_ratios.end()) {
+        reference_line_stats->set_reused_ratio(reused_ratio->second);
+      }
+      reference_line_stats->set_is_change_lane_path(
+          reference_line_info.IsChangeLanePath());
+      reference_line_stats->set_is_drivable(reference_line_info.IsDrivable());
+      reference_line_stats->set_cost(reference_line_info.Cost());
+      reference_line_stats->set_time_ms(reference_line_info.planning_time_ms());
+    }
     // set right of way status
     ptr_trajectory_pb->set_right_of_way_status(
         best_ref_info->GetRightOfWayStatus());
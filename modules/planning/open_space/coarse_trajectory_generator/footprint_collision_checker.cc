@@ -0,0 +1,169 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/footprint_collision_checker.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "cyber/common/log.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+// covers the rounding of Box2d corners and the point in box tolerance of
+// Box2d::HasOverlap() for degenerated segments
+constexpr double kBoundsMargin = 1e-6;
+}  // namespace
+
+FootprintCollisionChecker::FootprintCollisionChecker(
+    const common::VehicleParam& vehicle_param)
+    : vehicle_param_(vehicle_param) {
+  half_length_ = vehicle_param_.length() / 2.0;
+  half_width_ = vehicle_param_.width() / 2.0;
+  shift_distance_ = half_length_ - vehicle_param_.back_edge_to_center();
+}
+
+void FootprintCollisionChecker::SetObstacles(
+    const std::vector<std::vector<common::math::LineSegment2d>>&
+        obstacles_linesegments_vec) {
+  segments_.clear();
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec) {
+    segments_.insert(segments_.end(), obstacle_linesegments.begin(),
+                     obstacle_linesegments.end());
+  }
+  const size_t segment_num = segments_.size();
+  segment_min_x_.resize(segment_num);
+  segment_max_x_.resize(segment_num);
+  segment_min_y_.resize(segment_num);
+  segment_max_y_.resize(segment_num);
+  for (size_t i = 0; i < segment_num; ++i) {
+    const auto& start = segments_[i].start();
+    const auto& end = segments_[i].end();
+    segment_min_x_[i] = std::fmin(start.x(), end.x());
+    segment_max_x_[i] = std::fmax(start.x(), end.x());
+    segment_min_y_[i] = std::fmin(start.y(), end.y());
+    segment_max_y_[i] = std::fmax(start.y(), end.y());
+  }
+}
+
+bool FootprintCollisionChecker::HasOverlap(const std::vector<double>& xs,
+                                           const std::vector<double>& ys,
+                                           const std::vector<double>& phis,
+                                           const size_t start_index) const {
+  const size_t pose_num = xs.size();
+  if (segments_.empty() || start_index >= pose_num) {
+    return false;
+  }
+  std::vector<Bounds> footprints;
+  footprints.reserve(pose_num - start_index);
+  Bounds trajectory_bounds = FootprintBounds(xs[start_index], ys[start_index],
+                                             phis[start_index]);
+  for (size_t i = start_index; i < pose_num; ++i) {
+    footprints.push_back(FootprintBounds(xs[i], ys[i], phis[i]));
+    const Bounds& bounds = footprints.back();
+    trajectory_bounds.min_x = std::min(trajectory_bounds.min_x, bounds.min_x);
+    trajectory_bounds.max_x = std::max(trajectory_bounds.max_x, bounds.max_x);
+    trajectory_bounds.min_y = std::min(trajectory_bounds.min_y, bounds.min_y);
+    trajectory_bounds.max_y = std::max(trajectory_bounds.max_y, bounds.max_y);
+  }
+
+  std::vector<size_t> near_segments;
+  SelectSegments(trajectory_bounds, &near_segments);
+  if (near_segments.empty()) {
+    return false;
+  }
+
+  std::vector<size_t> candidates;
+  for (size_t i = start_index; i < pose_num; ++i) {
+    SelectSegments(footprints[i - start_index], near_segments, &candidates);
+    if (candidates.empty()) {
+      continue;
+    }
+    const common::math::Box2d bounding_box =
+        Node3d::GetBoundingBox(vehicle_param_, xs[i], ys[i], phis[i]);
+    for (const size_t index : candidates) {
+      if (bounding_box.HasOverlap(segments_[index])) {
+        ADEBUG << "collision with segment from "
+               << segments_[index].start().DebugString() << " to "
+               << segments_[index].end().DebugString();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+FootprintCollisionChecker::Bounds FootprintCollisionChecker::FootprintBounds(
+    const double x, const double y, const double phi) const {
+  const double cos_phi = std::cos(phi);
+  const double sin_phi = std::sin(phi);
+  const double center_x = x + shift_distance_ * cos_phi;
+  const double center_y = y + shift_distance_ * sin_phi;
+  const double dx = half_length_ * std::abs(cos_phi) +
+                    half_width_ * std::abs(sin_phi) + kBoundsMargin;
+  const double dy = half_length_ * std::abs(sin_phi) +
+                    half_width_ * std::abs(cos_phi) + kBoundsMargin;
+  Bounds bounds;
+  bounds.min_x = center_x - dx;
+  bounds.max_x = center_x + dx;
+  bounds.min_y = center_y - dy;
+  bounds.max_y = center_y + dy;
+  return bounds;
+}
+
+void FootprintCollisionChecker::SelectSegments(
+    const Bounds& bounds, std::vector<size_t>* selected) const {
+  const size_t segment_num = segments_.size();
+  selected->resize(segment_num);
+  size_t selected_num = 0;
+  // branch free so that the loop vectorizes
+  for (size_t i = 0; i < segment_num; ++i) {
+    const bool touch = (segment_max_x_[i] >= bounds.min_x) &
+                       (segment_min_x_[i] <= bounds.max_x) &
+                       (segment_max_y_[i] >= bounds.min_y) &
+                       (segment_min_y_[i] <= bounds.max_y);
+    (*selected)[selected_num] = i;
+    selected_num += touch;
+  }
+  selected->resize(selected_num);
+}
+
+void FootprintCollisionChecker::SelectSegments(
+    const Bounds& bounds, const std::vector<size_t>& from,
+    std::vector<size_t>* selected) const {
+  selected->resize(from.size());
+  size_t selected_num = 0;
+  for (size_t i = 0; i < from.size(); ++i) {
+    const size_t index = from[i];
+    const bool touch = (segment_max_x_[index] >= bounds.min_x) &
+                       (segment_min_x_[index] <= bounds.max_x) &
+                       (segment_max_y_[index] >= bounds.min_y) &
+                       (segment_min_y_[index] <= bounds.max_y);
+    (*selected)[selected_num] = index;
+    selected_num += touch;
+  }
+  selected->resize(selected_num);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "modules/common_msgs/config_msgs/vehicle_config.pb.h"
+
+#include "modules/common/math/line_segment2d.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class FootprintCollisionChecker
+ * @brief Checks vehicle footprints along a trajectory against obstacle line
+ * segments. Segment bounds are kept in flat arrays so that the axis aligned
+ * rejection tests run as tight loops over all segments, and the oriented
+ * footprint box is only built and tested against the few segments left.
+ * The result is the same as testing Node3d::GetBoundingBox() of every pose
+ * against every segment with Box2d::HasOverlap().
+ */
+class FootprintCollisionChecker {
+ public:
+  explicit FootprintCollisionChecker(
+      const common::VehicleParam& vehicle_param);
+
+  void SetObstacles(const std::vector<std::vector<common::math::LineSegment2d>>&
+                        obstacles_linesegments_vec);
+
+  bool empty() const { return segments_.empty(); }
+
+  /**
+   * @brief Whether the footprint at any pose from start_index on overlaps
+   * an obstacle segment. Safe to call concurrently.
+   */
+  bool HasOverlap(const std::vector<double>& xs, const std::vector<double>& ys,
+                  const std::vector<double>& phis,
+                  const size_t start_index) const;
+
+ private:
+  struct Bounds {
+    double min_x = 0.0;
+    double max_x = 0.0;
+    double min_y = 0.0;
+    double max_y = 0.0;
+  };
+
+  Bounds FootprintBounds(const double x, const double y,
+                         const double phi) const;
+
+  // indices of the segments whose bounds touch bounds
+  void SelectSegments(const Bounds& bounds,
+                      std::vector<size_t>* selected) const;
+
+  // the ones of them among from
+  void SelectSegments(const Bounds& bounds, const std::vector<size_t>& from,
+                      std::vector<size_t>* selected) const;
+
+ private:
+  common::VehicleParam vehicle_param_;
+  double half_length_ = 0.0;
+  double half_width_ = 0.0;
+  double shift_distance_ = 0.0;
+
+  std::vector<common::math::LineSegment2d> segments_;
+  std::vector<double> segment_min_x_;
+  std::vector<double> segment_max_x_;
+  std::vector<double> segment_min_y_;
+  std::vector<double> segment_max_y_;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/open_space/coarse_trajectory_generator/footprint_collision_checker.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+TEST(FootprintCollisionCheckerTest, SameAsBoxOverlap) {
+  const common::VehicleParam vehicle_param =
+      common::VehicleConfigHelper::GetConfig().vehicle_param();
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> position(-20.0, 20.0);
+  std::uniform_real_distribution<double> offset(-3.0, 3.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+
+  std::vector<std::vector<LineSegment2d>> obstacles(10);
+  for (auto& obstacle : obstacles) {
+    Vec2d start(position(generator), position(generator));
+    for (int i = 0; i < 4; ++i) {
+      const Vec2d end(start.x() + offset(generator),
+                      start.y() + offset(generator));
+      obstacle.emplace_back(start, end);
+      start = end;
+    }
+    // a degenerated segment
+    obstacle.emplace_back(start, start);
+  }
+  FootprintCollisionChecker checker(vehicle_param);
+  checker.SetObstacles(obstacles);
+  EXPECT_FALSE(checker.empty());
+
+  int collision_num = 0;
+  for (int trial = 0; trial < 2000; ++trial) {
+    std::vector<double> xs = {position(generator)};
+    std::vector<double> ys = {position(generator)};
+    std::vector<double> phis = {heading(generator)};
+    for (int i = 0; i < 4; ++i) {
+      xs.push_back(xs.back() + 0.5 * std::cos(phis.back()));
+      ys.push_back(ys.back() + 0.5 * std::sin(phis.back()));
+      phis.push_back(phis.back() + 0.05);
+    }
+    bool expected = false;
+    for (size_t i = 1; i < xs.size(); ++i) {
+      const auto box =
+          Node3d::GetBoundingBox(vehicle_param, xs[i], ys[i], phis[i]);
+      for (const auto& obstacle : obstacles) {
+        for (const auto& segment : obstacle) {
+          expected = expected || box.HasOverlap(segment);
+        }
+      }
+    }
+    collision_num += expected;
+    EXPECT_EQ(checker.HasOverlap(xs, ys, phis, 1), expected);
+  }
+  // both outcomes are covered
+  EXPECT_GT(collision_num, 0);
+  EXPECT_LT(collision_num, 2000);
+}
+
+TEST(FootprintCollisionCheckerTest, NoObstacles) {
+  FootprintCollisionChecker checker(
+      common::VehicleConfigHelper::GetConfig().vehicle_param());
+  checker.SetObstacles({});
+  EXPECT_TRUE(checker.empty());
+  EXPECT_FALSE(checker.HasOverlap({0.0}, {0.0}, {0.0}, 0));
+}
+
+}  // namespace planning
+}  // namespace apollo
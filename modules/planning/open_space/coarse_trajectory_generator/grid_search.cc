@@ -20,6 +20,8 @@
 
 #include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
 
+#include <algorithm>
+
 namespace apollo {
 namespace planning {
 
@@ -35,20 +37,23 @@ double GridSearch::EuclidDistance(const double x1, const double y1,
 }
 
 bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
-  const double node_grid_x = node->GetGridX();
-  const double node_grid_y = node->GetGridY();
-  if (node_grid_x > max_grid_x_ || node_grid_x < 0 ||
-      node_grid_y > max_grid_y_ || node_grid_y < 0) {
+  return CheckConstraints(static_cast<int>(node->GetGridX()),
+                          static_cast<int>(node->GetGridY()));
+}
+
+bool GridSearch::CheckConstraints(const int grid_x, const int grid_y) const {
+  if (grid_x > max_grid_x_ || grid_x < 0 || grid_y > max_grid_y_ ||
+      grid_y < 0) {
     return false;
   }
   if (obstacles_linesegments_vec_.empty()) {
     return true;
   }
+  const common::math::Vec2d point(grid_x, grid_y);
   for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
     for (const common::math::LineSegment2d& linesegment :
          obstacle_linesegments) {
-      if (linesegment.DistanceTo({node->GetGridX(), node->GetGridY()}) <
-          node_radius_) {
+      if (linesegment.DistanceTo(point) < node_radius_) {
         return false;
       }
     }
@@ -105,11 +110,11 @@ bool GridSearch::GenerateAStarPath(
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec,
     GridAStartResult* result) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
+  std::priority_queue<std::pair<uint64_t, double>,
+                      std::vector<std::pair<uint64_t, double>>, cmp>
       open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> close_set;
+  std::unordered_map<uint64_t, std::shared_ptr<Node2d>> open_set;
+  std::unordered_map<uint64_t, std::shared_ptr<Node2d>> close_set;
   XYbounds_ = XYbounds;
   std::shared_ptr<Node2d> start_node =
       std::make_shared<Node2d>(sx, sy, xy_grid_resolution_, XYbounds_);
@@ -123,7 +128,7 @@ bool GridSearch::GenerateAStarPath(
   // Grid a star begins
   size_t explored_node_num = 0;
   while (!open_pq.empty()) {
-    std::string current_id = open_pq.top().first;
+    const uint64_t current_id = open_pq.top().first;
     open_pq.pop();
     std::shared_ptr<Node2d> current_node = open_set[current_id];
     // Check destination
@@ -166,47 +171,74 @@ bool GridSearch::GenerateDpMap(
     const double ex, const double ey, const std::vector<double>& XYbounds,
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
+  std::priority_queue<std::pair<uint64_t, double>,
+                      std::vector<std::pair<uint64_t, double>>, cmp>
       open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  dp_map_ = decltype(dp_map_)();
   XYbounds_ = XYbounds;
   // XYbounds with xmin, xmax, ymin, ymax
   max_grid_y_ = std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_);
   max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
+  const Node2d end_node(ex, ey, xy_grid_resolution_, XYbounds_);
+  const int end_grid_x = static_cast<int>(end_node.GetGridX());
+  const int end_grid_y = static_cast<int>(end_node.GetGridY());
   obstacles_linesegments_vec_ = obstacles_linesegments_vec;
-  open_set.emplace(end_node->GetIndex(), end_node);
-  open_pq.emplace(end_node->GetIndex(), end_node->GetCost());
+
+  // every grid but the end one passes CheckConstraints, so the map is
+  // bounded by the search area plus the end grid
+  dp_min_grid_x_ = std::min(0, end_grid_x);
+  dp_min_grid_y_ = std::min(0, end_grid_y);
+  dp_size_x_ = std::max(static_cast<int>(max_grid_x_), end_grid_x) -
+               dp_min_grid_x_ + 1;
+  dp_size_y_ = std::max(static_cast<int>(max_grid_y_), end_grid_y) -
+               dp_min_grid_y_ + 1;
+  const size_t dp_size = static_cast<size_t>(dp_size_x_) * dp_size_y_;
+  dp_state_.assign(dp_size, DpState::UNSEEN);
+  dp_path_cost_.resize(dp_size);
+  dp_cost_.resize(dp_size);
+
+  const size_t end_cell = DpCell(end_grid_x, end_grid_y);
+  dp_state_[end_cell] = DpState::OPEN;
+  dp_path_cost_[end_cell] = 0.0;
+  dp_cost_[end_cell] = 0.0;
+  open_pq.emplace(end_cell, 0.0);
+
+  // same order as GenerateNextNodes
+  static constexpr int kNeighborNum = 8;
+  static constexpr int kNeighborDx[kNeighborNum] = {0, 1, 1, 1, 0, -1, -1, -1};
+  static constexpr int kNeighborDy[kNeighborNum] = {1, 1, 0, -1, -1, -1, 0, 1};
+  const double diagonal_distance = std::sqrt(2.0);
 
   // Grid a star begins
   size_t explored_node_num = 0;
   while (!open_pq.empty()) {
-    const std::string current_id = open_pq.top().first;
+    const size_t current_cell = static_cast<size_t>(open_pq.top().first);
     open_pq.pop();
-    std::shared_ptr<Node2d> current_node = open_set[current_id];
-    dp_map_.emplace(current_node->GetIndex(), current_node);
-    std::vector<std::shared_ptr<Node2d>> next_nodes =
-        std::move(GenerateNextNodes(current_node));
-    for (auto& next_node : next_nodes) {
-      if (!CheckConstraints(next_node)) {
+    dp_state_[current_cell] = DpState::CLOSED;
+    const int current_grid_x =
+        static_cast<int>(current_cell / dp_size_y_) + dp_min_grid_x_;
+    const int current_grid_y =
+        static_cast<int>(current_cell % dp_size_y_) + dp_min_grid_y_;
+    const double current_path_cost = dp_path_cost_[current_cell];
+    for (int i = 0; i < kNeighborNum; ++i) {
+      const int next_grid_x = current_grid_x + kNeighborDx[i];
+      const int next_grid_y = current_grid_y + kNeighborDy[i];
+      if (!CheckConstraints(next_grid_x, next_grid_y)) {
         continue;
       }
-      if (dp_map_.find(next_node->GetIndex()) != dp_map_.end()) {
+      const size_t next_cell = DpCell(next_grid_x, next_grid_y);
+      if (dp_state_[next_cell] == DpState::CLOSED) {
         continue;
       }
-      if (open_set.find(next_node->GetIndex()) == open_set.end()) {
+      const double next_cost =
+          current_path_cost + (i % 2 == 0 ? 1.0 : diagonal_distance);
+      if (dp_state_[next_cell] == DpState::UNSEEN) {
         ++explored_node_num;
-        next_node->SetPreNode(current_node);
-        open_set.emplace(next_node->GetIndex(), next_node);
-        open_pq.emplace(next_node->GetIndex(), next_node->GetCost());
-      } else {
-        if (open_set[next_node->GetIndex()]->GetCost() > next_node->GetCost()) {
-          open_set[next_node->GetIndex()]->SetCost(next_node->GetCost());
-          open_set[next_node->GetIndex()]->SetPreNode(current_node);
-        }
+        dp_state_[next_cell] = DpState::OPEN;
+        dp_path_cost_[next_cell] = next_cost;
+        dp_cost_[next_cell] = next_cost;
+        open_pq.emplace(next_cell, next_cost);
+      } else if (dp_cost_[next_cell] > next_cost) {
+        dp_cost_[next_cell] = next_cost;
       }
     }
   }
@@ -215,12 +247,19 @@ bool GridSearch::GenerateDpMap(
 }
 
 double GridSearch::CheckDpMap(const double sx, const double sy) {
-  std::string index = Node2d::CalcIndex(sx, sy, xy_grid_resolution_, XYbounds_);
-  if (dp_map_.find(index) != dp_map_.end()) {
-    return dp_map_[index]->GetCost() * xy_grid_resolution_;
-  } else {
+  // XYbounds with xmin, xmax, ymin, ymax
+  const int grid_x =
+      static_cast<int>((sx - XYbounds_[0]) / xy_grid_resolution_);
+  const int grid_y =
+      static_cast<int>((sy - XYbounds_[2]) / xy_grid_resolution_);
+  if (!InDpMap(grid_x, grid_y)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  const size_t cell = DpCell(grid_x, grid_y);
+  if (dp_state_[cell] != DpState::CLOSED) {
     return std::numeric_limits<double>::infinity();
   }
+  return dp_cost_[cell] * xy_grid_resolution_;
 }
 
 void GridSearch::LoadGridAStarResult(GridAStartResult* result) {
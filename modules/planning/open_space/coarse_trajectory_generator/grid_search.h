@@ -20,16 +20,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <queue>
-#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "absl/strings/str_cat.h"
-
 #include "modules/planning/proto/planner_open_space_config.pb.h"
 
 #include "cyber/common/log.h"
@@ -45,13 +43,13 @@ class Node2d {
     // XYbounds with xmin, xmax, ymin, ymax
     grid_x_ = static_cast<int>((x - XYbounds[0]) / xy_resolution);
     grid_y_ = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
+    index_ = ComputeIndex(grid_x_, grid_y_);
   }
   Node2d(const int grid_x, const int grid_y,
          const std::vector<double>& XYbounds) {
     grid_x_ = grid_x;
     grid_y_ = grid_y;
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
+    index_ = ComputeIndex(grid_x_, grid_y_);
   }
   void SetPathCost(const double path_cost) {
     path_cost_ = path_cost;
@@ -68,23 +66,24 @@ class Node2d {
   double GetPathCost() const { return path_cost_; }
   double GetHeuCost() const { return heuristic_; }
   double GetCost() const { return cost_; }
-  const std::string& GetIndex() const { return index_; }
+  uint64_t GetIndex() const { return index_; }
   std::shared_ptr<Node2d> GetPreNode() const { return pre_node_; }
-  static std::string CalcIndex(const double x, const double y,
-                               const double xy_resolution,
-                               const std::vector<double>& XYbounds) {
+  static uint64_t CalcIndex(const double x, const double y,
+                            const double xy_resolution,
+                            const std::vector<double>& XYbounds) {
     // XYbounds with xmin, xmax, ymin, ymax
     int grid_x = static_cast<int>((x - XYbounds[0]) / xy_resolution);
     int grid_y = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    return ComputeStringIndex(grid_x, grid_y);
+    return ComputeIndex(grid_x, grid_y);
   }
   bool operator==(const Node2d& right) const {
     return right.GetIndex() == index_;
   }
 
  private:
-  static std::string ComputeStringIndex(int x_grid, int y_grid) {
-    return absl::StrCat(x_grid, "_", y_grid);
+  static uint64_t ComputeIndex(int x_grid, int y_grid) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x_grid)) << 32) |
+           static_cast<uint32_t>(y_grid);
   }
 
  private:
@@ -93,7 +92,7 @@ class Node2d {
   double path_cost_ = 0.0;
   double heuristic_ = 0.0;
   double cost_ = 0.0;
-  std::string index_;
+  uint64_t index_ = 0;
   std::shared_ptr<Node2d> pre_node_ = nullptr;
 };
 
@@ -125,6 +124,7 @@ class GridSearch {
   std::vector<std::shared_ptr<Node2d>> GenerateNextNodes(
       std::shared_ptr<Node2d> node);
   bool CheckConstraints(std::shared_ptr<Node2d> node);
+  bool CheckConstraints(const int grid_x, const int grid_y) const;
   void LoadGridAStarResult(GridAStartResult* result);
 
  private:
@@ -140,12 +140,32 @@ class GridSearch {
       obstacles_linesegments_vec_;
 
   struct cmp {
-    bool operator()(const std::pair<std::string, double>& left,
-                    const std::pair<std::string, double>& right) const {
+    bool operator()(const std::pair<uint64_t, double>& left,
+                    const std::pair<uint64_t, double>& right) const {
       return left.second >= right.second;
     }
   };
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> dp_map_;
+
+  // dense grids of the dp map over [dp_min_grid_x_, dp_min_grid_x_ +
+  // dp_size_x_) x [dp_min_grid_y_, dp_min_grid_y_ + dp_size_y_), row major
+  enum class DpState : uint8_t { UNSEEN, OPEN, CLOSED };
+  size_t DpCell(const int grid_x, const int grid_y) const {
+    return static_cast<size_t>(grid_x - dp_min_grid_x_) * dp_size_y_ +
+           (grid_y - dp_min_grid_y_);
+  }
+  bool InDpMap(const int grid_x, const int grid_y) const {
+    return grid_x >= dp_min_grid_x_ && grid_x < dp_min_grid_x_ + dp_size_x_ &&
+           grid_y >= dp_min_grid_y_ && grid_y < dp_min_grid_y_ + dp_size_y_;
+  }
+  int dp_min_grid_x_ = 0;
+  int dp_min_grid_y_ = 0;
+  int dp_size_x_ = 0;
+  int dp_size_y_ = 0;
+  std::vector<DpState> dp_state_;
+  // cost when first reached, children are expanded from it
+  std::vector<double> dp_path_cost_;
+  // lowest cost found while open, the cost to the end once closed
+  std::vector<double> dp_cost_;
 };
 }  // namespace planning
 }  // namespace apollo
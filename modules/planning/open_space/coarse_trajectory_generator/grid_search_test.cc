@@ -0,0 +1,124 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/file.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+constexpr double kGoldenTolerance = 1e-6;
+
+const std::vector<double> kQueryX = {-12.0, -5.0, 0.0, 3.0, 9.0};
+const std::vector<double> kQueryY = {-4.0, 0.0, 5.0};
+
+std::vector<std::vector<LineSegment2d>> ToLineSegments(
+    const std::vector<std::vector<Vec2d>>& obstacles) {
+  std::vector<std::vector<LineSegment2d>> obstacles_linesegments_vec;
+  for (const auto& obstacle : obstacles) {
+    std::vector<LineSegment2d> linesegments;
+    for (size_t i = 0; i + 1 < obstacle.size(); ++i) {
+      linesegments.emplace_back(obstacle[i], obstacle[i + 1]);
+    }
+    obstacles_linesegments_vec.push_back(linesegments);
+  }
+  return obstacles_linesegments_vec;
+}
+
+}  // namespace
+
+class GridSearchTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    const std::string config_filename =
+        "/apollo/modules/planning/testdata/conf/"
+        "open_space_standard_parking_lot.pb.txt";
+    ACHECK(apollo::cyber::common::GetProtoFromFile(
+        config_filename, &planner_open_space_config_))
+        << "Failed to load open space config file " << config_filename;
+  }
+
+  // CheckDpMap() at every query point, x major
+  std::vector<double> DpMap(
+      const double ex, const double ey, const std::vector<double>& XYbounds,
+      const std::vector<std::vector<Vec2d>>& obstacles) {
+    GridSearch grid_search(planner_open_space_config_);
+    EXPECT_TRUE(grid_search.GenerateDpMap(ex, ey, XYbounds,
+                                          ToLineSegments(obstacles)));
+    std::vector<double> costs;
+    for (const double x : kQueryX) {
+      for (const double y : kQueryY) {
+        costs.push_back(grid_search.CheckDpMap(x, y));
+      }
+    }
+    return costs;
+  }
+
+ protected:
+  PlannerOpenSpaceConfig planner_open_space_config_;
+};
+
+// the costs were recorded from the string keyed dp map
+TEST_F(GridSearchTest, DpMapSameAsStringKeyedMap) {
+  const std::vector<double> line_costs =
+      DpMap(15.0, 0.0, {-50.0, 50.0, -50.0, 50.0}, {{{1.0, 0.0}, {-1.0, 0.0}}});
+  const std::vector<double> expected_line_costs = {
+      28.6568542495, 27.0000000000, 29.0710678119, 21.6568542495,
+      20.0000000000, 22.0710678119, 16.6568542495, 15.0000000000,
+      17.0710678119, 13.6568542495, 12.0000000000, 14.0710678119,
+      7.6568542495,  6.0000000000,  8.0710678119};
+  ASSERT_EQ(line_costs.size(), expected_line_costs.size());
+  for (size_t i = 0; i < line_costs.size(); ++i) {
+    EXPECT_NEAR(line_costs[i], expected_line_costs[i], kGoldenTolerance);
+  }
+
+  // a parking slot below a lane, the curb and the slot walls
+  const std::vector<double> slot_costs =
+      DpMap(0.0, -3.5, {-15.0, 15.0, -10.0, 10.0},
+            {{{-10.0, 2.0}, {-1.6, 2.0}},
+             {{1.6, 2.0}, {10.0, 2.0}},
+             {{-1.6, 2.0}, {-1.6, -6.0}},
+             {{1.6, -6.0}, {1.6, 2.0}},
+             {{-1.6, -6.0}, {1.6, -6.0}},
+             {{-10.0, 8.5}, {10.0, 8.5}}});
+  const std::vector<double> expected_slot_costs = {
+      12.0000000000, 13.6568542495, 15.7279220614, 5.0000000000,
+      6.6568542495,  11.0710678119, 0.0000000000,  4.0000000000,
+      9.0000000000,  3.0000000000,  5.2426406871,  10.2426406871,
+      9.0000000000,  10.6568542495, 12.7279220614};
+  ASSERT_EQ(slot_costs.size(), expected_slot_costs.size());
+  for (size_t i = 0; i < slot_costs.size(); ++i) {
+    EXPECT_NEAR(slot_costs[i], expected_slot_costs[i], kGoldenTolerance);
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -20,8 +20,8 @@
 
 #include "modules/planning/open_space/coarse_trajectory_generator/hybrid_a_star.h"
 
+#include <chrono>
 #include <limits>
-#include <unordered_set>
 
 #include "modules/planning/math/piecewise_jerk/piecewise_jerk_speed_problem.h"
 
@@ -100,18 +100,13 @@ HybridAStar::HybridAStar(const PlannerOpenSpaceConfig& open_space_conf) {
   max_acc_jerk_ =
       planner_open_space_config_.iterative_anchoring_smoother_config()
           .max_acc_jerk();
+  motion_primitives_.resize(next_node_num_);
 }
 
-bool HybridAStar::AnalyticExpansion(
-    std::shared_ptr<Node3d> current_node,
-    std::shared_ptr<Node3d>* candidate_final_node) {
-  std::shared_ptr<ReedSheppPath> reeds_shepp_to_check =
-      std::make_shared<ReedSheppPath>();
-  if (!reed_shepp_generator_->ShortestRSP(current_node, end_node_,
-                                          reeds_shepp_to_check)) {
-    return false;
-  }
-  if (!RSPCheck(reeds_shepp_to_check)) {
+bool HybridAStar::AnalyticExpansion(Node3d* current_node,
+                                    Node3d** candidate_final_node) {
+  ReedSheppPath reeds_shepp_to_check;
+  if (!ShootReedShepp(*current_node, &reeds_shepp_to_check)) {
     return false;
   }
   // load the whole RSP as nodes and add to the close set
@@ -119,26 +114,37 @@ bool HybridAStar::AnalyticExpansion(
   return true;
 }
 
-bool HybridAStar::RSPCheck(
-    const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end) {
-  std::shared_ptr<Node3d> node = std::shared_ptr<Node3d>(new Node3d(
-      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi,
-      XYbounds_, planner_open_space_config_));
-  return ValidityCheck(node);
+bool HybridAStar::ShootReedShepp(const Node3d& current_node,
+                                 ReedSheppPath* reeds_shepp_to_end) const {
+  if (!reed_shepp_generator_->ShortestRSP(current_node, *end_node_,
+                                          reeds_shepp_to_end)) {
+    return false;
+  }
+  return RSPCheck(*reeds_shepp_to_end);
+}
+
+bool HybridAStar::RSPCheck(const ReedSheppPath& reeds_shepp_to_end) const {
+  CHECK_EQ(reeds_shepp_to_end.x.size(), reeds_shepp_to_end.y.size());
+  CHECK_EQ(reeds_shepp_to_end.x.size(), reeds_shepp_to_end.phi.size());
+  return ValidityCheck(reeds_shepp_to_end.x, reeds_shepp_to_end.y,
+                       reeds_shepp_to_end.phi);
+}
+
+bool HybridAStar::ValidityCheck(const Node3d& node) const {
+  return ValidityCheck(node.GetXs(), node.GetYs(), node.GetPhis());
 }
 
-bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
-  CHECK_NOTNULL(node);
-  CHECK_GT(node->GetStepSize(), 0U);
+bool HybridAStar::ValidityCheck(
+    const std::vector<double>& traversed_x,
+    const std::vector<double>& traversed_y,
+    const std::vector<double>& traversed_phi) const {
+  CHECK_GT(traversed_x.size(), 0U);
 
   if (obstacles_linesegments_vec_.empty()) {
     return true;
   }
 
-  size_t node_step_size = node->GetStepSize();
-  const auto& traversed_x = node->GetXs();
-  const auto& traversed_y = node->GetYs();
-  const auto& traversed_phi = node->GetPhis();
+  size_t node_step_size = traversed_x.size();
 
   // The first {x, y, phi} is collision free unless they are start and end
   // configuration of search problem
@@ -154,37 +160,34 @@ bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
         traversed_y[i] > XYbounds_[3] || traversed_y[i] < XYbounds_[2]) {
       return false;
     }
-    Box2d bounding_box = Node3d::GetBoundingBox(
-        vehicle_param_, traversed_x[i], traversed_y[i], traversed_phi[i]);
-    for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
-      for (const common::math::LineSegment2d& linesegment :
-           obstacle_linesegments) {
-        if (bounding_box.HasOverlap(linesegment)) {
-          ADEBUG << "collision start at x: " << linesegment.start().x();
-          ADEBUG << "collision start at y: " << linesegment.start().y();
-          ADEBUG << "collision end at x: " << linesegment.end().x();
-          ADEBUG << "collision end at y: " << linesegment.end().y();
-          return false;
-        }
-      }
-    }
   }
-  return true;
+  return !footprint_checker_.HasOverlap(traversed_x, traversed_y,
+                                        traversed_phi, check_start_index);
 }
 
-std::shared_ptr<Node3d> HybridAStar::LoadRSPinCS(
-    const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end,
-    std::shared_ptr<Node3d> current_node) {
-  std::shared_ptr<Node3d> end_node = std::shared_ptr<Node3d>(new Node3d(
-      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi,
-      XYbounds_, planner_open_space_config_));
+Node3d* HybridAStar::LoadRSPinCS(const ReedSheppPath& reeds_shepp_to_end,
+                                 Node3d* current_node) {
+  Node3d* end_node =
+      node_pool_.Create(reeds_shepp_to_end.x, reeds_shepp_to_end.y,
+                        reeds_shepp_to_end.phi, XYbounds_,
+                        planner_open_space_config_);
   end_node->SetPre(current_node);
-  end_node->SetTrajCost(current_node->GetTrajCost() + reeds_shepp_to_end->cost);
+  end_node->SetTrajCost(current_node->GetTrajCost() + reeds_shepp_to_end.cost);
   return end_node;
 }
 
-std::shared_ptr<Node3d> HybridAStar::Next_node_generator(
-    std::shared_ptr<Node3d> current_node, size_t next_node_index) {
+Node3d* HybridAStar::Next_node_generator(Node3d* current_node,
+                                         size_t next_node_index) {
+  MotionPrimitive primitive;
+  if (!GenerateMotionPrimitive(*current_node, next_node_index, &primitive)) {
+    return nullptr;
+  }
+  return CreateNextNode(current_node, primitive);
+}
+
+bool HybridAStar::GenerateMotionPrimitive(const Node3d& current_node,
+                                          const size_t next_node_index,
+                                          MotionPrimitive* primitive) const {
   double steering = 0.0;
   double traveled_distance = 0.0;
   if (next_node_index < static_cast<double>(next_node_num_) / 2) {
@@ -203,12 +206,15 @@ std::shared_ptr<Node3d> HybridAStar::Next_node_generator(
   }
   // take above motion primitive to generate a curve driving the car to a
   // different grid
-  std::vector<double> intermediate_x;
-  std::vector<double> intermediate_y;
-  std::vector<double> intermediate_phi;
-  double last_x = current_node->GetX();
-  double last_y = current_node->GetY();
-  double last_phi = current_node->GetPhi();
+  std::vector<double>& intermediate_x = primitive->x;
+  std::vector<double>& intermediate_y = primitive->y;
+  std::vector<double>& intermediate_phi = primitive->phi;
+  intermediate_x.clear();
+  intermediate_y.clear();
+  intermediate_phi.clear();
+  double last_x = current_node.GetX();
+  double last_y = current_node.GetY();
+  double last_phi = current_node.GetPhi();
   intermediate_x.push_back(last_x);
   intermediate_y.push_back(last_y);
   intermediate_phi.push_back(last_phi);
@@ -227,24 +233,49 @@ std::shared_ptr<Node3d> HybridAStar::Next_node_generator(
     last_y = next_y;
     last_phi = next_phi;
   }
+  primitive->steering = steering;
+  primitive->forward = traveled_distance > 0.0;
   // check if the vehicle runs outside of XY boundary
   if (intermediate_x.back() > XYbounds_[1] ||
       intermediate_x.back() < XYbounds_[0] ||
       intermediate_y.back() > XYbounds_[3] ||
       intermediate_y.back() < XYbounds_[2]) {
-    return nullptr;
+    return false;
   }
-  std::shared_ptr<Node3d> next_node = std::shared_ptr<Node3d>(
-      new Node3d(intermediate_x, intermediate_y, intermediate_phi, XYbounds_,
-                 planner_open_space_config_));
+  return true;
+}
+
+Node3d* HybridAStar::CreateNextNode(Node3d* current_node,
+                                    const MotionPrimitive& primitive) {
+  Node3d* next_node =
+      node_pool_.Create(primitive.x, primitive.y, primitive.phi, XYbounds_,
+                        planner_open_space_config_);
   next_node->SetPre(current_node);
-  next_node->SetDirec(traveled_distance > 0.0);
-  next_node->SetSteer(steering);
+  next_node->SetDirec(primitive.forward);
+  next_node->SetSteer(primitive.steering);
   return next_node;
 }
 
-void HybridAStar::CalculateNodeCost(std::shared_ptr<Node3d> current_node,
-                                    std::shared_ptr<Node3d> next_node) {
+bool HybridAStar::ExpandInParallel(const Node3d& current_node) {
+  const int task_num = static_cast<int>(next_node_num_) + 1;
+  bool reeds_shepp_valid = false;
+  // the Reeds Shepp shot is the longest task, hand it out first
+#pragma omp parallel for schedule(dynamic, 1) \
+    num_threads(FLAGS_hybrid_a_star_thread_num)
+  for (int i = 0; i < task_num; ++i) {
+    if (i == 0) {
+      reeds_shepp_valid = ShootReedShepp(current_node, &reeds_shepp_to_end_);
+      continue;
+    }
+    MotionPrimitive* primitive = &motion_primitives_[i - 1];
+    primitive->valid =
+        GenerateMotionPrimitive(current_node, i - 1, primitive) &&
+        ValidityCheck(primitive->x, primitive->y, primitive->phi);
+  }
+  return reeds_shepp_valid;
+}
+
+void HybridAStar::CalculateNodeCost(Node3d* current_node, Node3d* next_node) {
   next_node->SetTrajCost(current_node->GetTrajCost() +
                          TrajCost(current_node, next_node));
   // evaluate heuristic cost
@@ -253,8 +284,7 @@ void HybridAStar::CalculateNodeCost(std::shared_ptr<Node3d> current_node,
   next_node->SetHeuCost(optimal_path_cost);
 }
 
-double HybridAStar::TrajCost(std::shared_ptr<Node3d> current_node,
-                             std::shared_ptr<Node3d> next_node) {
+double HybridAStar::TrajCost(Node3d* current_node, Node3d* next_node) {
   // evaluate cost on the trajectory and add current cost
   double piecewise_cost = 0.0;
   if (next_node->GetDirec()) {
@@ -273,13 +303,13 @@ double HybridAStar::TrajCost(std::shared_ptr<Node3d> current_node,
   return piecewise_cost;
 }
 
-double HybridAStar::HoloObstacleHeuristic(std::shared_ptr<Node3d> next_node) {
+double HybridAStar::HoloObstacleHeuristic(Node3d* next_node) {
   return grid_a_star_heuristic_generator_->CheckDpMap(next_node->GetX(),
                                                       next_node->GetY());
 }
 
 bool HybridAStar::GetResult(HybridAStartResult* result) {
-  std::shared_ptr<Node3d> current_node = final_node_;
+  const Node3d* current_node = final_node_;
   std::vector<double> hybrid_a_x;
   std::vector<double> hybrid_a_y;
   std::vector<double> hybrid_a_phi;
@@ -690,9 +720,10 @@ bool HybridAStar::Plan(
     const std::vector<std::vector<common::math::Vec2d>>& obstacles_vertices_vec,
     HybridAStartResult* result) {
   // clear containers
-  open_set_.clear();
-  close_set_.clear();
+  open_set_.Clear();
+  close_set_.Clear();
   open_pq_ = decltype(open_pq_)();
+  node_pool_.Clear();
   final_node_ = nullptr;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec;
@@ -707,6 +738,7 @@ bool HybridAStar::Plan(
     obstacles_linesegments_vec.emplace_back(obstacle_linesegments);
   }
   obstacles_linesegments_vec_ = std::move(obstacles_linesegments_vec);
+  footprint_checker_.SetObstacles(obstacles_linesegments_vec_);
   std::stringstream ssm;
   ssm << "roi boundary" << std::endl;
   for (auto vec : obstacles_linesegments_vec_) {
@@ -745,20 +777,20 @@ bool HybridAStar::Plan(
   ssm << XYbounds[2] << ", " << XYbounds[3] << std::endl;
   XYbounds_ = XYbounds;
   // load nodes and obstacles
-  start_node_.reset(
-      new Node3d({sx}, {sy}, {sphi}, XYbounds_, planner_open_space_config_));
-  end_node_.reset(
-      new Node3d({ex}, {ey}, {ephi}, XYbounds_, planner_open_space_config_));
+  start_node_ =
+      node_pool_.Create(sx, sy, sphi, XYbounds_, planner_open_space_config_);
+  end_node_ =
+      node_pool_.Create(ex, ey, ephi, XYbounds_, planner_open_space_config_);
   AINFO << "start node" << sx << "," << sy << "," << sphi;
   AINFO << "end node " << ex << "," << ey << "," << ephi;
   AINFO << ssm.str();
-  if (!ValidityCheck(start_node_)) {
+  if (!ValidityCheck(*start_node_)) {
     AERROR << "start_node in collision with obstacles";
     AERROR << start_node_->GetX() << "," << start_node_->GetY() << ","
            << start_node_->GetPhi();
     return false;
   }
-  if (!ValidityCheck(end_node_)) {
+  if (!ValidityCheck(*end_node_)) {
     AERROR << "end_node in collision with obstacles";
     return false;
   }
@@ -767,26 +799,36 @@ bool HybridAStar::Plan(
                                                   obstacles_linesegments_vec_);
   ADEBUG << "map time " << Clock::NowInSeconds() - map_time;
   // load open set, pq
-  open_set_.insert(start_node_->GetIndex());
+  open_set_.Insert(start_node_->GetIndex());
   open_pq_.emplace(start_node_, start_node_->GetCost());
   // Hybrid A* begins
   size_t explored_node_num = 0;
   size_t available_result_num = 0;
   double astar_start_time = Clock::NowInSeconds();
   double heuristic_time = 0.0;
-  double rs_time = 0.0;
+  std::chrono::duration<double> rs_time(0.0);
   double node_generator_time = 0.0;
   double validity_check_time = 0.0;
+  std::chrono::duration<double> expand_time(0.0);
   size_t max_explored_num = 1000;
   static constexpr int kMaxNodeNum = 200000;
-  std::vector<std::shared_ptr<Node3d>> candidate_final_nodes;
   while (!open_pq_.empty() && open_pq_.size() < kMaxNodeNum &&
          (available_result_num == 0 || explored_node_num < max_explored_num)) {
-    std::shared_ptr<Node3d> current_node = open_pq_.top().first;
+    Node3d* current_node = open_pq_.top().first;
     open_pq_.pop();
-    const double rs_start_time = Clock::NowInSeconds();
-    std::shared_ptr<Node3d> final_node = nullptr;
-    if (AnalyticExpansion(current_node, &final_node)) {
+    Node3d* final_node = nullptr;
+    if (FLAGS_enable_parallel_hybrid_a) {
+      const auto expand_start_time = std::chrono::steady_clock::now();
+      if (ExpandInParallel(*current_node)) {
+        final_node = LoadRSPinCS(reeds_shepp_to_end_, current_node);
+      }
+      expand_time += std::chrono::steady_clock::now() - expand_start_time;
+    } else {
+      const auto rs_start_time = std::chrono::steady_clock::now();
+      AnalyticExpansion(current_node, &final_node);
+      rs_time += std::chrono::steady_clock::now() - rs_start_time;
+    }
+    if (final_node != nullptr) {
       if (final_node_ == nullptr ||
           final_node_->GetTrajCost() > final_node->GetTrajCost()) {
         ADEBUG << "get result" << final_node->GetTrajCost();
@@ -795,46 +837,62 @@ bool HybridAStar::Plan(
       available_result_num++;
     }
     explored_node_num++;
-    const double rs_end_time = Clock::NowInSeconds();
-    rs_time += rs_end_time - rs_start_time;
-    close_set_.insert(current_node->GetIndex());
+    close_set_.Insert(current_node->GetIndex());
     size_t begin_index = 0;
     size_t end_index = next_node_num_;
-    std::unordered_set<std::string> temp_set;
+    // children join the open set only after all of them are generated
+    std::vector<uint64_t> temp_set;
     for (size_t i = begin_index; i < end_index; ++i) {
-      const double gen_node_time = Clock::NowInSeconds();
-      std::shared_ptr<Node3d> next_node = Next_node_generator(current_node, i);
-      node_generator_time += Clock::NowInSeconds() - gen_node_time;
-
-      // boundary check failure handle
-      if (next_node == nullptr) {
-        continue;
-      }
-      // check if the node is already in the close set
-      if (close_set_.count(next_node->GetIndex()) > 0) {
-        continue;
-      }
-      // collision check
-      const double validity_check_start_time = Clock::NowInSeconds();
-      if (!ValidityCheck(next_node)) {
-        continue;
+      Node3d* next_node = nullptr;
+      if (FLAGS_enable_parallel_hybrid_a) {
+        // already inside XY boundary and collision free
+        if (!motion_primitives_[i].valid) {
+          continue;
+        }
+        next_node = CreateNextNode(current_node, motion_primitives_[i]);
+        if (close_set_.Contains(next_node->GetIndex())) {
+          continue;
+        }
+      } else {
+        const double gen_node_time = Clock::NowInSeconds();
+        next_node = Next_node_generator(current_node, i);
+        node_generator_time += Clock::NowInSeconds() - gen_node_time;
+
+        // boundary check failure handle
+        if (next_node == nullptr) {
+          continue;
+        }
+        // check if the node is already in the close set
+        if (close_set_.Contains(next_node->GetIndex())) {
+          continue;
+        }
+        // collision check
+        const double validity_check_start_time = Clock::NowInSeconds();
+        if (!ValidityCheck(*next_node)) {
+          continue;
+        }
+        validity_check_time +=
+            Clock::NowInSeconds() - validity_check_start_time;
       }
-      validity_check_time += Clock::NowInSeconds() - validity_check_start_time;
-      if (open_set_.count(next_node->GetIndex()) == 0) {
+      if (!open_set_.Contains(next_node->GetIndex())) {
         const double start_time = Clock::NowInSeconds();
         CalculateNodeCost(current_node, next_node);
         const double end_time = Clock::NowInSeconds();
         heuristic_time += end_time - start_time;
-        temp_set.insert(next_node->GetIndex());
+        temp_set.push_back(next_node->GetIndex());
         open_pq_.emplace(next_node, next_node->GetCost());
       }
     }
-    open_set_.insert(temp_set.begin(), temp_set.end());
+    for (const uint64_t index : temp_set) {
+      open_set_.Insert(index);
+    }
   }
   AINFO << "explored node num is " << explored_node_num;
   AINFO << "cal node time is " << heuristic_time << "validity_check_time "
         << validity_check_time << "node_generator_time " << node_generator_time;
-  AINFO << "reed shepp time is " << rs_time;
+  AINFO << "reed shepp time is " << rs_time.count();
+  AINFO_IF(FLAGS_enable_parallel_hybrid_a)
+      << "parallel expansion time is " << expand_time.count();
   AINFO << "hybrid astar total time is "
         << Clock::NowInSeconds() - astar_start_time;
   if (final_node_ == nullptr) {
@@ -854,7 +912,7 @@ bool HybridAStar::Plan(
 
   ADEBUG << "explored node num is " << explored_node_num;
   ADEBUG << "heuristic time is " << heuristic_time;
-  ADEBUG << "reed shepp time is " << rs_time;
+  ADEBUG << "reed shepp time is " << rs_time.count();
   ADEBUG << "hybrid astar total time is "
          << Clock::NowInSeconds() - astar_start_time;
   return true;
@@ -25,7 +25,6 @@
 #include <queue>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -39,8 +38,10 @@
 #include "modules/common/math/math_utils.h"
 #include "modules/planning/common/obstacle.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/footprint_collision_checker.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/node_index_set.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/reeds_shepp_path.h"
 
 namespace apollo {
@@ -69,23 +70,44 @@ class HybridAStar {
                            std::vector<HybridAStartResult>* partitioned_result);
 
  private:
-  bool AnalyticExpansion(std::shared_ptr<Node3d> current_node,
-                         std::shared_ptr<Node3d>* candidate_final_node);
+  // curve of a steering and direction from a node, before it becomes a node
+  struct MotionPrimitive {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> phi;
+    double steering = 0.0;
+    bool forward = true;
+    // inside XY boundary and collision free
+    bool valid = false;
+  };
+
+  bool AnalyticExpansion(Node3d* current_node, Node3d** candidate_final_node);
+  // shortest Reeds Shepp path to the end node if it is collision free
+  bool ShootReedShepp(const Node3d& current_node,
+                      ReedSheppPath* reeds_shepp_to_end) const;
   // check collision and validity
-  bool ValidityCheck(std::shared_ptr<Node3d> node);
+  bool ValidityCheck(const Node3d& node) const;
+  bool ValidityCheck(const std::vector<double>& traversed_x,
+                     const std::vector<double>& traversed_y,
+                     const std::vector<double>& traversed_phi) const;
   // check Reeds Shepp path collision and validity
-  bool RSPCheck(const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end);
+  bool RSPCheck(const ReedSheppPath& reeds_shepp_to_end) const;
   // load the whole RSP as nodes and add to the close set
-  std::shared_ptr<Node3d> LoadRSPinCS(
-      const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end,
-      std::shared_ptr<Node3d> current_node);
-  std::shared_ptr<Node3d> Next_node_generator(
-      std::shared_ptr<Node3d> current_node, size_t next_node_index);
-  void CalculateNodeCost(std::shared_ptr<Node3d> current_node,
-                         std::shared_ptr<Node3d> next_node);
-  double TrajCost(std::shared_ptr<Node3d> current_node,
-                  std::shared_ptr<Node3d> next_node);
-  double HoloObstacleHeuristic(std::shared_ptr<Node3d> next_node);
+  Node3d* LoadRSPinCS(const ReedSheppPath& reeds_shepp_to_end,
+                      Node3d* current_node);
+  Node3d* Next_node_generator(Node3d* current_node, size_t next_node_index);
+  // return false if the curve runs outside of XY boundary
+  bool GenerateMotionPrimitive(const Node3d& current_node,
+                               const size_t next_node_index,
+                               MotionPrimitive* primitive) const;
+  Node3d* CreateNextNode(Node3d* current_node,
+                         const MotionPrimitive& primitive);
+  // generate and check all motion primitives of a node and shoot a Reeds
+  // Shepp path from it concurrently, return whether the shot is valid
+  bool ExpandInParallel(const Node3d& current_node);
+  void CalculateNodeCost(Node3d* current_node, Node3d* next_node);
+  double TrajCost(Node3d* current_node, Node3d* next_node);
+  double HoloObstacleHeuristic(Node3d* next_node);
   bool GetResult(HybridAStartResult* result);
   bool GetTemporalProfile(HybridAStartResult* result);
   bool GenerateSpeedAcceleration(HybridAStartResult* result);
@@ -122,25 +144,29 @@ class HybridAStar {
   double max_acc_jerk_ = 0.0;
   double arc_length_ = 0.0;
   std::vector<double> XYbounds_;
-  std::shared_ptr<Node3d> start_node_;
-  std::shared_ptr<Node3d> end_node_;
-  std::shared_ptr<Node3d> final_node_;
+  // every node of the current search, the pointers below point into it
+  Node3dPool node_pool_;
+  Node3d* start_node_ = nullptr;
+  Node3d* end_node_ = nullptr;
+  Node3d* final_node_ = nullptr;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
+  FootprintCollisionChecker footprint_checker_{vehicle_param_};
+  // results of ExpandInParallel
+  std::vector<MotionPrimitive> motion_primitives_;
+  ReedSheppPath reeds_shepp_to_end_;
 
   struct cmp {
-    bool operator()(
-        const std::pair<std::shared_ptr<Node3d>, double>& left,
-        const std::pair<std::shared_ptr<Node3d>, double>& right) const {
+    bool operator()(const std::pair<Node3d*, double>& left,
+                    const std::pair<Node3d*, double>& right) const {
       return left.second >= right.second;
     }
   };
-  std::priority_queue<std::pair<std::shared_ptr<Node3d>, double>,
-                      std::vector<std::pair<std::shared_ptr<Node3d>, double>>,
-                      cmp>
+  std::priority_queue<std::pair<Node3d*, double>,
+                      std::vector<std::pair<Node3d*, double>>, cmp>
       open_pq_;
-  std::unordered_set<std::string> open_set_;
-  std::unordered_set<std::string> close_set_;
+  NodeIndexSet open_set_;
+  NodeIndexSet close_set_;
   std::unique_ptr<ReedShepp> reed_shepp_generator_;
   std::unique_ptr<GridSearch> grid_a_star_heuristic_generator_;
 };
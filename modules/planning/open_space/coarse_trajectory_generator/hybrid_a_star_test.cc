@@ -20,6 +20,11 @@
 
 #include "modules/planning/open_space/coarse_trajectory_generator/hybrid_a_star.h"
 
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "cyber/common/file.h"
@@ -33,6 +38,84 @@ namespace planning {
 
 using apollo::common::math::Vec2d;
 
+namespace {
+
+// A plan with the sums of its x, y and phi and some of its points, recorded
+// from the string keyed search.
+struct GoldenPlan {
+  size_t size;
+  std::array<double, 3> sums;
+  std::vector<std::pair<size_t, std::array<double, 3>>> points;
+};
+
+constexpr double kGoldenTolerance = 1e-6;
+
+const std::vector<double> kLineXYBounds = {-50.0, 50.0, -50.0, 50.0};
+
+// a short wall on the straight line between start and end
+const std::vector<std::vector<Vec2d>> kLineObstacles = {
+    {{1.0, 0.0}, {-1.0, 0.0}}};
+
+const GoldenPlan kLinePlan = {
+    153,
+    {294.3012217850, 1484.6710955810, 157.7685037962},
+    {{0, {-15.0000000000, 0.0000000000, 0.0000000000}},
+     {38, {-16.4723292487, 11.5529139213, -2.1141728975}},
+     {76, {1.2274376670, 15.1938063646, 3.1396523581}},
+     {114, {19.8231691809, 13.4356313423, 2.4522819306}},
+     {152, {15.0000000000, 0.0000000000, 0.0000000000}}}};
+
+const std::vector<double> kSlotXYBounds = {-15.0, 15.0, -10.0, 10.0};
+
+// a parking slot below a lane, the curb and the slot walls
+const std::vector<std::vector<Vec2d>> kSlotObstacles = {
+    {{-10.0, 2.0}, {-1.6, 2.0}},  {{1.6, 2.0}, {10.0, 2.0}},
+    {{-1.6, 2.0}, {-1.6, -6.0}},  {{1.6, -6.0}, {1.6, 2.0}},
+    {{-1.6, -6.0}, {1.6, -6.0}},  {{-10.0, 8.5}, {10.0, 8.5}}};
+
+const GoldenPlan kSlotPlan = {
+    50,
+    {-20.1509365222, 116.1889919644, 42.0267846211},
+    {{0, {-6.0000000000, 4.0000000000, 0.0000000000}},
+     {12, {-0.0270214565, 3.6269345380, 0.1362034181}},
+     {24, {1.5732144293, 4.5684075415, 0.9273912099}},
+     {36, {0.2118504807, 2.8915290031, 1.5823755836}},
+     {49, {0.0000000000, -3.5000000000, 1.5707963268}}}};
+
+void ExpectGoldenPlan(const GoldenPlan& golden,
+                      const HybridAStartResult& result) {
+  ASSERT_EQ(result.x.size(), golden.size);
+  ASSERT_EQ(result.y.size(), golden.size);
+  ASSERT_EQ(result.phi.size(), golden.size);
+  std::array<double, 3> sums = {0.0, 0.0, 0.0};
+  for (size_t i = 0; i < golden.size; ++i) {
+    sums[0] += result.x[i];
+    sums[1] += result.y[i];
+    sums[2] += result.phi[i];
+  }
+  for (size_t i = 0; i < sums.size(); ++i) {
+    EXPECT_NEAR(sums[i], golden.sums[i], kGoldenTolerance);
+  }
+  for (const auto& point : golden.points) {
+    EXPECT_NEAR(result.x[point.first], point.second[0], kGoldenTolerance);
+    EXPECT_NEAR(result.y[point.first], point.second[1], kGoldenTolerance);
+    EXPECT_NEAR(result.phi[point.first], point.second[2], kGoldenTolerance);
+  }
+}
+
+void ExpectSameResult(const HybridAStartResult& expected,
+                      const HybridAStartResult& result) {
+  EXPECT_EQ(result.x, expected.x);
+  EXPECT_EQ(result.y, expected.y);
+  EXPECT_EQ(result.phi, expected.phi);
+  EXPECT_EQ(result.v, expected.v);
+  EXPECT_EQ(result.a, expected.a);
+  EXPECT_EQ(result.steer, expected.steer);
+  EXPECT_EQ(result.accumulated_s, expected.accumulated_s);
+}
+
+}  // namespace
+
 class HybridATest : public ::testing::Test {
  public:
   virtual void SetUp() {
@@ -77,5 +160,42 @@ TEST_F(HybridATest, test1) {
   ASSERT_TRUE(hybrid_test->Plan(sx, sy, sphi, ex, ey, ephi, XYbounds_,
                                 obstacles_list, &result));
 }
+
+TEST_F(HybridATest, SameAsStringKeyedSearch) {
+  HybridAStartResult line_result;
+  ASSERT_TRUE(hybrid_test->Plan(-15.0, 0.0, 0.0, 15.0, 0.0, 0.0,
+                                kLineXYBounds, kLineObstacles,
+                                &line_result));
+  ExpectGoldenPlan(kLinePlan, line_result);
+
+  // the second plan reuses the node pool and the sets of the first one
+  HybridAStartResult slot_result;
+  ASSERT_TRUE(hybrid_test->Plan(-6.0, 4.0, 0.0, 0.0, -3.5, M_PI_2,
+                                kSlotXYBounds, kSlotObstacles,
+                                &slot_result));
+  ExpectGoldenPlan(kSlotPlan, slot_result);
+}
+
+TEST_F(HybridATest, ParallelSameAsSequential) {
+  const bool enable_parallel_hybrid_a = FLAGS_enable_parallel_hybrid_a;
+  HybridAStartResult line_results[2];
+  HybridAStartResult slot_results[2];
+  for (const bool parallel : {false, true}) {
+    FLAGS_enable_parallel_hybrid_a = parallel;
+    ASSERT_TRUE(hybrid_test->Plan(-15.0, 0.0, 0.0, 15.0, 0.0, 0.0,
+                                  kLineXYBounds, kLineObstacles,
+                                  &line_results[parallel]));
+    ASSERT_TRUE(hybrid_test->Plan(-6.0, 4.0, 0.0, 0.0, -3.5, M_PI_2,
+                                  kSlotXYBounds, kSlotObstacles,
+                                  &slot_results[parallel]));
+  }
+  FLAGS_enable_parallel_hybrid_a = enable_parallel_hybrid_a;
+
+  ExpectGoldenPlan(kLinePlan, line_results[true]);
+  ExpectGoldenPlan(kSlotPlan, slot_results[true]);
+  ExpectSameResult(line_results[false], line_results[true]);
+  ExpectSameResult(slot_results[false], slot_results[true]);
+}
+
 }  // namespace planning
 }  // namespace apollo
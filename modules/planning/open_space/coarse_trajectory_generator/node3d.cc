@@ -20,7 +20,7 @@
 
 #include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
 
-#include "absl/strings/str_cat.h"
+#include <new>
 
 namespace apollo {
 namespace planning {
@@ -57,7 +57,7 @@ Node3d::Node3d(double x, double y, double phi,
   traversed_y_.push_back(y);
   traversed_phi_.push_back(phi);
 
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
+  index_ = ComputeIndex(x_grid_, y_grid_, phi_grid_);
 }
 
 Node3d::Node3d(const std::vector<double>& traversed_x,
@@ -89,7 +89,7 @@ Node3d::Node3d(const std::vector<double>& traversed_x,
   traversed_y_ = traversed_y;
   traversed_phi_ = traversed_phi;
 
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
+  index_ = ComputeIndex(x_grid_, y_grid_, phi_grid_);
   step_size_ = traversed_x.size();
 }
 
@@ -109,8 +109,21 @@ bool Node3d::operator==(const Node3d& right) const {
   return right.GetIndex() == index_;
 }
 
-std::string Node3d::ComputeStringIndex(int x_grid, int y_grid, int phi_grid) {
-  return absl::StrCat(x_grid, "_", y_grid, "_", phi_grid);
+uint64_t Node3d::ComputeIndex(int x_grid, int y_grid, int phi_grid) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x_grid) & 0xFFFFFF)
+          << 40) |
+         (static_cast<uint64_t>(static_cast<uint32_t>(y_grid) & 0xFFFFFF)
+          << 16) |
+         (static_cast<uint32_t>(phi_grid) & 0xFFFF);
+}
+
+void Node3dPool::Clear() {
+  for (size_t i = 0; i < size_; ++i) {
+    std::launder(
+        reinterpret_cast<Node3d*>(&chunks_[i / kChunkSize][i % kChunkSize]))
+        ->~Node3d();
+  }
+  size_ = 0;
 }
 
 }  // namespace planning
@@ -20,8 +20,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
-#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "modules/planning/proto/planner_open_space_config.pb.h"
@@ -57,22 +59,24 @@ class Node3d {
   double GetY() const { return y_; }
   double GetPhi() const { return phi_; }
   bool operator==(const Node3d& right) const;
-  const std::string& GetIndex() const { return index_; }
+  uint64_t GetIndex() const { return index_; }
   size_t GetStepSize() const { return step_size_; }
   bool GetDirec() const { return direction_; }
   double GetSteer() const { return steering_; }
-  std::shared_ptr<Node3d> GetPreNode() const { return pre_node_; }
+  const Node3d* GetPreNode() const { return pre_node_; }
   const std::vector<double>& GetXs() const { return traversed_x_; }
   const std::vector<double>& GetYs() const { return traversed_y_; }
   const std::vector<double>& GetPhis() const { return traversed_phi_; }
-  void SetPre(std::shared_ptr<Node3d> pre_node) { pre_node_ = pre_node; }
+  void SetPre(const Node3d* pre_node) { pre_node_ = pre_node; }
   void SetDirec(bool direction) { direction_ = direction; }
   void SetTrajCost(double cost) { traj_cost_ = cost; }
   void SetHeuCost(double cost) { heuristic_cost_ = cost; }
   void SetSteer(double steering) { steering_ = steering; }
 
  private:
-  static std::string ComputeStringIndex(int x_grid, int y_grid, int phi_grid);
+  // packs the grid coordinates into one integer, unique as long as |x_grid|
+  // and |y_grid| stay below 2^23 and |phi_grid| below 2^15
+  static uint64_t ComputeIndex(int x_grid, int y_grid, int phi_grid);
 
  private:
   double x_ = 0.0;
@@ -85,15 +89,54 @@ class Node3d {
   int x_grid_ = 0;
   int y_grid_ = 0;
   int phi_grid_ = 0;
-  std::string index_;
+  uint64_t index_ = 0;
   double traj_cost_ = 0.0;
   double heuristic_cost_ = 0.0;
   double cost_ = 0.0;
-  std::shared_ptr<Node3d> pre_node_ = nullptr;
+  // owned by the Node3dPool of the search
+  const Node3d* pre_node_ = nullptr;
   double steering_ = 0.0;
   // true for moving forward and false for moving backward
   bool direction_ = true;
 };
 
+/**
+ * @class Node3dPool
+ * @brief Owns the nodes of a search. Nodes are constructed in place in
+ * fixed size chunks so they never move, and are destroyed all at once by
+ * Clear(), which keeps the chunks for the next search.
+ */
+class Node3dPool {
+ public:
+  Node3dPool() = default;
+  ~Node3dPool() { Clear(); }
+
+  Node3dPool(const Node3dPool&) = delete;
+  Node3dPool& operator=(const Node3dPool&) = delete;
+
+  template <typename... Args>
+  Node3d* Create(Args&&... args) {
+    const size_t chunk = size_ / kChunkSize;
+    if (chunk == chunks_.size()) {
+      chunks_.emplace_back(new Storage[kChunkSize]);
+    }
+    void* address = &chunks_[chunk][size_ % kChunkSize];
+    Node3d* node = new (address) Node3d(std::forward<Args>(args)...);
+    ++size_;
+    return node;
+  }
+
+  void Clear();
+
+  size_t size() const { return size_; }
+
+ private:
+  static constexpr size_t kChunkSize = 1024;
+  using Storage = std::aligned_storage_t<sizeof(Node3d), alignof(Node3d)>;
+
+  std::vector<std::unique_ptr<Storage[]>> chunks_;
+  size_t size_ = 0;
+};
+
 }  // namespace planning
 }  // namespace apollo
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/node_index_set.h"
+
+#include <algorithm>
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// finalizer of splitmix64, packed indices differ mostly in a few bits
+size_t Hash(uint64_t index) {
+  index ^= index >> 30;
+  index *= 0xbf58476d1ce4e5b9ULL;
+  index ^= index >> 27;
+  index *= 0x94d049bb133111ebULL;
+  index ^= index >> 31;
+  return static_cast<size_t>(index);
+}
+
+}  // namespace
+
+NodeIndexSet::NodeIndexSet(const size_t initial_capacity) {
+  size_t capacity = 16;
+  while (capacity < initial_capacity) {
+    capacity <<= 1;
+  }
+  keys_.resize(capacity);
+  generations_.resize(capacity, 0);
+  mask_ = capacity - 1;
+}
+
+size_t NodeIndexSet::Find(const uint64_t index) const {
+  size_t slot = Hash(index) & mask_;
+  while (generations_[slot] == generation_ && keys_[slot] != index) {
+    slot = (slot + 1) & mask_;
+  }
+  return slot;
+}
+
+bool NodeIndexSet::Insert(const uint64_t index) {
+  // keep the load factor under one half
+  if (2 * (size_ + 1) > keys_.size()) {
+    Grow();
+  }
+  const size_t slot = Find(index);
+  if (generations_[slot] == generation_) {
+    return false;
+  }
+  keys_[slot] = index;
+  generations_[slot] = generation_;
+  ++size_;
+  return true;
+}
+
+bool NodeIndexSet::Contains(const uint64_t index) const {
+  return generations_[Find(index)] == generation_;
+}
+
+void NodeIndexSet::Clear() {
+  size_ = 0;
+  if (++generation_ == 0) {
+    // wrapped around, stale slots could look used again
+    std::fill(generations_.begin(), generations_.end(), 0);
+    generation_ = 1;
+  }
+}
+
+void NodeIndexSet::Grow() {
+  std::vector<uint64_t> keys;
+  keys.reserve(size_);
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    if (generations_[i] == generation_) {
+      keys.push_back(keys_[i]);
+    }
+  }
+  const size_t capacity = keys_.size() * 2;
+  keys_.assign(capacity, 0);
+  generations_.assign(capacity, 0);
+  generation_ = 1;
+  mask_ = capacity - 1;
+  for (const uint64_t key : keys) {
+    const size_t slot = Find(key);
+    keys_[slot] = key;
+    generations_[slot] = generation_;
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
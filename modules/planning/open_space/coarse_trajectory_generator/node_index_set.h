@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class NodeIndexSet
+ * @brief Open addressing hash set of packed node indices with linear
+ * probing. Clear() only bumps a generation counter, so a set reused across
+ * searches neither frees nor touches its table.
+ */
+class NodeIndexSet {
+ public:
+  explicit NodeIndexSet(const size_t initial_capacity = 1024);
+
+  /**
+   * @brief Insert an index, return false if it is already in the set.
+   */
+  bool Insert(const uint64_t index);
+
+  bool Contains(const uint64_t index) const;
+
+  void Clear();
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+ private:
+  size_t Find(const uint64_t index) const;
+
+  void Grow();
+
+ private:
+  std::vector<uint64_t> keys_;
+  // a slot is used if its generation equals the current one
+  std::vector<uint32_t> generations_;
+  uint32_t generation_ = 1;
+  size_t mask_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace planning
+}  // namespace apollo
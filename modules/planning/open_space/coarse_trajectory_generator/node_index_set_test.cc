@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/open_space/coarse_trajectory_generator/node_index_set.h"
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// packed the way Node3d packs grid indices
+uint64_t Index(const int x, const int y, const int phi) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x) & 0xFFFFFF) << 40) |
+         (static_cast<uint64_t>(static_cast<uint32_t>(y) & 0xFFFFFF) << 16) |
+         (static_cast<uint32_t>(phi) & 0xFFFF);
+}
+
+}  // namespace
+
+TEST(NodeIndexSetTest, InsertAndContains) {
+  NodeIndexSet set(4);
+  EXPECT_TRUE(set.empty());
+  for (int i = -500; i < 500; ++i) {
+    EXPECT_TRUE(set.Insert(Index(i, -i, i % 72)));
+  }
+  EXPECT_EQ(set.size(), 1000);
+  for (int i = -500; i < 500; ++i) {
+    EXPECT_TRUE(set.Contains(Index(i, -i, i % 72)));
+    EXPECT_FALSE(set.Insert(Index(i, -i, i % 72)));
+  }
+  EXPECT_FALSE(set.Contains(Index(1, 1, 1)));
+  EXPECT_FALSE(set.Contains(Index(0, 0, 1)));
+  EXPECT_TRUE(set.Insert(Index(0, 0, 1)));
+  EXPECT_TRUE(set.Contains(Index(0, 0, 1)));
+}
+
+TEST(NodeIndexSetTest, Clear) {
+  NodeIndexSet set;
+  for (int round = 0; round < 3; ++round) {
+    for (uint64_t i = 0; i < 100; ++i) {
+      EXPECT_TRUE(set.Insert(i * 7919));
+    }
+    EXPECT_EQ(set.size(), 100);
+    set.Clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.Contains(7919));
+  }
+}
+
+TEST(Node3dPoolTest, CreateAndClear) {
+  Node3dPool pool;
+  std::vector<Node3d*> nodes;
+  for (int i = 0; i < 3000; ++i) {
+    nodes.push_back(pool.Create(static_cast<double>(i), 0.0, 0.0));
+  }
+  EXPECT_EQ(pool.size(), 3000);
+  // nodes never move while the pool grows
+  EXPECT_DOUBLE_EQ(nodes.front()->GetX(), 0.0);
+  EXPECT_DOUBLE_EQ(nodes[1500]->GetX(), 1500.0);
+  nodes[1]->SetPre(nodes[0]);
+  EXPECT_EQ(nodes[1]->GetPreNode(), nodes[0]);
+  pool.Clear();
+  EXPECT_EQ(pool.size(), 0);
+  EXPECT_DOUBLE_EQ(pool.Create(5.0, 0.0, 0.0)->GetX(), 5.0);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -20,6 +20,8 @@
 #include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_interface.h"
 
 #include <algorithm>
+#include <cmath>
+#include <unordered_map>
 #include <vector>
 
 namespace apollo {
@@ -106,6 +108,8 @@ DistanceApproachIPOPTInterface::DistanceApproachIPOPTInterface(
   enable_constraint_check_ =
       distance_approach_config_.enable_constraint_check();
   enable_jacobian_ad_ = distance_approach_config_.enable_jacobian_ad();
+  enable_hand_derivative_ =
+      distance_approach_config_.enable_hand_derivative();
 }
 
 bool DistanceApproachIPOPTInterface::get_nlp_info(int& n, int& m,
@@ -442,7 +446,11 @@ bool DistanceApproachIPOPTInterface::eval_f(int n, const double* x, bool new_x,
 
 bool DistanceApproachIPOPTInterface::eval_grad_f(int n, const double* x,
                                                  bool new_x, double* grad_f) {
-  gradient(tag_f, n, x, grad_f);
+  if (enable_hand_derivative_) {
+    eval_grad_f_hand(n, x, grad_f);
+  } else {
+    gradient(tag_f, n, x, grad_f);
+  }
   return true;
 }
 
@@ -1312,6 +1320,23 @@ bool DistanceApproachIPOPTInterface::eval_h(int n, const double* x, bool new_x,
                                             bool new_lambda, int nele_hess,
                                             int* iRow, int* jCol,
                                             double* values) {
+  if (enable_hand_derivative_) {
+    if (values == nullptr) {
+      // return the structure. This is a symmetric matrix, fill the lower left
+      // triangle only.
+      std::copy(hessian_rows_.begin(), hessian_rows_.end(), iRow);
+      std::copy(hessian_cols_.begin(), hessian_cols_.end(), jCol);
+    } else {
+      std::fill_n(values, nele_hess, 0.0);
+      size_t term = 0;
+      eval_h_hand(x, obj_factor, lambda,
+                  [this, values, &term](int row, int col, double value) {
+                    values[hessian_slots_[term++]] += value;
+                  });
+    }
+    return true;
+  }
+
   if (values == nullptr) {
     // return the structure. This is a symmetric matrix, fill the lower left
     // triangle only.
@@ -1903,41 +1928,51 @@ void DistanceApproachIPOPTInterface::generate_tapes(int n, int m,
   obj_lam = new double[m + 1];
   get_starting_point(n, 1, &xp[0], 0, &zl[0], &zu[0], m, 0, &lamp[0]);
 
-  trace_on(tag_f);
-  for (int idx = 0; idx < n; idx++) {
-    xa[idx] <<= xp[idx];
-  }
-  eval_obj(n, &xa[0], &obj_value);
-  obj_value >>= dummy;
-  trace_off();
+  rind_L = nullptr;
+  cind_L = nullptr;
+  hessval = nullptr;
 
-  trace_on(tag_g);
-  for (int idx = 0; idx < n; idx++) {
-    xa[idx] <<= xp[idx];
-  }
-  eval_constraints(n, &xa[0], m, &g[0]);
-  for (int idx = 0; idx < m; idx++) {
-    g[idx] >>= dummy;
+  if (!enable_hand_derivative_) {
+    trace_on(tag_f);
+    for (int idx = 0; idx < n; idx++) {
+      xa[idx] <<= xp[idx];
+    }
+    eval_obj(n, &xa[0], &obj_value);
+    obj_value >>= dummy;
+    trace_off();
   }
-  trace_off();
 
-  trace_on(tag_L);
-  for (int idx = 0; idx < n; idx++) {
-    xa[idx] <<= xp[idx];
-  }
-  for (int idx = 0; idx < m; idx++) {
-    lam[idx] = 1.0;
-  }
-  sig = 1.0;
-  eval_obj(n, &xa[0], &obj_value);
-  obj_value *= mkparam(sig);
-  eval_constraints(n, &xa[0], m, &g[0]);
-  for (int idx = 0; idx < m; idx++) {
-    obj_value += g[idx] * mkparam(lam[idx]);
+  if (enable_jacobian_ad_) {
+    trace_on(tag_g);
+    for (int idx = 0; idx < n; idx++) {
+      xa[idx] <<= xp[idx];
+    }
+    eval_constraints(n, &xa[0], m, &g[0]);
+    for (int idx = 0; idx < m; idx++) {
+      g[idx] >>= dummy;
+    }
+    trace_off();
   }
-  obj_value >>= dummy;
 
-  trace_off();
+  if (!enable_hand_derivative_) {
+    trace_on(tag_L);
+    for (int idx = 0; idx < n; idx++) {
+      xa[idx] <<= xp[idx];
+    }
+    for (int idx = 0; idx < m; idx++) {
+      lam[idx] = 1.0;
+    }
+    sig = 1.0;
+    eval_obj(n, &xa[0], &obj_value);
+    obj_value *= mkparam(sig);
+    eval_constraints(n, &xa[0], m, &g[0]);
+    for (int idx = 0; idx < m; idx++) {
+      obj_value += g[idx] * mkparam(lam[idx]);
+    }
+    obj_value >>= dummy;
+
+    trace_off();
+  }
 
   if (enable_jacobian_ad_) {
     rind_g = nullptr;
@@ -1953,9 +1988,11 @@ void DistanceApproachIPOPTInterface::generate_tapes(int n, int m,
     *nnz_jac_g = nnz_jac;
   }
 
-  rind_L = nullptr;
-  cind_L = nullptr;
-  hessval = nullptr;
+  if (enable_hand_derivative_) {
+    generate_hessian_structure(n, m, nnz_h_lag);
+    return;
+  }
+
   options_L[0] = 0;
   options_L[1] = 1;
 
@@ -1965,5 +2002,318 @@ void DistanceApproachIPOPTInterface::generate_tapes(int n, int m,
 }
 //***************    end   ADOL-C part ***********************************
 
+//***************    start hand derivative part **************************
+void DistanceApproachIPOPTInterface::eval_grad_f_hand(int n, const double* x,
+                                                      double* grad_f) {
+  std::fill_n(grad_f, n, 0.0);
+
+  // gradient of w * ((x[a] - x[b]) / x[t] / ts)^2, b < 0 stands for the
+  // constant b_value
+  auto add_rate_gradient = [this, x, grad_f](double w, int a, int b,
+                                             double b_value, int t) {
+    const double rate = (x[a] - (b < 0 ? b_value : x[b])) / x[t] / ts_;
+    const double d_rate = 2.0 * w * rate / x[t] / ts_;
+    grad_f[a] += d_rate;
+    if (b >= 0) {
+      grad_f[b] -= d_rate;
+    }
+    grad_f[t] -= 2.0 * w * rate * rate / x[t];
+  };
+
+  // 1. objective to minimize state diff to warm up
+  int state_index = state_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    grad_f[state_index] = 2.0 * weight_state_x_ * (x[state_index] - xWS_(0, i));
+    grad_f[state_index + 1] =
+        2.0 * weight_state_y_ * (x[state_index + 1] - xWS_(1, i));
+    grad_f[state_index + 2] =
+        2.0 * weight_state_phi_ * (x[state_index + 2] - xWS_(2, i));
+    grad_f[state_index + 3] = 2.0 * weight_state_v_ * x[state_index + 3];
+    state_index += 4;
+  }
+
+  // 2. objective to minimize u square
+  int control_index = control_start_index_;
+  for (int i = 0; i < horizon_; ++i) {
+    grad_f[control_index] = 2.0 * weight_input_steer_ * x[control_index];
+    grad_f[control_index + 1] = 2.0 * weight_input_a_ * x[control_index + 1];
+    control_index += 2;
+  }
+
+  // 3. objective to minimize input change rate for first horizon
+  control_index = control_start_index_;
+  int time_index = time_start_index_;
+  add_rate_gradient(weight_stitching_steer_, control_index, -1,
+                    last_time_u_(0, 0), time_index);
+  add_rate_gradient(weight_stitching_a_, control_index + 1, -1,
+                    last_time_u_(1, 0), time_index);
+
+  // 4. objective to minimize input change rates, [0- horizon_ -2]
+  for (int i = 0; i < horizon_ - 1; ++i) {
+    add_rate_gradient(weight_rate_steer_, control_index + 2, control_index, 0.0,
+                      time_index + 1);
+    add_rate_gradient(weight_rate_a_, control_index + 3, control_index + 1,
+                      0.0, time_index + 1);
+    control_index += 2;
+    time_index++;
+  }
+
+  // 5. objective to minimize total time [0, horizon_]
+  time_index = time_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    grad_f[time_index] += weight_first_order_time_ +
+                          2.0 * weight_second_order_time_ * x[time_index];
+    time_index++;
+  }
+}
+
+template <class Accumulator>
+void DistanceApproachIPOPTInterface::eval_h_hand(const double* x,
+                                                 double obj_factor,
+                                                 const double* lambda,
+                                                 Accumulator add) {
+  const double ts_sqr = ts_ * ts_;
+
+  // hessian of w * ((x[a] - x[b]) / x[t] / ts)^2, b < 0 stands for the
+  // constant b_value
+  auto add_rate_hessian = [&](double w, int a, int b, double b_value, int t) {
+    const double time = x[t];
+    const double diff = x[a] - (b < 0 ? b_value : x[b]);
+    const double d_uu = 2.0 * w / (time * time * ts_sqr);
+    const double d_ut = -4.0 * w * diff / (time * time * time * ts_sqr);
+    add(a, a, d_uu);
+    add(t, a, d_ut);
+    if (b >= 0) {
+      add(b, b, d_uu);
+      add(a, b, -d_uu);
+      add(t, b, -d_ut);
+    }
+    add(t, t, 6.0 * w * diff * diff / (time * time * time * time * ts_sqr));
+  };
+
+  // 1. objective, all of its terms are separable or rate penalties
+  int state_index = state_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    add(state_index, state_index, 2.0 * obj_factor * weight_state_x_);
+    add(state_index + 1, state_index + 1, 2.0 * obj_factor * weight_state_y_);
+    add(state_index + 2, state_index + 2,
+        2.0 * obj_factor * weight_state_phi_);
+    add(state_index + 3, state_index + 3, 2.0 * obj_factor * weight_state_v_);
+    state_index += 4;
+  }
+
+  int control_index = control_start_index_;
+  for (int i = 0; i < horizon_; ++i) {
+    add(control_index, control_index, 2.0 * obj_factor * weight_input_steer_);
+    add(control_index + 1, control_index + 1,
+        2.0 * obj_factor * weight_input_a_);
+    control_index += 2;
+  }
+
+  control_index = control_start_index_;
+  int time_index = time_start_index_;
+  add_rate_hessian(obj_factor * weight_stitching_steer_, control_index, -1,
+                   last_time_u_(0, 0), time_index);
+  add_rate_hessian(obj_factor * weight_stitching_a_, control_index + 1, -1,
+                   last_time_u_(1, 0), time_index);
+  for (int i = 0; i < horizon_ - 1; ++i) {
+    add_rate_hessian(obj_factor * weight_rate_steer_, control_index + 2,
+                     control_index, 0.0, time_index + 1);
+    add_rate_hessian(obj_factor * weight_rate_a_, control_index + 3,
+                     control_index + 1, 0.0, time_index + 1);
+    control_index += 2;
+    time_index++;
+  }
+
+  time_index = time_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    add(time_index, time_index, 2.0 * obj_factor * weight_second_order_time_);
+    time_index++;
+  }
+
+  // 2. dynamics constraints, nonlinear in (phi, v, steer, a, t) of each step.
+  // With h = ts * t, p = h * (v + 0.5 * h * a) is the travelled distance and
+  // theta = phi + 0.5 * h * v * tan(steer) / wheelbase the mid step heading,
+  // x and y advance by p * cos(theta) and p * sin(theta), phi by
+  // p * tan(steer) / wheelbase and v by h * a.
+  state_index = state_start_index_;
+  control_index = control_start_index_;
+  time_index = time_start_index_;
+  int constraint_index = 0;
+  for (int i = 0; i < horizon_; ++i) {
+    const int index[5] = {state_index + 2, state_index + 3, control_index,
+                          control_index + 1, time_index};
+    const double v = x[state_index + 3];
+    const double a = x[control_index + 1];
+    const double h = ts_ * x[time_index];
+    const double tan_steer = std::tan(x[control_index]);
+    const double sec_sqr = 1.0 + tan_steer * tan_steer;
+    const double p = h * (v + 0.5 * h * a);
+    const double theta = x[state_index + 2] + 0.5 * h * v * tan_steer /
+                                                  wheelbase_;
+    const double cos_theta = std::cos(theta);
+    const double sin_theta = std::sin(theta);
+    const double curvature = tan_steer / wheelbase_;
+
+    const double dp[5] = {0.0, h, 0.0, 0.5 * h * h, ts_ * (v + h * a)};
+    double ddp[5][5] = {};
+    ddp[4][1] = ddp[1][4] = ts_;
+    ddp[4][3] = ddp[3][4] = ts_ * h;
+    ddp[4][4] = ts_sqr * a;
+
+    const double dtheta[5] = {1.0, 0.5 * h * curvature,
+                              0.5 * h * v * sec_sqr / wheelbase_, 0.0,
+                              0.5 * ts_ * v * curvature};
+    double ddtheta[5][5] = {};
+    ddtheta[2][1] = ddtheta[1][2] = 0.5 * h * sec_sqr / wheelbase_;
+    ddtheta[4][1] = ddtheta[1][4] = 0.5 * ts_ * curvature;
+    ddtheta[2][2] = h * v * sec_sqr * curvature;
+    ddtheta[4][2] = ddtheta[2][4] = 0.5 * ts_ * v * sec_sqr / wheelbase_;
+
+    const double dcurvature[5] = {0.0, 0.0, sec_sqr / wheelbase_, 0.0, 0.0};
+    double ddcurvature[5][5] = {};
+    ddcurvature[2][2] = 2.0 * sec_sqr * curvature;
+
+    const double lambda_x = lambda[constraint_index];
+    const double lambda_y = lambda[constraint_index + 1];
+    const double lambda_phi = lambda[constraint_index + 2];
+    const double lambda_v = lambda[constraint_index + 3];
+    for (int r = 0; r < 5; ++r) {
+      for (int c = 0; c <= r; ++c) {
+        // the acceleration enters every update linearly
+        if (r == 3 && c == 3) {
+          continue;
+        }
+        const double cross = dp[r] * dtheta[c] + dp[c] * dtheta[r];
+        const double dd_x = ddp[r][c] * cos_theta - cross * sin_theta -
+                            p * (dtheta[r] * dtheta[c] * cos_theta +
+                                 ddtheta[r][c] * sin_theta);
+        const double dd_y = ddp[r][c] * sin_theta + cross * cos_theta -
+                            p * (dtheta[r] * dtheta[c] * sin_theta -
+                                 ddtheta[r][c] * cos_theta);
+        const double dd_phi = ddp[r][c] * curvature + dp[r] * dcurvature[c] +
+                              dp[c] * dcurvature[r] + p * ddcurvature[r][c];
+        double value =
+            -(lambda_x * dd_x + lambda_y * dd_y + lambda_phi * dd_phi);
+        if (r == 4 && c == 3) {
+          value -= lambda_v * ts_;
+        }
+        add(index[r], index[c], value);
+      }
+    }
+
+    control_index += 2;
+    constraint_index += 4;
+    time_index++;
+    state_index += 4;
+  }
+
+  // 3. steering rate constraints (x[u_i] - x[u_i-1]) / x[t_i] / ts
+  control_index = control_start_index_;
+  time_index = time_start_index_;
+  for (int i = 0; i < horizon_; ++i) {
+    const double time = x[time_index];
+    const double last_steer =
+        i == 0 ? last_time_u_(0, 0) : x[control_index - 2];
+    const double mu = lambda[constraint_index];
+    const double d_ut = -mu / (time * time * ts_);
+    add(time_index, control_index, d_ut);
+    if (i > 0) {
+      add(time_index, control_index - 2, -d_ut);
+    }
+    add(time_index, time_index,
+        2.0 * mu * (x[control_index] - last_steer) /
+            (time * time * time * ts_));
+    constraint_index++;
+    control_index += 2;
+    time_index++;
+  }
+
+  // time equality constraints are linear
+  constraint_index += horizon_;
+
+  // 4. obstacle constraints, bilinear in the duals and the pose
+  state_index = state_start_index_;
+  int l_index = l_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    const double cos_phi = std::cos(x[state_index + 2]);
+    const double sin_phi = std::sin(x[state_index + 2]);
+    int edges_counter = 0;
+    for (int j = 0; j < obstacles_num_; ++j) {
+      const int current_edges_num = obstacles_edges_num_(j, 0);
+      double tmp1 = 0.0;
+      double tmp2 = 0.0;
+      for (int k = 0; k < current_edges_num; ++k) {
+        tmp1 += obstacles_A_(edges_counter + k, 0) * x[l_index + k];
+        tmp2 += obstacles_A_(edges_counter + k, 1) * x[l_index + k];
+      }
+
+      const double mu_norm = lambda[constraint_index];
+      // the rotation constraint along x and the distance constraint share
+      // the same phi dependency, the latter scaled by offset_
+      const double mu_cos = lambda[constraint_index + 1] +
+                            offset_ * lambda[constraint_index + 3];
+      const double mu_sin = lambda[constraint_index + 2];
+      const double mu_dist = lambda[constraint_index + 3];
+
+      for (int k = 0; k < current_edges_num; ++k) {
+        const double a_k0 = obstacles_A_(edges_counter + k, 0);
+        const double a_k1 = obstacles_A_(edges_counter + k, 1);
+        for (int kk = 0; kk <= k; ++kk) {
+          add(l_index + k, l_index + kk,
+              2.0 * mu_norm *
+                  (a_k0 * obstacles_A_(edges_counter + kk, 0) +
+                   a_k1 * obstacles_A_(edges_counter + kk, 1)));
+        }
+        add(l_index + k, state_index, mu_dist * a_k0);
+        add(l_index + k, state_index + 1, mu_dist * a_k1);
+        add(l_index + k, state_index + 2,
+            mu_cos * (-sin_phi * a_k0 + cos_phi * a_k1) -
+                mu_sin * (cos_phi * a_k0 + sin_phi * a_k1));
+      }
+      add(state_index + 2, state_index + 2,
+          -mu_cos * (cos_phi * tmp1 + sin_phi * tmp2) +
+              mu_sin * (sin_phi * tmp1 - cos_phi * tmp2));
+
+      edges_counter += current_edges_num;
+      l_index += current_edges_num;
+      constraint_index += 4;
+    }
+    state_index += 4;
+  }
+
+  // 5. variable bounds constraints are linear
+}
+
+void DistanceApproachIPOPTInterface::generate_hessian_structure(
+    int n, int m, int* nnz_h_lag) {
+  std::vector<double> xp(n);
+  std::vector<double> zl(m);
+  std::vector<double> zu(m);
+  std::vector<double> lam(m, 1.0);
+  get_starting_point(n, 1, &xp[0], 0, &zl[0], &zu[0], m, 0, &lam[0]);
+
+  hessian_rows_.clear();
+  hessian_cols_.clear();
+  hessian_slots_.clear();
+  std::unordered_map<int64_t, int> entries;
+  eval_h_hand(&xp[0], 1.0, &lam[0], [&](int row, int col, double value) {
+    if (row < col) {
+      std::swap(row, col);
+    }
+    const int64_t key = static_cast<int64_t>(row) * n + col;
+    auto entry = entries.find(key);
+    if (entry == entries.end()) {
+      entry =
+          entries.emplace(key, static_cast<int>(hessian_rows_.size())).first;
+      hessian_rows_.push_back(row);
+      hessian_cols_.push_back(col);
+    }
+    hessian_slots_.push_back(entry->second);
+  });
+  *nnz_h_lag = static_cast<int>(hessian_rows_.size());
+}
+//***************    end   hand derivative part **************************
+
 }  // namespace planning
 }  // namespace apollo
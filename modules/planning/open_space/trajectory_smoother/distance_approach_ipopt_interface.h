@@ -141,6 +141,21 @@ class DistanceApproachIPOPTInterface : public DistanceApproachInterface {
   void generate_tapes(int n, int m, int* nnz_jac_g, int* nnz_h_lag);
   //***************    end   ADOL-C part ***********************************
 
+  //***************    start hand derivative part **************************
+  /** Method to return the hand derived gradient of the objective */
+  void eval_grad_f_hand(int n, const double* x, double* grad_f);
+
+  /** Template to walk the hand derived hessian of the lagrangian, every term
+   * is passed to add(row, col, value) in the same order on every call */
+  template <class Accumulator>
+  void eval_h_hand(const double* x, double obj_factor, const double* lambda,
+                   Accumulator add);
+
+  /** Method to generate the lower triangle structure of the hand derived
+   * hessian of the lagrangian */
+  void generate_hessian_structure(int n, int m, int* nnz_h_lag);
+  //***************    end   hand derivative part **************************
+
  private:
   int num_of_variables_ = 0;
   int num_of_constraints_ = 0;
@@ -240,6 +255,8 @@ class DistanceApproachIPOPTInterface : public DistanceApproachInterface {
 
   bool enable_jacobian_ad_ = false;
 
+  bool enable_hand_derivative_ = false;
+
  private:
   DistanceApproachConfig distance_approach_config_;
   const common::VehicleParam vehicle_param_ =
@@ -260,6 +277,14 @@ class DistanceApproachIPOPTInterface : public DistanceApproachInterface {
   int options_g[4];
   int options_L[4];
   //***************    end   ADOL-C part ***********************************
+
+  //***************    start hand derivative part **************************
+  // lower triangle entries of the hessian of the lagrangian
+  std::vector<int> hessian_rows_;
+  std::vector<int> hessian_cols_;
+  // entry each term of eval_h_hand accumulates into
+  std::vector<int> hessian_slots_;
+  //***************    end   hand derivative part **************************
 };
 
 }  // namespace planning
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Solves a parallel parking manoeuvre with the distance approach smoother,
+// once with the ADOL-C derivatives and once with the hand derived ones: the
+// ego car moves 12m forward and 2.5m sideways into the gap between two parked
+// boxes, warm started from a straight line interpolation. Reports the solve
+// time per manoeuvre together with the ipopt iteration count.
+
+#include <vector>
+
+#include <coin/IpIpoptApplication.hpp>
+#include <coin/IpSolveStatistics.hpp>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_interface.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr double kTs = 0.25;
+constexpr int kObstaclesNum = 2;
+constexpr int kEdgesNum = 4;
+
+// half plane representation A * p <= b of an axis aligned box
+void AddBox(int index, double center_x, double center_y, double half_length,
+            double half_width, Eigen::MatrixXd* A, Eigen::MatrixXd* b) {
+  const int row = index * kEdgesNum;
+  A->block(row, 0, kEdgesNum, 2) << 1.0, 0.0, 0.0, 1.0, -1.0, 0.0, 0.0, -1.0;
+  b->block(row, 0, kEdgesNum, 1) << center_x + half_length,
+      center_y + half_width, half_length - center_x, half_width - center_y;
+}
+
+void BM_DistanceApproach(benchmark::State& state, bool hand_derivative) {
+  common::VehicleConfig vehicle_config;
+  auto* vehicle_param = vehicle_config.mutable_vehicle_param();
+  vehicle_param->set_front_edge_to_center(3.89);
+  vehicle_param->set_back_edge_to_center(1.043);
+  vehicle_param->set_left_edge_to_center(1.055);
+  vehicle_param->set_right_edge_to_center(1.055);
+  vehicle_param->set_wheel_base(2.8448);
+  vehicle_param->set_max_steer_angle(8.20304748437);
+  vehicle_param->set_max_steer_angle_rate(6.98131700798);
+  vehicle_param->set_steer_ratio(16.0);
+  common::VehicleConfigHelper::Init(vehicle_config);
+
+  PlannerOpenSpaceConfig config;
+  auto* distance_approach_config = config.mutable_distance_approach_config();
+  distance_approach_config->set_weight_steer(0.3);
+  distance_approach_config->set_weight_a(1.1);
+  distance_approach_config->set_weight_steer_rate(3.0);
+  distance_approach_config->set_weight_a_rate(2.5);
+  distance_approach_config->set_weight_x(18.0);
+  distance_approach_config->set_weight_y(14.0);
+  distance_approach_config->set_weight_phi(10.0);
+  distance_approach_config->set_weight_v(0.0);
+  distance_approach_config->set_weight_steer_stitching(1.75);
+  distance_approach_config->set_weight_a_stitching(3.25);
+  distance_approach_config->set_weight_first_order_time(1.0);
+  distance_approach_config->set_weight_second_order_time(2.0);
+  distance_approach_config->set_min_safety_distance(0.01);
+  distance_approach_config->set_max_speed_forward(2.0);
+  distance_approach_config->set_max_speed_reverse(1.0);
+  distance_approach_config->set_max_acceleration_forward(2.0);
+  distance_approach_config->set_max_acceleration_reverse(1.0);
+  distance_approach_config->set_min_time_sample_scaling(0.5);
+  distance_approach_config->set_max_time_sample_scaling(1.5);
+  distance_approach_config->set_enable_hand_derivative(hand_derivative);
+
+  const int horizon = static_cast<int>(state.range(0));
+  Eigen::MatrixXd ego(4, 1);
+  ego << vehicle_param->front_edge_to_center(),
+      vehicle_param->right_edge_to_center(),
+      vehicle_param->back_edge_to_center(),
+      vehicle_param->left_edge_to_center();
+  Eigen::MatrixXd x0(4, 1);
+  x0 << 0.0, 0.0, 0.0, 0.0;
+  Eigen::MatrixXd xf(4, 1);
+  xf << 12.0, 2.5, 0.0, 0.0;
+  Eigen::MatrixXd last_time_u = Eigen::MatrixXd::Zero(2, 1);
+  const std::vector<double> XYbounds = {-5.0, 25.0, -5.0, 8.0};
+
+  Eigen::MatrixXd xWS(4, horizon + 1);
+  for (int i = 0; i < horizon + 1; ++i) {
+    xWS.col(i) = x0 + (xf - x0) * static_cast<double>(i) / horizon;
+  }
+  Eigen::MatrixXd uWS = Eigen::MatrixXd::Zero(2, horizon);
+
+  Eigen::MatrixXi obstacles_edges_num =
+      Eigen::MatrixXi::Constant(kObstaclesNum, 1, kEdgesNum);
+  Eigen::MatrixXd obstacles_A(kObstaclesNum * kEdgesNum, 2);
+  Eigen::MatrixXd obstacles_b(kObstaclesNum * kEdgesNum, 1);
+  AddBox(0, -3.0, 3.0, 2.2, 0.95, &obstacles_A, &obstacles_b);
+  AddBox(1, 20.0, 3.0, 2.2, 0.95, &obstacles_A, &obstacles_b);
+  Eigen::MatrixXd l_warm_up =
+      0.1 * Eigen::MatrixXd::Ones(kObstaclesNum * kEdgesNum, horizon + 1);
+  Eigen::MatrixXd n_warm_up =
+      0.1 * Eigen::MatrixXd::Ones(4 * kObstaclesNum, horizon + 1);
+
+  Ipopt::SmartPtr<Ipopt::IpoptApplication> app = IpoptApplicationFactory();
+  app->Options()->SetIntegerValue("print_level", 0);
+  app->Options()->SetIntegerValue("max_iter", 1000);
+  app->Options()->SetNumericValue("tol", 1e-4);
+  app->Options()->SetNumericValue("acceptable_constr_viol_tol", 0.1);
+  app->Options()->SetNumericValue("mu_init", 0.1);
+  app->Initialize();
+
+  int solved = 0;
+  int iterations = 0;
+  for (auto _ : state) {
+    Ipopt::SmartPtr<Ipopt::TNLP> problem = new DistanceApproachIPOPTInterface(
+        horizon, kTs, ego, xWS, uWS, l_warm_up, n_warm_up, x0, xf, last_time_u,
+        XYbounds, obstacles_edges_num, kObstaclesNum, obstacles_A, obstacles_b,
+        config);
+    const Ipopt::ApplicationReturnStatus status = app->OptimizeTNLP(problem);
+    solved += status == Ipopt::Solve_Succeeded ||
+              status == Ipopt::Solved_To_Acceptable_Level;
+    iterations += app->Statistics()->IterationCount();
+  }
+  state.counters["iterations"] = benchmark::Counter(
+      iterations, benchmark::Counter::kAvgIterations);
+  state.counters["solved"] =
+      benchmark::Counter(solved, benchmark::Counter::kAvgIterations);
+}
+
+void BM_AdolcDerivative(benchmark::State& state) {
+  BM_DistanceApproach(state, false);
+}
+
+void BM_HandDerivative(benchmark::State& state) {
+  BM_DistanceApproach(state, true);
+}
+
+}  // namespace
+
+BENCHMARK(BM_AdolcDerivative)->Arg(30)->Arg(60)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HandDerivative)->Arg(30)->Arg(60)->Unit(benchmark::kMillisecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
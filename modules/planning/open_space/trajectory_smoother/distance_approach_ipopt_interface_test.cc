@@ -19,6 +19,9 @@
  **/
 #include "modules/planning/open_space/trajectory_smoother/distance_approach_ipopt_interface.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "cyber/common/file.h"
@@ -122,5 +125,69 @@ TEST_F(DistanceApproachIPOPTInterfaceTest, eval_f) {
   EXPECT_TRUE(res);
 }
 
+TEST_F(DistanceApproachIPOPTInterfaceTest, hand_derivative) {
+  planner_open_space_config_.mutable_distance_approach_config()
+      ->set_enable_hand_derivative(true);
+  Eigen::MatrixXd l_warm_up =
+      Eigen::MatrixXd::Ones(obstacles_edges_sum_, horizon_ + 1);
+  Eigen::MatrixXd n_warm_up =
+      Eigen::MatrixXd::Ones(4 * obstacles_num_, horizon_ + 1);
+  DistanceApproachIPOPTInterface hand_ptop(
+      horizon_, ts_, ego_, xWS_, uWS_, l_warm_up, n_warm_up, x0_, xf_,
+      last_time_u_, XYbounds_, obstacles_edges_num_, obstacles_num_,
+      obstacles_A_, obstacles_b_, planner_open_space_config_);
+
+  int n = 0;
+  int m = 0;
+  int nnz_jac_g = 0;
+  int nnz_h_lag = 0;
+  int hand_nnz_h_lag = 0;
+  Ipopt::TNLP::IndexStyleEnum index_style;
+  ASSERT_TRUE(
+      hand_ptop.get_nlp_info(n, m, nnz_jac_g, hand_nnz_h_lag, index_style));
+  ASSERT_TRUE(ptop_->get_nlp_info(n, m, nnz_jac_g, nnz_h_lag, index_style));
+
+  std::vector<double> x(n);
+  for (int i = 0; i < n; ++i) {
+    x[i] = 1.0 + 0.05 * (i % 7);
+  }
+  std::vector<double> lambda(m);
+  for (int i = 0; i < m; ++i) {
+    lambda[i] = 0.5 - 0.1 * (i % 11);
+  }
+  const double obj_factor = 0.8;
+
+  std::vector<double> grad_f(n);
+  std::vector<double> hand_grad_f(n);
+  EXPECT_TRUE(ptop_->eval_grad_f(n, x.data(), true, grad_f.data()));
+  EXPECT_TRUE(hand_ptop.eval_grad_f(n, x.data(), true, hand_grad_f.data()));
+  for (int i = 0; i < n; ++i) {
+    EXPECT_NEAR(grad_f[i], hand_grad_f[i], 1e-8) << "grad_f index: " << i;
+  }
+
+  // both triangles are folded into the lower one before comparing
+  auto dense_hessian = [&](DistanceApproachIPOPTInterface* ptop, int nnz) {
+    std::vector<int> rows(nnz);
+    std::vector<int> cols(nnz);
+    std::vector<double> values(nnz);
+    EXPECT_TRUE(ptop->eval_h(n, x.data(), true, obj_factor, m, lambda.data(),
+                             true, nnz, rows.data(), cols.data(), nullptr));
+    EXPECT_TRUE(ptop->eval_h(n, x.data(), true, obj_factor, m, lambda.data(),
+                             true, nnz, rows.data(), cols.data(),
+                             values.data()));
+    Eigen::MatrixXd hessian = Eigen::MatrixXd::Zero(n, n);
+    for (int idx = 0; idx < nnz; ++idx) {
+      const int row = std::max(rows[idx], cols[idx]);
+      const int col = std::min(rows[idx], cols[idx]);
+      hessian(row, col) += values[idx];
+    }
+    return hessian;
+  };
+  const Eigen::MatrixXd hessian = dense_hessian(ptop_.get(), nnz_h_lag);
+  const Eigen::MatrixXd hand_hessian =
+      dense_hessian(&hand_ptop, hand_nnz_h_lag);
+  EXPECT_LT((hessian - hand_hessian).cwiseAbs().maxCoeff(), 1e-8);
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -20,6 +20,7 @@
 
 #include "modules/planning/open_space/trajectory_smoother/dual_variable_warm_start_ipopt_interface.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "cyber/common/log.h"
@@ -61,6 +62,9 @@ DualVariableWarmStartIPOPTInterface::DualVariableWarmStartIPOPTInterface(
   n_warm_up_ = Eigen::MatrixXd::Zero(4 * obstacles_num_, horizon_ + 1);
   weight_d_ =
       planner_open_space_config.dual_variable_warm_start_config().weight_d();
+  enable_hand_derivative_ = planner_open_space_config
+                                .dual_variable_warm_start_config()
+                                .enable_hand_derivative();
 }
 
 bool DualVariableWarmStartIPOPTInterface::get_nlp_info(
@@ -84,7 +88,11 @@ bool DualVariableWarmStartIPOPTInterface::get_nlp_info(
   m = num_of_constraints_;
 
   // number of nonzero Jacobian and Lagrangian.
-  generate_tapes(n, m, &nnz_h_lag);
+  if (enable_hand_derivative_) {
+    generate_hessian_structure(&nnz_h_lag);
+  } else {
+    generate_tapes(n, m, &nnz_h_lag);
+  }
 
   int tmp = 0;
   for (int i = 0; i < horizon_ + 1; ++i) {
@@ -526,6 +534,18 @@ bool DualVariableWarmStartIPOPTInterface::eval_h(int n, const double* x,
                                                  bool new_lambda, int nele_hess,
                                                  int* iRow, int* jCol,
                                                  double* values) {
+  if (enable_hand_derivative_) {
+    if (values == nullptr) {
+      // return the structure. This is a symmetric matrix, fill the lower left
+      // triangle only.
+      std::copy(hessian_rows_.begin(), hessian_rows_.end(), iRow);
+      std::copy(hessian_cols_.begin(), hessian_cols_.end(), jCol);
+    } else {
+      eval_h_hand(lambda, values);
+    }
+    return true;
+  }
+
   if (values == nullptr) {
     // return the structure. This is a symmetric matrix, fill the lower left
     // triangle only.
@@ -773,5 +793,56 @@ void DualVariableWarmStartIPOPTInterface::generate_tapes(int n, int m,
 }
 //***************    end   ADOL-C part ***********************************
 
+//***************    start hand derivative part **************************
+// The objective and all constraints but norm(A' * lambda) <= 1 are linear in
+// the variables. The hessian of the lagrangian is the one of the norm
+// constraints, 2 * lambda_c * (A_k0 * A_p0 + A_k1 * A_p1) for the lambdas
+// k, p of an obstacle at a time step.
+void DualVariableWarmStartIPOPTInterface::generate_hessian_structure(
+    int* nnz_h_lag) {
+  hessian_rows_.clear();
+  hessian_cols_.clear();
+  int l_index = l_start_index_;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    for (int j = 0; j < obstacles_num_; ++j) {
+      int current_edges_num = obstacles_edges_num_(j, 0);
+      for (int k = 0; k < current_edges_num; ++k) {
+        for (int p = 0; p <= k; ++p) {
+          hessian_rows_.push_back(l_index + k);
+          hessian_cols_.push_back(l_index + p);
+        }
+      }
+      l_index += current_edges_num;
+    }
+  }
+  *nnz_h_lag = static_cast<int>(hessian_rows_.size());
+}
+
+void DualVariableWarmStartIPOPTInterface::eval_h_hand(const double* lambda,
+                                                      double* values) const {
+  int nz_index = 0;
+  int constraint_index = 0;
+  for (int i = 0; i < horizon_ + 1; ++i) {
+    int edges_counter = 0;
+    for (int j = 0; j < obstacles_num_; ++j) {
+      int current_edges_num = obstacles_edges_num_(j, 0);
+      const double factor = 2.0 * lambda[constraint_index];
+      for (int k = 0; k < current_edges_num; ++k) {
+        for (int p = 0; p <= k; ++p) {
+          values[nz_index] =
+              factor * (obstacles_A_(edges_counter + k, 0) *
+                            obstacles_A_(edges_counter + p, 0) +
+                        obstacles_A_(edges_counter + k, 1) *
+                            obstacles_A_(edges_counter + p, 1));
+          ++nz_index;
+        }
+      }
+      edges_counter += current_edges_num;
+      constraint_index += 4;
+    }
+  }
+}
+//***************    end   hand derivative part **************************
+
 }  // namespace planning
 }  // namespace apollo
@@ -117,6 +117,16 @@ class DualVariableWarmStartIPOPTInterface : public Ipopt::TNLP {
   void generate_tapes(int n, int m, int* nnz_h_lag);
   //***************    end   ADOL-C part ***********************************
 
+  //***************    start hand derivative part **************************
+  /** Method to generate the lower triangle structure of the hand derived
+   * hessian of the lagrangian */
+  void generate_hessian_structure(int* nnz_h_lag);
+
+  /** Method to return the values of the hand derived hessian of the
+   * lagrangian, in the order of generate_hessian_structure */
+  void eval_h_hand(const double* lambda, double* values) const;
+  //***************    end   hand derivative part **************************
+
  private:
   int num_of_variables_;
   int num_of_constraints_;
@@ -159,14 +169,22 @@ class DualVariableWarmStartIPOPTInterface : public Ipopt::TNLP {
 
   double weight_d_;
 
+  bool enable_hand_derivative_ = false;
+
   //***************    start ADOL-C part ***********************************
-  double* obj_lam;
-  unsigned int* rind_L; /* row indices    */
-  unsigned int* cind_L; /* column indices */
-  double* hessval;      /* values */
-  int nnz_L;
+  double* obj_lam = nullptr;
+  unsigned int* rind_L = nullptr; /* row indices    */
+  unsigned int* cind_L = nullptr; /* column indices */
+  double* hessval = nullptr;      /* values */
+  int nnz_L = 0;
   int options_L[4];
   //***************    end   ADOL-C part ***********************************
+
+  //***************    start hand derivative part **************************
+  // lower triangle entries of the hessian of the lagrangian
+  std::vector<int> hessian_rows_;
+  std::vector<int> hessian_cols_;
+  //***************    end   hand derivative part **************************
 };
 
 }  // namespace planning
@@ -19,6 +19,10 @@
  **/
 #include "modules/planning/open_space/trajectory_smoother/dual_variable_warm_start_ipopt_interface.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "cyber/common/file.h"
@@ -115,5 +119,69 @@ TEST_F(DualVariableWarmStartIPOPTInterfaceTest, eval_f) {
   EXPECT_TRUE(res);
 }
 
+TEST_F(DualVariableWarmStartIPOPTInterfaceTest, hand_derivative) {
+  Eigen::MatrixXd obstacles_A(10 * 4, 2);
+  Eigen::MatrixXd obstacles_b(10 * 4, 1);
+  for (int i = 0; i < obstacles_A.rows(); ++i) {
+    obstacles_A(i, 0) = std::cos(0.7 * i);
+    obstacles_A(i, 1) = std::sin(0.7 * i);
+    obstacles_b(i, 0) = 0.1 * i;
+  }
+  Eigen::MatrixXd xWS = Eigen::MatrixXd::Ones(4, horizon_ + 1);
+  DualVariableWarmStartIPOPTInterface ad_ptop(
+      horizon_, ts_, ego_, obstacles_edges_num_, obstacles_num_, obstacles_A,
+      obstacles_b, xWS, planner_open_space_config_);
+  planner_open_space_config_.mutable_dual_variable_warm_start_config()
+      ->set_enable_hand_derivative(true);
+  DualVariableWarmStartIPOPTInterface hand_ptop(
+      horizon_, ts_, ego_, obstacles_edges_num_, obstacles_num_, obstacles_A,
+      obstacles_b, xWS, planner_open_space_config_);
+
+  int n = 0;
+  int m = 0;
+  int nnz_jac_g = 0;
+  int nnz_h_lag = 0;
+  int hand_nnz_h_lag = 0;
+  Ipopt::TNLP::IndexStyleEnum index_style;
+  ASSERT_TRUE(
+      hand_ptop.get_nlp_info(n, m, nnz_jac_g, hand_nnz_h_lag, index_style));
+  ASSERT_TRUE(ad_ptop.get_nlp_info(n, m, nnz_jac_g, nnz_h_lag, index_style));
+
+  std::vector<double> x(n);
+  for (int i = 0; i < n; ++i) {
+    x[i] = 1.0 + 0.05 * (i % 7);
+  }
+  std::vector<double> lambda(m);
+  for (int i = 0; i < m; ++i) {
+    lambda[i] = 0.5 - 0.1 * (i % 11);
+  }
+  const double obj_factor = 0.8;
+
+  // both triangles are folded into the lower one before comparing
+  auto dense_hessian = [&](DualVariableWarmStartIPOPTInterface* ptop,
+                           int nnz) {
+    std::vector<int> rows(nnz);
+    std::vector<int> cols(nnz);
+    std::vector<double> values(nnz);
+    EXPECT_TRUE(ptop->eval_h(n, x.data(), true, obj_factor, m, lambda.data(),
+                             true, nnz, rows.data(), cols.data(), nullptr));
+    EXPECT_TRUE(ptop->eval_h(n, x.data(), true, obj_factor, m, lambda.data(),
+                             true, nnz, rows.data(), cols.data(),
+                             values.data()));
+    Eigen::MatrixXd hessian = Eigen::MatrixXd::Zero(n, n);
+    for (int idx = 0; idx < nnz; ++idx) {
+      const int row = std::max(rows[idx], cols[idx]);
+      const int col = std::min(rows[idx], cols[idx]);
+      hessian(row, col) += values[idx];
+    }
+    return hessian;
+  };
+  const Eigen::MatrixXd hessian = dense_hessian(&ad_ptop, nnz_h_lag);
+  const Eigen::MatrixXd hand_hessian =
+      dense_hessian(&hand_ptop, hand_nnz_h_lag);
+  EXPECT_GT(hessian.cwiseAbs().maxCoeff(), 0.1);
+  EXPECT_LT((hessian - hand_hessian).cwiseAbs().maxCoeff(), 1e-10);
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -21,6 +21,7 @@
 #include "modules/planning/open_space/trajectory_smoother/iterative_anchoring_smoother.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <random>
 
@@ -52,6 +53,7 @@ IterativeAnchoringSmoother::IterativeAnchoringSmoother(
   ego_width_ = vehicle_param.width();
   center_shift_distance_ =
       ego_length_ / 2.0 - vehicle_param.back_edge_to_center();
+  ego_radius_ = std::hypot(ego_length_ / 2.0, ego_width_ / 2.0);
   planner_open_space_config_ = planner_open_space_config;
   AINFO << "config:" << planner_open_space_config_.DebugString();
 }
@@ -144,6 +146,12 @@ bool IterativeAnchoringSmoother::Smooth(
     return false;
   }
 
+  obstacle_distance_field_.reset();
+  if (planner_open_space_config_.iterative_anchoring_smoother_config()
+          .enable_incremental_anchoring()) {
+    BuildObstacleDistanceField(interpolated_warm_start_path, bounds);
+  }
+
   // Check initial path collision avoidance, if it fails, smoother assumption
   // fails. Try reanchoring
   input_colliding_point_index_.clear();
@@ -436,6 +444,14 @@ bool IterativeAnchoringSmoother::SmoothPath(
       planner_open_space_config_.iterative_anchoring_smoother_config()
           .fem_pos_deviation_smoother_config());
 
+  // Only the bounds shrink between anchoring iterations, so the workspace
+  // set up by the first one is updated in place by the others
+  PiecewiseJerkSolver path_solver;
+  if (planner_open_space_config_.iterative_anchoring_smoother_config()
+          .enable_incremental_anchoring()) {
+    fem_pos_smoother.set_solver(&path_solver);
+  }
+
   // TODO(Jinyun): move to confs
   const size_t max_iteration_num = 50;
 
@@ -514,6 +530,12 @@ bool IterativeAnchoringSmoother::CheckCollisionAvoidance(
          path_points[i].y() + center_shift_distance_ * std::sin(heading)},
         heading, ego_length_, ego_width_);
 
+    if (obstacle_distance_field_ != nullptr &&
+        obstacle_distance_field_->DistanceLowerBound(ego_box.center()) >
+            ego_radius_) {
+      continue;
+    }
+
     bool is_colliding = false;
     for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
       for (const LineSegment2d& linesegment : obstacle_linesegments) {
@@ -537,6 +559,33 @@ bool IterativeAnchoringSmoother::CheckCollisionAvoidance(
   return true;
 }
 
+void IterativeAnchoringSmoother::BuildObstacleDistanceField(
+    const DiscretizedPath& path_points, const std::vector<double>& bounds) {
+  // Smoothed points stay within their bound of the raw points along x and y,
+  // and the ego box center is center_shift_distance_ ahead of them. Box
+  // centers outside the field get no lower bound and are checked exactly.
+  const double resolution =
+      planner_open_space_config_.iterative_anchoring_smoother_config()
+          .distance_field_resolution();
+  const double max_bound =
+      bounds.empty() ? 0.0 : *std::max_element(bounds.begin(), bounds.end());
+  const double margin =
+      max_bound * M_SQRT2 + std::abs(center_shift_distance_) + resolution;
+  double min_x = std::numeric_limits<double>::infinity();
+  double min_y = std::numeric_limits<double>::infinity();
+  double max_x = -std::numeric_limits<double>::infinity();
+  double max_y = -std::numeric_limits<double>::infinity();
+  for (const auto& path_point : path_points) {
+    min_x = std::min(min_x, path_point.x());
+    min_y = std::min(min_y, path_point.y());
+    max_x = std::max(max_x, path_point.x());
+    max_y = std::max(max_y, path_point.y());
+  }
+  obstacle_distance_field_ = std::make_unique<ObstacleDistanceField>(
+      &obstacles_linesegments_vec_, min_x - margin, min_y - margin,
+      max_x + margin, max_y + margin, resolution);
+}
+
 void IterativeAnchoringSmoother::AdjustPathBounds(
     const std::vector<size_t>& colliding_point_index,
     std::vector<double>* bounds) {
@@ -634,6 +683,10 @@ bool IterativeAnchoringSmoother::SmoothSpeed(const double init_a,
 
   PiecewiseJerkSpeedProblem piecewise_jerk_problem(
       num_of_knots, delta_t, {0.0, std::abs(init_v), std::abs(init_a)});
+  if (planner_open_space_config_.iterative_anchoring_smoother_config()
+          .enable_incremental_anchoring()) {
+    piecewise_jerk_problem.set_solver(&speed_solver_);
+  }
 
   auto s_curve_config =
       planner_open_space_config_.iterative_anchoring_smoother_config()
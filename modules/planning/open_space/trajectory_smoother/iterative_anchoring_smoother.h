@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -35,6 +36,8 @@
 #include "modules/planning/common/speed/speed_data.h"
 #include "modules/planning/common/trajectory/discretized_trajectory.h"
 #include "modules/planning/math/curve1d/quintic_polynomial_curve1d.h"
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
+#include "modules/planning/open_space/trajectory_smoother/obstacle_distance_field.h"
 
 namespace apollo {
 namespace planning {
@@ -69,6 +72,9 @@ class IterativeAnchoringSmoother {
   bool CheckCollisionAvoidance(const DiscretizedPath& path_points,
                                std::vector<size_t>* colliding_point_index);
 
+  void BuildObstacleDistanceField(const DiscretizedPath& path_points,
+                                  const std::vector<double>& bounds);
+
   void AdjustPathBounds(const std::vector<size_t>& colliding_point_index,
                         std::vector<double>* bounds);
 
@@ -101,10 +107,19 @@ class IterativeAnchoringSmoother {
   double ego_length_ = 0.0;
   double ego_width_ = 0.0;
   double center_shift_distance_ = 0.0;
+  // radius of the circle around the ego box center enclosing the box
+  double ego_radius_ = 0.0;
 
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
 
+  // collision check prefilter, only built in incremental anchoring
+  std::unique_ptr<ObstacleDistanceField> obstacle_distance_field_;
+
+  // speed problem workspace kept across smoothing calls in incremental
+  // anchoring
+  PiecewiseJerkSolver speed_solver_;
+
   std::vector<size_t> input_colliding_point_index_;
 
   bool enforce_initial_kappa_ = true;
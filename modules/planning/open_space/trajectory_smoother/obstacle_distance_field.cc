@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/trajectory_smoother/obstacle_distance_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+ObstacleDistanceField::ObstacleDistanceField(
+    const std::vector<std::vector<LineSegment2d>>* obstacles_linesegments_vec,
+    const double min_x, const double min_y, const double max_x,
+    const double max_y, const double resolution)
+    : obstacles_linesegments_vec_(obstacles_linesegments_vec),
+      min_x_(min_x),
+      min_y_(min_y),
+      resolution_(resolution),
+      cell_radius_(resolution * M_SQRT1_2) {
+  CHECK_NOTNULL(obstacles_linesegments_vec_);
+  CHECK_GT(resolution_, 0.0);
+  x_cells_num_ =
+      std::max(static_cast<int>(std::ceil((max_x - min_x) / resolution_)), 1);
+  y_cells_num_ =
+      std::max(static_cast<int>(std::ceil((max_y - min_y) / resolution_)), 1);
+  distances_.assign(static_cast<size_t>(x_cells_num_) * y_cells_num_, -1.0);
+}
+
+double ObstacleDistanceField::DistanceLowerBound(const Vec2d& point) {
+  const double x_index = std::floor((point.x() - min_x_) / resolution_);
+  const double y_index = std::floor((point.y() - min_y_) / resolution_);
+  if (!(x_index >= 0.0 && x_index < x_cells_num_ && y_index >= 0.0 &&
+        y_index < y_cells_num_)) {
+    return 0.0;
+  }
+  const int x_cell = static_cast<int>(x_index);
+  const int y_cell = static_cast<int>(y_index);
+  double& distance =
+      distances_[static_cast<size_t>(y_cell) * x_cells_num_ + x_cell];
+  if (distance < 0.0) {
+    const Vec2d cell_center(min_x_ + (x_cell + 0.5) * resolution_,
+                            min_y_ + (y_cell + 0.5) * resolution_);
+    distance = std::numeric_limits<double>::infinity();
+    for (const auto& obstacle_linesegments : *obstacles_linesegments_vec_) {
+      for (const LineSegment2d& linesegment : obstacle_linesegments) {
+        distance = std::min(distance, linesegment.DistanceTo(cell_center));
+      }
+    }
+  }
+  return std::max(distance - cell_radius_, 0.0);
+}
+
+}  // namespace planning
+}  // namespace apollo
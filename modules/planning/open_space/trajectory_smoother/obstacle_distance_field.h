@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "modules/common/math/line_segment2d.h"
+#include "modules/common/math/vec2d.h"
+
+namespace apollo {
+namespace planning {
+
+/*
+ * @brief:
+ * Grid over an axis aligned region storing the distance from every cell
+ * center to the nearest obstacle line segment. Cells are filled on first
+ * query, so repeated queries along a path that moves little between
+ * smoothing iterations only pay for the cells it visits.
+ */
+class ObstacleDistanceField {
+ public:
+  ObstacleDistanceField(
+      const std::vector<std::vector<common::math::LineSegment2d>>*
+          obstacles_linesegments_vec,
+      const double min_x, const double min_y, const double max_x,
+      const double max_y, const double resolution);
+
+  /**
+   * @brief Lower bound of the distance from point to the nearest obstacle
+   * line segment, 0.0 outside the field.
+   */
+  double DistanceLowerBound(const common::math::Vec2d& point);
+
+ private:
+  const std::vector<std::vector<common::math::LineSegment2d>>*
+      obstacles_linesegments_vec_;
+  double min_x_ = 0.0;
+  double min_y_ = 0.0;
+  double resolution_ = 0.0;
+  // distance of a cell center to any point of the cell
+  double cell_radius_ = 0.0;
+  int x_cells_num_ = 0;
+  int y_cells_num_ = 0;
+  // negative for cells not computed yet
+  std::vector<double> distances_;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/trajectory_smoother/obstacle_distance_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+TEST(ObstacleDistanceFieldTest, lower_bound) {
+  const std::vector<std::vector<LineSegment2d>> obstacles_linesegments_vec = {
+      {LineSegment2d({2.0, 2.0}, {4.0, 2.0}),
+       LineSegment2d({4.0, 2.0}, {4.0, 3.0})},
+      {LineSegment2d({-3.0, -1.0}, {-3.0, 1.5})}};
+  ObstacleDistanceField field(&obstacles_linesegments_vec, -5.0, -5.0, 5.0,
+                              5.0, 0.25);
+
+  for (double x = -4.9; x < 5.0; x += 0.37) {
+    for (double y = -4.9; y < 5.0; y += 0.41) {
+      double distance = std::numeric_limits<double>::infinity();
+      for (const auto& obstacle_linesegments : obstacles_linesegments_vec) {
+        for (const auto& linesegment : obstacle_linesegments) {
+          distance = std::min(distance, linesegment.DistanceTo({x, y}));
+        }
+      }
+      const double lower_bound = field.DistanceLowerBound({x, y});
+      EXPECT_LE(lower_bound, distance);
+      EXPECT_GE(lower_bound, distance - 0.25 * std::sqrt(2.0) * 2.0);
+      // queried twice, the cached cell answers the same
+      EXPECT_DOUBLE_EQ(lower_bound, field.DistanceLowerBound({x, y}));
+    }
+  }
+}
+
+TEST(ObstacleDistanceFieldTest, outside) {
+  const std::vector<std::vector<LineSegment2d>> obstacles_linesegments_vec = {
+      {LineSegment2d({2.0, 2.0}, {4.0, 2.0})}};
+  ObstacleDistanceField field(&obstacles_linesegments_vec, 0.0, 0.0, 1.0, 1.0,
+                              0.5);
+  EXPECT_GT(field.DistanceLowerBound({0.5, 0.5}), 0.0);
+  EXPECT_DOUBLE_EQ(field.DistanceLowerBound({-0.1, 0.5}), 0.0);
+  EXPECT_DOUBLE_EQ(field.DistanceLowerBound({0.5, 1.1}), 0.0);
+}
+
+}  // namespace planning
+}  // namespace apollo
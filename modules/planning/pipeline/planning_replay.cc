@@ -0,0 +1,442 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Replays the planning inputs of cyber records through
+ * OnLanePlanning::RunOnce in a single thread as fast as possible. Every
+ * prediction message triggers one planning cycle with the latest chassis,
+ * localization, routing, traffic light, pad and story messages before it,
+ * the same way PlanningComponent::Proc is triggered online, while the mock
+ * clock follows the record time. Reports latency percentiles per task and
+ * per cycle, heap and frame arena allocations per cycle, and the cycles
+ * whose trajectory differs from a baseline replay.
+ *
+ * Latencies are measured with std::chrono::steady_clock, the mock clock
+ * stands still during a cycle. Heap allocations are counted by the
+ * replacements of the global operator new below, over the whole process
+ * while a cycle runs. Memory taken with malloc directly, e.g. by Eigen's
+ * aligned allocator or by the osqp and ipopt solvers, is not counted.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "google/protobuf/util/message_differencer.h"
+
+#include "modules/planning/proto/planning_config.pb.h"
+
+#include "cyber/common/file.h"
+#include "cyber/init.h"
+#include "cyber/record/record_reader.h"
+#include "cyber/record/record_writer.h"
+#include "cyber/time/clock.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/on_lane_planning.h"
+
+DEFINE_string(replay_records, "",
+              "cyber records to replay, separated by ':', in time order");
+DEFINE_string(replay_planning_config_file,
+              "/apollo/modules/planning/conf/planning_config.pb.txt",
+              "planning config file used for the replay");
+DEFINE_string(replay_output_record, "",
+              "record to write the replayed trajectories to, so that a later "
+              "replay can diff against it");
+DEFINE_string(replay_baseline_record, "",
+              "record written by an earlier replay to diff trajectories with");
+DEFINE_int32(replay_max_reported_diffs, 3,
+             "number of differing trajectories printed in full");
+
+namespace {
+
+std::atomic<uint64_t> heap_allocations_num(0);
+std::atomic<uint64_t> heap_allocated_bytes(0);
+
+void* CountedMalloc(std::size_t size) {
+  heap_allocations_num.fetch_add(1, std::memory_order_relaxed);
+  heap_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  void* ptr = CountedMalloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return CountedMalloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return CountedMalloc(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+namespace apollo {
+namespace planning {
+
+using apollo::cyber::Clock;
+using apollo::cyber::Time;
+using apollo::cyber::record::RecordMessage;
+using apollo::cyber::record::RecordReader;
+using apollo::cyber::record::RecordWriter;
+using google::protobuf::util::MessageDifferencer;
+
+namespace {
+
+class LatencySamples {
+ public:
+  void Add(const std::string& name, const double value) {
+    samples_[name].push_back(value);
+  }
+
+  void Print(const std::string& title, const std::string& unit) const {
+    std::cout << title << " (" << unit << ")\n"
+              << std::left << std::setw(48) << "name" << std::right
+              << std::setw(8) << "count" << std::setw(12) << "mean"
+              << std::setw(12) << "p50" << std::setw(12) << "p90"
+              << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+    for (const auto& name_samples : samples_) {
+      std::vector<double> sorted = name_samples.second;
+      std::sort(sorted.begin(), sorted.end());
+      double sum = 0.0;
+      for (const double value : sorted) {
+        sum += value;
+      }
+      std::cout << std::left << std::setw(48) << name_samples.first
+                << std::right << std::setw(8) << sorted.size() << std::fixed
+                << std::setprecision(3) << std::setw(12)
+                << sum / static_cast<double>(sorted.size()) << std::setw(12)
+                << Percentile(sorted, 0.5) << std::setw(12)
+                << Percentile(sorted, 0.9) << std::setw(12)
+                << Percentile(sorted, 0.99) << std::setw(12) << sorted.back()
+                << "\n";
+    }
+    std::cout << std::endl;
+  }
+
+ private:
+  // nearest rank percentile of sorted samples
+  static double Percentile(const std::vector<double>& sorted,
+                           const double ratio) {
+    const size_t rank = static_cast<size_t>(
+        std::ceil(ratio * static_cast<double>(sorted.size())));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+  }
+
+  std::map<std::string, std::vector<double>> samples_;
+};
+
+// drop the fields that differ between two replays of the same inputs
+void TrimTrajectory(ADCTrajectory* trajectory) {
+  trajectory->clear_latency_stats();
+  trajectory->clear_debug();
+}
+
+class PlanningReplay {
+ public:
+  bool Init() {
+    ACHECK(cyber::common::GetProtoFromFile(FLAGS_replay_planning_config_file,
+                                           &config_))
+        << "failed to load planning config file "
+        << FLAGS_replay_planning_config_file;
+
+    // everything runs on the replay thread in record order
+    FLAGS_enable_reference_line_provider_thread = false;
+    FLAGS_use_multi_thread_to_add_obstacles = false;
+    FLAGS_enable_multi_thread_in_dp_st_graph = false;
+    FLAGS_enable_parallel_reference_line_planning = false;
+    FLAGS_enable_open_space_planner_thread = false;
+    // per task latencies are collected from the debug records of the stages
+    FLAGS_enable_record_debug = true;
+    Clock::SetMode(cyber::proto::MODE_MOCK);
+
+    injector_ = std::make_shared<DependencyInjector>();
+    planning_.reset(new OnLanePlanning(injector_));
+    if (!planning_->Init(config_).ok()) {
+      AERROR << "failed to init planning";
+      return false;
+    }
+
+    if (!FLAGS_replay_output_record.empty() &&
+        !writer_.Open(FLAGS_replay_output_record)) {
+      AERROR << "failed to open " << FLAGS_replay_output_record;
+      return false;
+    }
+    if (!FLAGS_replay_baseline_record.empty()) {
+      baseline_reader_.reset(new RecordReader(FLAGS_replay_baseline_record));
+      if (!baseline_reader_->IsValid()) {
+        AERROR << "failed to open " << FLAGS_replay_baseline_record;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void ReplayRecord(const std::string& record_file) {
+    RecordReader reader(record_file);
+    if (!reader.IsValid()) {
+      AERROR << "Fail to open " << record_file;
+      return;
+    }
+    const auto& topic_config = config_.topic_config();
+    RecordMessage message;
+    while (reader.ReadMessage(&message)) {
+      if (message.channel_name == topic_config.chassis_topic()) {
+        Parse(message, &local_view_.chassis);
+      } else if (message.channel_name == topic_config.localization_topic()) {
+        Parse(message, &local_view_.localization_estimate);
+      } else if (message.channel_name ==
+                 topic_config.routing_response_topic()) {
+        Parse(message, &local_view_.routing);
+      } else if (message.channel_name ==
+                 topic_config.traffic_light_detection_topic()) {
+        Parse(message, &local_view_.traffic_light);
+      } else if (message.channel_name == topic_config.planning_pad_topic()) {
+        Parse(message, &local_view_.pad_msg);
+      } else if (message.channel_name == topic_config.story_telling_topic()) {
+        Parse(message, &local_view_.stories);
+      } else if (message.channel_name == topic_config.prediction_topic()) {
+        if (Parse(message, &local_view_.prediction_obstacles)) {
+          RunOnce(message.time);
+        }
+      }
+    }
+  }
+
+  void Report() {
+    std::cout << "replayed " << cycles_num_ << " planning cycles, skipped "
+              << skipped_cycles_num_ << " without chassis, localization or "
+              << "routing\n\n";
+    cycle_latency_.Print("cycle latency", "ms");
+    task_latency_.Print("task latency", "ms");
+    heap_allocations_.Print("heap allocations per cycle", "count, bytes");
+    if (has_frame_arena_stats_) {
+      allocations_.Print("frame arena allocations per cycle", "count, bytes");
+    }
+    if (boundary_cache_queries_num_ > 0) {
+      std::cout << "obstacle boundary cache hits: " << boundary_cache_hits_num_
+                << " / " << boundary_cache_queries_num_ << " ("
+                << 100.0 * static_cast<double>(boundary_cache_hits_num_) /
+                       static_cast<double>(boundary_cache_queries_num_)
+                << "%)" << std::endl;
+    }
+    if (baseline_reader_ != nullptr) {
+      std::cout << "trajectories differing from the baseline: "
+                << different_cycles_num_ << " / " << compared_cycles_num_
+                << std::endl;
+    }
+    if (!FLAGS_replay_output_record.empty()) {
+      writer_.Close();
+    }
+  }
+
+ private:
+  template <typename MessageT>
+  bool Parse(const RecordMessage& message,
+             std::shared_ptr<MessageT>* local_view_message) {
+    auto parsed = std::make_shared<MessageT>();
+    if (!parsed->ParseFromString(message.content)) {
+      AERROR << "failed to parse message on " << message.channel_name;
+      return false;
+    }
+    *local_view_message = std::move(parsed);
+    return true;
+  }
+
+  void RunOnce(const uint64_t record_time) {
+    if (local_view_.chassis == nullptr ||
+        local_view_.localization_estimate == nullptr ||
+        local_view_.routing == nullptr) {
+      ++skipped_cycles_num_;
+      return;
+    }
+    if (local_view_.traffic_light == nullptr) {
+      local_view_.traffic_light =
+          std::make_shared<perception::TrafficLightDetection>();
+    }
+    if (local_view_.pad_msg == nullptr) {
+      local_view_.pad_msg = std::make_shared<PadMessage>();
+    }
+    if (local_view_.stories == nullptr) {
+      local_view_.stories = std::make_shared<storytelling::Stories>();
+    }
+    Clock::SetNow(Time(record_time));
+
+    ADCTrajectory trajectory;
+    const uint64_t start_allocations_num = heap_allocations_num.load();
+    const uint64_t start_allocated_bytes = heap_allocated_bytes.load();
+    const auto start_time = std::chrono::steady_clock::now();
+    planning_->RunOnce(local_view_, &trajectory);
+    const std::chrono::duration<double, std::milli> cycle_time =
+        std::chrono::steady_clock::now() - start_time;
+    ++cycles_num_;
+
+    cycle_latency_.Add("OnLanePlanning::RunOnce", cycle_time.count());
+    heap_allocations_.Add(
+        "num_allocations",
+        static_cast<double>(heap_allocations_num.load() -
+                            start_allocations_num));
+    heap_allocations_.Add(
+        "allocated_bytes",
+        static_cast<double>(heap_allocated_bytes.load() -
+                            start_allocated_bytes));
+    const auto& latency_stats = trajectory.latency_stats();
+    for (const auto& task_stats : latency_stats.task_stats()) {
+      task_latency_.Add(task_stats.name(), task_stats.time_ms());
+    }
+    if (latency_stats.has_frame_arena_stats()) {
+      has_frame_arena_stats_ = true;
+      const auto& frame_arena_stats = latency_stats.frame_arena_stats();
+      allocations_.Add(
+          "num_allocations",
+          static_cast<double>(frame_arena_stats.num_allocations()));
+      allocations_.Add(
+          "allocated_bytes",
+          static_cast<double>(frame_arena_stats.allocated_bytes()));
+      allocations_.Add(
+          "heap_allocated_bytes",
+          static_cast<double>(frame_arena_stats.heap_allocated_bytes()));
+    }
+    if (latency_stats.has_obstacle_boundary_cache_stats()) {
+      const auto& cache_stats = latency_stats.obstacle_boundary_cache_stats();
+      boundary_cache_queries_num_ += cache_stats.num_queries();
+      boundary_cache_hits_num_ += cache_stats.num_hits();
+    }
+
+    TrimTrajectory(&trajectory);
+    if (!FLAGS_replay_output_record.empty()) {
+      writer_.WriteMessage<ADCTrajectory>(
+          config_.topic_config().planning_trajectory_topic(), trajectory,
+          record_time);
+    }
+    if (baseline_reader_ != nullptr) {
+      CompareWithBaseline(trajectory);
+    }
+  }
+
+  void CompareWithBaseline(const ADCTrajectory& trajectory) {
+    RecordMessage message;
+    while (baseline_reader_->ReadMessage(&message)) {
+      if (message.channel_name !=
+          config_.topic_config().planning_trajectory_topic()) {
+        continue;
+      }
+      ADCTrajectory baseline;
+      if (!baseline.ParseFromString(message.content)) {
+        AERROR << "failed to parse baseline trajectory";
+        return;
+      }
+      ++compared_cycles_num_;
+      std::string diff;
+      MessageDifferencer differencer;
+      differencer.ReportDifferencesToString(&diff);
+      if (!differencer.Compare(baseline, trajectory)) {
+        ++different_cycles_num_;
+        if (different_cycles_num_ <= FLAGS_replay_max_reported_diffs) {
+          std::cout << "cycle " << cycles_num_ << " differs:\n"
+                    << diff << std::endl;
+        }
+      }
+      return;
+    }
+    AWARN << "baseline ended before cycle " << cycles_num_;
+  }
+
+  PlanningConfig config_;
+  std::shared_ptr<DependencyInjector> injector_;
+  std::unique_ptr<OnLanePlanning> planning_;
+  LocalView local_view_;
+
+  RecordWriter writer_;
+  std::unique_ptr<RecordReader> baseline_reader_;
+
+  int cycles_num_ = 0;
+  int skipped_cycles_num_ = 0;
+  int compared_cycles_num_ = 0;
+  int different_cycles_num_ = 0;
+  LatencySamples cycle_latency_;
+  LatencySamples task_latency_;
+  LatencySamples heap_allocations_;
+  bool has_frame_arena_stats_ = false;
+  LatencySamples allocations_;
+  uint64_t boundary_cache_queries_num_ = 0;
+  uint64_t boundary_cache_hits_num_ = 0;
+};
+
+}  // namespace
+
+void ReplayPlanning() {
+  if (FLAGS_replay_records.empty()) {
+    AERROR << "Requires FLAGS_replay_records to be set";
+    return;
+  }
+  PlanningReplay replay;
+  if (!replay.Init()) {
+    return;
+  }
+  const std::vector<std::string> records =
+      absl::StrSplit(FLAGS_replay_records, ':');
+  for (const auto& record : records) {
+    AINFO << "Replaying: " << record;
+    replay.ReplayRecord(record);
+  }
+  replay.Report();
+}
+
+}  // namespace planning
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::Init(argv[0]);
+  apollo::planning::ReplayPlanning();
+  return 0;
+}
@@ -31,6 +31,7 @@
 #include "modules/common/math/cartesian_frenet_conversion.h"
 #include "modules/common/math/path_matcher.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/common/trajectory/compact_trajectory.h"
 #include "modules/planning/constraint_checker/collision_checker.h"
 #include "modules/planning/constraint_checker/constraint_checker.h"
 #include "modules/planning/lattice/behavior/path_time_graph.h"
@@ -233,19 +234,33 @@ Status LatticePlanner::PlanOnReferenceLine(
 
   size_t num_lattice_traj = 0;
 
+  // reused by the candidates, only the chosen one is converted to protobuf
+  CompactTrajectory compact_trajectory;
+
   while (trajectory_evaluator.has_more_trajectory_pairs()) {
     double trajectory_pair_cost =
         trajectory_evaluator.top_trajectory_pair_cost();
     auto trajectory_pair = trajectory_evaluator.next_top_trajectory_pair();
 
     // combine two 1d trajectories to one 2d trajectory
-    auto combined_trajectory = TrajectoryCombiner::Combine(
-        *ptr_reference_line, *trajectory_pair.first, *trajectory_pair.second,
-        planning_init_point.relative_time());
+    DiscretizedTrajectory combined_trajectory;
+    if (FLAGS_enable_lattice_compact_trajectory) {
+      TrajectoryCombiner::Combine(*ptr_reference_line, *trajectory_pair.first,
+                                  *trajectory_pair.second,
+                                  planning_init_point.relative_time(),
+                                  &compact_trajectory);
+    } else {
+      combined_trajectory = TrajectoryCombiner::Combine(
+          *ptr_reference_line, *trajectory_pair.first, *trajectory_pair.second,
+          planning_init_point.relative_time());
+    }
 
     // check longitudinal and lateral acceleration
     // considering trajectory curvatures
-    auto result = ConstraintChecker::ValidTrajectory(combined_trajectory);
+    auto result =
+        FLAGS_enable_lattice_compact_trajectory
+            ? ConstraintChecker::ValidTrajectory(compact_trajectory)
+            : ConstraintChecker::ValidTrajectory(combined_trajectory);
     if (result != ConstraintChecker::Result::VALID) {
       ++combined_constraint_failure_count;
 
@@ -277,11 +292,17 @@ Status LatticePlanner::PlanOnReferenceLine(
     }
 
     // check collision with other obstacles
-    if (collision_checker.InCollision(combined_trajectory)) {
+    if (FLAGS_enable_lattice_compact_trajectory
+            ? collision_checker.InCollision(compact_trajectory)
+            : collision_checker.InCollision(combined_trajectory)) {
       ++collision_failure_count;
       continue;
     }
 
+    if (FLAGS_enable_lattice_compact_trajectory) {
+      combined_trajectory = compact_trajectory.ToDiscretizedTrajectory();
+    }
+
     // put combine trajectory into debug data
     const auto& combined_trajectory_points = combined_trajectory;
     num_lattice_traj += 1;
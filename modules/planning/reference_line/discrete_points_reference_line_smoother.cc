@@ -140,6 +140,7 @@ bool DiscretePointsReferenceLineSmoother::FemPosSmooth(
       config_.discrete_points().fem_pos_deviation_smoothing();
 
   FemPosDeviationSmoother smoother(fem_pos_config);
+  smoother.set_sqp_solvers(&fem_pos_sqp_solvers_);
 
   // box contraints on pos are used in fem pos smoother, thus shrink the
   // bounds by 1.0 / sqrt(2.0)
@@ -16,11 +16,13 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "modules/planning/proto/reference_line_smoother_config.pb.h"
 
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
 #include "modules/planning/reference_line/reference_line.h"
 #include "modules/planning/reference_line/reference_line_smoother.h"
 #include "modules/planning/reference_line/reference_point.h"
@@ -65,6 +67,10 @@ class DiscretePointsReferenceLineSmoother : public ReferenceLineSmoother {
   double zero_x_ = 0.0;
 
   double zero_y_ = 0.0;
+
+  // the osqp workspaces of the sparse sqp fem pos smoothing, kept across
+  // cycles since the number of anchor points rarely changes
+  std::vector<std::unique_ptr<PiecewiseJerkSolver>> fem_pos_sqp_solvers_;
 };
 
 }  // namespace planning
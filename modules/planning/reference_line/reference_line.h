@@ -119,6 +119,19 @@ class ReferenceLine {
   bool XYToSL(const XYPoint& xy, common::SLPoint* const sl_point) const {
     return XYToSL(common::math::Vec2d(xy.x(), xy.y()), sl_point);
   }
+  /**
+   * @brief Project xy_point onto the part of the reference line between
+   * start_s and end_s only, for points known to be close to that part, e.g.
+   * points following a previous projection along the line.
+   */
+  bool XYToSL(const common::math::Vec2d& xy_point, const double start_s,
+              const double end_s, common::SLPoint* const sl_point) const;
+  /**
+   * @brief Project many points at once, consecutive points are expected to be
+   * close to each other, e.g. the corners of a box or a trajectory.
+   */
+  bool XYToSL(const std::vector<common::math::Vec2d>& xy_points,
+              std::vector<common::SLPoint>* const sl_points) const;
 
   bool GetLaneWidth(const double s, double* const lane_left_width,
                     double* const lane_right_width) const;
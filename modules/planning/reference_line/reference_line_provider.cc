@@ -22,12 +22,12 @@
 #include "modules/planning/reference_line/reference_line_provider.h"
 
 #include <algorithm>
+#include <chrono>
 #include <limits>
 #include <utility>
 
 #include "cyber/common/file.h"
 #include "cyber/task/task.h"
-#include "cyber/time/clock.h"
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common/math/math_utils.h"
 #include "modules/common/util/point_factory.h"
@@ -48,7 +48,6 @@ using apollo::common::VehicleConfigHelper;
 using apollo::common::VehicleState;
 using apollo::common::math::AngleDiff;
 using apollo::common::math::Vec2d;
-using apollo::cyber::Clock;
 using apollo::hdmap::HDMapUtil;
 using apollo::hdmap::LaneWaypoint;
 using apollo::hdmap::MapPathPoint;
@@ -84,6 +83,11 @@ ReferenceLineProvider::ReferenceLineProvider(
     ACHECK(false) << "unknown smoother config "
                   << smoother_config_.DebugString();
   }
+  if (FLAGS_enable_incremental_reference_line_smoothing &&
+      !IsIncrementalSmoothing()) {
+    AWARN << "Incremental reference line smoothing needs the discrete points "
+             "smoother, smooth the whole extended reference line instead.";
+  }
   is_initialized_ = true;
 }
 
@@ -190,7 +194,7 @@ void ReferenceLineProvider::GenerateThread() {
   while (!is_stop_) {
     static constexpr int32_t kSleepTime = 50;  // milliseconds
     cyber::SleepFor(std::chrono::milliseconds(kSleepTime));
-    const double start_time = Clock::NowInSeconds();
+    const auto start_time = std::chrono::steady_clock::now();
     if (!has_routing_) {
       AWARN_EVERY(100) << "Routing is not ready.";
       continue;
@@ -203,9 +207,11 @@ void ReferenceLineProvider::GenerateThread() {
       continue;
     }
     UpdateReferenceLine(reference_lines, segments);
-    const double end_time = Clock::NowInSeconds();
+    const std::chrono::duration<double> calculation_time =
+        std::chrono::steady_clock::now() - start_time;
     std::lock_guard<std::mutex> lock(reference_lines_mutex_);
-    last_calculation_time_ = end_time - start_time;
+    last_calculation_time_ = calculation_time.count();
+    last_reused_ratios_ = reused_ratios_;
     is_reference_line_updated_ = true;
   }
 }
@@ -220,6 +226,17 @@ double ReferenceLineProvider::LastTimeDelay() {
   }
 }
 
+std::unordered_map<std::string, double>
+ReferenceLineProvider::LastReusedRatios() {
+  if (FLAGS_enable_reference_line_provider_thread &&
+      !FLAGS_use_navigation_mode) {
+    std::lock_guard<std::mutex> lock(reference_lines_mutex_);
+    return last_reused_ratios_;
+  } else {
+    return last_reused_ratios_;
+  }
+}
+
 bool ReferenceLineProvider::GetReferenceLines(
     std::list<ReferenceLine> *reference_lines,
     std::list<hdmap::RouteSegments> *segments) {
@@ -227,13 +244,14 @@ bool ReferenceLineProvider::GetReferenceLines(
   CHECK_NOTNULL(segments);
 
   if (FLAGS_use_navigation_mode) {
-    double start_time = Clock::NowInSeconds();
+    const auto start_time = std::chrono::steady_clock::now();
     bool result = GetReferenceLinesFromRelativeMap(reference_lines, segments);
     if (!result) {
       AERROR << "Failed to get reference line from relative map";
     }
-    double end_time = Clock::NowInSeconds();
-    last_calculation_time_ = end_time - start_time;
+    const std::chrono::duration<double> calculation_time =
+        std::chrono::steady_clock::now() - start_time;
+    last_calculation_time_ = calculation_time.count();
     return result;
   }
 
@@ -245,11 +263,13 @@ bool ReferenceLineProvider::GetReferenceLines(
       return true;
     }
   } else {
-    double start_time = Clock::NowInSeconds();
+    const auto start_time = std::chrono::steady_clock::now();
     if (CreateReferenceLine(reference_lines, segments)) {
       UpdateReferenceLine(*reference_lines, *segments);
-      double end_time = Clock::NowInSeconds();
-      last_calculation_time_ = end_time - start_time;
+      const std::chrono::duration<double> calculation_time =
+          std::chrono::steady_clock::now() - start_time;
+      last_calculation_time_ = calculation_time.count();
+      last_reused_ratios_ = reused_ratios_;
       return true;
     }
   }
@@ -576,6 +596,7 @@ bool ReferenceLineProvider::CreateReferenceLine(
     }
   }
 
+  reused_ratios_.clear();
   if (!CreateRouteSegments(vehicle_state, segments)) {
     AERROR << "Failed to create reference line from routing";
     return false;
@@ -594,6 +615,7 @@ bool ReferenceLineProvider::CreateReferenceLine(
                 << vehicle_state.y() << "} to stitched reference line";
         }
         Shrink(sl, &reference_lines->back(), &(*iter));
+        reused_ratios_[iter->Id()] = 0.0;
         ++iter;
       }
     }
@@ -601,12 +623,19 @@ bool ReferenceLineProvider::CreateReferenceLine(
   } else {  // stitching reference line
     for (auto iter = segments->begin(); iter != segments->end();) {
       reference_lines->emplace_back();
+      double reused_length = 0.0;
       if (!ExtendReferenceLine(vehicle_state, &(*iter),
-                               &reference_lines->back())) {
+                               &reference_lines->back(), &reused_length)) {
         AERROR << "Failed to extend reference line";
         reference_lines->pop_back();
         iter = segments->erase(iter);
       } else {
+        const double length = reference_lines->back().Length();
+        reused_ratios_[iter->Id()] =
+            length > 0.0 ? std::min(1.0, reused_length / length) : 0.0;
+        ADEBUG << "Reused " << reused_length << " of " << length
+               << " meters of reference line " << iter->Id()
+               << " from the previous cycle";
         ++iter;
       }
     }
@@ -623,7 +652,9 @@ bool ReferenceLineProvider::CreateReferenceLine(
 
 bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
                                                 RouteSegments *segments,
-                                                ReferenceLine *reference_line) {
+                                                ReferenceLine *reference_line,
+                                                double *reused_length) {
+  *reused_length = 0.0;
   RouteSegments segment_properties;
   segment_properties.SetProperties(*segments);
   auto prev_segment = route_segments_.begin();
@@ -658,6 +689,7 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
     *segments = *prev_segment;
     segments->SetProperties(segment_properties);
     *reference_line = *prev_ref;
+    *reused_length = reference_line->Length();
     ADEBUG << "Reference line remain " << remain_s
            << ", which is more than required " << look_forward_required_distance
            << " and no need to extend";
@@ -681,6 +713,7 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
     *segments = *prev_segment;
     segments->SetProperties(segment_properties);
     *reference_line = *prev_ref;
+    *reused_length = reference_line->Length();
     ADEBUG << "Could not further extend reference line";
     return true;
   }
@@ -690,6 +723,9 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
     AWARN << "Failed to smooth forward shifted reference line";
     return SmoothRouteSegment(*segments, reference_line);
   }
+  // the first point of the newly smoothed part, everything before it on the
+  // stitched reference line is reused from the previous one
+  const Vec2d smoothed_start = reference_line->reference_points().front();
   if (!reference_line->Stitch(*prev_ref)) {
     AWARN << "Failed to stitch reference line";
     return SmoothRouteSegment(*segments, reference_line);
@@ -701,11 +737,51 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
   *segments = shifted_segments;
   segments->SetProperties(segment_properties);
   common::SLPoint sl;
-  if (!reference_line->XYToSL(vec2d, &sl)) {
+  if (!IsIncrementalSmoothing()) {
+    if (!reference_line->XYToSL(vec2d, &sl)) {
+      AWARN << "Failed to project point: " << vec2d.DebugString()
+            << " to stitched reference line";
+    }
+  } else if (!XYToSLWithHint(*reference_line, vec2d, sl_point.s(), &sl)) {
+    // the stitched line keeps the part of the previous reference line around
+    // the vehicle, so the vehicle stays close to its previous projection
     AWARN << "Failed to project point: " << vec2d.DebugString()
           << " to stitched reference line";
   }
-  return Shrink(sl, reference_line, segments);
+  if (!Shrink(sl, reference_line, segments)) {
+    return false;
+  }
+  common::SLPoint reused_sl;
+  if (reference_line->XYToSL(smoothed_start, &reused_sl)) {
+    *reused_length =
+        common::math::Clamp(reused_sl.s(), 0.0, reference_line->Length());
+  }
+  return true;
+}
+
+bool ReferenceLineProvider::IsIncrementalSmoothing() const {
+  return FLAGS_enable_incremental_reference_line_smoothing &&
+         smoother_config_.has_discrete_points();
+}
+
+bool ReferenceLineProvider::XYToSLWithHint(const ReferenceLine &reference_line,
+                                           const Vec2d &xy, const double hint_s,
+                                           common::SLPoint *sl_point) const {
+  static constexpr double kHintWindow = 20.0;
+  const double start_s = std::max(0.0, hint_s - kHintWindow);
+  const double end_s = std::min(reference_line.Length(), hint_s + kHintWindow);
+  if (start_s < end_s &&
+      reference_line.XYToSL(xy, start_s, end_s, sl_point)) {
+    // a projection on the window border may belong to the part of the line
+    // outside of it
+    static constexpr double kBorderEpsilon = 1e-3;
+    if ((sl_point->s() > start_s + kBorderEpsilon || start_s <= 0.0) &&
+        (sl_point->s() < end_s - kBorderEpsilon ||
+         end_s >= reference_line.Length())) {
+      return true;
+    }
+  }
+  return reference_line.XYToSL(xy, sl_point);
 }
 
 bool ReferenceLineProvider::Shrink(const common::SLPoint &sl,
@@ -756,17 +832,26 @@ bool ReferenceLineProvider::Shrink(const common::SLPoint &sl,
 bool ReferenceLineProvider::IsReferenceLineSmoothValid(
     const ReferenceLine &raw, const ReferenceLine &smoothed) const {
   static constexpr double kReferenceLineDiffCheckStep = 10.0;
+  double hint_s = 0.0;
   for (double s = 0.0; s < smoothed.Length();
        s += kReferenceLineDiffCheckStep) {
     auto xy_new = smoothed.GetReferencePoint(s);
 
     common::SLPoint sl_new;
-    if (!raw.XYToSL(xy_new, &sl_new)) {
+    // the checked points move forward along both lines, so every projection
+    // onto the raw line starts around the previous one
+    const bool projected =
+        IsIncrementalSmoothing()
+            ? XYToSLWithHint(raw, xy_new, hint_s + kReferenceLineDiffCheckStep,
+                             &sl_new)
+            : raw.XYToSL(xy_new, &sl_new);
+    if (!projected) {
       AERROR << "Fail to change xy point on smoothed reference line to sl "
                 "point respect to raw reference line.";
       return false;
     }
 
+    hint_s = sl_new.s();
     const double diff = std::fabs(sl_new.l());
     if (diff > FLAGS_smoothed_reference_line_max_diff) {
       AERROR << "Fail to provide reference line because too large diff "
@@ -892,12 +977,43 @@ bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
   std::vector<AnchorPoint> anchor_points;
   GetAnchorPoints(raw_ref, &anchor_points);
   // modify anchor points based on prefix_ref
-  for (auto &point : anchor_points) {
+  FixAnchorPointsOnPrefix(prefix_ref, &anchor_points);
+
+  smoother_->SetAnchorPoints(anchor_points);
+  if (!smoother_->Smooth(raw_ref, reference_line)) {
+    AERROR << "Failed to smooth prefixed reference line with anchor points";
+    return false;
+  }
+  if (!IsReferenceLineSmoothValid(raw_ref, *reference_line)) {
+    AERROR << "The smoothed reference line error is too large";
+    return false;
+  }
+  return true;
+}
+
+void ReferenceLineProvider::FixAnchorPointsOnPrefix(
+    const ReferenceLine &prefix_ref,
+    std::vector<AnchorPoint> *anchor_points) const {
+  const bool is_incremental = IsIncrementalSmoothing();
+  bool has_prefix_anchor = false;
+  double hint_s = 0.0;
+  for (auto &point : *anchor_points) {
     common::SLPoint sl_point;
-    if (!prefix_ref.XYToSL(point.path_point, &sl_point)) {
+    const Vec2d xy(point.path_point.x(), point.path_point.y());
+    const double next_s = hint_s + smoother_config_.max_constraint_interval();
+    const bool projected =
+        has_prefix_anchor ? XYToSLWithHint(prefix_ref, xy, next_s, &sl_point)
+                          : prefix_ref.XYToSL(xy, &sl_point);
+    if (!projected) {
+      if (has_prefix_anchor) {
+        break;
+      }
       continue;
     }
     if (sl_point.s() < 0 || sl_point.s() > prefix_ref.Length()) {
+      if (has_prefix_anchor) {
+        break;
+      }
       continue;
     }
     auto prefix_ref_point = prefix_ref.GetNearestReferencePoint(sl_point.s());
@@ -908,19 +1024,15 @@ bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
     point.longitudinal_bound = 1e-6;
     point.lateral_bound = 1e-6;
     point.enforced = true;
-    break;
-  }
-
-  smoother_->SetAnchorPoints(anchor_points);
-  if (!smoother_->Smooth(raw_ref, reference_line)) {
-    AERROR << "Failed to smooth prefixed reference line with anchor points";
-    return false;
-  }
-  if (!IsReferenceLineSmoothValid(raw_ref, *reference_line)) {
-    AERROR << "The smoothed reference line error is too large";
-    return false;
+    // in incremental mode every anchor point on the overlap with prefix_ref is
+    // fixed to it, so only the appended part is actually smoothed and it
+    // joins the reused part with the same position and heading
+    if (!is_incremental) {
+      break;
+    }
+    has_prefix_anchor = true;
+    hint_s = sl_point.s();
   }
-  return true;
 }
 
 bool ReferenceLineProvider::SmoothReferenceLine(
@@ -26,9 +26,12 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "gtest/gtest_prod.h"
+
 #include "modules/common/vehicle_state/proto/vehicle_state.pb.h"
 #include "modules/common_msgs/planning_msgs/navigation.pb.h"
 #include "modules/planning/proto/planning_config.pb.h"
@@ -83,6 +86,13 @@ class ReferenceLineProvider {
 
   double LastTimeDelay();
 
+  /**
+   * @brief The share of each of the last computed reference lines, by
+   * length, that was kept from the previous cycle instead of being smoothed
+   * again, by the id of the route segments of the reference line.
+   */
+  std::unordered_map<std::string, double> LastReusedRatios();
+
   std::vector<routing::LaneWaypoint> FutureRouteWaypoints();
 
   bool UpdatedReferenceLine() { return is_reference_line_updated_.load(); }
@@ -131,10 +141,31 @@ class ReferenceLineProvider {
   /**
    * @brief This function creates a smoothed forward reference line
    * based on the given segments.
+   * @param reused_length set to the length at the start of the new reference
+   * line that was kept from the previous one.
    */
   bool ExtendReferenceLine(const common::VehicleState& state,
                            hdmap::RouteSegments* segments,
-                           ReferenceLine* reference_line);
+                           ReferenceLine* reference_line,
+                           double* reused_length);
+
+  /**
+   * @brief Whether FLAGS_enable_incremental_reference_line_smoothing applies
+   * to the configured smoother. Only the discrete points smoother bounds
+   * every point on its own, so fixing all the anchor points on the overlap
+   * cannot make its problem infeasible. The spline and spiral smoothers
+   * would have to bend whole pieces through them.
+   */
+  bool IsIncrementalSmoothing() const;
+
+  /**
+   * @brief Fix the anchor points of a reference line extending prefix_ref to
+   * prefix_ref: only the first one on prefix_ref, or all of them on the
+   * overlap with IsIncrementalSmoothing(). The smoother still solves the
+   * whole extended line, the overlap is only held in place.
+   */
+  void FixAnchorPointsOnPrefix(const ReferenceLine& prefix_ref,
+                               std::vector<AnchorPoint>* anchor_points) const;
 
   AnchorPoint GetAnchorPoint(const ReferenceLine& reference_line,
                              double s) const;
@@ -155,6 +186,17 @@ class ReferenceLineProvider {
   bool Shrink(const common::SLPoint& sl, ReferenceLine* ref,
               hdmap::RouteSegments* segments);
 
+  /**
+   * @brief Project xy onto reference_line around hint_s first and fall back
+   * to a projection onto the whole line if the hinted window misses it.
+   * Projections are not cached across cycles: the points projected while
+   * stitching move forward along the line, so the last projection is a good
+   * enough hint for the next one.
+   */
+  bool XYToSLWithHint(const ReferenceLine& reference_line,
+                      const common::math::Vec2d& xy, const double hint_s,
+                      common::SLPoint* sl_point) const;
+
  private:
   bool is_initialized_ = false;
   std::atomic<bool> is_stop_{false};
@@ -179,6 +221,11 @@ class ReferenceLineProvider {
   std::list<ReferenceLine> reference_lines_;
   std::list<hdmap::RouteSegments> route_segments_;
   double last_calculation_time_ = 0.0;
+  std::unordered_map<std::string, double> last_reused_ratios_;
+
+  // reused ratios of the reference lines being created, only touched by
+  // CreateReferenceLine
+  std::unordered_map<std::string, double> reused_ratios_;
 
   std::queue<std::list<ReferenceLine>> reference_line_history_;
   std::queue<std::list<hdmap::RouteSegments>> route_segments_history_;
@@ -188,6 +235,12 @@ class ReferenceLineProvider {
   std::atomic<bool> is_reference_line_updated_{true};
 
   const common::VehicleStateProvider* vehicle_state_provider_ = nullptr;
+
+  FRIEND_TEST(ReferenceLineProviderTest, XYToSLWithHint);
+  FRIEND_TEST(ReferenceLineProviderTest, FixFirstAnchorPointOnPrefix);
+  FRIEND_TEST(ReferenceLineProviderTest, FixAnchorPointsOnPrefixOverlap);
+  FRIEND_TEST(ReferenceLineProviderTest, SmoothPrefixedReferenceLine);
+  FRIEND_TEST(ReferenceLineProviderTest, IncrementalOnlyWithDiscretePoints);
 };
 
 }  // namespace planning
@@ -0,0 +1,238 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file reference_line_provider_test.cc
+ **/
+
+#include "modules/planning/reference_line/reference_line_provider.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::SLPoint;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+// straight line along y = offset from x = 0 to x = length, a point every
+// meter
+ReferenceLine StraightReferenceLine(const double length, const double offset) {
+  std::vector<ReferencePoint> ref_points;
+  for (int i = 0; i <= static_cast<int>(length); ++i) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(Vec2d(static_cast<double>(i), offset), 0.0), 0.0,
+        0.0);
+  }
+  return ReferenceLine(ref_points);
+}
+
+// 50m east along y = 0, a half circle of radius 5 and 50m back west along
+// y = 10
+ReferenceLine UTurnReferenceLine() {
+  std::vector<ReferencePoint> ref_points;
+  for (int i = 0; i < 50; ++i) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(Vec2d(static_cast<double>(i), 0.0), 0.0), 0.0,
+        0.0);
+  }
+  constexpr int kNumArcPoints = 16;
+  for (int i = 0; i < kNumArcPoints; ++i) {
+    const double angle = M_PI * static_cast<double>(i) / kNumArcPoints;
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(
+            Vec2d(50.0 + 5.0 * std::sin(angle), 5.0 - 5.0 * std::cos(angle)),
+            angle),
+        0.2, 0.0);
+  }
+  for (int i = 50; i >= 0; --i) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(Vec2d(static_cast<double>(i), 10.0), M_PI), 0.0,
+        0.0);
+  }
+  return ReferenceLine(ref_points);
+}
+
+// anchor points every 5m along y = 0.5 from x = 0 to x = 60
+std::vector<AnchorPoint> RawAnchorPoints() {
+  std::vector<AnchorPoint> anchor_points;
+  for (int i = 0; i <= 12; ++i) {
+    AnchorPoint anchor;
+    anchor.path_point.set_x(5.0 * i);
+    anchor.path_point.set_y(0.5);
+    anchor.path_point.set_s(5.0 * i);
+    anchor.lateral_bound = 0.2;
+    anchor.longitudinal_bound = 0.2;
+    anchor_points.push_back(anchor);
+  }
+  return anchor_points;
+}
+
+}  // namespace
+
+class ReferenceLineProviderTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    incremental_smoothing_ = FLAGS_enable_incremental_reference_line_smoothing;
+    smoother_config_filename_ = FLAGS_smoother_config_filename;
+  }
+
+  void TearDown() override {
+    FLAGS_enable_incremental_reference_line_smoothing = incremental_smoothing_;
+    FLAGS_smoother_config_filename = smoother_config_filename_;
+  }
+
+  // a provider with the smoother configured in planning/conf/config_name
+  std::unique_ptr<ReferenceLineProvider> CreateProvider(
+      const std::string& config_name) {
+    FLAGS_smoother_config_filename =
+        "/apollo/modules/planning/conf/" + config_name;
+    return std::make_unique<ReferenceLineProvider>(nullptr, nullptr);
+  }
+
+ protected:
+  ReferenceLineProvider provider_{nullptr, nullptr};
+  bool incremental_smoothing_ = false;
+  std::string smoother_config_filename_;
+};
+
+TEST_F(ReferenceLineProviderTest, XYToSLWithHint) {
+  const ReferenceLine reference_line = UTurnReferenceLine();
+  const Vec2d xy(20.0, 4.0);
+  SLPoint nearest;
+  ASSERT_TRUE(reference_line.XYToSL(xy, &nearest));
+  EXPECT_NEAR(20.0, nearest.s(), 1e-6);
+
+  SLPoint sl;
+  ASSERT_TRUE(provider_.XYToSLWithHint(reference_line, xy, 25.0, &sl));
+  EXPECT_NEAR(nearest.s(), sl.s(), 1e-6);
+  EXPECT_NEAR(nearest.l(), sl.l(), 1e-6);
+
+  // around the hint the point projects onto the leg back west, although the
+  // leg east is nearer
+  const double west_leg_s = reference_line.Length() - 50.0 + 30.0;
+  ASSERT_TRUE(provider_.XYToSLWithHint(reference_line, xy, west_leg_s, &sl));
+  EXPECT_NEAR(west_leg_s, sl.s(), 1e-6);
+  EXPECT_NEAR(6.0, sl.l(), 1e-6);
+
+  // nearest to the window end, the projection falls back to the whole line
+  ASSERT_TRUE(provider_.XYToSLWithHint(reference_line, xy, 60.0, &sl));
+  EXPECT_NEAR(nearest.s(), sl.s(), 1e-6);
+  EXPECT_NEAR(nearest.l(), sl.l(), 1e-6);
+}
+
+TEST_F(ReferenceLineProviderTest, FixFirstAnchorPointOnPrefix) {
+  FLAGS_enable_incremental_reference_line_smoothing = false;
+  const ReferenceLine prefix_ref = StraightReferenceLine(30.0, 0.0);
+  auto anchor_points = RawAnchorPoints();
+  provider_.FixAnchorPointsOnPrefix(prefix_ref, &anchor_points);
+
+  ASSERT_EQ(13, anchor_points.size());
+  EXPECT_TRUE(anchor_points[0].enforced);
+  EXPECT_NEAR(0.0, anchor_points[0].path_point.x(), 1e-6);
+  EXPECT_NEAR(0.0, anchor_points[0].path_point.y(), 1e-6);
+  EXPECT_DOUBLE_EQ(1e-6, anchor_points[0].lateral_bound);
+  for (size_t i = 1; i < anchor_points.size(); ++i) {
+    EXPECT_FALSE(anchor_points[i].enforced);
+    EXPECT_DOUBLE_EQ(0.5, anchor_points[i].path_point.y());
+    EXPECT_DOUBLE_EQ(0.2, anchor_points[i].lateral_bound);
+  }
+}
+
+TEST_F(ReferenceLineProviderTest, FixAnchorPointsOnPrefixOverlap) {
+  FLAGS_enable_incremental_reference_line_smoothing = true;
+  const auto provider =
+      CreateProvider("discrete_points_smoother_config.pb.txt");
+  const ReferenceLine prefix_ref = StraightReferenceLine(30.0, 0.0);
+  auto anchor_points = RawAnchorPoints();
+  provider->FixAnchorPointsOnPrefix(prefix_ref, &anchor_points);
+
+  // the anchor points up to x = 30 are on the prefix, the rest is left to
+  // the smoother
+  ASSERT_EQ(13, anchor_points.size());
+  for (size_t i = 0; i < anchor_points.size(); ++i) {
+    const auto& anchor = anchor_points[i];
+    if (i <= 6) {
+      EXPECT_TRUE(anchor.enforced);
+      EXPECT_NEAR(5.0 * static_cast<double>(i), anchor.path_point.x(), 1e-6);
+      EXPECT_NEAR(0.0, anchor.path_point.y(), 1e-6);
+      EXPECT_DOUBLE_EQ(1e-6, anchor.lateral_bound);
+      EXPECT_DOUBLE_EQ(1e-6, anchor.longitudinal_bound);
+    } else {
+      EXPECT_FALSE(anchor.enforced);
+      EXPECT_DOUBLE_EQ(0.5, anchor.path_point.y());
+      EXPECT_DOUBLE_EQ(0.2, anchor.lateral_bound);
+    }
+  }
+}
+
+TEST_F(ReferenceLineProviderTest, IncrementalOnlyWithDiscretePoints) {
+  FLAGS_enable_incremental_reference_line_smoothing = true;
+  const ReferenceLine prefix_ref = StraightReferenceLine(30.0, 0.0);
+  for (const std::string config_name :
+       {"qp_spline_smoother_config.pb.txt", "spiral_smoother_config.pb.txt",
+        "discrete_points_smoother_config.pb.txt"}) {
+    const auto provider = CreateProvider(config_name);
+    const bool is_discrete_points =
+        config_name == "discrete_points_smoother_config.pb.txt";
+    EXPECT_EQ(is_discrete_points, provider->IsIncrementalSmoothing())
+        << config_name;
+
+    // the spline and spiral smoothers keep only the first anchor point fixed
+    auto anchor_points = RawAnchorPoints();
+    provider->FixAnchorPointsOnPrefix(prefix_ref, &anchor_points);
+    EXPECT_TRUE(anchor_points[0].enforced) << config_name;
+    EXPECT_EQ(is_discrete_points, anchor_points[1].enforced) << config_name;
+  }
+}
+
+TEST_F(ReferenceLineProviderTest, SmoothPrefixedReferenceLine) {
+  FLAGS_enable_incremental_reference_line_smoothing = true;
+  const auto provider =
+      CreateProvider("discrete_points_smoother_config.pb.txt");
+  // the previous reference line is 0.1m left of the raw one
+  const ReferenceLine prefix_ref = StraightReferenceLine(40.0, 0.1);
+  const ReferenceLine raw_ref = StraightReferenceLine(100.0, 0.0);
+
+  ReferenceLine reference_line;
+  ASSERT_TRUE(provider->SmoothPrefixedReferenceLine(prefix_ref, raw_ref,
+                                                    &reference_line));
+  // the smoothed line goes through the prefix where it overlaps it
+  for (const double x : {0.0, 10.0, 20.0, 30.0, 40.0}) {
+    SLPoint sl;
+    ASSERT_TRUE(reference_line.XYToSL(Vec2d(x, 0.1), &sl));
+    EXPECT_NEAR(0.0, sl.l(), 1e-2) << "x = " << x;
+  }
+  // and the appended part stays within the bounds of the raw line
+  for (const double x : {50.0, 70.0, 90.0}) {
+    SLPoint sl;
+    ASSERT_TRUE(reference_line.XYToSL(Vec2d(x, 0.0), &sl));
+    EXPECT_LT(std::fabs(sl.l()), 0.1) << "x = " << x;
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file reference_line_test.cc
+ **/
+
+#include "modules/planning/reference_line/reference_line.h"
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/reference_line/reference_point.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::SLPoint;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+// 50m east along y = 0, a half circle of radius 5 and 50m back west along
+// y = 10, with points about every meter
+ReferenceLine UTurnReferenceLine() {
+  std::vector<ReferencePoint> ref_points;
+  for (int i = 0; i < 50; ++i) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(Vec2d(static_cast<double>(i), 0.0), 0.0), 0.0,
+        0.0);
+  }
+  constexpr int kNumArcPoints = 16;
+  for (int i = 0; i < kNumArcPoints; ++i) {
+    const double angle = M_PI * static_cast<double>(i) / kNumArcPoints;
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(
+            Vec2d(50.0 + 5.0 * std::sin(angle), 5.0 - 5.0 * std::cos(angle)),
+            angle),
+        0.2, 0.0);
+  }
+  for (int i = 50; i >= 0; --i) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(Vec2d(static_cast<double>(i), 10.0), M_PI), 0.0,
+        0.0);
+  }
+  return ReferenceLine(ref_points);
+}
+
+}  // namespace
+
+TEST(ReferenceLineTest, XYToSLInRange) {
+  const ReferenceLine reference_line = UTurnReferenceLine();
+  const Vec2d xy(20.0, 4.0);
+
+  SLPoint nearest;
+  ASSERT_TRUE(reference_line.XYToSL(xy, &nearest));
+  EXPECT_NEAR(20.0, nearest.s(), 1e-6);
+  EXPECT_NEAR(4.0, nearest.l(), 1e-6);
+
+  // the whole line gives the same projection as the range around it
+  SLPoint in_range;
+  ASSERT_TRUE(reference_line.XYToSL(xy, 0.0, reference_line.Length(),
+                                    &in_range));
+  EXPECT_NEAR(nearest.s(), in_range.s(), 1e-6);
+  EXPECT_NEAR(nearest.l(), in_range.l(), 1e-6);
+  ASSERT_TRUE(reference_line.XYToSL(xy, 10.0, 30.0, &in_range));
+  EXPECT_NEAR(nearest.s(), in_range.s(), 1e-6);
+  EXPECT_NEAR(nearest.l(), in_range.l(), 1e-6);
+
+  // only the leg back west is searched, the point is 6m left of it
+  const double west_leg_start_s = reference_line.Length() - 50.0;
+  ASSERT_TRUE(reference_line.XYToSL(xy, west_leg_start_s,
+                                    reference_line.Length(), &in_range));
+  EXPECT_NEAR(west_leg_start_s + 30.0, in_range.s(), 1e-6);
+  EXPECT_NEAR(6.0, in_range.l(), 1e-6);
+}
+
+}  // namespace planning
+}  // namespace apollo
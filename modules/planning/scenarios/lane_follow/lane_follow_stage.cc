@@ -20,10 +20,15 @@
 
 #include "modules/planning/scenarios/lane_follow/lane_follow_stage.h"
 
+#include <chrono>
+#include <future>
 #include <utility>
+#include <vector>
+
+#include "google/protobuf/util/message_differencer.h"
 
 #include "cyber/common/log.h"
-#include "cyber/time/clock.h"
+#include "cyber/task/task.h"
 #include "modules/common/math/math_utils.h"
 #include "modules/common/util/point_factory.h"
 #include "modules/common/util/string_util.h"
@@ -49,12 +54,37 @@ using apollo::common::SLPoint;
 using apollo::common::Status;
 using apollo::common::TrajectoryPoint;
 using apollo::common::util::PointFactory;
-using apollo::cyber::Clock;
+using google::protobuf::util::MessageDifferencer;
 
 namespace {
 constexpr double kPathOptimizationFallbackCost = 2e4;
 constexpr double kSpeedOptimizationFallbackCost = 2e4;
 constexpr double kStraightForwardLineCost = 10.0;
+
+// Apply the statuses `line_status` changed from `initial_status` to `merged`.
+void MergePlanningStatus(const PlanningStatus& initial_status,
+                         const PlanningStatus& line_status,
+                         PlanningStatus* merged) {
+  const auto* descriptor = PlanningStatus::descriptor();
+  const auto* reflection = PlanningStatus::GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const auto* field = descriptor->field(i);
+    const bool has_field = reflection->HasField(line_status, field);
+    if (has_field == reflection->HasField(initial_status, field) &&
+        (!has_field ||
+         MessageDifferencer::Equals(
+             reflection->GetMessage(line_status, field),
+             reflection->GetMessage(initial_status, field)))) {
+      continue;
+    }
+    if (has_field) {
+      reflection->MutableMessage(merged, field)
+          ->CopyFrom(reflection->GetMessage(line_status, field));
+    } else {
+      reflection->ClearField(merged, field);
+    }
+  }
+}
 }  // namespace
 
 LaneFollowStage::LaneFollowStage(
@@ -92,6 +122,17 @@ void LaneFollowStage::RecordObstacleDebugInfo(
 
 Stage::StageStatus LaneFollowStage::Process(
     const TrajectoryPoint& planning_start_point, Frame* frame) {
+  if (FLAGS_enable_parallel_reference_line_planning &&
+      frame->reference_line_info().size() > 1) {
+    if (!FLAGS_enable_lane_change_urgency_checking) {
+      return ProcessInParallel(planning_start_point, frame);
+    }
+    // the urgency check of the rule based stop decider reads and writes the
+    // other reference lines
+    AWARN_EVERY(100) << "Lane change urgency checking is enabled, plan "
+                        "reference lines sequentially.";
+  }
+
   bool has_drivable_reference_line = false;
 
   ADEBUG << "Number of reference lines:\t"
@@ -112,47 +153,152 @@ Stage::StageStatus LaneFollowStage::Process(
       break;
     }
 
+    const auto start_timestamp = std::chrono::steady_clock::now();
     auto cur_status =
         PlanOnReferenceLine(planning_start_point, frame, &reference_line_info);
+    const std::chrono::duration<double, std::milli> planning_time =
+        std::chrono::steady_clock::now() - start_timestamp;
+    reference_line_info.set_planning_time_ms(planning_time.count());
 
-    if (cur_status.ok()) {
-      if (reference_line_info.IsChangeLanePath()) {
-        ADEBUG << "reference line is lane change ref.";
-        ADEBUG << "FLAGS_enable_smarter_lane_change: "
-               << FLAGS_enable_smarter_lane_change;
-        if (reference_line_info.Cost() < kStraightForwardLineCost &&
-            (LaneChangeDecider::IsClearToChangeLane(&reference_line_info) ||
-             FLAGS_enable_smarter_lane_change)) {
-          // If the path and speed optimization succeed on target lane while
-          // under smart lane-change or IsClearToChangeLane under older version
-          has_drivable_reference_line = true;
-          reference_line_info.SetDrivable(true);
-          LaneChangeDecider::UpdatePreparationDistance(
-              true, frame, &reference_line_info, injector_->planning_context());
-          ADEBUG << "\tclear for lane change";
-        } else {
-          LaneChangeDecider::UpdatePreparationDistance(
-              false, frame, &reference_line_info,
-              injector_->planning_context());
-          reference_line_info.SetDrivable(false);
-          ADEBUG << "\tlane change failed";
-        }
-      } else {
-        ADEBUG << "reference line is NOT lane change ref.";
-        has_drivable_reference_line = true;
-      }
-    } else {
-      reference_line_info.SetDrivable(false);
+    has_drivable_reference_line =
+        SelectReferenceLine(cur_status, frame, &reference_line_info);
+  }
+
+  return has_drivable_reference_line ? StageStatus::RUNNING
+                                     : StageStatus::ERROR;
+}
+
+Stage::StageStatus LaneFollowStage::ProcessInParallel(
+    const TrajectoryPoint& planning_start_point, Frame* frame) {
+  ADEBUG << "Number of reference lines planned in parallel:\t"
+         << frame->reference_line_info().size();
+
+  // The leading lane change decider reorders the reference lines of the
+  // frame, so it runs on every line first, in the order the sequential loop
+  // would visit them.
+  size_t num_frame_tasks = 0;
+  while (num_frame_tasks < task_list_.size() &&
+         task_list_[num_frame_tasks]->Config().task_type() ==
+             TaskConfig::LANE_CHANGE_DECIDER) {
+    ++num_frame_tasks;
+  }
+  std::vector<ReferenceLineInfo*> reference_line_infos;
+  std::vector<Status> frame_task_status;
+  unsigned int count = 0;
+  for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
+    if (count++ == frame->mutable_reference_line_info()->size()) {
+      break;
     }
+    auto ret = Status::OK();
+    for (size_t i = 0; i < num_frame_tasks && ret.ok(); ++i) {
+      const auto start_timestamp = std::chrono::steady_clock::now();
+      ret = task_list_[i]->Execute(frame, &reference_line_info);
+      const std::chrono::duration<double, std::milli> time_diff =
+          std::chrono::steady_clock::now() - start_timestamp;
+      RecordDebugInfo(&reference_line_info, task_list_[i]->Name(),
+                      time_diff.count());
+    }
+    reference_line_infos.push_back(&reference_line_info);
+    frame_task_status.push_back(ret);
+  }
+
+  // Every line runs the remaining tasks on its own task instances and its
+  // own copy of the planning context; the first one on the calling thread.
+  const size_t num_lines = reference_line_infos.size();
+  std::vector<Status> status(num_lines);
+  const auto workers = GetReferenceLineWorkers(reference_line_infos);
+  const PlanningStatus initial_status =
+      injector_->planning_context()->planning_status();
+  for (auto* worker : workers) {
+    *worker->injector->planning_context()->mutable_planning_status() =
+        initial_status;
+  }
+  auto plan = [&](size_t i) {
+    const auto start_timestamp = std::chrono::steady_clock::now();
+    const std::vector<Task*> task_list(
+        workers[i]->task_list.begin() + num_frame_tasks,
+        workers[i]->task_list.end());
+    status[i] = PlanOnReferenceLine(planning_start_point, frame,
+                                    reference_line_infos[i], task_list,
+                                    frame_task_status[i]);
+    const std::chrono::duration<double, std::milli> planning_time =
+        std::chrono::steady_clock::now() - start_timestamp;
+    reference_line_infos[i]->set_planning_time_ms(planning_time.count());
+  };
+  std::vector<std::future<void>> results;
+  for (size_t i = 1; i < num_lines; ++i) {
+    results.push_back(cyber::Async(plan, i));
+  }
+  plan(0);
+  for (auto& result : results) {
+    result.get();
+  }
+
+  // Chain the contexts in the order of the sequential loop: the changes
+  // every line made are applied one after another up to the first drivable
+  // line, the lines after it are dropped.
+  PlanningStatus* planning_status =
+      injector_->planning_context()->mutable_planning_status();
+  bool has_drivable_reference_line = false;
+  for (size_t i = 0; i < num_lines; ++i) {
+    if (has_drivable_reference_line) {
+      reference_line_infos[i]->SetDrivable(false);
+      continue;
+    }
+    MergePlanningStatus(
+        initial_status,
+        workers[i]->injector->planning_context()->planning_status(),
+        planning_status);
+    has_drivable_reference_line =
+        SelectReferenceLine(status[i], frame, reference_line_infos[i]);
   }
 
   return has_drivable_reference_line ? StageStatus::RUNNING
                                      : StageStatus::ERROR;
 }
 
+bool LaneFollowStage::IsDrivable(const Status& status,
+                                 ReferenceLineInfo* reference_line_info) const {
+  if (!status.ok()) {
+    return false;
+  }
+  if (!reference_line_info->IsChangeLanePath()) {
+    return true;
+  }
+  // If the path and speed optimization succeed on target lane while
+  // under smart lane-change or IsClearToChangeLane under older version
+  return reference_line_info->Cost() < kStraightForwardLineCost &&
+         (LaneChangeDecider::IsClearToChangeLane(reference_line_info) ||
+          FLAGS_enable_smarter_lane_change);
+}
+
+bool LaneFollowStage::SelectReferenceLine(
+    const Status& status, Frame* frame,
+    ReferenceLineInfo* reference_line_info) {
+  const bool drivable = IsDrivable(status, reference_line_info);
+  if (status.ok() && reference_line_info->IsChangeLanePath()) {
+    ADEBUG << "reference line is lane change ref.";
+    ADEBUG << "FLAGS_enable_smarter_lane_change: "
+           << FLAGS_enable_smarter_lane_change;
+    LaneChangeDecider::UpdatePreparationDistance(
+        drivable, frame, reference_line_info, injector_->planning_context());
+    ADEBUG << (drivable ? "\tclear for lane change" : "\tlane change failed");
+  }
+  reference_line_info->SetDrivable(drivable);
+  return drivable;
+}
+
 Status LaneFollowStage::PlanOnReferenceLine(
     const TrajectoryPoint& planning_start_point, Frame* frame,
     ReferenceLineInfo* reference_line_info) {
+  return PlanOnReferenceLine(planning_start_point, frame, reference_line_info,
+                             task_list_, Status::OK());
+}
+
+Status LaneFollowStage::PlanOnReferenceLine(
+    const TrajectoryPoint& planning_start_point, Frame* frame,
+    ReferenceLineInfo* reference_line_info, const std::vector<Task*>& task_list,
+    const Status& prior_status) {
   if (!reference_line_info->IsChangeLanePath()) {
     reference_line_info->AddCost(kStraightForwardLineCost);
   }
@@ -160,14 +306,18 @@ Status LaneFollowStage::PlanOnReferenceLine(
   ADEBUG << "Current reference_line_info is IsChangeLanePath: "
          << reference_line_info->IsChangeLanePath();
 
-  auto ret = Status::OK();
-  for (auto* task : task_list_) {
-    const double start_timestamp = Clock::NowInSeconds();
+  auto ret = prior_status;
+  for (auto* task : task_list) {
+    if (!ret.ok()) {
+      break;
+    }
+    const auto start_timestamp = std::chrono::steady_clock::now();
 
     ret = task->Execute(frame, reference_line_info);
 
-    const double end_timestamp = Clock::NowInSeconds();
-    const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+    const std::chrono::duration<double, std::milli> time_diff =
+        std::chrono::steady_clock::now() - start_timestamp;
+    const double time_diff_ms = time_diff.count();
     ADEBUG << "after task[" << task->Name()
            << "]:" << reference_line_info->PathSpeedDebugString();
     ADEBUG << task->Name() << " time spend: " << time_diff_ms << " ms.";
@@ -71,6 +71,35 @@ class LaneFollowStage : public Stage {
   void RecordObstacleDebugInfo(ReferenceLineInfo* reference_line_info);
 
  private:
+  /**
+   * @brief Plan all the reference lines at the same time and then pick the
+   * drivable one the same way the sequential loop does.
+   *
+   * Every line starts from the planning context of the previous cycle, not
+   * from the one the lines before it left. The statuses the lines change
+   * are chained in order up to the drivable line afterwards, so the final
+   * context matches the sequential loop unless a line reads a status that
+   * a line before it changed, or two lines change the same status.
+   */
+  StageStatus ProcessInParallel(
+      const common::TrajectoryPoint& planning_start_point, Frame* frame);
+
+  common::Status PlanOnReferenceLine(
+      const common::TrajectoryPoint& planning_start_point, Frame* frame,
+      ReferenceLineInfo* reference_line_info,
+      const std::vector<Task*>& task_list,
+      const common::Status& prior_status);
+
+  bool IsDrivable(const common::Status& status,
+                  ReferenceLineInfo* reference_line_info) const;
+
+  /**
+   * @brief Mark the reference line drivable or not from its planning status
+   * and update the lane change status. Returns whether it is drivable.
+   */
+  bool SelectReferenceLine(const common::Status& status, Frame* frame,
+                           ReferenceLineInfo* reference_line_info);
+
   ScenarioConfig config_;
   std::unique_ptr<Stage> stage_;
 };
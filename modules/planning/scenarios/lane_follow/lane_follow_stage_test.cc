@@ -0,0 +1,197 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/scenarios/lane_follow/lane_follow_stage.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/util/message_differencer.h"
+#include "gtest/gtest.h"
+
+#include "modules/common/util/point_factory.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+namespace scenario {
+namespace lane_follow {
+
+using apollo::common::ErrorCode;
+using apollo::common::Status;
+using apollo::common::util::PointFactory;
+using google::protobuf::util::MessageDifferencer;
+
+namespace {
+
+constexpr char kFailedLine[] = "failed";
+constexpr char kDrivableLine[] = "drivable";
+constexpr char kDroppedLine[] = "dropped";
+constexpr double kLineLength = 50.0;
+
+// A task that changes a different planning status on every line. The failed
+// line is a lane change path that falls back, the drivable line follows its
+// own lane and the line after it must not change the planning status.
+class FakeTask : public Task {
+ public:
+  FakeTask(const TaskConfig& config,
+           const std::shared_ptr<DependencyInjector>& injector)
+      : Task(config, injector) {}
+
+  Status Execute(Frame* frame,
+                 ReferenceLineInfo* reference_line_info) override {
+    Task::Execute(frame, reference_line_info);
+    const auto& reference_line = reference_line_info->reference_line();
+    std::vector<common::PathPoint> path_points;
+    for (double s = 0.0; s <= kLineLength; s += 1.0) {
+      const auto point = reference_line.GetReferencePoint(s);
+      path_points.push_back(
+          PointFactory::ToPathPoint(point.x(), point.y(), 0.0, s));
+    }
+    auto* path_data = reference_line_info->mutable_path_data();
+    path_data->SetReferenceLine(&reference_line);
+    path_data->SetDiscretizedPath(DiscretizedPath(path_points));
+
+    auto* planning_status =
+        injector_->planning_context()->mutable_planning_status();
+    const std::string& id = reference_line_info->Lanes().Id();
+    if (id == kFailedLine) {
+      auto* path_decider = planning_status->mutable_path_decider();
+      path_decider->set_front_static_obstacle_cycle_counter(
+          path_decider->front_static_obstacle_cycle_counter() + 1);
+      return Status(ErrorCode::PLANNING_ERROR, "fake failure");
+    }
+    if (id == kDrivableLine) {
+      planning_status->mutable_destination()->set_has_passed_destination(
+          true);
+    } else {
+      planning_status->mutable_creep_decider()->set_creep_clear_counter(1);
+    }
+    SpeedData speed_data;
+    for (double t = 0.0; t <= 8.0; t += 0.1) {
+      speed_data.AppendSpeedPoint(5.0 * t, t, 5.0, 0.0, 0.0);
+    }
+    *reference_line_info->mutable_speed_data() = speed_data;
+    return Status::OK();
+  }
+};
+
+class TestLaneFollowStage : public LaneFollowStage {
+ public:
+  TestLaneFollowStage(const ScenarioConfig::StageConfig& config,
+                      const std::shared_ptr<DependencyInjector>& injector)
+      : LaneFollowStage(config, injector) {
+    // the constructor of Stage created the registered tasks
+    tasks_.clear();
+    task_list_.clear();
+    CreateTasks(injector_, &tasks_, &task_list_);
+  }
+
+ protected:
+  void CreateTasks(const std::shared_ptr<DependencyInjector>& injector,
+                   std::map<TaskConfig::TaskType, std::unique_ptr<Task>>* tasks,
+                   std::vector<Task*>* task_list) const override {
+    for (const auto& task_config : config().task_config()) {
+      auto task = std::make_unique<FakeTask>(task_config, injector);
+      task_list->push_back(task.get());
+      (*tasks)[task_config.task_type()] = std::move(task);
+    }
+  }
+};
+
+ReferenceLine StraightLine(double y) {
+  std::vector<ReferencePoint> points;
+  for (double x = 0.0; x <= kLineLength + 10.0; x += 1.0) {
+    points.emplace_back(hdmap::MapPathPoint({x, y}, 0.0), 0.0, 0.0);
+  }
+  return ReferenceLine(points);
+}
+
+// Plan the three lines and return the planning status of the stage.
+PlanningStatus Plan(bool parallel, std::vector<bool>* drivable) {
+  ScenarioConfig::StageConfig config;
+  config.set_stage_type(StageType::LANE_FOLLOW_DEFAULT_STAGE);
+  config.add_task_type(TaskConfig::PIECEWISE_JERK_PATH_OPTIMIZER);
+  config.add_task_config()->set_task_type(
+      TaskConfig::PIECEWISE_JERK_PATH_OPTIMIZER);
+
+  auto injector = std::make_shared<DependencyInjector>();
+  injector->planning_context()
+      ->mutable_planning_status()
+      ->mutable_path_decider()
+      ->set_front_static_obstacle_cycle_counter(1);
+  TestLaneFollowStage stage(config, injector);
+
+  common::TrajectoryPoint start_point;
+  *start_point.mutable_path_point() = PointFactory::ToPathPoint(0.0, 0.0);
+  Frame frame(1);
+  double y = 3.5;
+  for (const char* id : {kFailedLine, kDrivableLine, kDroppedLine}) {
+    hdmap::RouteSegments segments;
+    segments.SetId(id);
+    segments.SetIsOnSegment(std::string(id) != kFailedLine);
+    frame.mutable_reference_line_info()->emplace_back(
+        common::VehicleState(), start_point, StraightLine(y), segments);
+    y -= 3.5;
+  }
+
+  const bool enable_parallel_reference_line_planning =
+      FLAGS_enable_parallel_reference_line_planning;
+  FLAGS_enable_parallel_reference_line_planning = parallel;
+  EXPECT_EQ(stage.Process(start_point, &frame), Stage::RUNNING);
+  FLAGS_enable_parallel_reference_line_planning =
+      enable_parallel_reference_line_planning;
+
+  for (const auto& reference_line_info : frame.reference_line_info()) {
+    drivable->push_back(reference_line_info.IsDrivable());
+  }
+  return injector->planning_context()->planning_status();
+}
+
+}  // namespace
+
+TEST(LaneFollowStageTest, ParallelSameAsSequentialAfterFailedLine) {
+  const bool enable_lane_change_urgency_checking =
+      FLAGS_enable_lane_change_urgency_checking;
+  FLAGS_enable_lane_change_urgency_checking = false;
+  std::vector<bool> expected_drivable;
+  const PlanningStatus expected = Plan(false, &expected_drivable);
+  std::vector<bool> drivable;
+  const PlanningStatus planning_status = Plan(true, &drivable);
+  FLAGS_enable_lane_change_urgency_checking =
+      enable_lane_change_urgency_checking;
+
+  EXPECT_EQ(expected_drivable, std::vector<bool>({false, true, false}));
+  EXPECT_EQ(drivable, expected_drivable);
+  // the failed line and the drivable line both count, the dropped one not
+  EXPECT_EQ(expected.path_decider().front_static_obstacle_cycle_counter(), 2);
+  EXPECT_TRUE(expected.destination().has_passed_destination());
+  EXPECT_FALSE(expected.change_lane().is_current_opt_succeed());
+  EXPECT_FALSE(expected.has_creep_decider());
+  EXPECT_TRUE(MessageDifferencer::Equals(planning_status, expected))
+      << "sequential: " << expected.DebugString()
+      << "parallel: " << planning_status.DebugString();
+}
+
+}  // namespace lane_follow
+}  // namespace scenario
+}  // namespace planning
+}  // namespace apollo
@@ -20,9 +20,12 @@
 
 #include "modules/planning/scenarios/stage.h"
 
+#include <chrono>
 #include <unordered_map>
 #include <utility>
 
+#include "absl/strings/str_cat.h"
+
 #include "cyber/time/clock.h"
 #include "modules/planning/common/planning_context.h"
 #include "modules/planning/common/speed_profile_generator.h"
@@ -52,6 +55,13 @@ Stage::Stage(const ScenarioConfig::StageConfig& config,
 
   name_ = StageType_Name(config_.stage_type());
   next_stage_ = config_.stage_type();
+  CreateTasks(injector_, &tasks_, &task_list_);
+}
+
+void Stage::CreateTasks(
+    const std::shared_ptr<DependencyInjector>& injector,
+    std::map<TaskConfig::TaskType, std::unique_ptr<Task>>* tasks,
+    std::vector<Task*>* task_list) const {
   std::unordered_map<TaskConfig::TaskType, const TaskConfig*, std::hash<int>>
       config_map;
   for (const auto& task_config : config_.task_config()) {
@@ -62,15 +72,42 @@ Stage::Stage(const ScenarioConfig::StageConfig& config,
     ACHECK(config_map.find(task_type) != config_map.end())
         << "Task: " << TaskConfig::TaskType_Name(task_type)
         << " used but not configured";
-    auto iter = tasks_.find(task_type);
-    if (iter == tasks_.end()) {
-      auto ptr = TaskFactory::CreateTask(*config_map[task_type], injector_);
-      task_list_.push_back(ptr.get());
-      tasks_[task_type] = std::move(ptr);
+    auto iter = tasks->find(task_type);
+    if (iter == tasks->end()) {
+      auto ptr = TaskFactory::CreateTask(*config_map[task_type], injector);
+      task_list->push_back(ptr.get());
+      (*tasks)[task_type] = std::move(ptr);
+    } else {
+      task_list->push_back(iter->second.get());
+    }
+  }
+}
+
+std::vector<Stage::ReferenceLineWorker*> Stage::GetReferenceLineWorkers(
+    const std::vector<ReferenceLineInfo*>& reference_line_infos) {
+  std::unordered_map<std::string, std::unique_ptr<ReferenceLineWorker>>
+      workers;
+  std::vector<ReferenceLineWorker*> result;
+  for (size_t i = 0; i < reference_line_infos.size(); ++i) {
+    std::string key = reference_line_infos[i]->Lanes().Id();
+    if (key.empty() || workers.count(key) > 0) {
+      // not a stable key, fall back to the position of the line
+      key = absl::StrCat(key, "#", i);
+    }
+    auto iter = workers_.find(key);
+    std::unique_ptr<ReferenceLineWorker> worker;
+    if (iter != workers_.end()) {
+      worker = std::move(iter->second);
     } else {
-      task_list_.push_back(iter->second.get());
+      worker = std::make_unique<ReferenceLineWorker>();
+      worker->injector = injector_->Fork();
+      CreateTasks(worker->injector, &worker->tasks, &worker->task_list);
     }
+    result.push_back(worker.get());
+    workers.emplace(key, std::move(worker));
   }
+  workers_ = std::move(workers);
+  return result;
 }
 
 const std::string& Stage::Name() const { return name_; }
@@ -93,12 +130,13 @@ bool Stage::ExecuteTaskOnReferenceLine(
     }
 
     for (auto* task : task_list_) {
-      const double start_timestamp = Clock::NowInSeconds();
+      const auto start_timestamp = std::chrono::steady_clock::now();
 
       const auto ret = task->Execute(frame, &reference_line_info);
 
-      const double end_timestamp = Clock::NowInSeconds();
-      const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+      const std::chrono::duration<double, std::milli> time_diff =
+          std::chrono::steady_clock::now() - start_timestamp;
+      const double time_diff_ms = time_diff.count();
       ADEBUG << "after task[" << task->Name()
              << "]: " << reference_line_info.PathSpeedDebugString();
       ADEBUG << task->Name() << " time spend: " << time_diff_ms << " ms.";
@@ -145,12 +183,13 @@ bool Stage::ExecuteTaskOnReferenceLineForOnlineLearning(
   auto& picked_reference_line_info =
       frame->mutable_reference_line_info()->front();
   for (auto* task : task_list_) {
-    const double start_timestamp = Clock::NowInSeconds();
+    const auto start_timestamp = std::chrono::steady_clock::now();
 
     const auto ret = task->Execute(frame, &picked_reference_line_info);
 
-    const double end_timestamp = Clock::NowInSeconds();
-    const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+    const std::chrono::duration<double, std::milli> time_diff =
+        std::chrono::steady_clock::now() - start_timestamp;
+    const double time_diff_ms = time_diff.count();
     ADEBUG << "task[" << task->Name() << "] time spent: " << time_diff_ms
            << " ms.";
     RecordDebugInfo(&picked_reference_line_info, task->Name(), time_diff_ms);
@@ -23,6 +23,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "modules/planning/proto/planning_config.pb.h"
@@ -95,6 +96,35 @@ class Stage {
   void RecordDebugInfo(ReferenceLineInfo* reference_line_info,
                        const std::string& name, const double time_diff_ms);
 
+  /**
+   * @brief Own instances of the stage tasks, for planning one reference line
+   * at the same time as others. The injector is forked from the stage one,
+   * so the tasks write their own copy of the planning context.
+   */
+  struct ReferenceLineWorker {
+    std::shared_ptr<DependencyInjector> injector;
+    std::map<TaskConfig::TaskType, std::unique_ptr<Task>> tasks;
+    std::vector<Task*> task_list;
+  };
+
+  /**
+   * @brief One worker per given reference line. Workers are keyed by the id
+   * of the route segments of the line, so a line keeps its task instances,
+   * and the solver state they carry across cycles, while the lines of the
+   * frame are reordered, added or dropped. Workers of lines that are no
+   * longer given are released.
+   */
+  std::vector<ReferenceLineWorker*> GetReferenceLineWorkers(
+      const std::vector<ReferenceLineInfo*>& reference_line_infos);
+
+  /**
+   * @brief Create the tasks of the stage config with `injector`.
+   */
+  virtual void CreateTasks(
+      const std::shared_ptr<DependencyInjector>& injector,
+      std::map<TaskConfig::TaskType, std::unique_ptr<Task>>* tasks,
+      std::vector<Task*>* task_list) const;
+
  protected:
   std::map<TaskConfig::TaskType, std::unique_ptr<Task>> tasks_;
   std::vector<Task*> task_list_;
@@ -103,6 +133,10 @@ class Stage {
   void* context_ = nullptr;
   std::string name_;
   std::shared_ptr<DependencyInjector> injector_;
+
+ private:
+  std::unordered_map<std::string, std::unique_ptr<ReferenceLineWorker>>
+      workers_;
 };
 
 #define DECLARE_STAGE(NAME, CONTEXT)                          \
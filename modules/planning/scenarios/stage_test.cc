@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/scenarios/stage.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+namespace scenario {
+
+namespace {
+
+class TestStage : public Stage {
+ public:
+  TestStage(const ScenarioConfig::StageConfig& config,
+            const std::shared_ptr<DependencyInjector>& injector)
+      : Stage(config, injector) {}
+
+  using Stage::GetReferenceLineWorkers;
+
+  StageStatus Process(const common::TrajectoryPoint& planning_init_point,
+                      Frame* frame) override {
+    return StageStatus::RUNNING;
+  }
+};
+
+std::unique_ptr<ReferenceLineInfo> MakeReferenceLineInfo(
+    const std::string& id) {
+  hdmap::RouteSegments segments;
+  segments.SetId(id);
+  return std::make_unique<ReferenceLineInfo>(common::VehicleState(),
+                                             common::TrajectoryPoint(),
+                                             ReferenceLine(), segments);
+}
+
+}  // namespace
+
+TEST(StageTest, ReferenceLineWorkersKeyedByLine) {
+  ScenarioConfig::StageConfig config;
+  config.set_stage_type(StageType::LANE_FOLLOW_DEFAULT_STAGE);
+  auto injector = std::make_shared<DependencyInjector>();
+  TestStage stage(config, injector);
+
+  auto line_a = MakeReferenceLineInfo("1_0");
+  auto line_b = MakeReferenceLineInfo("1_1");
+  const auto workers =
+      stage.GetReferenceLineWorkers({line_a.get(), line_b.get()});
+  ASSERT_EQ(2, workers.size());
+  EXPECT_NE(workers[0], workers[1]);
+  for (const auto* worker : workers) {
+    ASSERT_NE(nullptr, worker->injector);
+    EXPECT_NE(injector->planning_context(),
+              worker->injector->planning_context());
+  }
+
+  // the lines of the next frame are reordered, each keeps its worker
+  const auto reordered =
+      stage.GetReferenceLineWorkers({line_b.get(), line_a.get()});
+  ASSERT_EQ(2, reordered.size());
+  EXPECT_EQ(workers[1], reordered[0]);
+  EXPECT_EQ(workers[0], reordered[1]);
+
+  // a new line gets a new worker, the kept line its old one
+  auto line_c = MakeReferenceLineInfo("2_0");
+  const auto changed =
+      stage.GetReferenceLineWorkers({line_c.get(), line_b.get()});
+  ASSERT_EQ(2, changed.size());
+  EXPECT_NE(workers[0], changed[0]);
+  EXPECT_NE(workers[1], changed[0]);
+  EXPECT_EQ(workers[1], changed[1]);
+}
+
+TEST(StageTest, ReferenceLineWorkersWithoutIds) {
+  ScenarioConfig::StageConfig config;
+  config.set_stage_type(StageType::LANE_FOLLOW_DEFAULT_STAGE);
+  TestStage stage(config, std::make_shared<DependencyInjector>());
+
+  auto line_a = MakeReferenceLineInfo("");
+  auto line_b = MakeReferenceLineInfo("");
+  auto line_c = MakeReferenceLineInfo("1_0");
+  auto line_d = MakeReferenceLineInfo("1_0");
+  const auto workers = stage.GetReferenceLineWorkers(
+      {line_a.get(), line_b.get(), line_c.get(), line_d.get()});
+  ASSERT_EQ(4, workers.size());
+  for (size_t i = 0; i < workers.size(); ++i) {
+    for (size_t j = i + 1; j < workers.size(); ++j) {
+      EXPECT_NE(workers[i], workers[j]);
+    }
+  }
+}
+
+}  // namespace scenario
+}  // namespace planning
+}  // namespace apollo
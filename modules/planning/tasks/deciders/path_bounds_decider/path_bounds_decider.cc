@@ -302,6 +302,10 @@ void PathBoundsDecider::InitPathBoundsDecider(
   } else {
     adc_lane_width_ = lane_left_width + lane_right_width;
   }
+
+  // Obstacle edges, shared by all the path bounds of this reference line.
+  sorted_obstacles_ = SortObstaclesForSweepLine(
+      reference_line_info.path_decision().obstacles());
 }
 
 common::TrajectoryPoint PathBoundsDecider::InferFrontAxeCenterFromRearAxeCenter(
@@ -347,8 +351,8 @@ Status PathBoundsDecider::GenerateRegularPathBound(
 
   // 3. Fine-tune the boundary based on static obstacles
   PathBound temp_path_bound = *path_bound;
-  if (!GetBoundaryFromStaticObstacles(reference_line_info.path_decision(),
-                                      path_bound, blocking_obstacle_id)) {
+  if (!GetBoundaryFromStaticObstacles(sorted_obstacles_, path_bound,
+                                      blocking_obstacle_id)) {
     const std::string msg =
         "Failed to decide fine tune the boundaries after "
         "taking into consideration all static obstacles.";
@@ -401,8 +405,8 @@ Status PathBoundsDecider::GenerateLaneChangePathBound(
 
   PathBound temp_path_bound = *path_bound;
   std::string blocking_obstacle_id;
-  if (!GetBoundaryFromStaticObstacles(reference_line_info.path_decision(),
-                                      path_bound, &blocking_obstacle_id)) {
+  if (!GetBoundaryFromStaticObstacles(sorted_obstacles_, path_bound,
+                                      &blocking_obstacle_id)) {
     const std::string msg =
         "Failed to decide fine tune the boundaries after "
         "taking into consideration all static obstacles.";
@@ -458,8 +462,8 @@ Status PathBoundsDecider::GeneratePullOverPathBound(
   // 3. Fine-tune the boundary based on static obstacles
   PathBound temp_path_bound = *path_bound;
   std::string blocking_obstacle_id;
-  if (!GetBoundaryFromStaticObstacles(reference_line_info.path_decision(),
-                                      path_bound, &blocking_obstacle_id)) {
+  if (!GetBoundaryFromStaticObstacles(sorted_obstacles_, path_bound,
+                                      &blocking_obstacle_id)) {
     const std::string msg =
         "Failed to decide fine tune the boundaries after "
         "taking into consideration all static obstacles.";
@@ -1405,11 +1409,8 @@ void PathBoundsDecider::GetBoundaryFromLaneChangeForbiddenZone(
 // obstacles whose headings differ from road-headings a lot.
 // TODO(all): (future work) this can be improved in the future.
 bool PathBoundsDecider::GetBoundaryFromStaticObstacles(
-    const PathDecision& path_decision, PathBound* const path_boundaries,
-    std::string* const blocking_obstacle_id) {
-  // Preprocessing.
-  auto indexed_obstacles = path_decision.obstacles();
-  auto sorted_obstacles = SortObstaclesForSweepLine(indexed_obstacles);
+    const std::vector<ObstacleEdge>& sorted_obstacles,
+    PathBound* const path_boundaries, std::string* const blocking_obstacle_id) {
   ADEBUG << "There are " << sorted_obstacles.size() << " obstacles.";
   double center_line = adc_frenet_l_;
   size_t obs_idx = 0;
@@ -1437,7 +1438,7 @@ bool PathBoundsDecider::GetBoundaryFromStaticObstacles(
         const double curr_obstacle_s = std::get<1>(curr_obstacle);
         const double curr_obstacle_l_min = std::get<2>(curr_obstacle);
         const double curr_obstacle_l_max = std::get<3>(curr_obstacle);
-        const std::string curr_obstacle_id = std::get<4>(curr_obstacle);
+        const std::string& curr_obstacle_id = std::get<4>(curr_obstacle);
         ADEBUG << "id[" << curr_obstacle_id << "] s[" << curr_obstacle_s
                << "] curr_obstacle_l_min[" << curr_obstacle_l_min
                << "] curr_obstacle_l_max[" << curr_obstacle_l_max
@@ -216,9 +216,11 @@ class PathBoundsDecider : public Decider {
   /** @brief Refine the boundary based on static obstacles. It will make sure
    *   the boundary doesn't contain any static obstacle so that the path
    *   generated by optimizer won't collide with any static obstacle.
+   * @param sorted_obstacles The obstacle edges from SortObstaclesForSweepLine.
    */
   bool GetBoundaryFromStaticObstacles(
-      const PathDecision& path_decision,
+      const std::vector<std::tuple<int, double, double, double, std::string>>&
+          sorted_obstacles,
       std::vector<std::tuple<double, double, double>>* const path_boundaries,
       std::string* const blocking_obstacle_id);
 
@@ -316,6 +318,10 @@ class PathBoundsDecider : public Decider {
   double adc_frenet_ld_ = 0.0;
   double adc_l_to_lane_center_ = 0.0;
   double adc_lane_width_ = 0.0;
+  // The start/end s edges of the static obstacles on the reference line,
+  // sorted once in InitPathBoundsDecider and swept by every candidate bound.
+  std::vector<std::tuple<int, double, double, double, std::string>>
+      sorted_obstacles_;
 
   FRIEND_TEST(PathBoundsDeciderTest, InitPathBoundary);
   FRIEND_TEST(PathBoundsDeciderTest, GetBoundaryFromLanesAndADC);
@@ -20,6 +20,7 @@
 #include "modules/planning/tasks/deciders/path_reuse_decider/path_reuse_decider.h"
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -34,9 +35,8 @@ using apollo::common::Status;
 using apollo::common::math::Polygon2d;
 using apollo::common::math::Vec2d;
 
-int PathReuseDecider::reusable_path_counter_ = 0;
-int PathReuseDecider::total_path_counter_ = 0;
-bool PathReuseDecider::path_reusable_ = false;
+std::atomic<int> PathReuseDecider::reusable_path_counter_(0);
+std::atomic<int> PathReuseDecider::total_path_counter_(0);
 
 PathReuseDecider::PathReuseDecider(
     const TaskConfig& config,
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -74,9 +75,13 @@ class PathReuseDecider : public Decider {
                        ReferenceLineInfo* const reference_line_info);
 
  private:
-  static int reusable_path_counter_;  // count reused path
-  static int total_path_counter_;     // count total path
-  static bool path_reusable_;
+  // shared by the tasks of all stage workers, which may run on different
+  // reference lines in parallel
+  static std::atomic<int> reusable_path_counter_;  // count reused path
+  static std::atomic<int> total_path_counter_;     // count total path
+  // kept across cycles by the task instance, which plans one reference line
+  // when the stage workers run in parallel
+  bool path_reusable_ = false;
 };
 
 }  // namespace planning
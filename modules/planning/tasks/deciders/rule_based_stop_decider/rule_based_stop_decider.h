@@ -71,6 +71,11 @@ class RuleBasedStopDecider : public Decider {
   RuleBasedStopDeciderConfig rule_based_stop_decider_config_;
   bool is_clear_to_change_lane_ = false;
   bool is_change_lane_planning_succeed_ = false;
+  // side pass stop state kept across cycles, owned by the task instance so
+  // that the stage workers planning reference lines in parallel do not share
+  // it
+  bool check_clear_ = false;
+  common::PathPoint change_lane_stop_path_point_;
 };
 }  // namespace planning
 }  // namespace apollo
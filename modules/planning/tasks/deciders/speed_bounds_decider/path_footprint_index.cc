@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/tasks/deciders/speed_bounds_decider/path_footprint_index.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Box2d;
+
+namespace {
+// Consecutive footprints overlap heavily, small runs keep the run bounding
+// boxes tight on curved paths.
+constexpr size_t kBlockSize = 8;
+}  // namespace
+
+PathFootprintIndex::PathFootprintIndex(std::vector<Box2d> footprints)
+    : footprints_(std::move(footprints)) {
+  for (size_t begin = 0; begin < footprints_.size(); begin += kBlockSize) {
+    Block block;
+    block.begin = begin;
+    block.end = std::min(begin + kBlockSize, footprints_.size());
+    block.min_x = footprints_[begin].min_x();
+    block.max_x = footprints_[begin].max_x();
+    block.min_y = footprints_[begin].min_y();
+    block.max_y = footprints_[begin].max_y();
+    for (size_t i = begin + 1; i < block.end; ++i) {
+      block.min_x = std::min(block.min_x, footprints_[i].min_x());
+      block.max_x = std::max(block.max_x, footprints_[i].max_x());
+      block.min_y = std::min(block.min_y, footprints_[i].min_y());
+      block.max_y = std::max(block.max_y, footprints_[i].max_y());
+    }
+    blocks_.push_back(block);
+  }
+  if (!blocks_.empty()) {
+    corridor_ = blocks_.front();
+    for (const auto& block : blocks_) {
+      corridor_.min_x = std::min(corridor_.min_x, block.min_x);
+      corridor_.max_x = std::max(corridor_.max_x, block.max_x);
+      corridor_.min_y = std::min(corridor_.min_y, block.min_y);
+      corridor_.max_y = std::max(corridor_.max_y, block.max_y);
+    }
+  }
+}
+
+int PathFootprintIndex::FirstOverlap(const Box2d& box, size_t start) const {
+  if (blocks_.empty() || Disjoint(corridor_, box)) {
+    return -1;
+  }
+  for (size_t b = start / kBlockSize; b < blocks_.size(); ++b) {
+    const Block& block = blocks_[b];
+    if (Disjoint(block, box)) {
+      continue;
+    }
+    // Same call as STBoundaryMapper::CheckOverlap so the result is
+    // bit-identical to the exhaustive scan.
+    for (size_t i = std::max(start, block.begin); i < block.end; ++i) {
+      if (box.HasOverlap(footprints_[i])) {
+        return static_cast<int>(i);
+      }
+    }
+  }
+  return -1;
+}
+
+}  // namespace planning
+}  // namespace apollo
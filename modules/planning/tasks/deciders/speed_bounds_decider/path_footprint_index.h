@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "modules/common/math/box2d.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class PathFootprintIndex
+ * @brief The ADC footprints swept along a path, grouped into runs of
+ * consecutive footprints with a shared axis aligned bounding box. A query
+ * skips every run whose bounding box misses the obstacle box and only runs
+ * the exact Box2d overlap check on the remaining footprints, in path order.
+ */
+class PathFootprintIndex {
+ public:
+  PathFootprintIndex() = default;
+
+  explicit PathFootprintIndex(std::vector<common::math::Box2d> footprints);
+
+  /**
+   * @brief Find the first footprint at or after start that overlaps box.
+   * @return the footprint index, -1 if there is none.
+   */
+  int FirstOverlap(const common::math::Box2d& box, size_t start = 0) const;
+
+  size_t size() const { return footprints_.size(); }
+
+  const common::math::Box2d& footprint(size_t index) const {
+    return footprints_[index];
+  }
+
+ private:
+  struct Block {
+    size_t begin = 0;
+    size_t end = 0;
+    double min_x = 0.0;
+    double max_x = 0.0;
+    double min_y = 0.0;
+    double max_y = 0.0;
+  };
+
+  static bool Disjoint(const Block& block, const common::math::Box2d& box) {
+    return box.max_x() < block.min_x || box.min_x() > block.max_x ||
+           box.max_y() < block.min_y || box.min_y() > block.max_y;
+  }
+
+  std::vector<common::math::Box2d> footprints_;
+  std::vector<Block> blocks_;
+  // bounding box of the whole corridor
+  Block corridor_;
+};
+
+}  // namespace planning
+}  // namespace apollo
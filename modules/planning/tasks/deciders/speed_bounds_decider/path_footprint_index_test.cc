@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/planning/tasks/deciders/speed_bounds_decider/path_footprint_index.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+// footprints along a quarter circle of radius 50m, one every meter
+std::vector<Box2d> ArcFootprints() {
+  std::vector<Box2d> footprints;
+  for (int i = 0; i < 79; ++i) {
+    const double theta = i / 50.0;
+    footprints.emplace_back(
+        Vec2d(50.0 * std::sin(theta), 50.0 * (1.0 - std::cos(theta))), theta,
+        4.9, 2.9);
+  }
+  return footprints;
+}
+
+int ExhaustiveFirstOverlap(const std::vector<Box2d>& footprints,
+                           const Box2d& box, size_t start) {
+  for (size_t i = start; i < footprints.size(); ++i) {
+    if (box.HasOverlap(footprints[i])) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+TEST(PathFootprintIndexTest, Empty) {
+  PathFootprintIndex index;
+  EXPECT_EQ(index.size(), 0);
+  EXPECT_EQ(index.FirstOverlap(Box2d(Vec2d(0.0, 0.0), 0.0, 1.0, 1.0)), -1);
+}
+
+TEST(PathFootprintIndexTest, FirstOverlap) {
+  PathFootprintIndex index(ArcFootprints());
+  ASSERT_EQ(index.size(), 79);
+  EXPECT_EQ(index.FirstOverlap(Box2d(Vec2d(0.0, 0.0), 0.0, 1.0, 1.0)), 0);
+  EXPECT_EQ(index.FirstOverlap(Box2d(Vec2d(0.0, 0.0), 0.0, 1.0, 1.0), 5),
+            -1);
+  EXPECT_EQ(index.FirstOverlap(Box2d(Vec2d(0.0, 20.0), 0.0, 4.0, 2.0)), -1);
+  EXPECT_EQ(index.FirstOverlap(Box2d(Vec2d(100.0, 0.0), 0.0, 4.0, 2.0)), -1);
+}
+
+TEST(PathFootprintIndexTest, SameAsExhaustiveScan) {
+  const auto footprints = ArcFootprints();
+  PathFootprintIndex index(footprints);
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> xy_dist(-10.0, 60.0);
+  std::uniform_real_distribution<double> heading_dist(-M_PI, M_PI);
+  std::uniform_int_distribution<size_t> start_dist(0, footprints.size());
+  int num_overlaps = 0;
+  for (int i = 0; i < 10000; ++i) {
+    const Box2d box(Vec2d(xy_dist(rng), xy_dist(rng)), heading_dist(rng), 4.5,
+                    1.9);
+    const size_t start = i % 2 == 0 ? 0 : start_dist(rng);
+    const int expected = ExhaustiveFirstOverlap(footprints, box, start);
+    EXPECT_EQ(index.FirstOverlap(box, start), expected);
+    num_overlaps += expected >= 0 ? 1 : 0;
+  }
+  EXPECT_GT(num_overlaps, 100);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -48,6 +48,26 @@ using apollo::common::Status;
 using apollo::common::math::Box2d;
 using apollo::common::math::Vec2d;
 
+namespace {
+
+constexpr int kDefaultNumPoint = 50;
+
+DiscretizedPath SubsamplePath(const std::vector<PathPoint>& path_points) {
+  if (path_points.size() > 2 * kDefaultNumPoint) {
+    const auto ratio = path_points.size() / kDefaultNumPoint;
+    std::vector<PathPoint> sampled_path_points;
+    for (size_t i = 0; i < path_points.size(); ++i) {
+      if (i % ratio == 0) {
+        sampled_path_points.push_back(path_points[i]);
+      }
+    }
+    return DiscretizedPath(std::move(sampled_path_points));
+  }
+  return DiscretizedPath(path_points);
+}
+
+}  // namespace
+
 STBoundaryMapper::STBoundaryMapper(
     const SpeedBoundsDeciderConfig& config, const ReferenceLine& reference_line,
     const PathData& path_data, const double planning_distance,
@@ -209,6 +229,11 @@ bool STBoundaryMapper::GetOverlapBoundaryPoints(
           ? FLAGS_lane_change_obstacle_nudge_l_buffer
           : FLAGS_nonstatic_obstacle_nudge_l_buffer;
 
+  const FootprintCorridor* corridor =
+      FLAGS_enable_st_boundary_footprint_index
+          ? &GetFootprintCorridor(path_points, l_buffer)
+          : nullptr;
+
   // Draw the given obstacle on the ST-graph.
   const auto& trajectory = obstacle.Trajectory();
   if (trajectory.trajectory_point().empty()) {
@@ -219,47 +244,46 @@ bool STBoundaryMapper::GetOverlapBoundaryPoints(
             << "] has NO prediction trajectory."
             << obstacle.Perception().ShortDebugString();
     }
-    for (const auto& curr_point_on_path : path_points) {
-      if (curr_point_on_path.s() > planning_max_distance_) {
-        break;
-      }
-
-      const Box2d& obs_box = obstacle.PerceptionBoundingBox();
-      if (CheckOverlap(curr_point_on_path, obs_box, l_buffer)) {
-        // If there is overlapping, then plot it on ST-graph.
-        const double backward_distance = -vehicle_param_.front_edge_to_center();
-        const double forward_distance = obs_box.length();
-        double low_s =
-            std::fmax(0.0, curr_point_on_path.s() + backward_distance);
-        double high_s = std::fmin(planning_max_distance_,
-                                  curr_point_on_path.s() + forward_distance);
-        // It is an unrotated rectangle appearing on the ST-graph.
-        // TODO(jiacheng): reconsider the backward_distance, it might be
-        // unnecessary, but forward_distance is indeed meaningful though.
-        lower_points->emplace_back(low_s, 0.0);
-        lower_points->emplace_back(low_s, planning_max_time_);
-        upper_points->emplace_back(high_s, 0.0);
-        upper_points->emplace_back(high_s, planning_max_time_);
-        break;
+    const Box2d& obs_box = obstacle.PerceptionBoundingBox();
+    int overlap_index = -1;
+    if (corridor != nullptr) {
+      overlap_index = corridor->path_index.FirstOverlap(obs_box);
+    } else {
+      for (size_t i = 0; i < path_points.size(); ++i) {
+        if (path_points[i].s() > planning_max_distance_) {
+          break;
+        }
+        if (CheckOverlap(path_points[i], obs_box, l_buffer)) {
+          overlap_index = static_cast<int>(i);
+          break;
+        }
       }
     }
+    if (overlap_index >= 0) {
+      // If there is overlapping, then plot it on ST-graph.
+      const auto& curr_point_on_path = path_points[overlap_index];
+      const double backward_distance = -vehicle_param_.front_edge_to_center();
+      const double forward_distance = obs_box.length();
+      double low_s = std::fmax(0.0, curr_point_on_path.s() + backward_distance);
+      double high_s = std::fmin(planning_max_distance_,
+                                curr_point_on_path.s() + forward_distance);
+      // It is an unrotated rectangle appearing on the ST-graph.
+      // TODO(jiacheng): reconsider the backward_distance, it might be
+      // unnecessary, but forward_distance is indeed meaningful though.
+      lower_points->emplace_back(low_s, 0.0);
+      lower_points->emplace_back(low_s, planning_max_time_);
+      upper_points->emplace_back(high_s, 0.0);
+      upper_points->emplace_back(high_s, planning_max_time_);
+    }
   } else {
     // For those with predicted trajectories (moving obstacles):
     // 1. Subsample to reduce computation time.
-    const int default_num_point = 50;
-    DiscretizedPath discretized_path;
-    if (path_points.size() > 2 * default_num_point) {
-      const auto ratio = path_points.size() / default_num_point;
-      std::vector<PathPoint> sampled_path_points;
-      for (size_t i = 0; i < path_points.size(); ++i) {
-        if (i % ratio == 0) {
-          sampled_path_points.push_back(path_points[i]);
-        }
-      }
-      discretized_path = DiscretizedPath(std::move(sampled_path_points));
-    } else {
-      discretized_path = DiscretizedPath(path_points);
+    DiscretizedPath subsampled_path;
+    if (corridor == nullptr) {
+      subsampled_path = SubsamplePath(path_points);
     }
+    const DiscretizedPath& discretized_path =
+        corridor != nullptr ? corridor->sampled_path : subsampled_path;
     // 2. Go through every point of the predicted obstacle trajectory.
     for (int i = 0; i < trajectory.trajectory_point_size(); ++i) {
       const auto& trajectory_point = trajectory.trajectory_point(i);
@@ -272,63 +296,78 @@ bool STBoundaryMapper::GetOverlapBoundaryPoints(
       }
 
       const double step_length = vehicle_param_.front_edge_to_center();
-      auto path_len =
-          std::min(FLAGS_max_trajectory_len, discretized_path.Length());
       // Go through every point of the ADC's path.
-      for (double path_s = 0.0; path_s < path_len; path_s += step_length) {
-        const auto curr_adc_path_point =
-            discretized_path.Evaluate(path_s + discretized_path.front().s());
-        if (CheckOverlap(curr_adc_path_point, obs_box, l_buffer)) {
-          // Found overlap, start searching with higher resolution
-          const double backward_distance = -step_length;
-          const double forward_distance = vehicle_param_.length() +
-                                          vehicle_param_.width() +
-                                          obs_box.length() + obs_box.width();
-          const double default_min_step = 0.1;  // in meters
-          const double fine_tuning_step_length = std::fmin(
-              default_min_step, discretized_path.Length() / default_num_point);
-
-          bool find_low = false;
-          bool find_high = false;
-          double low_s = std::fmax(0.0, path_s + backward_distance);
-          double high_s =
-              std::fmin(discretized_path.Length(), path_s + forward_distance);
-
-          // Keep shrinking by the resolution bidirectionally until finally
-          // locating the tight upper and lower bounds.
-          while (low_s < high_s) {
-            if (find_low && find_high) {
-              break;
-            }
-            if (!find_low) {
-              const auto& point_low = discretized_path.Evaluate(
-                  low_s + discretized_path.front().s());
-              if (!CheckOverlap(point_low, obs_box, l_buffer)) {
-                low_s += fine_tuning_step_length;
-              } else {
-                find_low = true;
-              }
-            }
-            if (!find_high) {
-              const auto& point_high = discretized_path.Evaluate(
-                  high_s + discretized_path.front().s());
-              if (!CheckOverlap(point_high, obs_box, l_buffer)) {
-                high_s -= fine_tuning_step_length;
-              } else {
-                find_high = true;
-              }
-            }
-          }
-          if (find_high && find_low) {
-            lower_points->emplace_back(
-                low_s - speed_bounds_config_.point_extension(),
-                trajectory_point_time);
-            upper_points->emplace_back(
-                high_s + speed_bounds_config_.point_extension(),
-                trajectory_point_time);
+      bool has_overlap = false;
+      double path_s = 0.0;
+      if (corridor != nullptr) {
+        const int index = corridor->sampled_index.FirstOverlap(obs_box);
+        if (index >= 0) {
+          has_overlap = true;
+          path_s = corridor->sampled_s[index];
+        }
+      } else {
+        auto path_len =
+            std::min(FLAGS_max_trajectory_len, discretized_path.Length());
+        for (; path_s < path_len; path_s += step_length) {
+          const auto curr_adc_path_point =
+              discretized_path.Evaluate(path_s + discretized_path.front().s());
+          if (CheckOverlap(curr_adc_path_point, obs_box, l_buffer)) {
+            has_overlap = true;
+            break;
           }
+        }
+      }
+      if (!has_overlap) {
+        continue;
+      }
+
+      // Found overlap, start searching with higher resolution
+      const double backward_distance = -step_length;
+      const double forward_distance = vehicle_param_.length() +
+                                      vehicle_param_.width() +
+                                      obs_box.length() + obs_box.width();
+      const double default_min_step = 0.1;  // in meters
+      const double fine_tuning_step_length = std::fmin(
+          default_min_step, discretized_path.Length() / kDefaultNumPoint);
+
+      bool find_low = false;
+      bool find_high = false;
+      double low_s = std::fmax(0.0, path_s + backward_distance);
+      double high_s =
+          std::fmin(discretized_path.Length(), path_s + forward_distance);
+
+      // Keep shrinking by the resolution bidirectionally until finally
+      // locating the tight upper and lower bounds.
+      while (low_s < high_s) {
+        if (find_low && find_high) {
           break;
         }
+        if (!find_low) {
+          const auto& point_low =
+              discretized_path.Evaluate(low_s + discretized_path.front().s());
+          if (!CheckOverlap(point_low, obs_box, l_buffer)) {
+            low_s += fine_tuning_step_length;
+          } else {
+            find_low = true;
+          }
+        }
+        if (!find_high) {
+          const auto& point_high =
+              discretized_path.Evaluate(high_s + discretized_path.front().s());
+          if (!CheckOverlap(point_high, obs_box, l_buffer)) {
+            high_s -= fine_tuning_step_length;
+          } else {
+            find_high = true;
+          }
+        }
+      }
+      if (find_high && find_low) {
+        lower_points->emplace_back(
+            low_s - speed_bounds_config_.point_extension(),
+            trajectory_point_time);
+        upper_points->emplace_back(
+            high_s + speed_bounds_config_.point_extension(),
+            trajectory_point_time);
       }
     }
   }
@@ -389,6 +428,12 @@ void STBoundaryMapper::ComputeSTBoundaryWithDecision(
 bool STBoundaryMapper::CheckOverlap(const PathPoint& path_point,
                                     const Box2d& obs_box,
                                     const double l_buffer) const {
+  // Check whether ADC bounding box overlaps with obstacle bounding box.
+  return obs_box.HasOverlap(GetADCBoundingBox(path_point, l_buffer));
+}
+
+Box2d STBoundaryMapper::GetADCBoundingBox(const PathPoint& path_point,
+                                          const double l_buffer) const {
   // Convert reference point from center of rear axis to center of ADC.
   Vec2d ego_center_map_frame((vehicle_param_.front_edge_to_center() -
                               vehicle_param_.back_edge_to_center()) *
@@ -401,11 +446,50 @@ bool STBoundaryMapper::CheckOverlap(const PathPoint& path_point,
   ego_center_map_frame.set_y(ego_center_map_frame.y() + path_point.y());
 
   // Compute the ADC bounding box.
-  Box2d adc_box(ego_center_map_frame, path_point.theta(),
-                vehicle_param_.length(), vehicle_param_.width() + l_buffer * 2);
+  return Box2d(ego_center_map_frame, path_point.theta(),
+               vehicle_param_.length(), vehicle_param_.width() + l_buffer * 2);
+}
 
-  // Check whether ADC bounding box overlaps with obstacle bounding box.
-  return obs_box.HasOverlap(adc_box);
+const STBoundaryMapper::FootprintCorridor&
+STBoundaryMapper::GetFootprintCorridor(
+    const std::vector<PathPoint>& path_points, const double l_buffer) const {
+  if (footprint_corridor_ != nullptr &&
+      footprint_corridor_->path_points == path_points.data() &&
+      footprint_corridor_->num_path_points == path_points.size() &&
+      footprint_corridor_->l_buffer == l_buffer) {
+    return *footprint_corridor_;
+  }
+  auto corridor = std::make_unique<FootprintCorridor>();
+  corridor->path_points = path_points.data();
+  corridor->num_path_points = path_points.size();
+  corridor->l_buffer = l_buffer;
+
+  // The stations are generated exactly like the exhaustive scan in
+  // GetOverlapBoundaryPoints, so the first overlapping one is the same.
+  std::vector<Box2d> footprints;
+  corridor->sampled_path = SubsamplePath(path_points);
+  const auto& sampled_path = corridor->sampled_path;
+  const double step_length = vehicle_param_.front_edge_to_center();
+  const double path_len =
+      std::min(FLAGS_max_trajectory_len, sampled_path.Length());
+  for (double path_s = 0.0; path_s < path_len; path_s += step_length) {
+    corridor->sampled_s.push_back(path_s);
+    footprints.push_back(GetADCBoundingBox(
+        sampled_path.Evaluate(path_s + sampled_path.front().s()), l_buffer));
+  }
+  corridor->sampled_index = PathFootprintIndex(std::move(footprints));
+
+  footprints.clear();
+  for (const auto& path_point : path_points) {
+    if (path_point.s() > planning_max_distance_) {
+      break;
+    }
+    footprints.push_back(GetADCBoundingBox(path_point, l_buffer));
+  }
+  corridor->path_index = PathFootprintIndex(std::move(footprints));
+
+  footprint_corridor_ = std::move(corridor);
+  return *footprint_corridor_;
 }
 
 }  // namespace planning
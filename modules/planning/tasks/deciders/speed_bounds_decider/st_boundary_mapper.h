@@ -30,11 +30,13 @@
 #include "modules/common/status/status.h"
 #include "modules/planning/common/dependency_injector.h"
 #include "modules/planning/common/obstacle.h"
+#include "modules/planning/common/path/discretized_path.h"
 #include "modules/planning/common/path/path_data.h"
 #include "modules/planning/common/path_decision.h"
 #include "modules/planning/common/speed/st_boundary.h"
 #include "modules/planning/common/speed_limit.h"
 #include "modules/planning/reference_line/reference_line.h"
+#include "modules/planning/tasks/deciders/speed_bounds_decider/path_footprint_index.h"
 
 namespace apollo {
 namespace planning {
@@ -53,6 +55,23 @@ class STBoundaryMapper {
 
  private:
   FRIEND_TEST(StBoundaryMapperTest, check_overlap_test);
+  FRIEND_TEST(StBoundaryMapperTest, footprint_index_test);
+
+  /** @brief The ADC footprints along a path for one lateral buffer. They
+   * only depend on the path, so they are built once and shared by every
+   * obstacle instead of being regenerated per trajectory point.
+   */
+  struct FootprintCorridor {
+    const common::PathPoint* path_points = nullptr;
+    size_t num_path_points = 0;
+    double l_buffer = 0.0;
+    // subsampled path and coarse search stations for moving obstacles
+    DiscretizedPath sampled_path;
+    std::vector<double> sampled_s;
+    PathFootprintIndex sampled_index;
+    // path points within the planning distance for static obstacles
+    PathFootprintIndex path_index;
+  };
 
   /** @brief Calls GetOverlapBoundaryPoints to get upper and lower points
    * for a given obstacle, and then formulate STBoundary based on that.
@@ -79,6 +98,16 @@ class STBoundaryMapper {
                     const common::math::Box2d& obs_box,
                     const double l_buffer) const;
 
+  /** @brief The ADC bounding box at a path-point, widened by l_buffer on
+   * both sides.
+   */
+  common::math::Box2d GetADCBoundingBox(const common::PathPoint& path_point,
+                                        const double l_buffer) const;
+
+  const FootprintCorridor& GetFootprintCorridor(
+      const std::vector<common::PathPoint>& path_points,
+      const double l_buffer) const;
+
   /** @brief Maps the closest STOP decision onto the ST-graph. This STOP
    * decision can be stopping for blocking obstacles, or can be due to
    * traffic rules, etc.
@@ -101,6 +130,7 @@ class STBoundaryMapper {
   const double planning_max_distance_;
   const double planning_max_time_;
   std::shared_ptr<DependencyInjector> injector_;
+  mutable std::unique_ptr<FootprintCorridor> footprint_corridor_;
 };
 
 }  // namespace planning
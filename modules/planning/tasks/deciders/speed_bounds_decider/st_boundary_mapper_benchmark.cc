@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Maps a dense urban scene onto the st graph with and without the footprint
+// index: a 150m gently curved path sampled every 0.5m, and the given number
+// of obstacles with 8s predictions at 10Hz, a third of them crossing the
+// path, the rest driving along the neighbour lanes or parked.
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/planning/common/path_decision.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/tasks/deciders/speed_bounds_decider/st_boundary_mapper.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+constexpr double kPathLength = 150.0;
+constexpr double kPathResolution = 0.5;
+constexpr double kCurvature = 0.005;
+constexpr int kPredictionPointNum = 80;
+constexpr double kPredictionPeriod = 0.1;
+constexpr uint32_t kSeed = 42;
+
+class DenseScene {
+ public:
+  explicit DenseScene(int obstacle_num) {
+    common::VehicleConfig vehicle_config;
+    auto* vehicle_param = vehicle_config.mutable_vehicle_param();
+    vehicle_param->set_front_edge_to_center(3.89);
+    vehicle_param->set_back_edge_to_center(1.043);
+    vehicle_param->set_left_edge_to_center(1.055);
+    vehicle_param->set_right_edge_to_center(1.055);
+    vehicle_param->set_length(4.933);
+    vehicle_param->set_width(2.11);
+    common::VehicleConfigHelper::Init(vehicle_config);
+
+    std::vector<ReferencePoint> ref_points;
+    std::vector<common::PathPoint> path_points;
+    for (double s = 0.0; s <= kPathLength; s += kPathResolution) {
+      const double theta = kCurvature * s;
+      const double x = std::sin(theta) / kCurvature;
+      const double y = (1.0 - std::cos(theta)) / kCurvature;
+      ref_points.emplace_back(
+          hdmap::MapPathPoint(common::math::Vec2d(x, y), theta), kCurvature,
+          0.0);
+      common::PathPoint path_point;
+      path_point.set_x(x);
+      path_point.set_y(y);
+      path_point.set_theta(theta);
+      path_point.set_kappa(kCurvature);
+      path_point.set_s(s);
+      path_points.push_back(path_point);
+    }
+    reference_line_ = std::make_unique<ReferenceLine>(ref_points);
+    path_data_.SetReferenceLine(reference_line_.get());
+    path_data_.SetDiscretizedPath(DiscretizedPath(std::move(path_points)));
+
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<double> s_dist(0.0, kPathLength);
+    std::uniform_real_distribution<double> speed_dist(0.0, 12.0);
+    std::uniform_int_distribution<int> lane_dist(-2, 2);
+    for (int i = 0; i < obstacle_num; ++i) {
+      common::SLPoint sl;
+      sl.set_s(s_dist(rng));
+      sl.set_l(lane_dist(rng) * 3.5);
+      common::math::Vec2d xy;
+      reference_line_->SLToXY(sl, &xy);
+      const double lane_heading =
+          reference_line_->GetReferencePoint(sl.s()).heading();
+      const bool crossing = i % 3 == 0;
+      const double heading = crossing ? lane_heading + M_PI_2 : lane_heading;
+      const double speed = i % 5 == 0 ? 0.0 : speed_dist(rng);
+
+      perception::PerceptionObstacle perception_obstacle;
+      perception_obstacle.set_id(i);
+      perception_obstacle.mutable_position()->set_x(xy.x());
+      perception_obstacle.mutable_position()->set_y(xy.y());
+      perception_obstacle.set_theta(heading);
+      perception_obstacle.set_length(4.5);
+      perception_obstacle.set_width(1.9);
+      perception_obstacle.mutable_velocity()->set_x(speed * std::cos(heading));
+      perception_obstacle.mutable_velocity()->set_y(speed * std::sin(heading));
+
+      prediction::Trajectory trajectory;
+      for (int k = 0; k < kPredictionPointNum; ++k) {
+        const double t = k * kPredictionPeriod;
+        auto* point = trajectory.add_trajectory_point();
+        point->mutable_path_point()->set_x(xy.x() +
+                                           speed * t * std::cos(heading));
+        point->mutable_path_point()->set_y(xy.y() +
+                                           speed * t * std::sin(heading));
+        point->mutable_path_point()->set_theta(heading);
+        point->set_v(speed);
+        point->set_relative_time(t);
+      }
+      if (speed == 0.0) {
+        path_decision_.AddObstacle(
+            Obstacle(std::to_string(i), perception_obstacle,
+                     prediction::ObstaclePriority::NORMAL, true));
+      } else {
+        path_decision_.AddObstacle(
+            Obstacle(std::to_string(i), perception_obstacle, trajectory,
+                     prediction::ObstaclePriority::NORMAL, false));
+      }
+    }
+  }
+
+  void MapObstacles() {
+    STBoundaryMapper mapper(config_, *reference_line_, path_data_, kPathLength,
+                            kPredictionPointNum * kPredictionPeriod,
+                            injector_);
+    mapper.ComputeSTBoundary(&path_decision_);
+  }
+
+ private:
+  SpeedBoundsDeciderConfig config_;
+  std::unique_ptr<ReferenceLine> reference_line_;
+  PathData path_data_;
+  PathDecision path_decision_;
+  std::shared_ptr<DependencyInjector> injector_ =
+      std::make_shared<DependencyInjector>();
+};
+
+void BM_MapObstacles(benchmark::State& state, bool use_index) {
+  FLAGS_enable_st_boundary_footprint_index = use_index;
+  DenseScene scene(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    scene.MapObstacles();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Exhaustive(benchmark::State& state) { BM_MapObstacles(state, false); }
+
+void BM_FootprintIndex(benchmark::State& state) {
+  BM_MapObstacles(state, true);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Exhaustive)->Arg(20)->Arg(50)->Arg(100);
+BENCHMARK(BM_FootprintIndex)->Arg(20)->Arg(50)->Arg(100);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -16,11 +16,14 @@
 
 #include "modules/planning/tasks/deciders/speed_bounds_decider/st_boundary_mapper.h"
 
+#include <cmath>
+
 #include "gmock/gmock.h"
 
 #include "cyber/common/log.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/obstacle.h"
+#include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/reference_line/qp_spline_reference_line_smoother.h"
 #include "modules/planning/tasks/deciders/speed_bounds_decider/speed_limit_decider.h"
 
@@ -92,5 +95,83 @@ TEST_F(StBoundaryMapperTest, check_overlap_test) {
   EXPECT_TRUE(mapper.CheckOverlap(path_point, box, 0.0));
 }
 
+TEST_F(StBoundaryMapperTest, footprint_index_test) {
+  SpeedBoundsDeciderConfig config;
+  const double planning_distance = 70.0;
+  const double planning_time = 10.0;
+  const auto& path_points = path_data_.discretized_path();
+  ASSERT_GT(path_points.size(), 2);
+
+  // Static and crossing obstacles scattered around the path, some of them
+  // far away from it.
+  std::vector<Obstacle> obstacles;
+  for (int i = 0; i < 30; ++i) {
+    const auto& anchor = path_points[(i * 7) % path_points.size()];
+    const double offset = (i % 5 - 2) * 1.5;
+    perception::PerceptionObstacle perception_obstacle;
+    perception_obstacle.set_id(i);
+    perception_obstacle.mutable_position()->set_x(
+        anchor.x() - offset * std::sin(anchor.theta()));
+    perception_obstacle.mutable_position()->set_y(
+        anchor.y() + offset * std::cos(anchor.theta()));
+    perception_obstacle.set_theta(anchor.theta() + 0.3 * i);
+    perception_obstacle.set_length(4.0);
+    perception_obstacle.set_width(2.0);
+    if (i % 3 == 0) {
+      obstacles.emplace_back(std::to_string(i), perception_obstacle,
+                             prediction::ObstaclePriority::NORMAL, true);
+      continue;
+    }
+    prediction::Trajectory trajectory;
+    const double heading = anchor.theta() + 0.5 * (i % 4) + M_PI_2;
+    for (int k = 0; k < 40; ++k) {
+      auto* point = trajectory.add_trajectory_point();
+      point->mutable_path_point()->set_x(
+          perception_obstacle.position().x() +
+          (k - 20) * 0.5 * std::cos(heading));
+      point->mutable_path_point()->set_y(
+          perception_obstacle.position().y() +
+          (k - 20) * 0.5 * std::sin(heading));
+      point->mutable_path_point()->set_theta(heading);
+      point->set_relative_time(k * 0.2);
+    }
+    obstacles.emplace_back(std::to_string(i), perception_obstacle, trajectory,
+                           prediction::ObstaclePriority::NORMAL, false);
+  }
+
+  STBoundaryMapper indexed_mapper(config, *reference_line_, path_data_,
+                                  planning_distance, planning_time, injector_);
+  STBoundaryMapper exhaustive_mapper(config, *reference_line_, path_data_,
+                                     planning_distance, planning_time,
+                                     injector_);
+  int num_overlaps = 0;
+  for (const auto& obstacle : obstacles) {
+    std::vector<STPoint> upper_points;
+    std::vector<STPoint> lower_points;
+    FLAGS_enable_st_boundary_footprint_index = true;
+    const bool indexed = indexed_mapper.GetOverlapBoundaryPoints(
+        path_points, obstacle, &upper_points, &lower_points);
+
+    std::vector<STPoint> expected_upper_points;
+    std::vector<STPoint> expected_lower_points;
+    FLAGS_enable_st_boundary_footprint_index = false;
+    const bool exhaustive = exhaustive_mapper.GetOverlapBoundaryPoints(
+        path_points, obstacle, &expected_upper_points, &expected_lower_points);
+
+    EXPECT_EQ(indexed, exhaustive) << obstacle.Id();
+    ASSERT_EQ(upper_points.size(), expected_upper_points.size());
+    ASSERT_EQ(lower_points.size(), expected_lower_points.size());
+    for (size_t k = 0; k < upper_points.size(); ++k) {
+      EXPECT_EQ(upper_points[k].s(), expected_upper_points[k].s());
+      EXPECT_EQ(upper_points[k].t(), expected_upper_points[k].t());
+      EXPECT_EQ(lower_points[k].s(), expected_lower_points[k].s());
+      EXPECT_EQ(lower_points[k].t(), expected_lower_points[k].t());
+    }
+    num_overlaps += indexed ? 1 : 0;
+  }
+  FLAGS_enable_st_boundary_footprint_index = true;
+  EXPECT_GT(num_overlaps, 0);
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -20,6 +20,7 @@
 #include "modules/planning/tasks/optimizers/path_time_heuristic/dp_st_cost.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "modules/common/configs/vehicle_config_helper.h"
@@ -148,7 +149,7 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
       continue;
     }
 
-    auto boundary = obstacle->path_st_boundary();
+    const auto& boundary = obstacle->path_st_boundary();
 
     if (boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
       continue;
@@ -161,16 +162,8 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
     }
     double s_upper = 0.0;
     double s_lower = 0.0;
-
-    int boundary_index = boundary_map_[boundary.id()];
-    if (boundary_cost_[boundary_index][st_graph_point.index_t()].first < 0.0) {
-      boundary.GetBoundarySRange(t, &s_upper, &s_lower);
-      boundary_cost_[boundary_index][st_graph_point.index_t()] =
-          std::make_pair(s_upper, s_lower);
-    } else {
-      s_upper = boundary_cost_[boundary_index][st_graph_point.index_t()].first;
-      s_lower = boundary_cost_[boundary_index][st_graph_point.index_t()].second;
-    }
+    GetBoundarySRange(boundary, t, st_graph_point.index_t(), &s_upper,
+                      &s_lower);
     if (s < s_lower) {
       const double follow_distance_s = config_.safe_distance();
       if (s + follow_distance_s < s_lower) {
@@ -195,6 +188,97 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
   return cost * unit_t_;
 }
 
+void DpStCost::SetObstacleCosts(const size_t first_row, const size_t last_row,
+                                std::vector<StGraphPoint>* column) {
+  if (first_row > last_row) {
+    return;
+  }
+  const double t = column->at(first_row).point().t();
+  const uint32_t index_t = column->at(first_row).index_t();
+
+  double drivable_lower_bound = -kInf;
+  double drivable_upper_bound = kInf;
+  if (FLAGS_use_st_drivable_boundary) {
+    static constexpr double boundary_resolution = 0.1;
+    int index = static_cast<int>(t / boundary_resolution);
+    drivable_lower_bound = st_drivable_boundary_.st_boundary(index).s_lower();
+    drivable_upper_bound = st_drivable_boundary_.st_boundary(index).s_upper();
+  }
+
+  // the obstacles GetObstacleCost considers at this time, in the same order
+  struct ActiveBoundary {
+    const STBoundary* boundary;
+    double s_upper;
+    double s_lower;
+  };
+  std::vector<ActiveBoundary> active_boundaries;
+  for (const auto* obstacle : obstacles_) {
+    if (obstacle->IsVirtual() || obstacle->LongitudinalDecision().has_stop()) {
+      continue;
+    }
+    const auto& boundary = obstacle->path_st_boundary();
+    if (boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
+      continue;
+    }
+    if (t < boundary.min_t() || t > boundary.max_t()) {
+      continue;
+    }
+    double s_upper = 0.0;
+    double s_lower = 0.0;
+    GetBoundarySRange(boundary, t, index_t, &s_upper, &s_lower);
+    active_boundaries.push_back({&boundary, s_upper, s_lower});
+  }
+
+  const double follow_distance_s = config_.safe_distance();
+  const double overtake_distance_s =
+      StGapEstimator::EstimateSafeOvertakingGap();
+  for (size_t r = first_row; r <= last_row; ++r) {
+    auto& st_graph_point = (*column)[r];
+    const double s = st_graph_point.point().s();
+    if (s > drivable_upper_bound || s < drivable_lower_bound) {
+      st_graph_point.SetObstacleCost(kInf);
+      continue;
+    }
+    double cost = 0.0;
+    for (const auto& active_boundary : active_boundaries) {
+      if (active_boundary.boundary->IsPointInBoundary(st_graph_point.point())) {
+        cost = kInf;
+        break;
+      }
+      if (s < active_boundary.s_lower) {
+        if (s + follow_distance_s < active_boundary.s_lower) {
+          continue;
+        }
+        auto s_diff = follow_distance_s - active_boundary.s_lower + s;
+        cost += config_.obstacle_weight() * config_.default_obstacle_cost() *
+                s_diff * s_diff;
+      } else if (s > active_boundary.s_upper) {
+        if (s > active_boundary.s_upper + overtake_distance_s) {
+          continue;
+        }
+        auto s_diff = overtake_distance_s + active_boundary.s_upper - s;
+        cost += config_.obstacle_weight() * config_.default_obstacle_cost() *
+                s_diff * s_diff;
+      }
+    }
+    st_graph_point.SetObstacleCost(std::isinf(cost) ? kInf : cost * unit_t_);
+  }
+}
+
+void DpStCost::GetBoundarySRange(const STBoundary& boundary, const double t,
+                                 const uint32_t index_t, double* s_upper,
+                                 double* s_lower) {
+  const int boundary_index = boundary_map_[boundary.id()];
+  auto& boundary_cost = boundary_cost_[boundary_index][index_t];
+  if (boundary_cost.first < 0.0) {
+    boundary.GetBoundarySRange(t, s_upper, s_lower);
+    boundary_cost = std::make_pair(*s_upper, *s_lower);
+  } else {
+    *s_upper = boundary_cost.first;
+    *s_lower = boundary_cost.second;
+  }
+}
+
 double DpStCost::GetSpatialPotentialCost(const StGraphPoint& point) {
   return (total_s_ - point.point().s()) * config_.spatial_potential_penalty();
 }
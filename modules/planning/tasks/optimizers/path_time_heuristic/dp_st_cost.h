@@ -46,6 +46,14 @@ class DpStCost {
 
   double GetObstacleCost(const StGraphPoint& point);
 
+  /**
+   * @brief Set the obstacle costs of the rows first_row to last_row of one
+   * column of the cost table, equal to GetObstacleCost on each point. The
+   * obstacles are filtered and their s ranges looked up once per column.
+   */
+  void SetObstacleCosts(const size_t first_row, const size_t last_row,
+                        std::vector<StGraphPoint>* column);
+
   double GetSpatialPotentialCost(const StGraphPoint& point);
 
   double GetReferenceCost(const STPoint& point,
@@ -72,6 +80,11 @@ class DpStCost {
                                  const STPoint& third, const STPoint& fourth);
 
  private:
+  // the s range of the boundary at the time of column index_t, cached
+  void GetBoundarySRange(const STBoundary& boundary, const double t,
+                         const uint32_t index_t, double* s_upper,
+                         double* s_lower);
+
   double GetAccelCost(const double accel);
   double JerkCost(const double jerk);
 
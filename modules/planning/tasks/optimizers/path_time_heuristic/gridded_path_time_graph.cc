@@ -240,6 +240,10 @@ Status GriddedPathTimeGraph::CalculateTotalCost() {
     int count = static_cast<int>(next_highest_row) -
                 static_cast<int>(next_lowest_row) + 1;
     if (count > 0) {
+      if (FLAGS_enable_dp_st_graph_cost_tables) {
+        dp_st_cost_.SetObstacleCosts(next_lowest_row, next_highest_row,
+                                     &cost_table_[c]);
+      }
       std::vector<std::future<void>> results;
       for (size_t r = next_lowest_row; r <= next_highest_row; ++r) {
         auto msg = std::make_shared<StGraphMessage>(c, r);
@@ -267,6 +271,11 @@ Status GriddedPathTimeGraph::CalculateTotalCost() {
         lowest_row = std::min(lowest_row, l_r);
       }
     }
+    if (count > 0) {
+      UpdatePreColumn(c, next_lowest_row, next_highest_row);
+    } else {
+      UpdatePreColumn(c, 1, 0);
+    }
     next_highest_row = highest_row;
     next_lowest_row = lowest_row;
   }
@@ -274,6 +283,96 @@ Status GriddedPathTimeGraph::CalculateTotalCost() {
   return Status::OK();
 }
 
+void GriddedPathTimeGraph::UpdatePreColumn(const size_t c,
+                                           const size_t first_row,
+                                           const size_t last_row) {
+  pre_col_first_row_ = static_cast<uint32_t>(first_row);
+  pre_col_last_row_ = static_cast<uint32_t>(last_row);
+  if (!FLAGS_enable_dp_st_graph_cost_tables) {
+    return;
+  }
+  pre_col_speed_.resize(dimension_s_);
+  pre_col_cost_.resize(dimension_s_);
+  const auto& col = cost_table_[c];
+  for (size_t r = first_row; r <= last_row; ++r) {
+    pre_col_speed_[r] = col[r].GetOptimalSpeed();
+    pre_col_cost_[r] = col[r].pre_point() == nullptr
+                           ? std::numeric_limits<double>::infinity()
+                           : col[r].total_cost();
+  }
+}
+
+void GriddedPathTimeGraph::GetFeasiblePreRows(
+    const uint32_t c, const uint32_t r, const uint32_t r_low,
+    std::vector<uint32_t>* rows, std::vector<double>* accelerations) const {
+  rows->clear();
+  accelerations->clear();
+  const double s = cost_table_[c][r].point().s();
+  // The mininal s to model as constant acceleration formula
+  // default: 0.25 * 7 = 1.75 m
+  const double min_s_consider_speed = dense_unit_s_ * dimension_t_;
+
+  if (!FLAGS_enable_dp_st_graph_cost_tables) {
+    const auto& pre_col = cost_table_[c - 1];
+    for (uint32_t r_pre = r + 1; r_pre-- > r_low;) {
+      if (std::isinf(pre_col[r_pre].total_cost()) ||
+          pre_col[r_pre].pre_point() == nullptr) {
+        continue;
+      }
+      // Use curr_v = (point.s - pre_point.s) / unit_t as current v
+      // Use pre_v = (pre_point.s - prepre_point.s) / unit_t as previous v
+      // Current acc estimate: curr_a = (curr_v - pre_v) / unit_t
+      // = (point.s + prepre_point.s - 2 * pre_point.s) / (unit_t * unit_t)
+      const double curr_a = 2 *
+                            ((s - pre_col[r_pre].point().s()) / unit_t_ -
+                             pre_col[r_pre].GetOptimalSpeed()) /
+                            unit_t_;
+      if (curr_a > max_acceleration_ || curr_a < max_deceleration_) {
+        continue;
+      }
+      if (pre_col[r_pre].GetOptimalSpeed() + curr_a * unit_t_ <
+              -kDoubleEpsilon &&
+          s > min_s_consider_speed) {
+        continue;
+      }
+      rows->push_back(r_pre);
+      accelerations->push_back(curr_a);
+    }
+    return;
+  }
+
+  // Rows out of the range calculated in the previous column are unreachable.
+  const uint32_t first_row = std::max(r_low, pre_col_first_row_);
+  const uint32_t last_row = std::min(r, pre_col_last_row_);
+  if (first_row > last_row) {
+    return;
+  }
+  // The same tests as above on all the candidates at once, without branches
+  // so that the loop can be vectorized.
+  const bool consider_speed = s > min_s_consider_speed;
+  const size_t num_rows = last_row - first_row + 1;
+  std::vector<double> curr_a(num_rows);
+  std::vector<uint8_t> feasible(num_rows);
+  for (size_t i = 0; i < num_rows; ++i) {
+    const size_t r_pre = first_row + i;
+    const double pre_speed = pre_col_speed_[r_pre];
+    const double a =
+        2 * ((s - spatial_distance_by_index_[r_pre]) / unit_t_ - pre_speed) /
+        unit_t_;
+    curr_a[i] = a;
+    feasible[i] = !std::isinf(pre_col_cost_[r_pre]) &
+                  !(a > max_acceleration_) & !(a < max_deceleration_) &
+                  !(consider_speed & (pre_speed + a * unit_t_ < -kDoubleEpsilon));
+  }
+  // from row r downwards, the order the costs are compared in
+  for (size_t i = num_rows; i-- > 0;) {
+    if (feasible[i]) {
+      rows->push_back(static_cast<uint32_t>(first_row + i));
+      accelerations->push_back(curr_a[i]);
+    }
+  }
+}
+
 void GriddedPathTimeGraph::GetRowRange(const StGraphPoint& point,
                                        size_t* next_highest_row,
                                        size_t* next_lowest_row) {
@@ -324,7 +423,9 @@ void GriddedPathTimeGraph::CalculateCostAt(
   const uint32_t r = msg->r;
   auto& cost_cr = cost_table_[c][r];
 
-  cost_cr.SetObstacleCost(dp_st_cost_.GetObstacleCost(cost_cr));
+  if (!FLAGS_enable_dp_st_graph_cost_tables) {
+    cost_cr.SetObstacleCost(dp_st_cost_.GetObstacleCost(cost_cr));
+  }
   if (cost_cr.obstacle_cost() > std::numeric_limits<double>::max()) {
     return;
   }
@@ -384,37 +485,19 @@ void GriddedPathTimeGraph::CalculateCostAt(
     r_low = static_cast<uint32_t>(
         std::distance(spatial_distance_by_index_.begin(), pre_lowest_itr));
   }
-  const uint32_t r_pre_size = r - r_low + 1;
   const auto& pre_col = cost_table_[c - 1];
   double curr_speed_limit = speed_limit;
 
+  std::vector<uint32_t> pre_rows;
+  std::vector<double> pre_accelerations;
+  GetFeasiblePreRows(c, r, r_low, &pre_rows, &pre_accelerations);
+
   if (c == 2) {
-    for (uint32_t i = 0; i < r_pre_size; ++i) {
-      uint32_t r_pre = r - i;
-      if (std::isinf(pre_col[r_pre].total_cost()) ||
-          pre_col[r_pre].pre_point() == nullptr) {
-        continue;
-      }
+    for (size_t i = 0; i < pre_rows.size(); ++i) {
+      const uint32_t r_pre = pre_rows[i];
       // TODO(Jiaxuan): Calculate accurate acceleration by recording speed
       // data in ST point.
-      // Use curr_v = (point.s - pre_point.s) / unit_t as current v
-      // Use pre_v = (pre_point.s - prepre_point.s) / unit_t as previous v
-      // Current acc estimate: curr_a = (curr_v - pre_v) / unit_t
-      // = (point.s + prepre_point.s - 2 * pre_point.s) / (unit_t * unit_t)
-      const double curr_a =
-          2 *
-          ((cost_cr.point().s() - pre_col[r_pre].point().s()) / unit_t_ -
-           pre_col[r_pre].GetOptimalSpeed()) /
-          unit_t_;
-      if (curr_a < max_deceleration_ || curr_a > max_acceleration_) {
-        continue;
-      }
-
-      if (pre_col[r_pre].GetOptimalSpeed() + curr_a * unit_t_ <
-              -kDoubleEpsilon &&
-          cost_cr.point().s() > min_s_consider_speed) {
-        continue;
-      }
+      const double curr_a = pre_accelerations[i];
 
       // Filter out continuous-time node connection which is in collision with
       // obstacle
@@ -440,29 +523,9 @@ void GriddedPathTimeGraph::CalculateCostAt(
     return;
   }
 
-  for (uint32_t i = 0; i < r_pre_size; ++i) {
-    uint32_t r_pre = r - i;
-    if (std::isinf(pre_col[r_pre].total_cost()) ||
-        pre_col[r_pre].pre_point() == nullptr) {
-      continue;
-    }
-    // Use curr_v = (point.s - pre_point.s) / unit_t as current v
-    // Use pre_v = (pre_point.s - prepre_point.s) / unit_t as previous v
-    // Current acc estimate: curr_a = (curr_v - pre_v) / unit_t
-    // = (point.s + prepre_point.s - 2 * pre_point.s) / (unit_t * unit_t)
-    const double curr_a =
-        2 *
-        ((cost_cr.point().s() - pre_col[r_pre].point().s()) / unit_t_ -
-         pre_col[r_pre].GetOptimalSpeed()) /
-        unit_t_;
-    if (curr_a > max_acceleration_ || curr_a < max_deceleration_) {
-      continue;
-    }
-
-    if (pre_col[r_pre].GetOptimalSpeed() + curr_a * unit_t_ < -kDoubleEpsilon &&
-        cost_cr.point().s() > min_s_consider_speed) {
-      continue;
-    }
+  for (size_t i = 0; i < pre_rows.size(); ++i) {
+    const uint32_t r_pre = pre_rows[i];
+    const double curr_a = pre_accelerations[i];
 
     if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
                                 pre_col[r_pre])) {
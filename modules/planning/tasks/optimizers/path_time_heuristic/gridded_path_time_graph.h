@@ -82,6 +82,19 @@ class GriddedPathTimeGraph {
   void GetRowRange(const StGraphPoint& point, size_t* next_highest_row,
                    size_t* next_lowest_row);
 
+  // Keep the speeds and costs of the points of column c that can be the
+  // predecessor of a point of the next column, in the rows first_row to
+  // last_row.
+  void UpdatePreColumn(const size_t c, const size_t first_row,
+                       const size_t last_row);
+
+  // The rows of the previous column from which point (c, r) is reachable
+  // within the acceleration bounds, from row r down to r_low, with the
+  // accelerations to reach it.
+  void GetFeasiblePreRows(const uint32_t c, const uint32_t r,
+                          const uint32_t r_low, std::vector<uint32_t>* rows,
+                          std::vector<double>* accelerations) const;
+
  private:
   const StGraphData& st_graph_data_;
 
@@ -119,6 +132,13 @@ class GriddedPathTimeGraph {
   double max_acceleration_ = 0.0;
   double max_deceleration_ = 0.0;
 
+  // the predecessor candidates of the column being calculated, with infinite
+  // costs for the points that cannot be a predecessor, see UpdatePreColumn
+  std::vector<double> pre_col_speed_;
+  std::vector<double> pre_col_cost_;
+  uint32_t pre_col_first_row_ = 0;
+  uint32_t pre_col_last_row_ = 0;
+
   // cost_table_[t][s]
   // row: s, col: t --- NOTICE: Please do NOT change.
   std::vector<std::vector<StGraphPoint>> cost_table_;
@@ -19,6 +19,10 @@
  **/
 #include "modules/planning/tasks/optimizers/path_time_heuristic/gridded_path_time_graph.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "modules/common_msgs/basic_msgs/pnc_point.pb.h"
@@ -136,5 +140,57 @@ TEST_F(DpStGraphTest, simple) {
   EXPECT_TRUE(ret.ok());
 }
 
+TEST_F(DpStGraphTest, cost_tables) {
+  // a car cutting in ahead, a slower one further on and a crossing one
+  const std::vector<std::vector<std::pair<STPoint, STPoint>>> boundary_points =
+      {{{STPoint(20.0, 1.0), STPoint(25.0, 1.0)},
+        {STPoint(32.0, 4.0), STPoint(37.0, 4.0)}},
+       {{STPoint(60.0, 0.0), STPoint(66.0, 0.0)},
+        {STPoint(80.0, 7.0), STPoint(86.0, 7.0)}},
+       {{STPoint(40.0, 5.0), STPoint(44.0, 5.0)},
+        {STPoint(40.0, 6.0), STPoint(44.0, 6.0)}}};
+
+  std::vector<const Obstacle*> obstacles;
+  std::vector<const STBoundary*> boundaries;
+  for (size_t i = 0; i < boundary_points.size(); ++i) {
+    Obstacle obstacle;
+    obstacle.SetId("o" + std::to_string(i));
+    obstacle_list_.push_back(obstacle);
+    STBoundary boundary(boundary_points[i]);
+    boundary.set_id(obstacle_list_.back().Id());
+    obstacle_list_.back().set_path_st_boundary(boundary);
+    obstacles.push_back(&obstacle_list_.back());
+    boundaries.push_back(&obstacle_list_.back().path_st_boundary());
+  }
+
+  init_point_.set_v(10.0);
+  init_point_.set_a(0.0);
+
+  planning_internal::STGraphDebug st_graph_debug;
+  st_graph_data_ = StGraphData();
+  st_graph_data_.LoadData(boundaries, 30.0, init_point_, speed_limit_, 10.0,
+                          120.0, 7.0, &st_graph_debug);
+
+  FLAGS_enable_dp_st_graph_cost_tables = false;
+  SpeedData expected;
+  EXPECT_TRUE(GriddedPathTimeGraph(st_graph_data_, dp_config_, obstacles,
+                                   init_point_)
+                  .Search(&expected)
+                  .ok());
+
+  FLAGS_enable_dp_st_graph_cost_tables = true;
+  SpeedData speed_data;
+  EXPECT_TRUE(GriddedPathTimeGraph(st_graph_data_, dp_config_, obstacles,
+                                   init_point_)
+                  .Search(&speed_data)
+                  .ok());
+
+  ASSERT_EQ(expected.size(), speed_data.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_DOUBLE_EQ(expected[i].s(), speed_data[i].s());
+    EXPECT_DOUBLE_EQ(expected[i].t(), speed_data[i].t());
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -165,11 +165,30 @@ common::Status PiecewiseJerkPathOptimizer::Process(
       ddl_bounds.emplace_back(-lat_acc_bound - kappa, lat_acc_bound - kappa);
     }
 
-    bool res_opt =
-        OptimizePath(init_frenet_state, end_state, std::move(path_reference_l),
-                     path_reference_size, path_boundary.delta_s(),
-                     is_valid_path_reference, path_boundary.boundary(),
-                     ddl_bounds, w, max_iter, &opt_l, &opt_dl, &opt_ddl);
+    SolverState* solver_state = nullptr;
+    if (FLAGS_enable_persistent_piecewise_jerk_solver) {
+      solver_state = &solver_states_[path_boundary.label()];
+      PrepareWarmStart(planning_start_point.path_point(),
+                       path_boundary.delta_s(), path_boundary_size,
+                       solver_state);
+    }
+
+    bool res_opt = OptimizePath(
+        init_frenet_state, end_state, std::move(path_reference_l),
+        path_reference_size, path_boundary.delta_s(), is_valid_path_reference,
+        path_boundary.boundary(), ddl_bounds, w, max_iter, solver_state,
+        &opt_l, &opt_dl, &opt_ddl);
+
+    if (solver_state != nullptr) {
+      solver_state->start_point =
+          common::math::Vec2d(planning_start_point.path_point().x(),
+                              planning_start_point.path_point().y());
+      solver_state->start_heading = planning_start_point.path_point().theta();
+      solver_state->delta_s = path_boundary.delta_s();
+      solver_state->l = opt_l;
+      solver_state->dl = opt_dl;
+      solver_state->ddl = opt_ddl;
+    }
 
     if (res_opt) {
       for (size_t i = 0; i < path_boundary_size; i += 4) {
@@ -239,8 +258,9 @@ bool PiecewiseJerkPathOptimizer::OptimizePath(
     const double delta_s, const bool is_valid_path_reference,
     const std::vector<std::pair<double, double>>& lat_boundaries,
     const std::vector<std::pair<double, double>>& ddl_bounds,
-    const std::array<double, 5>& w, const int max_iter, std::vector<double>* x,
-    std::vector<double>* dx, std::vector<double>* ddx) {
+    const std::array<double, 5>& w, const int max_iter,
+    SolverState* solver_state, std::vector<double>* x, std::vector<double>* dx,
+    std::vector<double>* ddx) {
   // num of knots
   const size_t kNumKnots = lat_boundaries.size();
   PiecewiseJerkPathProblem piecewise_jerk_problem(kNumKnots, delta_s,
@@ -307,11 +327,26 @@ bool PiecewiseJerkPathOptimizer::OptimizePath(
       std::fmax(init_state.first[1], 1.0), axis_distance, max_yaw_rate);
   piecewise_jerk_problem.set_dddx_bound(jerk_bound);
 
+  if (solver_state != nullptr) {
+    piecewise_jerk_problem.set_solver(&solver_state->solver);
+    if (solver_state->warm_start_l.size() == kNumKnots) {
+      piecewise_jerk_problem.set_warm_start(solver_state->warm_start_l,
+                                            solver_state->warm_start_dl,
+                                            solver_state->warm_start_ddl);
+    }
+  }
+
   bool success = piecewise_jerk_problem.Optimize(max_iter);
 
   auto end_time = std::chrono::system_clock::now();
   std::chrono::duration<double> diff = end_time - start_time;
   ADEBUG << "Path Optimizer used time: " << diff.count() * 1000 << " ms.";
+  if (solver_state != nullptr) {
+    const auto& stats = solver_state->solver.stats();
+    ADEBUG << "Path Optimizer " << (stats.setup ? "set up" : "updated")
+           << " osqp, " << stats.iterations << " iterations in "
+           << stats.time_ms << " ms.";
+  }
 
   if (!success) {
     AERROR << "piecewise jerk path optimizer failed";
@@ -335,6 +370,34 @@ bool PiecewiseJerkPathOptimizer::OptimizePath(
   return true;
 }
 
+void PiecewiseJerkPathOptimizer::PrepareWarmStart(
+    const common::PathPoint& start_point, const double delta_s,
+    const size_t num_of_knots, SolverState* solver_state) const {
+  solver_state->warm_start_l.clear();
+  solver_state->warm_start_dl.clear();
+  solver_state->warm_start_ddl.clear();
+  if (solver_state->l.empty() || solver_state->delta_s != delta_s) {
+    return;
+  }
+  // reference line s is not stable across cycles, measure the distance
+  // travelled along the last start heading instead
+  const common::math::Vec2d travel =
+      common::math::Vec2d(start_point.x(), start_point.y()) -
+      solver_state->start_point;
+  const double offset =
+      travel.InnerProd(common::math::Vec2d::CreateUnitVec2d(
+          solver_state->start_heading));
+  if (offset < 0.0 ||
+      offset > delta_s * static_cast<double>(solver_state->l.size() - 1)) {
+    return;
+  }
+  ShiftPiecewiseJerkSolution(solver_state->l, solver_state->dl,
+                             solver_state->ddl, delta_s, offset, num_of_knots,
+                             &solver_state->warm_start_l,
+                             &solver_state->warm_start_dl,
+                             &solver_state->warm_start_ddl);
+}
+
 FrenetFramePath PiecewiseJerkPathOptimizer::ToPiecewiseJerkPath(
     const std::vector<double>& x, const std::vector<double>& dx,
     const std::vector<double>& ddx, const double delta_s,
@@ -21,9 +21,13 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
 #include "modules/planning/tasks/optimizers/path_optimizer.h"
 
 namespace apollo {
@@ -38,6 +42,21 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
   virtual ~PiecewiseJerkPathOptimizer() = default;
 
  private:
+  // osqp workspace and last solution of one kind of path boundary
+  struct SolverState {
+    PiecewiseJerkSolver solver;
+    common::math::Vec2d start_point;
+    double start_heading = 0.0;
+    double delta_s = 0.0;
+    std::vector<double> l;
+    std::vector<double> dl;
+    std::vector<double> ddl;
+    // last solution shifted to the current start point
+    std::vector<double> warm_start_l;
+    std::vector<double> warm_start_dl;
+    std::vector<double> warm_start_ddl;
+  };
+
   common::Status Process(const SpeedData& speed_data,
                          const ReferenceLine& reference_line,
                          const common::TrajectoryPoint& init_point,
@@ -63,6 +82,8 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
    * @param ddl_bounds: constains
    * @param w: weighting scales
    * @param max_iter: optimization max interations
+   * @param solver_state: persistent solver to use and update, nullptr to
+   * solve from scratch
    * @param ptr_x: optimization result of x
    * @param ptr_dx: optimization result of dx
    * @param ptr_ddx: optimization result of ddx
@@ -78,8 +99,12 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
       const std::vector<std::pair<double, double>>& lat_boundaries,
       const std::vector<std::pair<double, double>>& ddl_bounds,
       const std::array<double, 5>& w, const int max_iter,
-      std::vector<double>* ptr_x, std::vector<double>* ptr_dx,
-      std::vector<double>* ptr_ddx);
+      SolverState* solver_state, std::vector<double>* ptr_x,
+      std::vector<double>* ptr_dx, std::vector<double>* ptr_ddx);
+
+  void PrepareWarmStart(const common::PathPoint& start_point,
+                        const double delta_s, const size_t num_of_knots,
+                        SolverState* solver_state) const;
 
   FrenetFramePath ToPiecewiseJerkPath(const std::vector<double>& l,
                                       const std::vector<double>& dl,
@@ -93,6 +118,8 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
 
   double GaussianWeighting(const double x, const double peak_weighting,
                            const double peak_weighting_x) const;
+
+  std::unordered_map<std::string, SolverState> solver_states_;
 };
 
 }  // namespace planning
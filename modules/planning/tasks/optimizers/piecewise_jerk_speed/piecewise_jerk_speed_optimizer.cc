@@ -167,10 +167,18 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   piecewise_jerk_problem.set_penalty_dx(penalty_dx);
   piecewise_jerk_problem.set_dx_bounds(std::move(s_dot_bounds));
 
+  const double start_time =
+      frame_->vehicle_state().timestamp() + init_point.relative_time();
+  if (FLAGS_enable_persistent_piecewise_jerk_solver) {
+    piecewise_jerk_problem.set_solver(&solver_);
+    SetWarmStart(start_time, delta_t, num_of_knots, &piecewise_jerk_problem);
+  }
+
   // Solve the problem
   if (!piecewise_jerk_problem.Optimize()) {
     const std::string msg = "Piecewise jerk speed optimizer failed!";
     AERROR << msg;
+    last_s_.clear();
     speed_data->clear();
     return Status(ErrorCode::PLANNING_ERROR, msg);
   }
@@ -179,6 +187,16 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   const std::vector<double>& s = piecewise_jerk_problem.opt_x();
   const std::vector<double>& ds = piecewise_jerk_problem.opt_dx();
   const std::vector<double>& dds = piecewise_jerk_problem.opt_ddx();
+  if (FLAGS_enable_persistent_piecewise_jerk_solver) {
+    const auto& stats = solver_.stats();
+    ADEBUG << "Piecewise jerk speed optimizer "
+           << (stats.setup ? "set up" : "updated") << " osqp, "
+           << stats.iterations << " iterations in " << stats.time_ms << " ms";
+    last_start_time_ = start_time;
+    last_s_ = s;
+    last_ds_ = ds;
+    last_dds_ = dds;
+  }
   for (int i = 0; i < num_of_knots; ++i) {
     ADEBUG << "For t[" << i * delta_t << "], s = " << s[i] << ", v = " << ds[i]
            << ", a = " << dds[i];
@@ -202,5 +220,27 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   return Status::OK();
 }
 
+void PiecewiseJerkSpeedOptimizer::SetWarmStart(
+    const double start_time, const double delta_t, const size_t num_of_knots,
+    PiecewiseJerkProblem* problem) const {
+  // the new start point is stitched onto the last trajectory, so the last
+  // solution shifted by the elapsed time is close to the new optimum
+  const double offset = start_time - last_start_time_;
+  if (last_s_.empty() || offset < 0.0 ||
+      offset > delta_t * static_cast<double>(last_s_.size() - 1)) {
+    return;
+  }
+  std::vector<double> s;
+  std::vector<double> ds;
+  std::vector<double> dds;
+  ShiftPiecewiseJerkSolution(last_s_, last_ds_, last_dds_, delta_t, offset,
+                             num_of_knots, &s, &ds, &dds);
+  const double start_s = s.front();
+  for (auto& s_i : s) {
+    s_i -= start_s;
+  }
+  problem->set_warm_start(std::move(s), std::move(ds), std::move(dds));
+}
+
 }  // namespace planning
 }  // namespace apollo
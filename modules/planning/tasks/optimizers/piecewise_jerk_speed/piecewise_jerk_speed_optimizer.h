@@ -20,6 +20,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_problem.h"
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_solver.h"
 #include "modules/planning/tasks/optimizers/speed_optimizer.h"
 
 namespace apollo {
@@ -35,6 +39,17 @@ class PiecewiseJerkSpeedOptimizer : public SpeedOptimizer {
   common::Status Process(const PathData& path_data,
                          const common::TrajectoryPoint& init_point,
                          SpeedData* const speed_data) override;
+
+  void SetWarmStart(const double start_time, const double delta_t,
+                    const size_t num_of_knots,
+                    PiecewiseJerkProblem* problem) const;
+
+  PiecewiseJerkSolver solver_;
+  // last solution and the absolute time of its first knot
+  double last_start_time_ = 0.0;
+  std::vector<double> last_s_;
+  std::vector<double> last_ds_;
+  std::vector<double> last_dds_;
 };
 
 }  // namespace planning
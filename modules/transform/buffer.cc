@@ -17,10 +17,12 @@
 #include "modules/transform/buffer.h"
 
 #include "absl/strings/str_cat.h"
+#include "tf2/exceptions.h"
 
 #include "cyber/cyber.h"
 #include "cyber/time/clock.h"
 #include "modules/common/adapters/adapter_gflags.h"
+#include "modules/transform/transform_gflags.h"
 
 using Time = ::apollo::cyber::Time;
 using Clock = ::apollo::cyber::Clock;
@@ -36,6 +38,38 @@ namespace transform {
 Buffer::Buffer() : BufferCore() { Init(); }
 
 int Buffer::Init() {
+  if (FLAGS_enable_tf_shm_store) {
+    shm_store_ = ShmTransformStore::Open(FLAGS_tf_shm_store_name,
+                                         FLAGS_tf_shm_open_timeout_ms);
+    if (shm_store_ != nullptr && !shm_store_->AcquireWriter()) {
+      AINFO << "Read transforms from shared memory store "
+            << FLAGS_tf_shm_store_name;
+      read_from_shm_ = true;
+      // the store stops being fed when its writer process dies, check for
+      // that and take the role over
+      writer_check_timer_.reset(new cyber::Timer(
+          FLAGS_tf_shm_writer_check_interval_ms,
+          [this]() { TakeOverShmWriter(); }, false));
+      writer_check_timer_->Start();
+      return cyber::SUCC;
+    }
+  }
+  SubscribeTransforms();
+  return cyber::SUCC;
+}
+
+void Buffer::TakeOverShmWriter() {
+  if (node_ != nullptr || !shm_store_->AcquireWriter()) {
+    return;
+  }
+  // lookups keep being served from the store, which still has the history
+  // the previous writer left
+  AINFO << "The writer of shared memory store " << FLAGS_tf_shm_store_name
+        << " is gone, subscribe the transform channels to feed it.";
+  SubscribeTransforms();
+}
+
+void Buffer::SubscribeTransforms() {
   const std::string node_name =
       absl::StrCat("transform_listener_", Time::Now().ToNanosecond());
   node_ = cyber::CreateNode(node_name);
@@ -54,8 +88,6 @@ int Buffer::Init() {
       attr_static, [&](const std::shared_ptr<TransformStampeds>& msg_evt) {
         SubscriptionCallbackImpl(msg_evt, true);
       });
-
-  return cyber::SUCC;
 }
 
 void Buffer::SubscriptionCallback(
@@ -76,6 +108,10 @@ void Buffer::SubscriptionCallbackImpl(
   if (now.ToNanosecond() < last_update_.ToNanosecond()) {
     AINFO << "Detected jump back in time. Clearing TF buffer.";
     clear();
+    cache_.ClearDynamic();
+    if (shm_store_ != nullptr) {
+      shm_store_->ClearDynamic();
+    }
     // cache static transform stamped again.
     for (auto& msg : static_msgs_) {
       setTransform(msg, authority, true);
@@ -113,6 +149,25 @@ void Buffer::SubscriptionCallbackImpl(
         static_msgs_.push_back(trans_stamped);
       }
       setTransform(trans_stamped, authority, is_static);
+
+      TransformSample sample;
+      sample.stamp_ns = trans_stamped.header.stamp;
+      sample.translation[0] = transform.translation().x();
+      sample.translation[1] = transform.translation().y();
+      sample.translation[2] = transform.translation().z();
+      sample.rotation[0] = transform.rotation().qx();
+      sample.rotation[1] = transform.rotation().qy();
+      sample.rotation[2] = transform.rotation().qz();
+      sample.rotation[3] = transform.rotation().qw();
+      if (FLAGS_enable_tf_lockfree_lookup) {
+        cache_.SetTransform(trans_stamped.header.frame_id,
+                            trans_stamped.child_frame_id, sample, is_static);
+      }
+      if (shm_store_ != nullptr) {
+        shm_store_->SetTransform(trans_stamped.header.frame_id,
+                                 trans_stamped.child_frame_id, sample,
+                                 is_static);
+      }
     } catch (tf2::TransformException& ex) {
       std::string temp = ex.what();
       AERROR << "Failure to set received transform:" << temp.c_str();
@@ -123,6 +178,14 @@ void Buffer::SubscriptionCallbackImpl(
 bool Buffer::GetLatestStaticTF(const std::string& frame_id,
                                const std::string& child_frame_id,
                                TransformStamped* tf) {
+  if (read_from_shm_) {
+    TransformSample sample;
+    if (!shm_store_->GetLatestStatic(frame_id, child_frame_id, &sample)) {
+      return false;
+    }
+    SampleToCyber(sample, frame_id, child_frame_id, tf);
+    return true;
+  }
   for (auto reverse_iter = static_msgs_.rbegin();
        reverse_iter != static_msgs_.rend(); ++reverse_iter) {
     if ((*reverse_iter).header.frame_id == frame_id &&
@@ -165,10 +228,66 @@ void Buffer::TF2MsgToCyber(
       tf2_trans_stamped.transform.rotation.w);
 }
 
+void Buffer::SampleToCyber(const TransformSample& sample,
+                           const std::string& frame_id,
+                           const std::string& child_frame_id,
+                           TransformStamped* trans_stamped) const {
+  trans_stamped->mutable_header()->set_timestamp_sec(
+      static_cast<double>(sample.stamp_ns) / 1e9);
+  trans_stamped->mutable_header()->set_frame_id(frame_id);
+  trans_stamped->set_child_frame_id(child_frame_id);
+  auto* translation = trans_stamped->mutable_transform()->mutable_translation();
+  translation->set_x(sample.translation[0]);
+  translation->set_y(sample.translation[1]);
+  translation->set_z(sample.translation[2]);
+  auto* rotation = trans_stamped->mutable_transform()->mutable_rotation();
+  rotation->set_qx(sample.rotation[0]);
+  rotation->set_qy(sample.rotation[1]);
+  rotation->set_qz(sample.rotation[2]);
+  rotation->set_qw(sample.rotation[3]);
+}
+
+bool Buffer::LookupSample(const std::string& target_frame,
+                          const std::string& source_frame, uint64_t time_ns,
+                          TransformSample* sample, TransformCacheError* error,
+                          std::string* errstr) const {
+  if (read_from_shm_) {
+    return shm_store_->LookupTransform(target_frame, source_frame, time_ns,
+                                       sample, error, errstr);
+  }
+  return cache_.LookupTransform(target_frame, source_frame, time_ns, sample,
+                                error, errstr);
+}
+
+void Buffer::ThrowLookupError(TransformCacheError error,
+                              const std::string& errstr) const {
+  switch (error) {
+    case TransformCacheError::NOT_CONNECTED:
+      throw tf2::ConnectivityException(errstr);
+    case TransformCacheError::EXTRAPOLATION:
+    case TransformCacheError::BUSY:
+      throw tf2::ExtrapolationException(errstr);
+    default:
+      throw tf2::LookupException(errstr);
+  }
+}
+
 TransformStamped Buffer::lookupTransform(const std::string& target_frame,
                                          const std::string& source_frame,
                                          const cyber::Time& time,
                                          const float timeout_second) const {
+  if (UseSampleLookup()) {
+    TransformSample sample;
+    TransformCacheError error = TransformCacheError::NONE;
+    std::string errstr;
+    if (!LookupSample(target_frame, source_frame, time.ToNanosecond(),
+                      &sample, &error, &errstr)) {
+      ThrowLookupError(error, errstr);
+    }
+    TransformStamped trans_stamped;
+    SampleToCyber(sample, target_frame, source_frame, &trans_stamped);
+    return trans_stamped;
+  }
   tf2::Time tf2_time(time.ToNanosecond());
   geometry_msgs::TransformStamped tf2_trans_stamped =
       tf2::BufferCore::lookupTransform(target_frame, source_frame, tf2_time);
@@ -183,6 +302,22 @@ TransformStamped Buffer::lookupTransform(const std::string& target_frame,
                                          const cyber::Time& source_time,
                                          const std::string& fixed_frame,
                                          const float timeout_second) const {
+  if (UseSampleLookup()) {
+    TransformSample target_fixed;
+    TransformSample fixed_source;
+    TransformCacheError error = TransformCacheError::NONE;
+    std::string errstr;
+    if (!LookupSample(target_frame, fixed_frame, target_time.ToNanosecond(),
+                      &target_fixed, &error, &errstr) ||
+        !LookupSample(fixed_frame, source_frame, source_time.ToNanosecond(),
+                      &fixed_source, &error, &errstr)) {
+      ThrowLookupError(error, errstr);
+    }
+    TransformStamped trans_stamped;
+    SampleToCyber(ComposeSample(target_fixed, fixed_source), target_frame,
+                  source_frame, &trans_stamped);
+    return trans_stamped;
+  }
   geometry_msgs::TransformStamped tf2_trans_stamped =
       tf2::BufferCore::lookupTransform(target_frame, target_time.ToNanosecond(),
                                        source_frame, source_time.ToNanosecond(),
@@ -202,8 +337,14 @@ bool Buffer::canTransform(const std::string& target_frame,
   while (Clock::Now().ToNanosecond() < start_time + timeout_ns &&
          !cyber::IsShutdown()) {
     errstr->clear();
-    bool retval = tf2::BufferCore::canTransform(target_frame, source_frame,
-                                                time.ToNanosecond(), errstr);
+    TransformSample sample;
+    TransformCacheError error = TransformCacheError::NONE;
+    bool retval =
+        UseSampleLookup()
+            ? LookupSample(target_frame, source_frame, time.ToNanosecond(),
+                           &sample, &error, errstr)
+            : tf2::BufferCore::canTransform(target_frame, source_frame,
+                                            time.ToNanosecond(), errstr);
     if (retval) {
       return true;
     } else {
@@ -233,9 +374,19 @@ bool Buffer::canTransform(const std::string& target_frame,
   while (Clock::Now().ToNanosecond() < start_time + timeout_ns &&
          !cyber::IsShutdown()) {  // Make sure we haven't been stopped
     errstr->clear();
-    bool retval = tf2::BufferCore::canTransform(
-        target_frame, target_time.ToNanosecond(), source_frame,
-        source_time.ToNanosecond(), fixed_frame, errstr);
+    TransformSample sample;
+    TransformCacheError error = TransformCacheError::NONE;
+    bool retval =
+        UseSampleLookup()
+            ? LookupSample(target_frame, fixed_frame,
+                           target_time.ToNanosecond(), &sample, &error,
+                           errstr) &&
+                  LookupSample(fixed_frame, source_frame,
+                               source_time.ToNanosecond(), &sample, &error,
+                               errstr)
+            : tf2::BufferCore::canTransform(
+                  target_frame, target_time.ToNanosecond(), source_frame,
+                  source_time.ToNanosecond(), fixed_frame, errstr);
     if (retval) {
       return true;
     } else {
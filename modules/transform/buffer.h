@@ -24,7 +24,11 @@
 #include "tf2/convert.h"
 
 #include "cyber/node/node.h"
+#include "cyber/timer/timer.h"
 #include "modules/transform/buffer_interface.h"
+#include "modules/transform/shm_transform_store.h"
+#include "modules/transform/transform_cache.h"
+#include "modules/transform/transform_gflags.h"
 
 namespace apollo {
 namespace transform {
@@ -124,9 +128,28 @@ class Buffer : public BufferInterface, public tf2::BufferCore {
   void SubscriptionCallbackImpl(
       const std::shared_ptr<const TransformStampeds>& transform,
       bool is_static);
+  void SubscribeTransforms();
+  // run periodically by a reader of the shared memory store, becomes its
+  // writer and subscribes the channels once the writer process is gone
+  void TakeOverShmWriter();
 
   void TF2MsgToCyber(const geometry_msgs::TransformStamped& tf2_trans_stamped,
                      TransformStamped& trans_stamped) const;  // NOLINT
+  void SampleToCyber(const TransformSample& sample,
+                     const std::string& frame_id,
+                     const std::string& child_frame_id,
+                     TransformStamped* trans_stamped) const;
+  // lookups served by the shared memory store or the lock free cache
+  // instead of tf2::BufferCore
+  bool UseSampleLookup() const {
+    return read_from_shm_ || FLAGS_enable_tf_lockfree_lookup;
+  }
+  bool LookupSample(const std::string& target_frame,
+                    const std::string& source_frame, uint64_t time_ns,
+                    TransformSample* sample, TransformCacheError* error,
+                    std::string* errstr) const;
+  [[noreturn]] void ThrowLookupError(TransformCacheError error,
+                                     const std::string& errstr) const;
 
   std::unique_ptr<cyber::Node> node_;
   std::shared_ptr<cyber::Reader<TransformStampeds>> message_subscriber_tf_;
@@ -136,6 +159,13 @@ class Buffer : public BufferInterface, public tf2::BufferCore {
   cyber::Time last_update_;
   std::vector<geometry_msgs::TransformStamped> static_msgs_;
 
+  // host wide transform store, the process owning its writer role keeps
+  // subscribing the channels, the others only read from it
+  std::unique_ptr<ShmTransformStore> shm_store_;
+  bool read_from_shm_ = false;
+  std::unique_ptr<cyber::Timer> writer_check_timer_;
+  TransformCache cache_;
+
   DECLARE_SINGLETON(Buffer)
 };  // class
 
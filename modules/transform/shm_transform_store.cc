@@ -0,0 +1,450 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/transform/shm_transform_store.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace transform {
+
+namespace {
+constexpr uint64_t kStoreMagic = 0x41504f4c4c4f5446;  // "APOLLOTF"
+// a frame tree deeper than this is considered broken
+constexpr int kMaxChainDepth = 32;
+constexpr auto kOpenPollInterval = std::chrono::milliseconds(1);
+}  // namespace
+
+std::unique_ptr<ShmTransformStore> ShmTransformStore::Open(
+    const std::string& name, int timeout_ms) {
+  const size_t size = sizeof(Layout);
+  // only the process creating the segment sizes and initializes it, the
+  // others wait for both before they use it
+  bool created = true;
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    if (errno != EEXIST) {
+      AERROR << "create shm " << name << " failed, error: " << strerror(errno);
+      return nullptr;
+    }
+    created = false;
+    fd = shm_open(name.c_str(), O_RDWR, 0644);
+    if (fd < 0) {
+      AERROR << "open shm " << name << " failed, error: " << strerror(errno);
+      return nullptr;
+    }
+  }
+  if (created && ftruncate(fd, size) < 0) {
+    AERROR << "ftruncate failed: " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+  struct stat file_stat;
+  while (true) {
+    if (fstat(fd, &file_stat) < 0) {
+      AERROR << "fstat shm " << name << " failed: " << strerror(errno);
+      close(fd);
+      return nullptr;
+    }
+    if (static_cast<size_t>(file_stat.st_size) >= size) {
+      break;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      AERROR << "shm " << name << " has unexpected size, remove it and retry.";
+      close(fd);
+      return nullptr;
+    }
+    std::this_thread::sleep_for(kOpenPollInterval);
+  }
+
+  // the descriptor is kept open, the writer role is a lock on it
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    AERROR << "attach shm failed: " << strerror(errno);
+    close(fd);
+    if (created) {
+      shm_unlink(name.c_str());
+    }
+    return nullptr;
+  }
+
+  Layout* layout = static_cast<Layout*>(addr);
+  if (created) {
+    // the segment is zero filled by ftruncate, rings only need their slots
+    // sequence reset which is zero already
+    layout->writer_pid.store(0, std::memory_order_relaxed);
+    layout->edge_num.store(0, std::memory_order_relaxed);
+    layout->magic.store(kStoreMagic, std::memory_order_release);
+  }
+  while (layout->magic.load(std::memory_order_acquire) != kStoreMagic) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      AERROR << "shm " << name << " is not initialized by its creator, "
+             << "remove it and retry.";
+      munmap(addr, size);
+      close(fd);
+      return nullptr;
+    }
+    std::this_thread::sleep_for(kOpenPollInterval);
+  }
+  return std::unique_ptr<ShmTransformStore>(
+      new ShmTransformStore(name, fd, layout));
+}
+
+ShmTransformStore::ShmTransformStore(const std::string& name, int fd,
+                                     Layout* layout)
+    : name_(name), fd_(fd), layout_(layout) {}
+
+ShmTransformStore::~ShmTransformStore() {
+  if (layout_ == nullptr) {
+    return;
+  }
+  if (is_writer_) {
+    int32_t pid = getpid();
+    layout_->writer_pid.compare_exchange_strong(pid, 0);
+  }
+  munmap(layout_, sizeof(Layout));
+  layout_ = nullptr;
+  // releases the writer lock
+  close(fd_);
+  fd_ = -1;
+}
+
+bool ShmTransformStore::IsReady() const {
+  return layout_->magic.load(std::memory_order_acquire) == kStoreMagic;
+}
+
+bool ShmTransformStore::AcquireWriter() {
+  if (is_writer_) {
+    return true;
+  }
+  if (!IsReady()) {
+    return false;
+  }
+  // the kernel drops the lock when the writer process dies, however it dies
+  if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+    if (errno != EWOULDBLOCK) {
+      AERROR << "lock transform store " << name_
+             << " failed: " << strerror(errno);
+    }
+    return false;
+  }
+  const int32_t self = getpid();
+  const int32_t previous = layout_->writer_pid.exchange(self);
+  if (previous != 0) {
+    AWARN << "writer process " << previous << " of transform store " << name_
+          << " is gone without giving the role back.";
+  }
+  // the previous writer may have died in the middle of a push
+  const uint32_t num = edge_num();
+  for (uint32_t i = 0; i < num; ++i) {
+    layout_->edges[i].ring.Recover();
+  }
+  is_writer_ = true;
+  AINFO << "process " << self << " becomes the writer of transform store "
+        << name_;
+  return true;
+}
+
+uint32_t ShmTransformStore::edge_num() const {
+  return std::min(layout_->edge_num.load(std::memory_order_acquire),
+                  kMaxEdgeNum);
+}
+
+int ShmTransformStore::FindEdge(const std::string& child_frame_id,
+                                uint64_t hash) const {
+  const uint32_t num = edge_num();
+  for (uint32_t i = 0; i < num; ++i) {
+    const Edge& edge = layout_->edges[i];
+    if (edge.child_hash == hash &&
+        child_frame_id.compare(edge.child_frame_id) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+bool ShmTransformStore::HasFrame(const std::string& frame) const {
+  const uint32_t num = edge_num();
+  for (uint32_t i = 0; i < num; ++i) {
+    const Edge& edge = layout_->edges[i];
+    if (frame.compare(edge.frame_id) == 0 ||
+        frame.compare(edge.child_frame_id) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ShmTransformStore::SetTransform(const std::string& frame_id,
+                                     const std::string& child_frame_id,
+                                     const TransformSample& sample,
+                                     bool is_static) {
+  if (!is_writer_) {
+    AERROR << "only the writer process can set transforms.";
+    return false;
+  }
+  if (frame_id.empty() || child_frame_id.empty() ||
+      frame_id.size() >= kMaxFrameIdLength ||
+      child_frame_id.size() >= kMaxFrameIdLength) {
+    AERROR << "invalid frame id, frame_id: " << frame_id
+           << ", child_frame_id: " << child_frame_id;
+    return false;
+  }
+  const uint64_t hash = cyber::common::Hash(child_frame_id);
+  int index = FindEdge(child_frame_id, hash);
+  if (index < 0) {
+    const uint32_t num = layout_->edge_num.load(std::memory_order_relaxed);
+    if (num >= kMaxEdgeNum) {
+      AERROR << "too many frames in transform store, drop " << frame_id
+             << " -> " << child_frame_id;
+      return false;
+    }
+    Edge& edge = layout_->edges[num];
+    edge.child_hash = hash;
+    std::strncpy(edge.frame_id, frame_id.c_str(), kMaxFrameIdLength - 1);
+    std::strncpy(edge.child_frame_id, child_frame_id.c_str(),
+                 kMaxFrameIdLength - 1);
+    edge.is_static = is_static ? 1 : 0;
+    edge.ring.Init();
+    // publish the edge after it is fully initialized
+    layout_->edge_num.store(num + 1, std::memory_order_release);
+    index = static_cast<int>(num);
+  }
+  Edge& edge = layout_->edges[index];
+  if (frame_id.compare(edge.frame_id) != 0) {
+    AWARN << "frame " << child_frame_id << " changes parent from "
+          << edge.frame_id << " to " << frame_id << ", ignored.";
+    return false;
+  }
+  if (edge.ring.Push(sample)) {
+    return true;
+  }
+  if (!edge.is_static) {
+    return false;
+  }
+  // static transforms are time independent, the latest one wins
+  edge.ring.Clear();
+  return edge.ring.Push(sample);
+}
+
+void ShmTransformStore::ClearDynamic() {
+  if (!is_writer_) {
+    return;
+  }
+  const uint32_t num = edge_num();
+  for (uint32_t i = 0; i < num; ++i) {
+    if (!layout_->edges[i].is_static) {
+      layout_->edges[i].ring.Clear();
+    }
+  }
+}
+
+RingLookupStatus ShmTransformStore::LookupEdge(
+    const Edge& edge, uint64_t stamp_ns, TransformSample* sample) const {
+  return edge.ring.Lookup(edge.is_static ? 0 : stamp_ns, sample);
+}
+
+bool ShmTransformStore::GetLatestStatic(const std::string& frame_id,
+                                        const std::string& child_frame_id,
+                                        TransformSample* transform) const {
+  if (!IsReady()) {
+    return false;
+  }
+  int index = FindEdge(child_frame_id, cyber::common::Hash(child_frame_id));
+  if (index < 0) {
+    return false;
+  }
+  const Edge& edge = layout_->edges[index];
+  return edge.is_static && frame_id.compare(edge.frame_id) == 0 &&
+         edge.ring.Lookup(0, transform) == RingLookupStatus::OK;
+}
+
+bool ShmTransformStore::LookupTransform(const std::string& target_frame,
+                                        const std::string& source_frame,
+                                        uint64_t stamp_ns,
+                                        TransformSample* transform,
+                                        TransformCacheError* error,
+                                        std::string* errstr) const {
+  auto set_error = [error, errstr](TransformCacheError code,
+                                   const std::string& reason) {
+    if (error != nullptr) {
+      *error = code;
+    }
+    if (errstr != nullptr) {
+      *errstr = reason;
+    }
+    return false;
+  };
+  if (!IsReady()) {
+    return set_error(TransformCacheError::UNKNOWN_FRAME,
+                     "transform store is not initialized");
+  }
+  if (error != nullptr) {
+    *error = TransformCacheError::NONE;
+  }
+  if (target_frame == source_frame) {
+    *transform = TransformSample();
+    transform->stamp_ns = stamp_ns;
+    return true;
+  }
+
+  // ancestors of the source frame with their depth, only the edges below the
+  // common ancestor are looked up so unrelated edges never fail a lookup
+  std::vector<int> source_edges;
+  std::unordered_map<std::string, size_t> source_depth;
+  std::string frame = source_frame;
+  source_depth.emplace(frame, 0);
+  for (int depth = 0; depth < kMaxChainDepth; ++depth) {
+    int index = FindEdge(frame, cyber::common::Hash(frame));
+    if (index < 0) {
+      break;
+    }
+    source_edges.push_back(index);
+    frame = layout_->edges[index].frame_id;
+    source_depth.emplace(frame, source_edges.size());
+  }
+
+  std::vector<int> target_edges;
+  frame = target_frame;
+  auto common = source_depth.find(frame);
+  for (int depth = 0;
+       common == source_depth.end() && depth < kMaxChainDepth; ++depth) {
+    int index = FindEdge(frame, cyber::common::Hash(frame));
+    if (index < 0) {
+      break;
+    }
+    target_edges.push_back(index);
+    frame = layout_->edges[index].frame_id;
+    common = source_depth.find(frame);
+  }
+  auto status_error = [&set_error](RingLookupStatus status,
+                                   const std::string& reason) {
+    return set_error(status == RingLookupStatus::BUSY
+                         ? TransformCacheError::BUSY
+                         : TransformCacheError::EXTRAPOLATION,
+                     reason + ", status: " +
+                         std::to_string(static_cast<int>(status)));
+  };
+
+  if (common == source_depth.end()) {
+    for (const auto& frame_name : {target_frame, source_frame}) {
+      if (!HasFrame(frame_name)) {
+        return set_error(TransformCacheError::UNKNOWN_FRAME,
+                         "unknown frame " + frame_name);
+      }
+    }
+    // tf2 reports an edge that can not serve the stamp before the broken
+    // connection, as TransformCache does
+    for (const auto* edges : {&source_edges, &target_edges}) {
+      for (size_t i = 0; stamp_ns != 0 && i < edges->size(); ++i) {
+        const Edge& edge = layout_->edges[(*edges)[i]];
+        TransformSample parent_child;
+        RingLookupStatus status = LookupEdge(edge, stamp_ns, &parent_child);
+        if (status != RingLookupStatus::OK) {
+          return status_error(status, "lookup " +
+                                          std::string(edge.frame_id) +
+                                          " -> " + edge.child_frame_id +
+                                          " at " + std::to_string(stamp_ns) +
+                                          " failed");
+        }
+      }
+    }
+    return set_error(TransformCacheError::NOT_CONNECTED,
+                     "frame " + target_frame + " and " + source_frame +
+                         " are not connected");
+  }
+
+  // the latest time every dynamic edge of the chain can serve, the same as
+  // TransformCache and tf2
+  if (stamp_ns == 0) {
+    uint64_t common_stamp = std::numeric_limits<uint64_t>::max();
+    auto latest_stamp = [this, &common_stamp, &status_error](
+                            const std::vector<int>& edges, size_t depth) {
+      for (size_t i = 0; i < depth; ++i) {
+        const Edge& edge = layout_->edges[edges[i]];
+        if (edge.is_static) {
+          continue;
+        }
+        TransformSample latest;
+        RingLookupStatus status = edge.ring.Lookup(0, &latest);
+        if (status != RingLookupStatus::OK) {
+          return status_error(status, "no transform for frame " +
+                                          std::string(edge.child_frame_id));
+        }
+        common_stamp = std::min(common_stamp, latest.stamp_ns);
+      }
+      return true;
+    };
+    if (!latest_stamp(source_edges, common->second) ||
+        !latest_stamp(target_edges, target_edges.size())) {
+      return false;
+    }
+    if (common_stamp != std::numeric_limits<uint64_t>::max()) {
+      stamp_ns = common_stamp;
+    }
+  }
+
+  // pose of the source and the target frame in the common ancestor
+  auto compose_chain = [this, stamp_ns, &status_error](
+                           const std::vector<int>& edges, size_t depth,
+                           TransformSample* ancestor_child) {
+    for (size_t i = 0; i < depth; ++i) {
+      const Edge& edge = layout_->edges[edges[i]];
+      TransformSample parent_child;
+      RingLookupStatus status = LookupEdge(edge, stamp_ns, &parent_child);
+      if (status != RingLookupStatus::OK) {
+        return status_error(status, "lookup " + std::string(edge.frame_id) +
+                                        " -> " + edge.child_frame_id +
+                                        " at " + std::to_string(stamp_ns) +
+                                        " failed");
+      }
+      *ancestor_child = ComposeSample(parent_child, *ancestor_child);
+    }
+    return true;
+  };
+  TransformSample ancestor_source;
+  TransformSample ancestor_target;
+  if (!compose_chain(source_edges, common->second, &ancestor_source) ||
+      !compose_chain(target_edges, target_edges.size(), &ancestor_target)) {
+    return false;
+  }
+  *transform = ComposeSample(InverseSample(ancestor_target), ancestor_source);
+  transform->stamp_ns = stamp_ns;
+  return true;
+}
+
+}  // namespace transform
+}  // namespace apollo
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest_prod.h"
+
+#include "modules/transform/transform_cache.h"
+#include "modules/transform/transform_ring.h"
+
+namespace apollo {
+namespace transform {
+
+/**
+ * @class ShmTransformStore
+ * @brief Host wide transform history in POSIX shared memory.
+ *
+ * One process owns the writer role and feeds every /tf and /tf_static
+ * message into the store, all the other processes look transforms up
+ * directly from the mapped segment without subscribing to the channels.
+ * Each (frame_id, child_frame_id) edge has a seqlocked TransformRing so
+ * lookups never block the writer nor each other.
+ */
+class ShmTransformStore {
+ public:
+  static constexpr uint32_t kMaxEdgeNum = 64;
+  static constexpr uint32_t kRingSize = 1024;
+  static constexpr uint32_t kMaxFrameIdLength = 64;
+
+  /**
+   * @brief Open the segment `name`, create and initialize it if it does not
+   * exist yet. A process opening a segment created by another one waits up
+   * to `timeout_ms` for the creator to initialize it. Returns nullptr on
+   * failure.
+   */
+  static std::unique_ptr<ShmTransformStore> Open(const std::string& name,
+                                                 int timeout_ms = 1000);
+
+  ~ShmTransformStore();
+
+  /**
+   * @brief Try to become the single writer of the store. The role is an
+   * exclusive flock on the segment, it is taken over when the previous
+   * writer process is gone, so readers call it again from time to time.
+   */
+  bool AcquireWriter();
+  bool IsWriter() const { return is_writer_; }
+
+  // writer only
+  bool SetTransform(const std::string& frame_id,
+                    const std::string& child_frame_id,
+                    const TransformSample& sample, bool is_static);
+  void ClearDynamic();
+
+  /**
+   * @brief Transform mapping data from `source_frame` into `target_frame` at
+   * `stamp_ns`. A zero stamp uses the latest time available on every edge
+   * of the chain, as TransformCache and tf2 do. On failure `error` tells
+   * why, the same way TransformCache does.
+   */
+  bool LookupTransform(const std::string& target_frame,
+                       const std::string& source_frame, uint64_t stamp_ns,
+                       TransformSample* transform,
+                       TransformCacheError* error = nullptr,
+                       std::string* errstr = nullptr) const;
+
+  bool GetLatestStatic(const std::string& frame_id,
+                       const std::string& child_frame_id,
+                       TransformSample* transform) const;
+
+  uint32_t edge_num() const;
+
+ private:
+  struct Edge {
+    uint64_t child_hash;
+    char frame_id[kMaxFrameIdLength];
+    char child_frame_id[kMaxFrameIdLength];
+    uint32_t is_static;
+    TransformRing<kRingSize> ring;
+  };
+
+  struct Layout {
+    std::atomic<uint64_t> magic;
+    // informative only, the writer role is the lock on the segment
+    std::atomic<int32_t> writer_pid;
+    std::atomic<uint32_t> edge_num;
+    Edge edges[kMaxEdgeNum];
+  };
+
+  ShmTransformStore(const std::string& name, int fd, Layout* layout);
+
+  FRIEND_TEST(ShmTransformStoreTest, TakeOverAfterCrash);
+
+  bool IsReady() const;
+  // index of the edge whose child is `child_frame_id`, -1 if none
+  int FindEdge(const std::string& child_frame_id, uint64_t hash) const;
+  // whether any edge has `frame` as its parent or child
+  bool HasFrame(const std::string& frame) const;
+  RingLookupStatus LookupEdge(const Edge& edge, uint64_t stamp_ns,
+                              TransformSample* sample) const;
+
+  std::string name_;
+  int fd_ = -1;
+  Layout* layout_ = nullptr;
+  bool is_writer_ = false;
+};
+
+}  // namespace transform
+}  // namespace apollo
@@ -0,0 +1,419 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/transform/shm_transform_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "tf2/buffer_core.h"
+#include "tf2/exceptions.h"
+
+namespace apollo {
+namespace transform {
+
+namespace {
+
+TransformSample MakeSample(uint64_t stamp_ns, double x, double y,
+                           double yaw) {
+  TransformSample sample;
+  sample.stamp_ns = stamp_ns;
+  sample.translation[0] = x;
+  sample.translation[1] = y;
+  sample.rotation[2] = std::sin(yaw / 2.0);
+  sample.rotation[3] = std::cos(yaw / 2.0);
+  return sample;
+}
+
+geometry_msgs::TransformStamped ToTf2(const std::string& frame_id,
+                                      const std::string& child_frame_id,
+                                      const TransformSample& sample) {
+  geometry_msgs::TransformStamped msg;
+  msg.header.stamp = sample.stamp_ns;
+  msg.header.frame_id = frame_id;
+  msg.child_frame_id = child_frame_id;
+  msg.transform.translation.x = sample.translation[0];
+  msg.transform.translation.y = sample.translation[1];
+  msg.transform.translation.z = sample.translation[2];
+  msg.transform.rotation.x = sample.rotation[0];
+  msg.transform.rotation.y = sample.rotation[1];
+  msg.transform.rotation.z = sample.rotation[2];
+  msg.transform.rotation.w = sample.rotation[3];
+  return msg;
+}
+
+void ExpectSameTransform(const geometry_msgs::TransformStamped& expected,
+                         const TransformSample& result) {
+  EXPECT_EQ(result.stamp_ns, expected.header.stamp);
+  EXPECT_NEAR(result.translation[0], expected.transform.translation.x, 1e-9);
+  EXPECT_NEAR(result.translation[1], expected.transform.translation.y, 1e-9);
+  EXPECT_NEAR(result.translation[2], expected.transform.translation.z, 1e-9);
+  // q and -q are the same rotation
+  const double dot = result.rotation[0] * expected.transform.rotation.x +
+                     result.rotation[1] * expected.transform.rotation.y +
+                     result.rotation[2] * expected.transform.rotation.z +
+                     result.rotation[3] * expected.transform.rotation.w;
+  EXPECT_NEAR(std::fabs(dot), 1.0, 1e-9);
+}
+
+class ShmTransformStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    name_ = "/shm_transform_store_test_" + std::to_string(getpid());
+    shm_unlink(name_.c_str());
+    writer_ = ShmTransformStore::Open(name_);
+    ASSERT_NE(writer_, nullptr);
+    ASSERT_TRUE(writer_->AcquireWriter());
+  }
+
+  void TearDown() override {
+    writer_.reset();
+    shm_unlink(name_.c_str());
+  }
+
+  std::string name_;
+  std::unique_ptr<ShmTransformStore> writer_;
+};
+
+}  // namespace
+
+TEST(TransformRingTest, Lookup) {
+  static TransformRing<8> ring;
+  ring.Init();
+  TransformSample sample;
+  EXPECT_EQ(ring.Lookup(0, &sample), RingLookupStatus::EMPTY);
+  for (uint64_t i = 1; i <= 20; ++i) {
+    EXPECT_TRUE(ring.Push(MakeSample(i * 100, static_cast<double>(i), 0, 0)));
+  }
+  EXPECT_FALSE(ring.Push(MakeSample(100, 0, 0, 0)));
+  EXPECT_EQ(ring.size(), 7);
+
+  EXPECT_EQ(ring.Lookup(0, &sample), RingLookupStatus::OK);
+  EXPECT_EQ(sample.stamp_ns, 2000);
+  EXPECT_EQ(ring.Lookup(1850, &sample), RingLookupStatus::OK);
+  EXPECT_NEAR(sample.translation[0], 18.5, 1e-9);
+  EXPECT_EQ(ring.Lookup(1400, &sample), RingLookupStatus::OK);
+  EXPECT_NEAR(sample.translation[0], 14.0, 1e-9);
+  EXPECT_EQ(ring.Lookup(1000, &sample), RingLookupStatus::EXTRAPOLATION_PAST);
+  EXPECT_EQ(ring.Lookup(2100, &sample),
+            RingLookupStatus::EXTRAPOLATION_FUTURE);
+
+  ring.Clear();
+  EXPECT_EQ(ring.Lookup(0, &sample), RingLookupStatus::EMPTY);
+  EXPECT_TRUE(ring.Push(MakeSample(50, 0, 0, 0)));
+}
+
+TEST(TransformRingTest, CrashInPush) {
+  static TransformRing<8> ring;
+  ring.Init();
+  for (uint64_t i = 1; i <= 20; ++i) {
+    EXPECT_TRUE(ring.Push(MakeSample(i * 100, static_cast<double>(i), 0, 0)));
+  }
+  // the writer dies after it marked the next slot as under writing and
+  // wrote part of the sample
+  auto crash_in_push = [](uint64_t stamp_ns) {
+    const uint64_t count = ring.count_.load();
+    auto& slot = ring.slots_[count % 8];
+    slot.seq.fetch_add(1);
+    slot.index = count;
+    slot.sample = MakeSample(stamp_ns, -1.0, 0, 0);
+  };
+  crash_in_push(2100);
+  TransformSample sample;
+  EXPECT_EQ(ring.Lookup(0, &sample), RingLookupStatus::OK);
+  EXPECT_EQ(sample.stamp_ns, 2000);
+  EXPECT_EQ(ring.Lookup(1450, &sample), RingLookupStatus::OK);
+  EXPECT_NEAR(sample.translation[0], 14.5, 1e-9);
+
+  // the next push still leaves the slot readable
+  EXPECT_TRUE(ring.Push(MakeSample(2100, 21.0, 0, 0)));
+  EXPECT_EQ(ring.Lookup(0, &sample), RingLookupStatus::OK);
+  EXPECT_EQ(sample.stamp_ns, 2100);
+  EXPECT_EQ(ring.Lookup(2050, &sample), RingLookupStatus::OK);
+  EXPECT_NEAR(sample.translation[0], 20.5, 1e-9);
+
+  // a new writer recovers the ring before it goes on
+  crash_in_push(2200);
+  ring.Recover();
+  EXPECT_EQ(ring.size(), 7);
+  EXPECT_EQ(ring.Lookup(1550, &sample), RingLookupStatus::OK);
+  EXPECT_NEAR(sample.translation[0], 15.5, 1e-9);
+  EXPECT_FALSE(ring.Push(MakeSample(2000, 0, 0, 0)));
+  for (uint64_t i = 22; i <= 30; ++i) {
+    EXPECT_TRUE(ring.Push(MakeSample(i * 100, static_cast<double>(i), 0, 0)));
+  }
+  EXPECT_EQ(ring.Lookup(2450, &sample), RingLookupStatus::OK);
+  EXPECT_NEAR(sample.translation[0], 24.5, 1e-9);
+  EXPECT_EQ(ring.Lookup(0, &sample), RingLookupStatus::OK);
+  EXPECT_EQ(sample.stamp_ns, 3000);
+}
+
+TEST_F(ShmTransformStoreTest, ChainLookup) {
+  // world -> localization -> novatel, localization -> velodyne (static)
+  EXPECT_TRUE(writer_->SetTransform(
+      "world", "localization", MakeSample(1000, 10.0, 0.0, M_PI_2), false));
+  EXPECT_TRUE(writer_->SetTransform(
+      "world", "localization", MakeSample(2000, 20.0, 0.0, M_PI_2), false));
+  EXPECT_TRUE(writer_->SetTransform("localization", "novatel",
+                                    MakeSample(0, 1.0, 0.0, 0.0), true));
+  EXPECT_TRUE(writer_->SetTransform("localization", "velodyne",
+                                    MakeSample(0, 0.0, 2.0, 0.0), true));
+  EXPECT_FALSE(writer_->SetTransform("world", "novatel",
+                                     MakeSample(0, 0.0, 0.0, 0.0), true));
+
+  auto reader = ShmTransformStore::Open(name_);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_FALSE(reader->IsWriter());
+  EXPECT_EQ(reader->edge_num(), 3);
+
+  TransformSample result;
+  // novatel origin in world at t = 1500: localization at (15, 0), rotated by
+  // 90 degrees, novatel is 1m ahead along the localization x axis
+  ASSERT_TRUE(reader->LookupTransform("world", "novatel", 1500, &result));
+  EXPECT_NEAR(result.translation[0], 15.0, 1e-6);
+  EXPECT_NEAR(result.translation[1], 1.0, 1e-6);
+
+  // sibling frames only go through the static edges
+  ASSERT_TRUE(reader->LookupTransform("novatel", "velodyne", 0, &result));
+  EXPECT_NEAR(result.translation[0], -1.0, 1e-6);
+  EXPECT_NEAR(result.translation[1], 2.0, 1e-6);
+
+  ASSERT_TRUE(reader->LookupTransform("novatel", "world", 2000, &result));
+  TransformSample forward;
+  ASSERT_TRUE(reader->LookupTransform("world", "novatel", 2000, &forward));
+  TransformSample identity = ComposeSample(forward, result);
+  EXPECT_NEAR(identity.translation[0], 0.0, 1e-6);
+  EXPECT_NEAR(identity.translation[1], 0.0, 1e-6);
+
+  TransformCacheError error = TransformCacheError::NONE;
+  std::string errstr;
+  EXPECT_FALSE(reader->LookupTransform("world", "novatel", 3000, &result,
+                                       &error, &errstr));
+  EXPECT_EQ(error, TransformCacheError::EXTRAPOLATION);
+  EXPECT_FALSE(errstr.empty());
+  EXPECT_FALSE(
+      reader->LookupTransform("world", "unknown", 0, &result, &error));
+  EXPECT_EQ(error, TransformCacheError::UNKNOWN_FRAME);
+  EXPECT_TRUE(writer_->SetTransform("map", "imu",
+                                    MakeSample(0, 0.0, 0.0, 0.0), true));
+  EXPECT_FALSE(reader->LookupTransform("world", "imu", 0, &result, &error));
+  EXPECT_EQ(error, TransformCacheError::NOT_CONNECTED);
+  EXPECT_TRUE(reader->LookupTransform("world", "novatel", 0, &result, &error));
+  EXPECT_EQ(error, TransformCacheError::NONE);
+
+  EXPECT_TRUE(reader->GetLatestStatic("localization", "velodyne", &result));
+  EXPECT_FALSE(reader->GetLatestStatic("world", "localization", &result));
+
+  writer_->ClearDynamic();
+  EXPECT_FALSE(reader->LookupTransform("world", "novatel", 0, &result));
+  EXPECT_TRUE(reader->LookupTransform("novatel", "velodyne", 0, &result));
+}
+
+TEST_F(ShmTransformStoreTest, TakeOverWriter) {
+  // the role of this process is given back, a child process becomes the
+  // writer and exits without giving it back once the parent lets it go
+  writer_.reset();
+  int to_child[2];
+  int to_parent[2];
+  ASSERT_EQ(pipe(to_child), 0);
+  ASSERT_EQ(pipe(to_parent), 0);
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    auto child = ShmTransformStore::Open(name_);
+    const char acquired = child != nullptr && child->AcquireWriter();
+    char done = 0;
+    if (write(to_parent[1], &acquired, 1) != 1 ||
+        read(to_child[0], &done, 1) != 1) {
+      _exit(1);
+    }
+    _exit(0);
+  }
+  char acquired = 0;
+  ASSERT_EQ(read(to_parent[0], &acquired, 1), 1);
+  ASSERT_TRUE(acquired);
+
+  auto reader = ShmTransformStore::Open(name_);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_FALSE(reader->AcquireWriter());
+
+  const char done = 1;
+  ASSERT_EQ(write(to_child[1], &done, 1), 1);
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  for (int fd : {to_child[0], to_child[1], to_parent[0], to_parent[1]}) {
+    close(fd);
+  }
+
+  EXPECT_TRUE(reader->AcquireWriter());
+  EXPECT_TRUE(reader->IsWriter());
+  EXPECT_TRUE(reader->SetTransform("world", "localization",
+                                   MakeSample(1000, 1.0, 0.0, 0.0), false));
+}
+
+TEST_F(ShmTransformStoreTest, TakeOverAfterCrash) {
+  // a child process becomes the writer and dies in the middle of a push
+  writer_.reset();
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    auto child = ShmTransformStore::Open(name_);
+    if (child == nullptr || !child->AcquireWriter()) {
+      _exit(1);
+    }
+    for (uint64_t i = 1; i <= 3; ++i) {
+      child->SetTransform("world", "localization",
+                          MakeSample(i * 1000, static_cast<double>(i), 0, 0),
+                          false);
+    }
+    auto& ring = child->layout_->edges[0].ring;
+    const uint64_t count = ring.count_.load();
+    auto& slot = ring.slots_[count % ShmTransformStore::kRingSize];
+    slot.seq.fetch_add(1);
+    slot.index = count;
+    slot.sample = MakeSample(4000, -1.0, 0, 0);
+    _exit(0);
+  }
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  auto store = ShmTransformStore::Open(name_);
+  ASSERT_NE(store, nullptr);
+  ASSERT_TRUE(store->AcquireWriter());
+  TransformSample result;
+  ASSERT_TRUE(store->LookupTransform("world", "localization", 0, &result));
+  EXPECT_EQ(result.stamp_ns, 3000);
+  EXPECT_FALSE(store->SetTransform("world", "localization",
+                                   MakeSample(2500, 0, 0, 0), false));
+  EXPECT_TRUE(store->SetTransform("world", "localization",
+                                  MakeSample(4000, 4.0, 0, 0), false));
+  ASSERT_TRUE(store->LookupTransform("world", "localization", 0, &result));
+  EXPECT_EQ(result.stamp_ns, 4000);
+  EXPECT_NEAR(result.translation[0], 4.0, 1e-9);
+  ASSERT_TRUE(store->LookupTransform("world", "localization", 3500, &result));
+  EXPECT_NEAR(result.translation[0], 3.5, 1e-9);
+}
+
+TEST_F(ShmTransformStoreTest, SameAsBufferCore) {
+  struct Edge {
+    const char* frame_id;
+    const char* child_frame_id;
+    TransformSample sample;
+    bool is_static;
+  };
+  // localization and imu are sampled at different times
+  const std::vector<Edge> edges = {
+      {"world", "localization", MakeSample(1000, 10.0, 0.0, 0.0), false},
+      {"world", "localization", MakeSample(2000, 20.0, 5.0, M_PI_2), false},
+      {"world", "localization", MakeSample(3000, 30.0, 10.0, M_PI), false},
+      {"localization", "imu", MakeSample(1500, 0.5, 0.0, 0.1), false},
+      {"localization", "imu", MakeSample(2600, 1.5, 0.2, -0.1), false},
+      {"imu", "velodyne", MakeSample(0, 1.0, 0.0, 0.3), true},
+      {"localization", "camera", MakeSample(0, 2.0, 1.0, -0.2), true},
+      {"map", "odom", MakeSample(2000, 1.0, 0.0, 0.0), false},
+  };
+  tf2::BufferCore buffer;
+  for (const auto& edge : edges) {
+    ASSERT_TRUE(buffer.setTransform(
+        ToTf2(edge.frame_id, edge.child_frame_id, edge.sample), "test",
+        edge.is_static));
+    ASSERT_TRUE(writer_->SetTransform(edge.frame_id, edge.child_frame_id,
+                                      edge.sample, edge.is_static));
+  }
+  auto reader = ShmTransformStore::Open(name_);
+  ASSERT_NE(reader, nullptr);
+
+  const std::vector<std::pair<std::string, std::string>> frame_pairs = {
+      {"world", "velodyne"},     {"velodyne", "world"},
+      {"camera", "velodyne"},    {"imu", "camera"},
+      {"world", "localization"}, {"world", "odom"},
+      {"odom", "unknown"}};
+  for (const auto& frames : frame_pairs) {
+    for (uint64_t stamp : {0, 1000, 1500, 1700, 2000, 2345, 2600, 2900, 3000,
+                           3100}) {
+      SCOPED_TRACE(frames.first + " <- " + frames.second + " at " +
+                   std::to_string(stamp));
+      geometry_msgs::TransformStamped expected;
+      TransformCacheError expected_error = TransformCacheError::NONE;
+      try {
+        expected =
+            buffer.lookupTransform(frames.first, frames.second, stamp);
+      } catch (const tf2::ExtrapolationException&) {
+        expected_error = TransformCacheError::EXTRAPOLATION;
+      } catch (const tf2::ConnectivityException&) {
+        expected_error = TransformCacheError::NOT_CONNECTED;
+      } catch (const tf2::LookupException&) {
+        expected_error = TransformCacheError::UNKNOWN_FRAME;
+      }
+      TransformSample result;
+      TransformCacheError error = TransformCacheError::NONE;
+      EXPECT_EQ(reader->LookupTransform(frames.first, frames.second, stamp,
+                                        &result, &error),
+                expected_error == TransformCacheError::NONE);
+      ASSERT_EQ(error, expected_error);
+      if (error == TransformCacheError::NONE) {
+        ExpectSameTransform(expected, result);
+      }
+    }
+  }
+}
+
+TEST(ShmTransformStoreOpenTest, WaitForCreator) {
+  const std::string name =
+      "/shm_transform_store_open_test_" + std::to_string(getpid());
+  shm_unlink(name.c_str());
+
+  // created but never sized nor initialized
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  EXPECT_EQ(ShmTransformStore::Open(name, 10), nullptr);
+  shm_unlink(name.c_str());
+
+  // processes starting at the same time all get an initialized store
+  std::vector<std::unique_ptr<ShmTransformStore>> stores(4);
+  std::vector<std::thread> threads;
+  for (auto& store : stores) {
+    threads.emplace_back(
+        [&name, &store]() { store = ShmTransformStore::Open(name); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& store : stores) {
+    ASSERT_NE(store, nullptr);
+    EXPECT_EQ(store->edge_num(), 0);
+  }
+  stores.clear();
+  shm_unlink(name.c_str());
+}
+
+}  // namespace transform
+}  // namespace apollo
@@ -0,0 +1,303 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/transform/transform_cache.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace transform {
+
+TransformCache::TransformCache() {
+  for (auto& slot : index_) {
+    slot.store(kInvalidFrameId, std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+TransformCache::~TransformCache() {}
+
+int32_t TransformCache::FindFrame(const std::string& frame,
+                                  uint64_t hash) const {
+  for (uint32_t i = 0; i < kIndexSize; ++i) {
+    const int32_t id =
+        index_[(hash + i) % kIndexSize].load(std::memory_order_acquire);
+    if (id == kInvalidFrameId) {
+      return kInvalidFrameId;
+    }
+    const Frame& item = *frames_[id];
+    if (item.hash == hash && item.name == frame) {
+      return id;
+    }
+  }
+  return kInvalidFrameId;
+}
+
+int32_t TransformCache::FindOrAddFrame(const std::string& frame) {
+  const uint64_t hash = cyber::common::Hash(frame);
+  int32_t id = FindFrame(frame, hash);
+  if (id != kInvalidFrameId) {
+    return id;
+  }
+  const uint32_t num = frame_num_.load(std::memory_order_relaxed);
+  if (num >= kMaxFrameNum) {
+    AERROR << "too many frames in transform cache, drop frame " << frame;
+    return kInvalidFrameId;
+  }
+  std::unique_ptr<Frame> item(new Frame());
+  item->name = frame;
+  item->hash = hash;
+  item->ring.Init();
+  frames_[num] = std::move(item);
+  frame_num_.store(num + 1, std::memory_order_release);
+
+  // the index has twice as many slots as frames, a free one always exists
+  uint32_t slot = hash % kIndexSize;
+  while (index_[slot].load(std::memory_order_relaxed) != kInvalidFrameId) {
+    slot = (slot + 1) % kIndexSize;
+  }
+  index_[slot].store(static_cast<int32_t>(num), std::memory_order_release);
+  return static_cast<int32_t>(num);
+}
+
+int32_t TransformCache::GetFrameId(const std::string& frame) const {
+  return FindFrame(frame, cyber::common::Hash(frame));
+}
+
+bool TransformCache::SetTransform(const std::string& frame_id,
+                                  const std::string& child_frame_id,
+                                  const TransformSample& sample,
+                                  bool is_static) {
+  if (frame_id.empty() || child_frame_id.empty() ||
+      frame_id == child_frame_id) {
+    AERROR << "invalid frame id, frame_id: " << frame_id
+           << ", child_frame_id: " << child_frame_id;
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  const int32_t parent = FindOrAddFrame(frame_id);
+  const int32_t child = FindOrAddFrame(child_frame_id);
+  if (parent == kInvalidFrameId || child == kInvalidFrameId) {
+    return false;
+  }
+
+  Frame& item = *frames_[child];
+  const int32_t old_parent = item.parent.load(std::memory_order_relaxed);
+  if (old_parent != parent) {
+    if (old_parent != kInvalidFrameId) {
+      AWARN << "frame " << child_frame_id << " changes parent from "
+            << frames_[old_parent]->name << " to " << frame_id;
+      item.ring.Clear();
+    }
+    item.parent.store(parent, std::memory_order_release);
+  }
+  item.is_static.store(is_static, std::memory_order_release);
+  if (item.ring.Push(sample)) {
+    return true;
+  }
+  if (!is_static) {
+    return false;
+  }
+  // static transforms are time independent, the latest one wins
+  item.ring.Clear();
+  return item.ring.Push(sample);
+}
+
+void TransformCache::ClearDynamic() {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  const uint32_t num = frame_num_.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < num; ++i) {
+    if (!frames_[i]->is_static.load(std::memory_order_relaxed)) {
+      frames_[i]->ring.Clear();
+    }
+  }
+}
+
+int TransformCache::GetChain(int32_t frame_id, int32_t* chain) const {
+  int length = 0;
+  while (frame_id != kInvalidFrameId && length <= kMaxChainDepth) {
+    chain[length++] = frame_id;
+    frame_id = frames_[frame_id]->parent.load(std::memory_order_acquire);
+  }
+  return length;
+}
+
+bool TransformCache::LookupTransform(int32_t target_id, int32_t source_id,
+                                     uint64_t stamp_ns,
+                                     TransformSample* transform,
+                                     TransformCacheError* error,
+                                     std::string* errstr) const {
+  auto set_error = [error, errstr](TransformCacheError code,
+                                   const std::string& reason) {
+    if (error != nullptr) {
+      *error = code;
+    }
+    if (errstr != nullptr) {
+      *errstr = reason;
+    }
+    return false;
+  };
+  const int32_t num = static_cast<int32_t>(frame_num());
+  if (target_id < 0 || target_id >= num || source_id < 0 ||
+      source_id >= num) {
+    return set_error(TransformCacheError::UNKNOWN_FRAME,
+                     "invalid frame id " + std::to_string(target_id) +
+                         " or " + std::to_string(source_id));
+  }
+  if (error != nullptr) {
+    *error = TransformCacheError::NONE;
+  }
+  if (target_id == source_id) {
+    *transform = TransformSample();
+    transform->stamp_ns = stamp_ns;
+    return true;
+  }
+
+  int32_t source_chain[kMaxChainDepth + 1];
+  int32_t target_chain[kMaxChainDepth + 1];
+  const int source_length = GetChain(source_id, source_chain);
+  const int target_length = GetChain(target_id, target_chain);
+  // depth of the common ancestor in the source and the target chain
+  int source_depth = -1;
+  int target_depth = 0;
+  for (; target_depth < target_length; ++target_depth) {
+    const int32_t* iter = std::find(source_chain, source_chain + source_length,
+                                    target_chain[target_depth]);
+    if (iter != source_chain + source_length) {
+      source_depth = static_cast<int>(iter - source_chain);
+      break;
+    }
+  }
+  auto status_error = [&set_error](RingLookupStatus status,
+                                   const std::string& reason) {
+    return set_error(status == RingLookupStatus::BUSY
+                         ? TransformCacheError::BUSY
+                         : TransformCacheError::EXTRAPOLATION,
+                     reason + ", status: " +
+                         std::to_string(static_cast<int>(status)));
+  };
+
+  if (source_depth < 0) {
+    // tf2 reports an edge that can not serve the stamp before the broken
+    // connection
+    for (const auto& chain : {std::make_pair(source_chain, source_length),
+                              std::make_pair(target_chain, target_length)}) {
+      for (int i = 0; stamp_ns != 0 && i + 1 < chain.second; ++i) {
+        const Frame& item = *frames_[chain.first[i]];
+        if (item.is_static.load(std::memory_order_acquire)) {
+          continue;
+        }
+        TransformSample parent_child;
+        RingLookupStatus status = item.ring.Lookup(stamp_ns, &parent_child);
+        if (status != RingLookupStatus::OK) {
+          return status_error(status, "lookup " + item.name + " at " +
+                                          std::to_string(stamp_ns) +
+                                          " failed");
+        }
+      }
+    }
+    return set_error(TransformCacheError::NOT_CONNECTED,
+                     "frame " + frames_[target_id]->name + " and " +
+                         frames_[source_id]->name + " are not connected");
+  }
+
+  // the latest time every dynamic edge of the chain can serve
+  if (stamp_ns == 0) {
+    uint64_t common_stamp = std::numeric_limits<uint64_t>::max();
+    auto latest_stamp = [this, &common_stamp, &status_error](
+                            const int32_t* chain, int depth) {
+      for (int i = 0; i < depth; ++i) {
+        const Frame& item = *frames_[chain[i]];
+        if (item.is_static.load(std::memory_order_acquire)) {
+          continue;
+        }
+        TransformSample latest;
+        RingLookupStatus status = item.ring.Lookup(0, &latest);
+        if (status != RingLookupStatus::OK) {
+          return status_error(status, "no transform for frame " + item.name);
+        }
+        common_stamp = std::min(common_stamp, latest.stamp_ns);
+      }
+      return true;
+    };
+    if (!latest_stamp(source_chain, source_depth) ||
+        !latest_stamp(target_chain, target_depth)) {
+      return false;
+    }
+    if (common_stamp != std::numeric_limits<uint64_t>::max()) {
+      stamp_ns = common_stamp;
+    }
+  }
+
+  auto compose_chain = [this, stamp_ns, &status_error](
+                           const int32_t* chain, int depth,
+                           TransformSample* ancestor_child) {
+    for (int i = 0; i < depth; ++i) {
+      const Frame& item = *frames_[chain[i]];
+      const bool is_static = item.is_static.load(std::memory_order_acquire);
+      TransformSample parent_child;
+      RingLookupStatus status =
+          item.ring.Lookup(is_static ? 0 : stamp_ns, &parent_child);
+      if (status != RingLookupStatus::OK) {
+        return status_error(status, "lookup " + frames_[chain[i + 1]]->name +
+                                        " -> " + item.name + " at " +
+                                        std::to_string(stamp_ns) + " failed");
+      }
+      *ancestor_child = ComposeSample(parent_child, *ancestor_child);
+    }
+    return true;
+  };
+  TransformSample ancestor_source;
+  TransformSample ancestor_target;
+  if (!compose_chain(source_chain, source_depth, &ancestor_source) ||
+      !compose_chain(target_chain, target_depth, &ancestor_target)) {
+    return false;
+  }
+  *transform = ComposeSample(InverseSample(ancestor_target), ancestor_source);
+  transform->stamp_ns = stamp_ns;
+  return true;
+}
+
+bool TransformCache::LookupTransform(const std::string& target_frame,
+                                     const std::string& source_frame,
+                                     uint64_t stamp_ns,
+                                     TransformSample* transform,
+                                     TransformCacheError* error,
+                                     std::string* errstr) const {
+  const int32_t target_id = GetFrameId(target_frame);
+  const int32_t source_id = GetFrameId(source_frame);
+  if (target_id == kInvalidFrameId || source_id == kInvalidFrameId) {
+    if (error != nullptr) {
+      *error = TransformCacheError::UNKNOWN_FRAME;
+    }
+    if (errstr != nullptr) {
+      *errstr = "frame " +
+                (target_id == kInvalidFrameId ? target_frame : source_frame) +
+                " does not exist";
+    }
+    return false;
+  }
+  return LookupTransform(target_id, source_id, stamp_ns, transform, error,
+                         errstr);
+}
+
+}  // namespace transform
+}  // namespace apollo
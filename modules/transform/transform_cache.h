@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "modules/transform/transform_ring.h"
+
+namespace apollo {
+namespace transform {
+
+enum class TransformCacheError {
+  NONE = 0,
+  UNKNOWN_FRAME,
+  NOT_CONNECTED,
+  EXTRAPOLATION,
+  BUSY,
+};
+
+/**
+ * @class TransformCache
+ * @brief In process transform history serving lookups without locks.
+ *
+ * Frame names are resolved to integer ids once, every frame keeps the pose
+ * in its parent as a time sorted TransformRing, and a lookup walks the
+ * parent ids up to the common ancestor, binary searching and slerping each
+ * edge. Writers are serialized by a mutex, readers never take it.
+ */
+class TransformCache {
+ public:
+  static constexpr uint32_t kMaxFrameNum = 256;
+  static constexpr uint32_t kRingSize = 1024;
+  static constexpr int kMaxChainDepth = 32;
+  static constexpr int32_t kInvalidFrameId = -1;
+
+  TransformCache();
+  ~TransformCache();
+
+  bool SetTransform(const std::string& frame_id,
+                    const std::string& child_frame_id,
+                    const TransformSample& sample, bool is_static);
+  void ClearDynamic();
+
+  /**
+   * @brief Id of `frame`, kInvalidFrameId if it was never seen. Ids are
+   * stable during the lifetime of the cache so callers may keep them.
+   */
+  int32_t GetFrameId(const std::string& frame) const;
+
+  /**
+   * @brief Transform mapping data from `source_id` into `target_id` at
+   * `stamp_ns`. A zero stamp uses the latest time available on every edge
+   * of the chain, as tf2 does.
+   */
+  bool LookupTransform(int32_t target_id, int32_t source_id,
+                       uint64_t stamp_ns, TransformSample* transform,
+                       TransformCacheError* error = nullptr,
+                       std::string* errstr = nullptr) const;
+  bool LookupTransform(const std::string& target_frame,
+                       const std::string& source_frame, uint64_t stamp_ns,
+                       TransformSample* transform,
+                       TransformCacheError* error = nullptr,
+                       std::string* errstr = nullptr) const;
+
+  uint32_t frame_num() const {
+    return frame_num_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr uint32_t kIndexSize = kMaxFrameNum * 2;
+
+  struct Frame {
+    std::string name;
+    uint64_t hash = 0;
+    std::atomic<int32_t> parent{kInvalidFrameId};
+    std::atomic<bool> is_static{false};
+    TransformRing<kRingSize> ring;
+  };
+
+  int32_t FindFrame(const std::string& frame, uint64_t hash) const;
+  // writer only
+  int32_t FindOrAddFrame(const std::string& frame);
+  // ids from `frame_id` up to its root, returns the chain length
+  int GetChain(int32_t frame_id, int32_t* chain) const;
+
+  std::unique_ptr<Frame> frames_[kMaxFrameNum];
+  std::atomic<uint32_t> frame_num_{0};
+  // open addressing index from name hash to frame id
+  std::atomic<int32_t> index_[kIndexSize];
+  std::mutex write_mutex_;
+};
+
+}  // namespace transform
+}  // namespace apollo
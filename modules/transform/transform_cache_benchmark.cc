@@ -0,0 +1,163 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares tf2::BufferCore with TransformCache on the frame tree of the
+// vehicle: world -> localization -> novatel -> velodyne128, 10s of 100Hz
+// localization and static extrinsics, queried at random times the way the
+// lidar motion compensator does.
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "tf2/buffer_core.h"
+
+#include "modules/transform/transform_cache.h"
+
+namespace apollo {
+namespace transform {
+
+namespace {
+
+constexpr uint64_t kStartNs = 1000000000000;
+constexpr uint64_t kPeriodNs = 10000000;
+constexpr int kSampleNum = 1000;
+constexpr uint32_t kSeed = 42;
+
+struct Edge {
+  const char* frame_id;
+  const char* child_frame_id;
+  bool is_static;
+};
+
+constexpr Edge kEdges[] = {
+    {"world", "localization", false},
+    {"localization", "novatel", true},
+    {"novatel", "velodyne128", true},
+};
+
+TransformSample MakeSample(uint64_t stamp_ns, int i) {
+  TransformSample sample;
+  sample.stamp_ns = stamp_ns;
+  sample.translation[0] = 0.1 * i;
+  sample.translation[1] = 0.05 * i;
+  sample.translation[2] = 1.0;
+  const double yaw = 0.001 * i;
+  sample.rotation[2] = std::sin(yaw / 2.0);
+  sample.rotation[3] = std::cos(yaw / 2.0);
+  return sample;
+}
+
+geometry_msgs::TransformStamped ToTf2(const Edge& edge,
+                                      const TransformSample& sample) {
+  geometry_msgs::TransformStamped msg;
+  msg.header.stamp = sample.stamp_ns;
+  msg.header.frame_id = edge.frame_id;
+  msg.child_frame_id = edge.child_frame_id;
+  msg.transform.translation.x = sample.translation[0];
+  msg.transform.translation.y = sample.translation[1];
+  msg.transform.translation.z = sample.translation[2];
+  msg.transform.rotation.x = sample.rotation[0];
+  msg.transform.rotation.y = sample.rotation[1];
+  msg.transform.rotation.z = sample.rotation[2];
+  msg.transform.rotation.w = sample.rotation[3];
+  return msg;
+}
+
+template <typename Setter>
+void Fill(Setter setter) {
+  for (int i = 0; i < kSampleNum; ++i) {
+    for (const auto& edge : kEdges) {
+      if (edge.is_static && i > 0) {
+        continue;
+      }
+      const uint64_t stamp = edge.is_static ? 0 : kStartNs + i * kPeriodNs;
+      setter(edge, MakeSample(stamp, i));
+    }
+  }
+}
+
+tf2::BufferCore* GetBufferCore() {
+  static tf2::BufferCore* buffer_core = []() {
+    auto* buffer = new tf2::BufferCore();
+    Fill([buffer](const Edge& edge, const TransformSample& sample) {
+      buffer->setTransform(ToTf2(edge, sample), "benchmark", edge.is_static);
+    });
+    return buffer;
+  }();
+  return buffer_core;
+}
+
+TransformCache* GetTransformCache() {
+  static TransformCache* transform_cache = []() {
+    auto* cache = new TransformCache();
+    Fill([cache](const Edge& edge, const TransformSample& sample) {
+      cache->SetTransform(edge.frame_id, edge.child_frame_id, sample,
+                          edge.is_static);
+    });
+    return cache;
+  }();
+  return transform_cache;
+}
+
+uint64_t RandomStamp(std::mt19937* engine) {
+  std::uniform_int_distribution<uint64_t> dist(
+      kStartNs, kStartNs + (kSampleNum - 1) * kPeriodNs);
+  return dist(*engine);
+}
+
+}  // namespace
+
+void BM_BufferCoreLookup(benchmark::State& state) {  // NOLINT
+  const tf2::BufferCore* buffer = GetBufferCore();
+  std::mt19937 engine(kSeed);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(buffer->lookupTransform(
+        "world", "velodyne128", tf2::Time(RandomStamp(&engine))));
+  }
+}
+BENCHMARK(BM_BufferCoreLookup)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_TransformCacheLookup(benchmark::State& state) {  // NOLINT
+  const TransformCache* cache = GetTransformCache();
+  std::mt19937 engine(kSeed);
+  TransformSample result;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache->LookupTransform(
+        "world", "velodyne128", RandomStamp(&engine), &result));
+  }
+}
+BENCHMARK(BM_TransformCacheLookup)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_TransformCacheLookupById(benchmark::State& state) {  // NOLINT
+  const TransformCache* cache = GetTransformCache();
+  const int32_t world = cache->GetFrameId("world");
+  const int32_t velodyne = cache->GetFrameId("velodyne128");
+  std::mt19937 engine(kSeed);
+  TransformSample result;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache->LookupTransform(
+        world, velodyne, RandomStamp(&engine), &result));
+  }
+}
+BENCHMARK(BM_TransformCacheLookupById)->ThreadRange(1, 8)->UseRealTime();
+
+}  // namespace transform
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,263 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/transform/transform_cache.h"
+
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "tf2/buffer_core.h"
+#include "tf2/exceptions.h"
+
+namespace apollo {
+namespace transform {
+
+namespace {
+
+TransformSample MakeSample(uint64_t stamp_ns, double x, double y,
+                           double yaw) {
+  TransformSample sample;
+  sample.stamp_ns = stamp_ns;
+  sample.translation[0] = x;
+  sample.translation[1] = y;
+  sample.rotation[2] = std::sin(yaw / 2.0);
+  sample.rotation[3] = std::cos(yaw / 2.0);
+  return sample;
+}
+
+geometry_msgs::TransformStamped ToTf2(const std::string& frame_id,
+                                      const std::string& child_frame_id,
+                                      const TransformSample& sample) {
+  geometry_msgs::TransformStamped msg;
+  msg.header.stamp = sample.stamp_ns;
+  msg.header.frame_id = frame_id;
+  msg.child_frame_id = child_frame_id;
+  msg.transform.translation.x = sample.translation[0];
+  msg.transform.translation.y = sample.translation[1];
+  msg.transform.translation.z = sample.translation[2];
+  msg.transform.rotation.x = sample.rotation[0];
+  msg.transform.rotation.y = sample.rotation[1];
+  msg.transform.rotation.z = sample.rotation[2];
+  msg.transform.rotation.w = sample.rotation[3];
+  return msg;
+}
+
+// lookup result of tf2, the error is NONE on success
+TransformCacheError LookupBufferCore(const tf2::BufferCore& buffer,
+                                     const std::string& target_frame,
+                                     const std::string& source_frame,
+                                     uint64_t stamp_ns,
+                                     geometry_msgs::TransformStamped* result) {
+  try {
+    *result = buffer.lookupTransform(target_frame, source_frame, stamp_ns);
+  } catch (const tf2::ExtrapolationException&) {
+    return TransformCacheError::EXTRAPOLATION;
+  } catch (const tf2::ConnectivityException&) {
+    return TransformCacheError::NOT_CONNECTED;
+  } catch (const tf2::LookupException&) {
+    return TransformCacheError::UNKNOWN_FRAME;
+  }
+  return TransformCacheError::NONE;
+}
+
+}  // namespace
+
+TEST(TransformCacheTest, LookupTransform) {
+  TransformCache cache;
+  EXPECT_TRUE(cache.SetTransform("world", "localization",
+                                 MakeSample(1000, 10.0, 0.0, M_PI_2), false));
+  EXPECT_TRUE(cache.SetTransform("world", "localization",
+                                 MakeSample(3000, 30.0, 0.0, M_PI_2), false));
+  EXPECT_TRUE(cache.SetTransform("localization", "imu",
+                                 MakeSample(1500, 0.0, 0.0, 0.0), false));
+  EXPECT_TRUE(cache.SetTransform("localization", "imu",
+                                 MakeSample(2500, 0.0, 0.0, 0.0), false));
+  EXPECT_TRUE(cache.SetTransform("imu", "velodyne",
+                                 MakeSample(0, 1.0, 0.0, 0.0), true));
+  EXPECT_EQ(cache.frame_num(), 4);
+
+  const int32_t world = cache.GetFrameId("world");
+  const int32_t velodyne = cache.GetFrameId("velodyne");
+  ASSERT_NE(world, TransformCache::kInvalidFrameId);
+  ASSERT_NE(velodyne, TransformCache::kInvalidFrameId);
+  EXPECT_EQ(cache.GetFrameId("unknown"), TransformCache::kInvalidFrameId);
+
+  TransformSample result;
+  TransformCacheError error;
+  ASSERT_TRUE(cache.LookupTransform(world, velodyne, 2000, &result, &error));
+  EXPECT_EQ(error, TransformCacheError::NONE);
+  EXPECT_NEAR(result.translation[0], 20.0, 1e-6);
+  EXPECT_NEAR(result.translation[1], 1.0, 1e-6);
+
+  // the latest common time of localization and imu
+  ASSERT_TRUE(cache.LookupTransform("world", "velodyne", 0, &result));
+  EXPECT_EQ(result.stamp_ns, 2500);
+  EXPECT_NEAR(result.translation[0], 25.0, 1e-6);
+
+  ASSERT_TRUE(cache.LookupTransform(velodyne, world, 2000, &result));
+  EXPECT_NEAR(result.translation[0], -1.0, 1e-6);
+  EXPECT_NEAR(result.translation[1], 20.0, 1e-6);
+
+  EXPECT_FALSE(cache.LookupTransform(world, velodyne, 2800, &result, &error));
+  EXPECT_EQ(error, TransformCacheError::EXTRAPOLATION);
+  EXPECT_FALSE(
+      cache.LookupTransform("world", "unknown", 2000, &result, &error));
+  EXPECT_EQ(error, TransformCacheError::UNKNOWN_FRAME);
+
+  EXPECT_TRUE(cache.SetTransform("map", "odom", MakeSample(1000, 0, 0, 0),
+                                 false));
+  EXPECT_FALSE(cache.LookupTransform("world", "odom", 1000, &result, &error));
+  EXPECT_EQ(error, TransformCacheError::NOT_CONNECTED);
+
+  cache.ClearDynamic();
+  EXPECT_FALSE(cache.LookupTransform(world, velodyne, 2000, &result));
+  ASSERT_TRUE(cache.LookupTransform("imu", "velodyne", 0, &result));
+  EXPECT_NEAR(result.translation[0], 1.0, 1e-6);
+}
+
+TEST(TransformCacheTest, SameAsBufferCore) {
+  struct Edge {
+    std::string frame_id;
+    std::string child_frame_id;
+    TransformSample sample;
+    bool is_static;
+  };
+  std::vector<Edge> edges;
+  std::mt19937 engine(42);
+  std::uniform_real_distribution<double> position(-50.0, 50.0);
+  std::uniform_real_distribution<double> yaw(-M_PI, M_PI);
+  // localization at 100Hz and imu at 40Hz with a phase shift, so no two
+  // dynamic edges share a stamp
+  for (uint64_t stamp = 10000; stamp <= 1000000; stamp += 10000) {
+    edges.push_back({"world", "localization",
+                     MakeSample(stamp, position(engine), position(engine),
+                                yaw(engine)),
+                     false});
+  }
+  for (uint64_t stamp = 13000; stamp <= 980000; stamp += 25000) {
+    edges.push_back({"localization", "imu",
+                     MakeSample(stamp, position(engine), position(engine),
+                                yaw(engine)),
+                     false});
+  }
+  edges.push_back({"imu", "velodyne", MakeSample(0, 1.0, 0.5, 0.3), true});
+  edges.push_back({"localization", "camera", MakeSample(0, 2.0, 1.0, -0.2),
+                   true});
+  edges.push_back({"camera", "lens", MakeSample(0, 0.1, 0.0, 0.0), true});
+  edges.push_back({"map", "odom", MakeSample(50000, 1.0, 0.0, 0.0), false});
+
+  tf2::BufferCore buffer;
+  TransformCache cache;
+  for (const auto& edge : edges) {
+    ASSERT_TRUE(buffer.setTransform(
+        ToTf2(edge.frame_id, edge.child_frame_id, edge.sample), "test",
+        edge.is_static));
+    ASSERT_TRUE(cache.SetTransform(edge.frame_id, edge.child_frame_id,
+                                   edge.sample, edge.is_static));
+  }
+
+  std::vector<uint64_t> stamps = {
+      // the latest common time
+      0,
+      // exact samples of either edge
+      10000, 13000, 500000, 513000, 963000,
+      // out of the range of imu, of localization, or of both
+      5000, 11000, 990000, 1000000, 1100000};
+  std::uniform_int_distribution<uint64_t> stamp(13000, 963000);
+  for (int i = 0; i < 100; ++i) {
+    stamps.push_back(stamp(engine));
+  }
+  const std::vector<std::pair<std::string, std::string>> frame_pairs = {
+      {"world", "velodyne"}, {"velodyne", "world"},  {"lens", "velodyne"},
+      {"imu", "lens"},       {"velodyne", "camera"}, {"camera", "lens"},
+      {"world", "world"},    {"world", "odom"},      {"world", "unknown"}};
+  for (const auto& frames : frame_pairs) {
+    for (const uint64_t stamp_ns : stamps) {
+      SCOPED_TRACE(frames.first + " <- " + frames.second + " at " +
+                   std::to_string(stamp_ns));
+      geometry_msgs::TransformStamped expected;
+      const TransformCacheError expected_error = LookupBufferCore(
+          buffer, frames.first, frames.second, stamp_ns, &expected);
+      TransformSample result;
+      TransformCacheError error = TransformCacheError::NONE;
+      EXPECT_EQ(cache.LookupTransform(frames.first, frames.second, stamp_ns,
+                                      &result, &error),
+                expected_error == TransformCacheError::NONE);
+      ASSERT_EQ(error, expected_error);
+      if (error != TransformCacheError::NONE) {
+        continue;
+      }
+      EXPECT_EQ(result.stamp_ns, expected.header.stamp);
+      EXPECT_NEAR(result.translation[0], expected.transform.translation.x,
+                  1e-9);
+      EXPECT_NEAR(result.translation[1], expected.transform.translation.y,
+                  1e-9);
+      EXPECT_NEAR(result.translation[2], expected.transform.translation.z,
+                  1e-9);
+      // q and -q are the same rotation
+      const double dot = result.rotation[0] * expected.transform.rotation.x +
+                         result.rotation[1] * expected.transform.rotation.y +
+                         result.rotation[2] * expected.transform.rotation.z +
+                         result.rotation[3] * expected.transform.rotation.w;
+      EXPECT_NEAR(std::fabs(dot), 1.0, 1e-9);
+    }
+  }
+}
+
+TEST(TransformCacheTest, ConcurrentLookup) {
+  TransformCache cache;
+  cache.SetTransform("world", "localization", MakeSample(1, 0.0, 0.0, 0.0),
+                     false);
+  const int32_t world = cache.GetFrameId("world");
+  const int32_t localization = cache.GetFrameId("localization");
+
+  std::atomic<bool> stop(false);
+  std::atomic<int> failures(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      TransformSample result;
+      while (!stop.load()) {
+        if (!cache.LookupTransform(world, localization, 0, &result)) {
+          continue;
+        }
+        // x and y are always written equal, a torn read would differ
+        if (std::fabs(result.translation[0] - result.translation[1]) > 1e-9) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (uint64_t stamp = 2; stamp < 200000; ++stamp) {
+    const double value = static_cast<double>(stamp);
+    cache.SetTransform("world", "localization",
+                       MakeSample(stamp, value, value, 0.0), false);
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(failures.load(), 0);
+}
+
+}  // namespace transform
+}  // namespace apollo
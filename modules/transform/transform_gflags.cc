@@ -0,0 +1,33 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/transform/transform_gflags.h"
+
+DEFINE_bool(enable_tf_shm_store, false,
+            "Share the transform history of the host through shared memory, "
+            "only one process subscribes /tf and /tf_static.");
+DEFINE_string(tf_shm_store_name, "/apollo_transform_store",
+              "Name of the shared memory transform store.");
+DEFINE_int32(tf_shm_writer_check_interval_ms, 1000,
+             "Interval at which reader processes check whether the writer "
+             "of the shared memory transform store is still alive, and take "
+             "the writer role over when it is gone.");
+DEFINE_int32(tf_shm_open_timeout_ms, 1000,
+             "How long to wait for the creator of the shared memory "
+             "transform store to initialize it.");
+DEFINE_bool(enable_tf_lockfree_lookup, false,
+            "Serve transform lookups from the lock free transform cache "
+            "instead of tf2::BufferCore.");
@@ -0,0 +1,30 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file transform_gflags.h
+ * @brief The gflags used by transform module
+ */
+
+#pragma once
+
+#include "gflags/gflags.h"
+
+DECLARE_bool(enable_tf_shm_store);
+DECLARE_string(tf_shm_store_name);
+DECLARE_int32(tf_shm_writer_check_interval_ms);
+DECLARE_int32(tf_shm_open_timeout_ms);
+DECLARE_bool(enable_tf_lockfree_lookup);
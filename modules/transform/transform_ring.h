@@ -0,0 +1,305 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Eigen/Geometry"
+#include "gtest/gtest_prod.h"
+
+namespace apollo {
+namespace transform {
+
+/**
+ * @brief Pose of a child frame in its parent frame at `stamp_ns`.
+ * Plain data so that it can live in shared memory.
+ */
+struct TransformSample {
+  uint64_t stamp_ns = 0;
+  double translation[3] = {0.0, 0.0, 0.0};
+  double rotation[4] = {0.0, 0.0, 0.0, 1.0};  // qx, qy, qz, qw
+};
+
+inline Eigen::Quaterniond SampleRotation(const TransformSample& sample) {
+  return Eigen::Quaterniond(sample.rotation[3], sample.rotation[0],
+                            sample.rotation[1], sample.rotation[2]);
+}
+
+inline void SetSampleRotation(const Eigen::Quaterniond& q,
+                              TransformSample* sample) {
+  sample->rotation[0] = q.x();
+  sample->rotation[1] = q.y();
+  sample->rotation[2] = q.z();
+  sample->rotation[3] = q.w();
+}
+
+/**
+ * @brief Linear interpolation of the translation and slerp of the rotation,
+ * same as tf2::TimeCache.
+ */
+inline TransformSample InterpolateSample(const TransformSample& first,
+                                         const TransformSample& second,
+                                         uint64_t stamp_ns) {
+  if (second.stamp_ns == first.stamp_ns) {
+    return second;
+  }
+  const double ratio =
+      static_cast<double>(stamp_ns - first.stamp_ns) /
+      static_cast<double>(second.stamp_ns - first.stamp_ns);
+  TransformSample result;
+  result.stamp_ns = stamp_ns;
+  for (int i = 0; i < 3; ++i) {
+    result.translation[i] = first.translation[i] +
+                            (second.translation[i] - first.translation[i]) *
+                                ratio;
+  }
+  SetSampleRotation(
+      SampleRotation(first).slerp(ratio, SampleRotation(second)).normalized(),
+      &result);
+  return result;
+}
+
+/**
+ * @brief Returns first * second, the stamp of `first` is kept.
+ */
+inline TransformSample ComposeSample(const TransformSample& first,
+                                     const TransformSample& second) {
+  const Eigen::Quaterniond q1 = SampleRotation(first);
+  const Eigen::Vector3d t1(first.translation[0], first.translation[1],
+                           first.translation[2]);
+  const Eigen::Vector3d t2(second.translation[0], second.translation[1],
+                           second.translation[2]);
+  const Eigen::Vector3d t = q1 * t2 + t1;
+  TransformSample result;
+  result.stamp_ns = first.stamp_ns;
+  result.translation[0] = t.x();
+  result.translation[1] = t.y();
+  result.translation[2] = t.z();
+  SetSampleRotation((q1 * SampleRotation(second)).normalized(), &result);
+  return result;
+}
+
+inline TransformSample InverseSample(const TransformSample& sample) {
+  const Eigen::Quaterniond q = SampleRotation(sample).inverse();
+  const Eigen::Vector3d t =
+      q * Eigen::Vector3d(-sample.translation[0], -sample.translation[1],
+                          -sample.translation[2]);
+  TransformSample result;
+  result.stamp_ns = sample.stamp_ns;
+  result.translation[0] = t.x();
+  result.translation[1] = t.y();
+  result.translation[2] = t.z();
+  SetSampleRotation(q, &result);
+  return result;
+}
+
+enum class RingLookupStatus {
+  OK = 0,
+  EMPTY,
+  EXTRAPOLATION_PAST,
+  EXTRAPOLATION_FUTURE,
+  BUSY,
+};
+
+/**
+ * @class TransformRing
+ * @brief Time ordered history of one frame pair, written by a single thread
+ * and read by any number of threads without locks. Every slot is guarded by
+ * a sequence lock and remembers the index it was written with, so readers
+ * detect slots overwritten under them and retry. The class is standard
+ * layout and can be placed in shared memory.
+ */
+template <uint32_t N>
+class TransformRing {
+ public:
+  static_assert(N > 2, "ring is too small");
+
+  void Init() {
+    count_.store(0, std::memory_order_relaxed);
+    first_valid_.store(0, std::memory_order_relaxed);
+    last_stamp_ns_ = 0;
+    for (auto& slot : slots_) {
+      slot.seq.store(0, std::memory_order_relaxed);
+      slot.index = 0;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /**
+   * @brief Append a sample, samples older than the latest one are rejected.
+   * Writer only.
+   */
+  bool Push(const TransformSample& sample) {
+    uint64_t count = count_.load(std::memory_order_relaxed);
+    if (count > first_valid_.load(std::memory_order_relaxed) &&
+        sample.stamp_ns < last_stamp_ns_) {
+      return false;
+    }
+    Slot& slot = slots_[count % N];
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    // a writer that died in the middle of a push left the sequence odd
+    seq += seq & 1;
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.index = count;
+    slot.sample = sample;
+    slot.seq.store(seq + 2, std::memory_order_release);
+    count_.store(count + 1, std::memory_order_release);
+    last_stamp_ns_ = sample.stamp_ns;
+    return true;
+  }
+
+  /**
+   * @brief Make the ring consistent again when the previous writer may have
+   * died in the middle of a Push. The slot it was writing is not readable,
+   * it held the sample right behind the oldest readable one. New writer
+   * only, before its first Push.
+   */
+  void Recover() {
+    for (auto& slot : slots_) {
+      const uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+      if (seq & 1) {
+        slot.index = kInvalidIndex;
+        slot.seq.store(seq + 1, std::memory_order_release);
+      }
+    }
+    const uint64_t count = count_.load(std::memory_order_relaxed);
+    TransformSample latest;
+    last_stamp_ns_ =
+        count > first_valid_.load(std::memory_order_relaxed) &&
+                Read(count - 1, &latest)
+            ? latest.stamp_ns
+            : 0;
+  }
+
+  /**
+   * @brief Drop the history, e.g. when time jumps back. Writer only.
+   */
+  void Clear() {
+    first_valid_.store(count_.load(std::memory_order_relaxed),
+                       std::memory_order_release);
+    last_stamp_ns_ = 0;
+  }
+
+  /**
+   * @brief Sample at `stamp_ns`, interpolated between its neighbours. A zero
+   * stamp returns the latest sample.
+   */
+  RingLookupStatus Lookup(uint64_t stamp_ns, TransformSample* sample) const {
+    for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+      const uint64_t count = count_.load(std::memory_order_acquire);
+      uint64_t first = first_valid_.load(std::memory_order_acquire);
+      if (count <= first) {
+        return RingLookupStatus::EMPTY;
+      }
+      // the slot behind the oldest one may be under writing
+      if (count - first > N - 1) {
+        first = count - (N - 1);
+      }
+      TransformSample latest;
+      if (!Read(count - 1, &latest)) {
+        continue;
+      }
+      if (stamp_ns == 0 || stamp_ns == latest.stamp_ns) {
+        *sample = latest;
+        return RingLookupStatus::OK;
+      }
+      if (stamp_ns > latest.stamp_ns) {
+        *sample = latest;
+        return RingLookupStatus::EXTRAPOLATION_FUTURE;
+      }
+      TransformSample oldest;
+      if (!Read(first, &oldest)) {
+        continue;
+      }
+      if (stamp_ns <= oldest.stamp_ns) {
+        *sample = oldest;
+        return stamp_ns == oldest.stamp_ns
+                   ? RingLookupStatus::OK
+                   : RingLookupStatus::EXTRAPOLATION_PAST;
+      }
+      // invariant: stamp(lo) < stamp_ns <= stamp(hi)
+      uint64_t lo = first;
+      uint64_t hi = count - 1;
+      TransformSample lo_sample = oldest;
+      TransformSample hi_sample = latest;
+      bool torn = false;
+      while (hi - lo > 1) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        TransformSample mid_sample;
+        if (!Read(mid, &mid_sample)) {
+          torn = true;
+          break;
+        }
+        if (mid_sample.stamp_ns < stamp_ns) {
+          lo = mid;
+          lo_sample = mid_sample;
+        } else {
+          hi = mid;
+          hi_sample = mid_sample;
+        }
+      }
+      if (torn) {
+        continue;
+      }
+      *sample = InterpolateSample(lo_sample, hi_sample, stamp_ns);
+      return RingLookupStatus::OK;
+    }
+    return RingLookupStatus::BUSY;
+  }
+
+  uint64_t size() const {
+    const uint64_t count = count_.load(std::memory_order_acquire);
+    const uint64_t first = first_valid_.load(std::memory_order_acquire);
+    return count - first > N - 1 ? N - 1 : count - first;
+  }
+
+ private:
+  static constexpr int kMaxAttempts = 8;
+  static constexpr uint64_t kInvalidIndex = ~0ULL;
+
+  FRIEND_TEST(TransformRingTest, CrashInPush);
+  FRIEND_TEST(ShmTransformStoreTest, TakeOverAfterCrash);
+
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    uint64_t index;
+    TransformSample sample;
+  };
+
+  bool Read(uint64_t index, TransformSample* sample) const {
+    const Slot& slot = slots_[index % N];
+    const uint32_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      return false;
+    }
+    const uint64_t slot_index = slot.index;
+    *sample = slot.sample;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == seq &&
+           slot_index == index;
+  }
+
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> first_valid_;
+  uint64_t last_stamp_ns_;
+  Slot slots_[N];
+};
+
+}  // namespace transform
+}  // namespace apollo